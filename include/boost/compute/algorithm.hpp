@@ -50,6 +50,7 @@
 #include <boost/compute/algorithm/lower_bound.hpp>
 #include <boost/compute/algorithm/lexicographical_compare.hpp> 
 #include <boost/compute/algorithm/max_element.hpp>
+#include <boost/compute/algorithm/median.hpp>
 #include <boost/compute/algorithm/merge.hpp>
 #include <boost/compute/algorithm/min_element.hpp>
 #include <boost/compute/algorithm/minmax_element.hpp>
@@ -57,10 +58,14 @@
 #include <boost/compute/algorithm/next_permutation.hpp>
 #include <boost/compute/algorithm/none_of.hpp>
 #include <boost/compute/algorithm/partial_sum.hpp>
+#include <boost/compute/algorithm/partial_sort.hpp>
+#include <boost/compute/algorithm/partial_sort_copy.hpp>
 #include <boost/compute/algorithm/partition.hpp>
 #include <boost/compute/algorithm/partition_copy.hpp>
 #include <boost/compute/algorithm/partition_point.hpp>
+#include <boost/compute/algorithm/percentile.hpp>
 #include <boost/compute/algorithm/prev_permutation.hpp>
+#include <boost/compute/algorithm/random_permutation.hpp>
 #include <boost/compute/algorithm/random_shuffle.hpp>
 #include <boost/compute/algorithm/reduce.hpp>
 #include <boost/compute/algorithm/reduce_by_key.hpp>
@@ -75,6 +80,7 @@
 #include <boost/compute/algorithm/scatter.hpp>
 #include <boost/compute/algorithm/search.hpp>
 #include <boost/compute/algorithm/search_n.hpp>
+#include <boost/compute/algorithm/segmented_sort.hpp>
 #include <boost/compute/algorithm/set_difference.hpp>
 #include <boost/compute/algorithm/set_intersection.hpp>
 #include <boost/compute/algorithm/set_symmetric_difference.hpp>
@@ -85,6 +91,7 @@
 #include <boost/compute/algorithm/stable_sort.hpp>
 #include <boost/compute/algorithm/stable_sort_by_key.hpp>
 #include <boost/compute/algorithm/swap_ranges.hpp>
+#include <boost/compute/algorithm/top_k.hpp>
 #include <boost/compute/algorithm/transform.hpp>
 #include <boost/compute/algorithm/transform_reduce.hpp>
 #include <boost/compute/algorithm/unique.hpp>
@@ -17,12 +17,16 @@
 #include <boost/compute/system.hpp>
 #include <boost/compute/functional.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/reduce.hpp>
 #include <boost/compute/algorithm/detail/serial_accumulate.hpp>
 #include <boost/compute/container/array.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -121,6 +125,33 @@ inline T dispatch_accumulate(InputIterator first,
     }
 }
 
+template<class InputIterator, class T, class BinaryFunction>
+inline future<T> dispatch_accumulate_async(InputIterator first,
+                                           InputIterator last,
+                                           T init,
+                                           BinaryFunction function,
+                                           command_queue &queue)
+{
+    size_t size = iterator_range_size(first, last);
+    if(size == 0){
+        return make_queue_future(init, queue);
+    }
+
+    // accumulate into device memory, the result is only read when the
+    // future's value is requested
+    buffer result(queue.get_context(), sizeof(T));
+    if(can_accumulate_with_reduce(init, function)){
+        reduce(first, last, buffer_iterator<T>(result, 0), function, queue);
+    }
+    else {
+        serial_accumulate(
+            first, last, buffer_iterator<T>(result, 0), init, function, queue
+        );
+    }
+
+    return make_device_future<T>(result, queue);
+}
+
 } // end detail namespace
 
 /// Returns the result of applying \p function to the elements in the
@@ -187,6 +218,51 @@ inline T accumulate(InputIterator first,
     return detail::dispatch_accumulate(first, last, init, plus<IT>(), queue);
 }
 
+/// Asynchronous version of accumulate(). The commands are enqueued after
+/// \p events and the result is kept in device memory until \c get() is
+/// called on the returned future.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see accumulate()
+template<class InputIterator, class T, class BinaryFunction>
+inline future<T>
+accumulate_async(InputIterator first,
+                 InputIterator last,
+                 T init,
+                 BinaryFunction function,
+                 command_queue &queue = system::default_queue(),
+                 const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    detail::enqueue_wait_list(queue, events);
+
+    return detail::dispatch_accumulate_async(
+        first, last, init, function, queue
+    );
+}
+
+/// \overload
+template<class InputIterator, class T>
+inline future<T>
+accumulate_async(InputIterator first,
+                 InputIterator last,
+                 T init,
+                 command_queue &queue = system::default_queue(),
+                 const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    typedef typename std::iterator_traits<InputIterator>::value_type IT;
+
+    detail::enqueue_wait_list(queue, events);
+
+    return detail::dispatch_accumulate_async(
+        first, last, init, plus<IT>(), queue
+    );
+}
+
 } // end compute namespace
 } // end boost namespace
 
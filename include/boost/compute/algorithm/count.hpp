@@ -36,7 +36,6 @@ inline size_t count(InputIterator first,
                     const T &value,
                     command_queue &queue = system::default_queue())
 {
-    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
 
     using ::boost::compute::_1;
@@ -56,6 +55,44 @@ inline size_t count(InputIterator first,
     }
 }
 
+/// Asynchronous version of count(). The commands are enqueued after
+/// \p events and the count is kept in device memory until \c get() is
+/// called on the returned future.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see count()
+template<class InputIterator, class T>
+inline future<size_t>
+count_async(InputIterator first,
+            InputIterator last,
+            const T &value,
+            command_queue &queue = system::default_queue(),
+            const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    using ::boost::compute::_1;
+    using ::boost::compute::lambda::all;
+
+    if(vector_size<value_type>::value == 1){
+        return ::boost::compute::count_if_async(first,
+                                                last,
+                                                _1 == value,
+                                                queue,
+                                                events);
+    }
+    else {
+        return ::boost::compute::count_if_async(first,
+                                                last,
+                                                all(_1 == value),
+                                                queue,
+                                                events);
+    }
+}
+
 } // end compute namespace
 } // end boost namespace
 
@@ -12,57 +12,169 @@
 #define BOOST_COMPUTE_ALGORITHM_COUNT_IF_HPP
 
 #include <boost/static_assert.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <boost/compute/buffer.hpp>
 
 #include <boost/compute/device.hpp>
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
 #include <boost/compute/algorithm/detail/count_if_with_ballot.hpp>
 #include <boost/compute/algorithm/detail/count_if_with_reduce.hpp>
 #include <boost/compute/algorithm/detail/count_if_with_threads.hpp>
+#include <boost/compute/algorithm/detail/host_stream.hpp>
 #include <boost/compute/algorithm/detail/serial_count_if.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
 namespace compute {
+namespace detail {
 
-/// Returns the number of elements in the range [\p first, \p last)
-/// for which \p predicate returns \c true.
-///
-/// Space complexity on CPUs: \Omega(1)<br>
-/// Space complexity on GPUs: \Omega(n)
+// counts each chunk of a host range streamed by host_stream_reduce()
+template<class Predicate>
+struct count_if_stream_chunk
+{
+    count_if_stream_chunk(Predicate predicate)
+        : m_predicate(predicate)
+    {
+    }
+
+    template<class InputIterator, class OutputIterator>
+    void operator()(InputIterator first,
+                    InputIterator last,
+                    OutputIterator result,
+                    command_queue &queue) const
+    {
+        count_if_with_reduce(first, last, m_predicate, result, queue);
+    }
+
+    Predicate m_predicate;
+};
+
+// count_if() for device iterators
 template<class InputIterator, class Predicate>
-inline size_t count_if(InputIterator first,
-                       InputIterator last,
-                       Predicate predicate,
-                       command_queue &queue = system::default_queue())
+inline size_t dispatch_count_if(InputIterator first,
+                                InputIterator last,
+                                Predicate predicate,
+                                command_queue &queue,
+                                typename boost::enable_if<
+                                    is_device_iterator<InputIterator>
+                                >::type* = 0)
 {
-    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
     const device &device = queue.get_device();
 
-    size_t input_size = detail::iterator_range_size(first, last);
+    size_t input_size = iterator_range_size(first, last);
     if(input_size == 0){
         return 0;
     }
 
     if(device.type() & device::cpu){
         if(input_size < 1024){
-            return detail::serial_count_if(first, last, predicate, queue);
+            return serial_count_if(first, last, predicate, queue);
         }
         else {
-            return detail::count_if_with_threads(first, last, predicate, queue);
+            return count_if_with_threads(first, last, predicate, queue);
         }
     }
     else {
         if(input_size < 32){
-            return detail::serial_count_if(first, last, predicate, queue);
+            return serial_count_if(first, last, predicate, queue);
         }
         else {
-            return detail::count_if_with_reduce(first, last, predicate, queue);
+            return count_if_with_reduce(first, last, predicate, queue);
         }
     }
 }
 
+// count_if() for host iterators
+template<class InputIterator, class Predicate>
+inline size_t dispatch_count_if(InputIterator first,
+                                InputIterator last,
+                                Predicate predicate,
+                                command_queue &queue,
+                                typename boost::disable_if<
+                                    is_device_iterator<InputIterator>
+                                >::type* = 0)
+{
+    // count the values in each chunk while the next ones are uploaded and
+    // then sum the counts of the chunks
+    ::boost::compute::vector<ulong_> counts(queue.get_context());
+    host_stream_reduce(
+        first, last, counts, count_if_stream_chunk<Predicate>(predicate), queue
+    );
+
+    ulong_ count = 0;
+    ::boost::compute::reduce(
+        counts.begin(), counts.end(), &count, plus<ulong_>(), queue
+    );
+
+    return static_cast<size_t>(count);
+}
+
+} // end detail namespace
+
+/// Returns the number of elements in the range [\p first, \p last)
+/// for which \p predicate returns \c true.
+///
+/// When [\p first, \p last) is a host range it is streamed through the
+/// device in chunks staged in pinned host memory, see reduce().
+///
+/// Space complexity on CPUs: \Omega(1)<br>
+/// Space complexity on GPUs: \Omega(n)
+template<class InputIterator, class Predicate>
+inline size_t count_if(InputIterator first,
+                       InputIterator last,
+                       Predicate predicate,
+                       command_queue &queue = system::default_queue())
+{
+    return detail::dispatch_count_if(first, last, predicate, queue);
+}
+
+/// Asynchronous version of count_if(). The commands are enqueued after
+/// \p events and the count is kept in device memory until \c get() is
+/// called on the returned future.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see count_if()
+template<class InputIterator, class Predicate>
+inline future<size_t>
+count_if_async(InputIterator first,
+               InputIterator last,
+               Predicate predicate,
+               command_queue &queue = system::default_queue(),
+               const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    // device type with the same size as size_t on the host
+    typedef typename boost::mpl::if_c<
+        sizeof(size_t) == sizeof(ulong_), ulong_, uint_
+    >::type size_type;
+
+    detail::enqueue_wait_list(queue, events);
+
+    if(first == last){
+        return detail::make_queue_future<size_t>(0, queue);
+    }
+
+    buffer result(queue.get_context(), sizeof(size_type));
+    detail::count_if_with_reduce(
+        first, last, predicate, buffer_iterator<size_type>(result, 0), queue
+    );
+
+    return detail::make_device_future<size_t>(result, queue);
+}
+
 } // end compute namespace
 } // end boost namespace
 
@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_COPY_ON_DEVICE_HPP
 
 #include <iterator>
+#include <string>
 
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/async/future.hpp>
@@ -37,19 +38,21 @@ inline event copy_on_device_cpu(InputIterator first,
 {
     meta_kernel k("copy");
     const device& device = queue.get_device();
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
 
     k <<
-        "uint block = " <<
-            "(uint)ceil(((float)count)/get_global_size(0));\n" <<
-        "uint index = get_global_id(0) * block;\n" <<
-        "uint end = min(count, index + block);\n" <<
+        index_type << " block = " <<
+            "(count + get_global_size(0) - 1) / get_global_size(0);\n" <<
+        index_type << " index = get_global_id(0) * block;\n" <<
+        index_type << " end = min(count, index + block);\n" <<
         "while(index < end){\n" <<
             result[k.var<uint_>("index")] << '=' <<
                 first[k.var<uint_>("index")] << ";\n" <<
             "index++;\n" <<
         "}\n";
 
-    k.add_set_arg<const uint_>("count", static_cast<uint_>(count));
+    k.add_set_index_arg("count", count);
 
     size_t global_work_size = device.compute_units();
     if(count <= 1024) global_work_size = 1;
@@ -75,9 +78,10 @@ inline event copy_on_device_gpu(InputIterator first,
     uint_ tpb = parameters->get(cache_key, "tpb", 128);
 
     meta_kernel k("copy");
+    k.set_index_type_for(count);
     k <<
-        "uint index = get_local_id(0) + " <<
-            "(" << vpt * tpb << " * get_group_id(0));\n" <<
+        k.index_type() << " index = get_local_id(0) + " <<
+            "(" << vpt * tpb << " * (" << k.index_type() << ") get_group_id(0));\n" <<
         "for(uint i = 0; i < " << vpt << "; i++){\n" <<
         "    if(index < count){\n" <<
                 result[k.var<uint_>("index")] << '=' <<
@@ -86,7 +90,7 @@ inline event copy_on_device_gpu(InputIterator first,
         "    }\n"
         "}\n";
 
-    k.add_set_arg<const uint_>("count", static_cast<uint_>(count));
+    k.add_set_index_arg("count", count);
     size_t global_work_size = calculate_work_size(count, vpt, tpb);
     return k.exec_1d(queue, 0, global_work_size, tpb, events);
 }
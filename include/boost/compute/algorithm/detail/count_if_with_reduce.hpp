@@ -80,6 +80,26 @@ inline size_t count_if_with_reduce(InputIterator first,
     return static_cast<size_t>(count);
 }
 
+// counts the number of elements matching predicate using reduce() and
+// writes the count to result without reading it back to the host
+template<class InputIterator, class Predicate, class OutputIterator>
+inline void count_if_with_reduce(InputIterator first,
+                                 InputIterator last,
+                                 Predicate predicate,
+                                 OutputIterator result,
+                                 command_queue &queue)
+{
+    countable_predicate<Predicate> reduce_predicate(predicate);
+
+    ::boost::compute::reduce(
+        ::boost::compute::make_transform_iterator(first, reduce_predicate),
+        ::boost::compute::make_transform_iterator(last, reduce_predicate),
+        result,
+        ::boost::compute::plus<ulong_>(),
+        queue
+    );
+}
+
 } // end detail namespace
 } // end compute namespace
 } // end boost namespace
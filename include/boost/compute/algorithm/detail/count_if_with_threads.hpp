@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_COUNT_IF_WITH_THREADS_HPP
 
 #include <numeric>
+#include <string>
 
 #include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/container/vector.hpp>
@@ -41,24 +42,26 @@ public:
         typedef typename std::iterator_traits<InputIterator>::value_type T;
 
         m_size = detail::iterator_range_size(first, last);
+        set_index_type_for(m_size);
+        const std::string index_type = this->index_type();
 
-        m_size_arg = add_arg<const ulong_>("size");
+        m_size_arg = add_index_arg("size");
         m_counts_arg = add_arg<ulong_ *>(memory_object::global_memory, "counts");
 
         *this <<
             // thread parameters
             "const uint gid = get_global_id(0);\n" <<
-            "const uint block_size = size / get_global_size(0);\n" <<
-            "const uint start = block_size * gid;\n" <<
-            "uint end = 0;\n" <<
+            "const " << index_type << " block_size = size / get_global_size(0);\n" <<
+            "const " << index_type << " start = block_size * gid;\n" <<
+            index_type << " end = 0;\n" <<
             "if(gid == get_global_size(0) - 1)\n" <<
             "    end = size;\n" <<
             "else\n" <<
             "    end = block_size * gid + block_size;\n" <<
 
             // count values
-            "uint count = 0;\n" <<
-            "for(uint i = start; i < end; i++){\n" <<
+            index_type << " count = 0;\n" <<
+            "for(" << index_type << " i = start; i < end; i++){\n" <<
                 decl<const T>("value") << "="
                     << first[expr<uint_>("i")] << ";\n" <<
                 if_(predicate(var<const T>("value"))) << "{\n" <<
@@ -91,7 +94,7 @@ public:
         ::boost::compute::vector<ulong_> counts(threads, context);
 
         // exec kernel
-        set_arg(m_size_arg, static_cast<ulong_>(m_size));
+        set_index_arg(m_size_arg, m_size);
         set_arg(m_counts_arg, counts.get_buffer());
         exec_1d(queue, 0, threads, 1);
 
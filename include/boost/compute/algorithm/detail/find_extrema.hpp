@@ -11,7 +11,11 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_FIND_EXTREMA_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_FIND_EXTREMA_HPP
 
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/async/future.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/algorithm/detail/find_extrema_on_cpu.hpp>
 #include <boost/compute/algorithm/detail/find_extrema_with_reduce.hpp>
 #include <boost/compute/algorithm/detail/find_extrema_with_atomics.hpp>
@@ -60,9 +64,79 @@ inline InputIterator find_extrema(InputIterator first,
         return serial_find_extrema(first, last, compare, find_minimum, queue);
     #endif
 
+    // and for large ranges on devices without 64-bit atomics
+    if(!find_extrema_with_atomics_supported(first, last, queue))
+    {
+        return serial_find_extrema(first, last, compare, find_minimum, queue);
+    }
+
     return find_extrema_with_atomics(first, last, compare, find_minimum, queue);
 }
 
+// enqueues the search for the first extremum of [first, last), which holds
+// at least two elements, and writes its index to the start of index. the
+// index is a ulong_ if requires_64bit_indices() is true for the size of the
+// range and a uint_ otherwise. nothing is read back to the host, so instead of the per-core
+// search of find_extrema_on_cpu() the reduce-based version is used on
+// every device with enough local memory for it.
+template<class InputIterator, class Compare>
+inline void find_extrema_index(InputIterator first,
+                               InputIterator last,
+                               Compare compare,
+                               const bool find_minimum,
+                               const buffer &index,
+                               command_queue &queue)
+{
+    size_t count = iterator_range_size(first, last);
+
+    if(count < 512 ||
+       !find_extrema_with_reduce_requirements_met(first, last, queue, false)){
+        serial_find_extrema_index(
+            first, last, compare, find_minimum, index, queue
+        );
+        return;
+    }
+
+    if(requires_64bit_indices(count)){
+        find_extrema_with_reduce_index(
+            first, last, compare, find_minimum,
+            make_buffer_iterator<ulong_>(index), queue
+        );
+    }
+    else {
+        find_extrema_with_reduce_index(
+            first, last, compare, find_minimum,
+            make_buffer_iterator<uint_>(index), queue
+        );
+    }
+}
+
+// find_extrema() which returns a future for the extremum. its index is kept
+// in device memory until the future's get() is called.
+template<class InputIterator, class Compare>
+inline future<InputIterator> find_extrema_async(InputIterator first,
+                                                InputIterator last,
+                                                Compare compare,
+                                                const bool find_minimum,
+                                                command_queue &queue)
+{
+    if(iterator_range_size(first, last) < 2){
+        return make_queue_future(first, queue);
+    }
+
+    if(requires_64bit_indices(iterator_range_size(first, last))){
+        buffer index(queue.get_context(), sizeof(ulong_));
+        find_extrema_index(first, last, compare, find_minimum, index, queue);
+
+        return make_device_index_future<ulong_>(first, index, queue);
+    }
+
+    buffer index(queue.get_context(), sizeof(uint_));
+    find_extrema_index(first, last, compare, find_minimum, index, queue);
+
+    return make_device_index_future<uint_>(first, index, queue);
+}
+
 } // end detail namespace
 } // end compute namespace
 } // end boost namespace
@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_FIND_EXTREMA_ON_CPU_HPP
 
 #include <algorithm>
+#include <string>
 
 #include <boost/compute/algorithm/detail/find_extrema_with_reduce.hpp>
 #include <boost/compute/algorithm/detail/find_extrema_with_atomics.hpp>
@@ -59,25 +60,33 @@ inline InputIterator find_extrema_on_cpu(InputIterator first,
     }
 
     meta_kernel k("find_extrema_on_cpu");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    const size_t index_size =
+        k.uses_64bit_indices() ? sizeof(ulong_) : sizeof(uint_);
+
     buffer output(context, sizeof(input_type) * compute_units);
     buffer output_idx(
-        context, sizeof(uint_) * compute_units,
+        context, index_size * compute_units,
         buffer::read_write | buffer::alloc_host_ptr
     );
 
-    size_t count_arg = k.add_arg<uint_>("count");
+    size_t count_arg = k.add_index_arg("count");
     size_t output_arg =
         k.add_arg<input_type *>(memory_object::global_memory, "output");
-    size_t output_idx_arg =
+    size_t output_idx_arg = k.uses_64bit_indices() ?
+        k.add_arg<ulong_ *>(memory_object::global_memory, "output_idx") :
         k.add_arg<uint_ *>(memory_object::global_memory, "output_idx");
 
     k <<
-        "uint block = " <<
-            "(uint)ceil(((float)count)/get_global_size(0));\n" <<
-        "uint index = get_global_id(0) * block;\n" <<
-        "uint end = min(count, index + block);\n" <<
-
-        "uint value_index = index;\n" <<
+        "const " << index_type << " global_size = get_global_size(0);\n" <<
+        "const " << index_type << " block = " <<
+            "(count + global_size - 1) / global_size;\n" <<
+        index_type << " index = " <<
+            "(" << index_type << ")(get_global_id(0)) * block;\n" <<
+        "const " << index_type << " end = min(count, index + block);\n" <<
+
+        index_type << " value_index = index;\n" <<
         k.decl<input_type>("value") << " = " << first[k.var<uint_>("index")] << ";\n" <<
 
         "index++;\n" <<
@@ -105,7 +114,7 @@ inline InputIterator find_extrema_on_cpu(InputIterator first,
     }
     kernel kernel = k.compile(context, options);
 
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(kernel, count_arg, count);
     kernel.set_arg(output_arg, output);
     kernel.set_arg(output_idx_arg, output_idx);
     queue.enqueue_1d_range_kernel(kernel, 0, global_work_size, 0);
@@ -118,16 +127,23 @@ inline InputIterator find_extrema_on_cpu(InputIterator first,
         queue
     );
 
-    uint_* output_idx_host_ptr =
-        static_cast<uint_*>(
-            queue.enqueue_map_buffer(
-                output_idx, command_queue::map_read,
-                0, global_work_size * sizeof(uint_)
-            )
+    void *output_idx_host_ptr =
+        queue.enqueue_map_buffer(
+            output_idx, command_queue::map_read,
+            0, global_work_size * index_size
         );
 
-    difference_type extremum_idx =
-        static_cast<difference_type>(*(output_idx_host_ptr + result.get_index()));
+    difference_type extremum_idx;
+    if(k.uses_64bit_indices()){
+        extremum_idx = static_cast<difference_type>(
+            static_cast<ulong_ *>(output_idx_host_ptr)[result.get_index()]
+        );
+    }
+    else {
+        extremum_idx = static_cast<difference_type>(
+            static_cast<uint_ *>(output_idx_host_ptr)[result.get_index()]
+        );
+    }
     return first + extremum_idx;
 }
 
@@ -11,6 +11,8 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_FIND_EXTREMA_WITH_ATOMICS_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_FIND_EXTREMA_WITH_ATOMICS_HPP
 
+#include <string>
+
 #include <boost/compute/types.hpp>
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/container/detail/scalar.hpp>
@@ -22,24 +24,33 @@ namespace boost {
 namespace compute {
 namespace detail {
 
-template<class InputIterator, class Compare>
-inline InputIterator find_extrema_with_atomics(InputIterator first,
-                                               InputIterator last,
-                                               Compare compare,
-                                               const bool find_minimum,
-                                               command_queue &queue)
+template<class IndexType, class InputIterator, class Compare>
+inline InputIterator find_extrema_with_atomics_with_index_type(InputIterator first,
+                                                               InputIterator last,
+                                                               Compare compare,
+                                                               const bool find_minimum,
+                                                               command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
     typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
 
     const context &context = queue.get_context();
+    size_t count = iterator_range_size(first, last);
 
     meta_kernel k("find_extrema");
-    atomic_cmpxchg<uint_> atomic_cmpxchg_uint;
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+
+    // 64-bit indices need atom_cmpxchg() from cl_khr_int64_base_atomics
+    std::string atomic_cmpxchg_index = BOOST_COMPUTE_DETAIL_ATOMIC_PREFIX "cmpxchg";
+    if(k.uses_64bit_indices()){
+        k.add_extension_pragma("cl_khr_int64_base_atomics");
+        atomic_cmpxchg_index = "atom_cmpxchg";
+    }
 
     k <<
-        "const uint gid = get_global_id(0);\n" <<
-        "uint old_index = *index;\n" <<
+        "const " << index_type << " gid = get_global_id(0);\n" <<
+        index_type << " old_index = *index;\n" <<
 
         k.decl<value_type>("old") <<
             " = " << first[k.var<uint_>("old_index")] << ";\n" <<
@@ -69,16 +80,15 @@ inline InputIterator find_extrema_with_atomics(InputIterator first,
                   "&& gid < old_index)){\n" <<
         "#endif\n" <<
 
-        "  if(" << atomic_cmpxchg_uint(k.var<uint_ *>("index"),
-                                       k.var<uint_>("old_index"),
-                                       k.var<uint_>("gid")) << " == old_index)\n" <<
+        "  if(" << atomic_cmpxchg_index << "(index, old_index, gid) == old_index)\n" <<
         "      break;\n" <<
         "  else\n" <<
         "    old_index = *index;\n" <<
         "old = " << first[k.var<uint_>("old_index")] << ";\n" <<
         "}\n";
 
-    size_t index_arg_index = k.add_arg<uint_ *>(memory_object::global_memory, "index");
+    size_t index_arg_index =
+        k.add_arg<IndexType *>(memory_object::global_memory, "index");
 
     std::string options;
     if(!find_minimum){
@@ -87,20 +97,48 @@ inline InputIterator find_extrema_with_atomics(InputIterator first,
     kernel kernel = k.compile(context, options);
 
     // setup index buffer
-    scalar<uint_> index(context);
+    scalar<IndexType> index(context);
     kernel.set_arg(index_arg_index, index.get_buffer());
 
     // initialize index
     index.write(0, queue);
 
     // run kernel
-    size_t count = iterator_range_size(first, last);
     queue.enqueue_1d_range_kernel(kernel, 0, count, 0);
 
     // read index and return iterator
     return first + static_cast<difference_type>(index.read(queue));
 }
 
+// ranges which need 64-bit indices require the cl_khr_int64_base_atomics
+// extension (see find_extrema_with_atomics_supported())
+template<class InputIterator, class Compare>
+inline InputIterator find_extrema_with_atomics(InputIterator first,
+                                               InputIterator last,
+                                               Compare compare,
+                                               const bool find_minimum,
+                                               command_queue &queue)
+{
+    if(requires_64bit_indices(iterator_range_size(first, last))){
+        return find_extrema_with_atomics_with_index_type<ulong_>(
+            first, last, compare, find_minimum, queue
+        );
+    }
+
+    return find_extrema_with_atomics_with_index_type<uint_>(
+        first, last, compare, find_minimum, queue
+    );
+}
+
+template<class InputIterator>
+inline bool find_extrema_with_atomics_supported(InputIterator first,
+                                                InputIterator last,
+                                                command_queue &queue)
+{
+    return !requires_64bit_indices(iterator_range_size(first, last)) ||
+           queue.get_device().supports_extension("cl_khr_int64_base_atomics");
+}
+
 } // end detail namespace
 } // end compute namespace
 } // end boost namespace
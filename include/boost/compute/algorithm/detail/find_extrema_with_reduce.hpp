@@ -29,10 +29,13 @@ namespace boost {
 namespace compute {
 namespace detail {
 
+// if dedicated_local_memory is false, devices which keep local memory in
+// global memory (like most CPUs) are accepted as well
 template<class InputIterator>
 bool find_extrema_with_reduce_requirements_met(InputIterator first,
                                                InputIterator last,
-                                               command_queue &queue)
+                                               command_queue &queue,
+                                               const bool dedicated_local_memory = true)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type input_type;
 
@@ -40,7 +43,8 @@ bool find_extrema_with_reduce_requirements_met(InputIterator first,
 
     // device must have dedicated local memory storage
     // otherwise reduction would be highly inefficient
-    if(device.get_info<CL_DEVICE_LOCAL_MEM_TYPE>() != CL_LOCAL)
+    if(dedicated_local_memory &&
+       device.get_info<CL_DEVICE_LOCAL_MEM_TYPE>() != CL_LOCAL)
     {
         return false;
     }
@@ -63,7 +67,10 @@ bool find_extrema_with_reduce_requirements_met(InputIterator first,
     // local memory size needed to perform parallel reduction
     size_t required_local_mem_size = 0;
     // indices size
-    required_local_mem_size += sizeof(uint_) * work_group_size;
+    const size_t index_size =
+        requires_64bit_indices(iterator_range_size(first, last)) ?
+            sizeof(ulong_) : sizeof(uint_);
+    required_local_mem_size += index_size * work_group_size;
     // values size
     required_local_mem_size += sizeof(input_type) * work_group_size;
 
@@ -78,12 +85,19 @@ bool find_extrema_with_reduce_requirements_met(InputIterator first,
 ///
 /// If \p use_input_idx is false, it's assumed that input data is ordered by
 /// increasing index and \p input_idx is not used in the algorithm.
-template<class InputIterator, class ResultIterator, class Compare>
+///
+/// Indices have the value type of \p result_idx (\c uint_ or \c ulong_
+/// for ranges which need 64-bit indices).
+template<class InputIterator,
+         class InputIndexIterator,
+         class ResultIterator,
+         class ResultIndexIterator,
+         class Compare>
 inline void find_extrema_with_reduce(InputIterator input,
-                                     vector<uint_>::iterator input_idx,
+                                     InputIndexIterator input_idx,
                                      size_t count,
                                      ResultIterator result,
-                                     vector<uint_>::iterator result_idx,
+                                     ResultIndexIterator result_idx,
                                      size_t work_groups_no,
                                      size_t work_group_size,
                                      Compare compare,
@@ -92,23 +106,24 @@ inline void find_extrema_with_reduce(InputIterator input,
                                      command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type input_type;
+    typedef typename std::iterator_traits<ResultIndexIterator>::value_type index_type;
 
     const context &context = queue.get_context();
 
     meta_kernel k("find_extrema_reduce");
-    size_t count_arg = k.add_arg<uint_>("count");
+    size_t count_arg = k.add_arg<index_type>("count");
     size_t block_arg = k.add_arg<input_type *>(memory_object::local_memory, "block");
-    size_t block_idx_arg = k.add_arg<uint_ *>(memory_object::local_memory, "block_idx");
+    size_t block_idx_arg = k.add_arg<index_type *>(memory_object::local_memory, "block_idx");
 
     k <<
         // Work item global id
-        k.decl<const uint_>("gid") << " = get_global_id(0);\n" <<
+        k.decl<const index_type>("gid") << " = get_global_id(0);\n" <<
 
         // Index of element that will be read from input buffer
-        k.decl<uint_>("idx") << " = gid;\n" <<
+        k.decl<index_type>("idx") << " = gid;\n" <<
 
         k.decl<input_type>("acc") << ";\n" <<
-        k.decl<uint_>("acc_idx") << ";\n" <<
+        k.decl<index_type>("acc_idx") << ";\n" <<
         "if(gid < count) {\n" <<
             // Real index of currently best element
             "#ifdef BOOST_COMPUTE_USE_INPUT_IDX\n" <<
@@ -128,7 +143,7 @@ inline void find_extrema_with_reduce(InputIterator input,
             // Next element
             k.decl<input_type>("next") << " = " << input[k.var<uint_>("idx")] << ";\n" <<
             "#ifdef BOOST_COMPUTE_USE_INPUT_IDX\n" <<
-            k.decl<uint_>("next_idx") << " = " << input_idx[k.var<uint_>("idx")] << ";\n" <<
+            k.decl<index_type>("next_idx") << " = " << input_idx[k.var<uint_>("idx")] << ";\n" <<
             "#endif\n" <<
 
             // Comparison between currently best element (acc) and next element
@@ -168,8 +183,8 @@ inline void find_extrema_with_reduce(InputIterator input,
         "block_idx[lid] = acc_idx;\n" <<
         "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
 
-        k.decl<uint_>("group_offset") <<
-            " = count - (get_local_size(0) * get_group_id(0));\n\n";
+        k.decl<index_type>("group_offset") <<
+            " = count - ((" << type_name<index_type>() << ")(get_local_size(0)) * get_group_id(0));\n\n";
 
     k <<
         "#pragma unroll\n"
@@ -192,8 +207,8 @@ inline void find_extrema_with_reduce(InputIterator input,
                              k.var<input_type>("mine")) << ";\n" <<
                  "#endif\n" <<
                  "block[lid] = compare_result ? mine : other;\n" <<
-                 k.decl<uint_>("mine_idx") << " = block_idx[lid];\n" <<
-                 k.decl<uint_>("other_idx") << " = block_idx[lid+offset];\n" <<
+                 k.decl<index_type>("mine_idx") << " = block_idx[lid];\n" <<
+                 k.decl<index_type>("other_idx") << " = block_idx[lid+offset];\n" <<
                  "block_idx[lid] = compare_result ? " <<
                      "mine_idx : " <<
                      "(equal ? min(mine_idx, other_idx) : other_idx);\n" <<
@@ -217,9 +232,9 @@ inline void find_extrema_with_reduce(InputIterator input,
 
     kernel kernel = k.compile(context, options);
 
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    kernel.set_arg(count_arg, static_cast<index_type>(count));
     kernel.set_arg(block_arg, local_buffer<input_type>(work_group_size));
-    kernel.set_arg(block_idx_arg, local_buffer<uint_>(work_group_size));
+    kernel.set_arg(block_idx_arg, local_buffer<index_type>(work_group_size));
 
     queue.enqueue_1d_range_kernel(kernel,
                                   0,
@@ -227,11 +242,14 @@ inline void find_extrema_with_reduce(InputIterator input,
                                   work_group_size);
 }
 
-template<class InputIterator, class ResultIterator, class Compare>
+template<class InputIterator,
+         class ResultIterator,
+         class ResultIndexIterator,
+         class Compare>
 inline void find_extrema_with_reduce(InputIterator input,
                                      size_t count,
                                      ResultIterator result,
-                                     vector<uint_>::iterator result_idx,
+                                     ResultIndexIterator result_idx,
                                      size_t work_groups_no,
                                      size_t work_group_size,
                                      Compare compare,
@@ -239,23 +257,30 @@ inline void find_extrema_with_reduce(InputIterator input,
                                      command_queue &queue)
 {
     // dummy will not be used
-    buffer_iterator<uint_> dummy = result_idx;
+    ResultIndexIterator dummy = result_idx;
     return find_extrema_with_reduce(
         input, dummy, count, result, result_idx, work_groups_no,
         work_group_size, compare, find_minimum, false, queue
     );
 }
 
+// enqueues both phases of the reduction for the first extremum of
+// [first, last) and writes its index to the first element of result_idx.
+// result_idx holds ulong_ values if requires_64bit_indices() is true for the
+// size of the range and uint_ values otherwise. nothing is read back to the
+// host.
+//
 // Space complexity: \Omega(2 * work-group-size * work-groups-per-compute-unit)
-template<class InputIterator, class Compare>
-InputIterator find_extrema_with_reduce(InputIterator first,
-                                       InputIterator last,
-                                       Compare compare,
-                                       const bool find_minimum,
-                                       command_queue &queue)
+template<class InputIterator, class ResultIndexIterator, class Compare>
+inline void find_extrema_with_reduce_index(InputIterator first,
+                                           InputIterator last,
+                                           Compare compare,
+                                           const bool find_minimum,
+                                           ResultIndexIterator result_idx,
+                                           command_queue &queue)
 {
-    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
     typedef typename std::iterator_traits<InputIterator>::value_type input_type;
+    typedef typename std::iterator_traits<ResultIndexIterator>::value_type index_type;
 
     const context &context = queue.get_context();
     const device &device = queue.get_device();
@@ -283,7 +308,7 @@ InputIterator find_extrema_with_reduce(InputIterator first,
     size_t work_groups_no = compute_units_no * work_groups_per_cu;
     work_groups_no = (std::min)(
         work_groups_no,
-        static_cast<size_t>(std::ceil(float(count) / work_group_size))
+        (count + work_group_size - 1) / work_group_size
     );
 
     // phase I: finding candidates for extremum
@@ -291,7 +316,7 @@ InputIterator find_extrema_with_reduce(InputIterator first,
     // device buffors for extremum candidates and their indices
     // each work-group computes its candidate
     vector<input_type> candidates(work_groups_no, context);
-    vector<uint_> candidates_idx(work_groups_no, context);
+    vector<index_type> candidates_idx(work_groups_no, context);
 
     // finding candidates for first extremum and their indices
     find_extrema_with_reduce(
@@ -300,42 +325,55 @@ InputIterator find_extrema_with_reduce(InputIterator first,
     );
 
     // phase II: finding extremum from among the candidates
-
-    // zero-copy buffers for final result (value and index)
-    vector<input_type, ::boost::compute::pinned_allocator<input_type> >
-        result(1, context);
-    vector<uint_, ::boost::compute::pinned_allocator<uint_> >
-        result_idx(1, context);
+    vector<input_type> result(1, context);
 
     // get extremum from among the candidates
     find_extrema_with_reduce(
         candidates.begin(), candidates_idx.begin(), work_groups_no, result.begin(),
-        result_idx.begin(), 1, work_group_size, compare, find_minimum, true, queue
+        result_idx, 1, work_group_size, compare, find_minimum, true, queue
+    );
+}
+
+template<class IndexType, class InputIterator, class Compare>
+InputIterator find_extrema_with_reduce_with_index_type(InputIterator first,
+                                                       InputIterator last,
+                                                       Compare compare,
+                                                       const bool find_minimum,
+                                                       command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
+
+    // zero-copy buffer for the index of the extremum
+    vector<IndexType, ::boost::compute::pinned_allocator<IndexType> >
+        result_idx(1, queue.get_context());
+
+    find_extrema_with_reduce_index(
+        first, last, compare, find_minimum, result_idx.begin(), queue
     );
 
     // mapping extremum index to host
-    uint_* result_idx_host_ptr =
-        static_cast<uint_*>(
+    IndexType* result_idx_host_ptr =
+        static_cast<IndexType*>(
             queue.enqueue_map_buffer(
                 result_idx.get_buffer(), command_queue::map_read,
-                0, sizeof(uint_)
+                0, sizeof(IndexType)
             )
         );
 
     return first + static_cast<difference_type>(*result_idx_host_ptr);
 }
 
-template<class InputIterator>
-InputIterator find_extrema_with_reduce(InputIterator first,
-                                       InputIterator last,
-                                       ::boost::compute::less<
-                                           typename std::iterator_traits<
-                                               InputIterator
-                                           >::value_type
-                                       >
-                                       compare,
-                                       const bool find_minimum,
-                                       command_queue &queue)
+template<class IndexType, class InputIterator>
+InputIterator find_extrema_with_reduce_with_index_type(InputIterator first,
+                                                       InputIterator last,
+                                                       ::boost::compute::less<
+                                                           typename std::iterator_traits<
+                                                               InputIterator
+                                                           >::value_type
+                                                       >
+                                                       compare,
+                                                       const bool find_minimum,
+                                                       command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
     typedef typename std::iterator_traits<InputIterator>::value_type input_type;
@@ -366,7 +404,7 @@ InputIterator find_extrema_with_reduce(InputIterator first,
     size_t work_groups_no = compute_units_no * work_groups_per_cu;
     work_groups_no = (std::min)(
         work_groups_no,
-        static_cast<size_t>(std::ceil(float(count) / work_group_size))
+        (count + work_group_size - 1) / work_group_size
     );
 
     // phase I: finding candidates for extremum
@@ -376,7 +414,7 @@ InputIterator find_extrema_with_reduce(InputIterator first,
     // zero-copy buffers are used to eliminate copying data back to host
     vector<input_type, ::boost::compute::pinned_allocator<input_type> >
         candidates(work_groups_no, context);
-    vector<uint_, ::boost::compute::pinned_allocator <uint_> >
+    vector<IndexType, ::boost::compute::pinned_allocator<IndexType> >
         candidates_idx(work_groups_no, context);
 
     // finding candidates for first extremum and their indices
@@ -396,17 +434,17 @@ InputIterator find_extrema_with_reduce(InputIterator first,
             )
         );
 
-    uint_* candidates_idx_host_ptr =
-        static_cast<uint_*>(
+    IndexType* candidates_idx_host_ptr =
+        static_cast<IndexType*>(
             queue.enqueue_map_buffer(
                 candidates_idx.get_buffer(), command_queue::map_read,
-                0, work_groups_no * sizeof(uint_)
+                0, work_groups_no * sizeof(IndexType)
             )
         );
 
     input_type* i = candidates_host_ptr;
-    uint_* idx = candidates_idx_host_ptr;
-    uint_* extremum_idx = idx;
+    IndexType* idx = candidates_idx_host_ptr;
+    IndexType* extremum_idx = idx;
     input_type extremum = *candidates_host_ptr;
     i++; idx++;
 
@@ -437,6 +475,25 @@ InputIterator find_extrema_with_reduce(InputIterator first,
     return first + static_cast<difference_type>(*extremum_idx);
 }
 
+// Space complexity: \Omega(2 * work-group-size * work-groups-per-compute-unit)
+template<class InputIterator, class Compare>
+InputIterator find_extrema_with_reduce(InputIterator first,
+                                       InputIterator last,
+                                       Compare compare,
+                                       const bool find_minimum,
+                                       command_queue &queue)
+{
+    if(requires_64bit_indices(iterator_range_size(first, last))){
+        return find_extrema_with_reduce_with_index_type<ulong_>(
+            first, last, compare, find_minimum, queue
+        );
+    }
+
+    return find_extrema_with_reduce_with_index_type<uint_>(
+        first, last, compare, find_minimum, queue
+    );
+}
+
 } // end detail namespace
 } // end compute namespace
 } // end boost namespace
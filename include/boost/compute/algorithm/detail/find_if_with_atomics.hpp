@@ -12,89 +12,106 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_FIND_IF_WITH_ATOMICS_HPP
 
 #include <iterator>
+#include <string>
+
+#include <boost/throw_exception.hpp>
 
 #include <boost/compute/types.hpp>
+#include <boost/compute/buffer.hpp>
 #include <boost/compute/functional.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/container/detail/scalar.hpp>
 #include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/type_traits/type_name.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
 #include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/exception/unsupported_extension_error.hpp>
 
 namespace boost {
 namespace compute {
 namespace detail {
 
+// returns the atomic min function for the index type of k. 64-bit indices
+// need atom_min() from the cl_khr_int64_extended_atomics extension.
+inline std::string find_if_atomic_min(meta_kernel &k)
+{
+    if(k.uses_64bit_indices()){
+        k.add_extension_pragma("cl_khr_int64_extended_atomics");
+        return "atom_min";
+    }
+
+    return BOOST_COMPUTE_DETAIL_ATOMIC_PREFIX "min";
+}
+
 template<class InputIterator, class UnaryPredicate>
-inline InputIterator find_if_with_atomics_one_vpt(InputIterator first,
-                                                  InputIterator last,
-                                                  UnaryPredicate predicate,
-                                                  const size_t count,
-                                                  command_queue &queue)
+inline void find_if_with_atomics_one_vpt(InputIterator first,
+                                         InputIterator last,
+                                         UnaryPredicate predicate,
+                                         const size_t count,
+                                         const buffer &index,
+                                         command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
-    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
 
     const context &context = queue.get_context();
 
     detail::meta_kernel k("find_if");
-    size_t index_arg = k.add_arg<int *>(memory_object::global_memory, "index");
-    atomic_min<uint_> atomic_min_uint;
+    k.set_index_type_for(count);
+    size_t index_arg = k.uses_64bit_indices() ?
+        k.add_arg<ulong_ *>(memory_object::global_memory, "index") :
+        k.add_arg<uint_ *>(memory_object::global_memory, "index");
+    const std::string atomic_min_index = find_if_atomic_min(k);
 
-    k << k.decl<const uint_>("i") << " = get_global_id(0);\n"
+    k << "const " << k.index_type() << " i = get_global_id(0);\n"
       << k.decl<const value_type>("value") << "="
       <<     first[k.var<const uint_>("i")] << ";\n"
       << "if(" << predicate(k.var<const value_type>("value")) << "){\n"
-      << "    " << atomic_min_uint(k.var<uint_ *>("index"), k.var<uint_>("i")) << ";\n"
+      << "    " << atomic_min_index << "(index, i);\n"
       << "}\n";
 
     kernel kernel = k.compile(context);
+    kernel.set_arg(index_arg, index);
 
-    scalar<uint_> index(context);
-    kernel.set_arg(index_arg, index.get_buffer());
-
-    // initialize index to the last iterator's index
-    index.write(static_cast<uint_>(count), queue);
     queue.enqueue_1d_range_kernel(kernel, 0, count, 0);
-
-    // read index and return iterator
-    return first + static_cast<difference_type>(index.read(queue));
 }
 
 template<class InputIterator, class UnaryPredicate>
-inline InputIterator find_if_with_atomics_multiple_vpt(InputIterator first,
-                                                       InputIterator last,
-                                                       UnaryPredicate predicate,
-                                                       const size_t count,
-                                                       const size_t vpt,
-                                                       command_queue &queue)
+inline void find_if_with_atomics_multiple_vpt(InputIterator first,
+                                              InputIterator last,
+                                              UnaryPredicate predicate,
+                                              const size_t count,
+                                              const size_t vpt,
+                                              const buffer &index,
+                                              command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
-    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
 
     const context &context = queue.get_context();
     const device &device = queue.get_device();
 
     detail::meta_kernel k("find_if");
-    size_t index_arg = k.add_arg<uint_ *>(memory_object::global_memory, "index");
-    size_t count_arg = k.add_arg<const uint_>("count");
-    size_t vpt_arg = k.add_arg<const uint_>("vpt");
-    atomic_min<uint_> atomic_min_uint;
+    k.set_index_type_for(count);
+    size_t index_arg = k.uses_64bit_indices() ?
+        k.add_arg<ulong_ *>(memory_object::global_memory, "index") :
+        k.add_arg<uint_ *>(memory_object::global_memory, "index");
+    size_t count_arg = k.add_index_arg("count");
+    size_t vpt_arg = k.add_index_arg("vpt");
+    const std::string index_type = k.index_type();
+    const std::string atomic_min_index = find_if_atomic_min(k);
 
     // for GPUs reads from global memory are coalesced
     if(device.type() & device::gpu) {
         k <<
-            k.decl<const uint_>("lsize") << " = get_local_size(0);\n" <<
-            k.decl<uint_>("id") << " = get_local_id(0) + get_group_id(0) * lsize * vpt;\n" <<
-            k.decl<const uint_>("end") << " = min(" <<
-                    "id + (lsize *" << k.var<uint_>("vpt") << ")," <<
-                    "count" <<
-            ");\n" <<
+            "const " << index_type << " lsize = get_local_size(0);\n" <<
+            index_type << " id = get_local_id(0) + " <<
+                "(" << index_type << ")(get_group_id(0)) * lsize * vpt;\n" <<
+            "const " << index_type << " end = min(id + (lsize * vpt), count);\n" <<
 
             // checking if the index is already found
-            "__local uint local_index;\n" <<
+            "__local " << index_type << " local_index;\n" <<
             "if(get_local_id(0) == 0){\n" <<
             "    local_index = *index;\n " <<
             "};\n" <<
@@ -107,8 +124,7 @@ inline InputIterator find_if_with_atomics_multiple_vpt(InputIterator first,
             "    " << k.decl<const value_type>("value") << " = " <<
                       first[k.var<const uint_>("id")] << ";\n"
             "    if(" << predicate(k.var<const value_type>("value")) << "){\n" <<
-            "        " << atomic_min_uint(k.var<uint_ *>("index"),
-                                          k.var<uint_>("id")) << ";\n" <<
+            "        " << atomic_min_index << "(index, id);\n" <<
             "        return;\n"
             "    }\n" <<
             "    id+=lsize;\n" <<
@@ -117,17 +133,13 @@ inline InputIterator find_if_with_atomics_multiple_vpt(InputIterator first,
     // efficiently used.
     } else {
         k <<
-            k.decl<uint_>("id") << " = get_global_id(0) * " << k.var<uint_>("vpt") << ";\n" <<
-            k.decl<const uint_>("end") << " = min(" <<
-                    "id + " << k.var<uint_>("vpt") << "," <<
-                    "count" <<
-            ");\n" <<
+            index_type << " id = get_global_id(0) * vpt;\n" <<
+            "const " << index_type << " end = min(id + vpt, count);\n" <<
             "while(id < end && (*index) > id){\n" <<
             "    " << k.decl<const value_type>("value") << " = " <<
                       first[k.var<const uint_>("id")] << ";\n"
             "    if(" << predicate(k.var<const value_type>("value")) << "){\n" <<
-            "        " << atomic_min_uint(k.var<uint_ *>("index"),
-                                          k.var<uint_>("id")) << ";\n" <<
+            "        " << atomic_min_index << "(index, id);\n" <<
             "        return;\n" <<
             "    }\n" <<
             "    id++;\n" <<
@@ -135,40 +147,38 @@ inline InputIterator find_if_with_atomics_multiple_vpt(InputIterator first,
     }
 
     kernel kernel = k.compile(context);
+    kernel.set_arg(index_arg, index);
+    k.set_index_arg(kernel, count_arg, count);
+    k.set_index_arg(kernel, vpt_arg, vpt);
 
-    scalar<uint_> index(context);
-    kernel.set_arg(index_arg, index.get_buffer());
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
-    kernel.set_arg(vpt_arg, static_cast<uint_>(vpt));
-
-    // initialize index to the last iterator's index
-    index.write(static_cast<uint_>(count), queue);
-
-    const size_t global_wg_size = static_cast<size_t>(
-        std::ceil(float(count) / vpt)
-    );
+    const size_t global_wg_size = (count + vpt - 1) / vpt;
     queue.enqueue_1d_range_kernel(kernel, 0, global_wg_size, 0);
-
-    // read index and return iterator
-    return first + static_cast<difference_type>(index.read(queue));
 }
 
-// Space complexity: O(1)
+// enqueues the kernels which write the index of the first element of
+// [first, last) (count elements) for which predicate returns true to the
+// start of index. the index is a ulong_ if requires_64bit_indices(count)
+// and a uint_ otherwise. it must hold count before the kernels run and
+// keeps it if there is no such element.
 template<class InputIterator, class UnaryPredicate>
-inline InputIterator find_if_with_atomics(InputIterator first,
-                                          InputIterator last,
-                                          UnaryPredicate predicate,
-                                          command_queue &queue)
+inline void find_if_with_atomics_index(InputIterator first,
+                                       InputIterator last,
+                                       UnaryPredicate predicate,
+                                       const size_t count,
+                                       const buffer &index,
+                                       command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
 
-    size_t count = detail::iterator_range_size(first, last);
-    if(count == 0){
-        return last;
-    }
-
     const device &device = queue.get_device();
 
+    if(requires_64bit_indices(count) &&
+       !device.supports_extension("cl_khr_int64_extended_atomics")){
+        BOOST_THROW_EXCEPTION(
+            unsupported_extension_error("cl_khr_int64_extended_atomics")
+        );
+    }
+
     // load cached parameters
     std::string cache_key = std::string("__boost_find_if_with_atomics_")
         + type_name<value_type>();
@@ -181,9 +191,10 @@ inline InputIterator find_if_with_atomics(InputIterator first,
         const size_t one_vpt_threshold =
             parameters->get(cache_key, "one_vpt_threshold", 1048576);
         if(count <= one_vpt_threshold){
-            return find_if_with_atomics_one_vpt(
-                first, last, predicate, count, queue
+            find_if_with_atomics_one_vpt(
+                first, last, predicate, count, index, queue
             );
+            return;
         }
     }
 
@@ -196,13 +207,104 @@ inline InputIterator find_if_with_atomics(InputIterator first,
         // for CPUs work is split equally between compute units
         const size_t max_compute_units =
             device.get_info<CL_DEVICE_MAX_COMPUTE_UNITS>();
-        vpt = static_cast<size_t>(
-            std::ceil(float(count) / max_compute_units)
+        vpt = (count + max_compute_units - 1) / max_compute_units;
+    }
+
+    find_if_with_atomics_multiple_vpt(
+        first, last, predicate, count, vpt, index, queue
+    );
+}
+
+template<class IndexType, class InputIterator, class UnaryPredicate>
+inline InputIterator find_if_with_atomics_with_index_type(InputIterator first,
+                                                          InputIterator last,
+                                                          UnaryPredicate predicate,
+                                                          const size_t count,
+                                                          command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
+
+    scalar<IndexType> index(queue.get_context());
+
+    // initialize index to the last iterator's index
+    index.write(static_cast<IndexType>(count), queue);
+
+    find_if_with_atomics_index(
+        first, last, predicate, count, index.get_buffer(), queue
+    );
+
+    // read index and return iterator
+    return first + static_cast<difference_type>(index.read(queue));
+}
+
+// enqueues the search and returns a future for its result. the index is
+// kept in a device buffer of IndexType until get() is called on the future.
+template<class IndexType, class InputIterator, class UnaryPredicate>
+inline future<InputIterator>
+find_if_with_atomics_async_with_index_type(InputIterator first,
+                                           InputIterator last,
+                                           UnaryPredicate predicate,
+                                           const size_t count,
+                                           command_queue &queue)
+{
+    // the index starts as count, which is kept if no element matches. it is
+    // copied when the buffer is created so the host does not wait for the
+    // commands before it.
+    IndexType initial_index = static_cast<IndexType>(count);
+    buffer index(queue.get_context(),
+                 sizeof(IndexType),
+                 buffer::read_write | buffer::copy_host_ptr,
+                 &initial_index);
+
+    find_if_with_atomics_index(
+        first, last, predicate, count, index, queue
+    );
+
+    return make_device_index_future<IndexType>(first, index, queue);
+}
+
+// Space complexity: O(1)
+template<class InputIterator, class UnaryPredicate>
+inline InputIterator find_if_with_atomics(InputIterator first,
+                                          InputIterator last,
+                                          UnaryPredicate predicate,
+                                          command_queue &queue)
+{
+    size_t count = detail::iterator_range_size(first, last);
+    if(count == 0){
+        return last;
+    }
+
+    if(requires_64bit_indices(count)){
+        return find_if_with_atomics_with_index_type<ulong_>(
+            first, last, predicate, count, queue
+        );
+    }
+
+    return find_if_with_atomics_with_index_type<uint_>(
+        first, last, predicate, count, queue
+    );
+}
+
+template<class InputIterator, class UnaryPredicate>
+inline future<InputIterator> find_if_with_atomics_async(InputIterator first,
+                                                        InputIterator last,
+                                                        UnaryPredicate predicate,
+                                                        command_queue &queue)
+{
+    size_t count = detail::iterator_range_size(first, last);
+    if(count == 0){
+        return make_queue_future(last, queue);
+    }
+
+    if(requires_64bit_indices(count)){
+        return find_if_with_atomics_async_with_index_type<ulong_>(
+            first, last, predicate, count, queue
         );
     }
 
-    return find_if_with_atomics_multiple_vpt(
-        first, last, predicate, count, vpt, queue
+    return find_if_with_atomics_async_with_index_type<uint_>(
+        first, last, predicate, count, queue
     );
 }
 
@@ -0,0 +1,316 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_HOST_STREAM_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_HOST_STREAM_HPP
+
+#include <algorithm>
+#include <iterator>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/device.hpp>
+#include <boost/compute/event.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// algorithms called with host iterators stream the range through the device
+// in chunks instead of copying all of it to the device at once. the chunks
+// are staged in pinned host memory and rotate through a few slots so that
+// the upload of one chunk, the kernel on the chunk before it and the
+// download of the chunk before that run at the same time on separate
+// queues. only the slots are allocated on the device, so the range may be
+// larger than the device memory. ranges which fit into a single chunk are
+// copied to scratch memory of the queue and computed in one shot instead, as
+// there is nothing to overlap and setting up the slots would cost more than
+// the copies.
+
+// the commands on each queue wait for events of the other queues, so every
+// queue is flushed after enqueueing commands which another queue (or a host
+// wait on another queue's events) depends on. otherwise an implementation may
+// never submit them and the wait never returns.
+
+// the number of chunks in flight
+const size_t host_stream_slots = 3;
+
+// returns the size in bytes of each of the chunks of a streamed range. this
+// can be tuned with the "chunk_bytes" parameter of "__boost_host_stream".
+inline size_t host_stream_chunk_bytes(const device &device)
+{
+    // by default the slots use at most a quarter of the device memory
+    const ulong_ default_chunk_bytes =
+        (std::min)(
+            (std::min)(ulong_(32 * 1024 * 1024), device.max_memory_alloc_size()),
+            device.global_memory_size() / (8 * host_stream_slots)
+        );
+
+    boost::shared_ptr<parameter_cache> parameters =
+        parameter_cache::get_global_cache(device);
+
+    return parameters->get(
+        "__boost_host_stream",
+        "chunk_bytes",
+        static_cast<uint_>(default_chunk_bytes)
+    );
+}
+
+// returns the number of values of the given size in each chunk
+inline size_t host_stream_chunk_size(const device &device, size_t value_size)
+{
+    return (std::max)(size_t(1), host_stream_chunk_bytes(device) / value_size);
+}
+
+// storage for one chunk of count values of type T: a pinned host buffer
+// which stays mapped while the slot is in use and a device buffer
+template<class T>
+class host_stream_buffer : boost::noncopyable
+{
+public:
+    host_stream_buffer()
+        : m_host(0)
+    {
+    }
+
+    ~host_stream_buffer()
+    {
+        if(m_host){
+            m_queue.enqueue_unmap_buffer(m_pinned, m_host);
+        }
+    }
+
+    void allocate(size_t count, command_queue &queue)
+    {
+        const context &context = queue.get_context();
+
+        m_queue = queue;
+        m_pinned = buffer(context,
+                          count * sizeof(T),
+                          buffer::read_write | buffer::alloc_host_ptr);
+        m_host = static_cast<T *>(
+            queue.enqueue_map_buffer(m_pinned,
+                                     CL_MAP_READ | CL_MAP_WRITE,
+                                     0,
+                                     count * sizeof(T))
+        );
+        m_device = buffer(context, count * sizeof(T));
+    }
+
+    T* host() const
+    {
+        return m_host;
+    }
+
+    buffer_iterator<T> device_begin() const
+    {
+        return buffer_iterator<T>(m_device, 0);
+    }
+
+    // copies count values from the pinned host memory to the device
+    event upload(size_t count, command_queue &queue)
+    {
+        return queue.enqueue_write_buffer_async(
+            m_device, 0, count * sizeof(T), m_host
+        );
+    }
+
+    // copies count values from the device to the pinned host memory
+    event download(size_t count, command_queue &queue, const event &computed)
+    {
+        return queue.enqueue_read_buffer_async(
+            m_device, 0, count * sizeof(T), m_host, wait_list(computed)
+        );
+    }
+
+private:
+    command_queue m_queue;
+    buffer m_pinned;
+    T *m_host;
+    buffer m_device;
+};
+
+// streams the host range [first, last) through the device and copies the
+// values of type T written for it by function to result. function is called
+// with the device input range of each chunk, the start of its device output
+// range and queue.
+template<class T, class InputIterator, class OutputIterator, class Function>
+inline OutputIterator host_stream_transform(InputIterator first,
+                                            InputIterator last,
+                                            OutputIterator result,
+                                            Function function,
+                                            command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type input_type;
+    typedef T output_type;
+
+    const size_t count = static_cast<size_t>(std::distance(first, last));
+    if(count == 0){
+        return result;
+    }
+
+    const context &context = queue.get_context();
+    const device &device = queue.get_device();
+
+    const size_t chunk_size = (std::min)(
+        count,
+        host_stream_chunk_size(device, sizeof(input_type) + sizeof(output_type))
+    );
+    const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    const size_t slots = (std::min)(host_stream_slots, chunk_count);
+
+    if(chunk_count == 1){
+        scratch_vector<input_type> input(count, queue);
+        scratch_vector<output_type> output(count, queue);
+        ::boost::compute::copy(first, last, input.begin(), queue);
+        function(input.begin(), input.end(), output.begin(), queue);
+        return ::boost::compute::copy(output.begin(), output.end(), result, queue);
+    }
+
+    command_queue upload_queue(context, device);
+    command_queue download_queue(context, device);
+
+    host_stream_buffer<input_type> input[host_stream_slots];
+    host_stream_buffer<output_type> output[host_stream_slots];
+    event downloaded[host_stream_slots];
+    size_t sizes[host_stream_slots];
+    for(size_t s = 0; s < slots; s++){
+        input[s].allocate(chunk_size, upload_queue);
+        output[s].allocate(chunk_size, download_queue);
+    }
+
+    for(size_t i = 0; i < chunk_count; i++){
+        const size_t s = i % slots;
+        const size_t n = (std::min)(chunk_size, count - i * chunk_size);
+
+        // the chunk which used the slot before must be downloaded first
+        if(i >= slots){
+            downloaded[s].wait();
+            result = std::copy(output[s].host(), output[s].host() + sizes[s], result);
+        }
+
+        InputIterator chunk_last = first;
+        std::advance(chunk_last, n);
+        std::copy(first, chunk_last, input[s].host());
+        first = chunk_last;
+        sizes[s] = n;
+
+        event uploaded = input[s].upload(n, upload_queue);
+        upload_queue.flush();
+        enqueue_wait_list(queue, wait_list(uploaded));
+        function(input[s].device_begin(),
+                 input[s].device_begin() + n,
+                 output[s].device_begin(),
+                 queue);
+        event computed = queue.enqueue_marker();
+        queue.flush();
+        downloaded[s] = output[s].download(n, download_queue, computed);
+        download_queue.flush();
+    }
+
+    // copy out the chunks still in flight in order
+    for(size_t i = chunk_count - slots; i < chunk_count; i++){
+        const size_t s = i % slots;
+        downloaded[s].wait();
+        result = std::copy(output[s].host(), output[s].host() + sizes[s], result);
+    }
+
+    return result;
+}
+
+// streams the host range [first, last) through the device and stores one
+// partial result for each chunk in partials. function is called with the
+// device range of each chunk, an iterator to its partial result and queue.
+template<class InputIterator, class T, class Function>
+inline void host_stream_reduce(InputIterator first,
+                               InputIterator last,
+                               ::boost::compute::vector<T> &partials,
+                               Function function,
+                               command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type input_type;
+
+    const context &context = queue.get_context();
+    const device &device = queue.get_device();
+
+    const size_t count = static_cast<size_t>(std::distance(first, last));
+    if(count == 0){
+        return;
+    }
+
+    const size_t chunk_size =
+        (std::min)(count, host_stream_chunk_size(device, sizeof(input_type)));
+    const size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    const size_t slots = (std::min)(host_stream_slots, chunk_count);
+
+    partials.resize(chunk_count, queue);
+
+    if(chunk_count == 1){
+        scratch_vector<input_type> input(count, queue);
+        ::boost::compute::copy(first, last, input.begin(), queue);
+        function(input.begin(), input.end(), partials.begin(), queue);
+        return;
+    }
+
+    command_queue upload_queue(context, device);
+
+    host_stream_buffer<input_type> input[host_stream_slots];
+    event reduced[host_stream_slots];
+    for(size_t s = 0; s < slots; s++){
+        input[s].allocate(chunk_size, upload_queue);
+    }
+
+    for(size_t i = 0; i < chunk_count; i++){
+        const size_t s = i % slots;
+        const size_t n = (std::min)(chunk_size, count - i * chunk_size);
+
+        // the chunk which used the slot before must be reduced first
+        if(i >= slots){
+            reduced[s].wait();
+        }
+
+        InputIterator chunk_last = first;
+        std::advance(chunk_last, n);
+        std::copy(first, chunk_last, input[s].host());
+        first = chunk_last;
+
+        event uploaded = input[s].upload(n, upload_queue);
+        upload_queue.flush();
+        enqueue_wait_list(queue, wait_list(uploaded));
+        function(input[s].device_begin(),
+                 input[s].device_begin() + n,
+                 partials.begin() + i,
+                 queue);
+        reduced[s] = queue.enqueue_marker();
+        queue.flush();
+    }
+
+    // the slots are released on return so wait for the last chunks
+    for(size_t s = 0; s < slots; s++){
+        reduced[s].wait();
+    }
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_HOST_STREAM_HPP
@@ -11,6 +11,8 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_INSERTION_SORT_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_INSERTION_SORT_HPP
 
+#include <string>
+
 #include <boost/compute/kernel.hpp>
 #include <boost/compute/program.hpp>
 #include <boost/compute/command_queue.hpp>
@@ -36,19 +38,21 @@ inline void serial_insertion_sort(Iterator first,
     }
 
     meta_kernel k("serial_insertion_sort");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
     size_t local_data_arg = k.add_arg<T *>(memory_object::local_memory, "data");
-    size_t count_arg = k.add_arg<uint_>("n");
+    size_t count_arg = k.add_index_arg("n");
 
     k <<
         // copy data to local memory
-        "for(uint i = 0; i < n; i++){\n" <<
+        "for(" << index_type << " i = 0; i < n; i++){\n" <<
         "    data[i] = " << first[k.var<uint_>("i")] << ";\n"
-        "}\n"
+        "}\n" <<
 
         // sort data in local memory
-        "for(uint i = 1; i < n; i++){\n" <<
+        "for(" << index_type << " i = 1; i < n; i++){\n" <<
         "    " << k.decl<const T>("value") << " = data[i];\n" <<
-        "    uint pos = i;\n" <<
+        "    " << index_type << " pos = i;\n" <<
         "    while(pos > 0 && " <<
                    compare(k.var<const T>("value"),
                            k.var<const T>("data[pos-1]")) << "){\n" <<
@@ -59,14 +63,14 @@ inline void serial_insertion_sort(Iterator first,
         "}\n" <<
 
         // copy sorted data to output
-        "for(uint i = 0; i < n; i++){\n" <<
+        "for(" << index_type << " i = 0; i < n; i++){\n" <<
         "    " << first[k.var<uint_>("i")] << " = data[i];\n"
         "}\n";
 
     const context &context = queue.get_context();
     ::boost::compute::kernel kernel = k.compile(context);
     kernel.set_arg(local_data_arg, local_buffer<T>(count));
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(kernel, count_arg, count);
 
     queue.enqueue_task(kernel);
 }
@@ -99,22 +103,24 @@ inline void serial_insertion_sort_by_key(KeyIterator keys_first,
     }
 
     meta_kernel k("serial_insertion_sort_by_key");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
     size_t local_keys_arg = k.add_arg<key_type *>(memory_object::local_memory, "keys");
     size_t local_data_arg = k.add_arg<value_type *>(memory_object::local_memory, "data");
-    size_t count_arg = k.add_arg<uint_>("n");
+    size_t count_arg = k.add_index_arg("n");
 
     k <<
         // copy data to local memory
-        "for(uint i = 0; i < n; i++){\n" <<
+        "for(" << index_type << " i = 0; i < n; i++){\n" <<
         "    keys[i] = " << keys_first[k.var<uint_>("i")] << ";\n"
         "    data[i] = " << values_first[k.var<uint_>("i")] << ";\n"
-        "}\n"
+        "}\n" <<
 
         // sort data in local memory
-        "for(uint i = 1; i < n; i++){\n" <<
+        "for(" << index_type << " i = 1; i < n; i++){\n" <<
         "    " << k.decl<const key_type>("key") << " = keys[i];\n" <<
         "    " << k.decl<const value_type>("value") << " = data[i];\n" <<
-        "    uint pos = i;\n" <<
+        "    " << index_type << " pos = i;\n" <<
         "    while(pos > 0 && " <<
                    compare(k.var<const key_type>("key"),
                            k.var<const key_type>("keys[pos-1]")) << "){\n" <<
@@ -127,7 +133,7 @@ inline void serial_insertion_sort_by_key(KeyIterator keys_first,
         "}\n" <<
 
         // copy sorted data to output
-        "for(uint i = 0; i < n; i++){\n" <<
+        "for(" << index_type << " i = 0; i < n; i++){\n" <<
         "    " << keys_first[k.var<uint_>("i")] << " = keys[i];\n"
         "    " << values_first[k.var<uint_>("i")] << " = data[i];\n"
         "}\n";
@@ -136,7 +142,7 @@ inline void serial_insertion_sort_by_key(KeyIterator keys_first,
     ::boost::compute::kernel kernel = k.compile(context);
     kernel.set_arg(local_keys_arg, static_cast<uint_>(count * sizeof(key_type)), 0);
     kernel.set_arg(local_data_arg, static_cast<uint_>(count * sizeof(value_type)), 0);
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(kernel, count_arg, count);
 
     queue.enqueue_task(kernel);
 }
@@ -11,13 +11,18 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_MERGE_SORT_ON_CPU_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_MERGE_SORT_ON_CPU_HPP
 
+#include <algorithm>
+#include <string>
+
 #include <boost/compute/kernel.hpp>
 #include <boost/compute/program.hpp>
 #include <boost/compute/command_queue.hpp>
-#include <boost/compute/algorithm/detail/merge_with_merge_path.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 
 namespace boost {
 namespace compute {
@@ -38,15 +43,17 @@ inline void merge_blocks(KeyIterator keys_first,
     (void) values_first;
 
     meta_kernel k("merge_sort_on_cpu_merge_blocks");
-    size_t count_arg = k.add_arg<const uint_>("count");
-    size_t block_size_arg = k.add_arg<uint_>("block_size");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t count_arg = k.add_index_arg("count");
+    size_t block_size_arg = k.add_index_arg("block_size");
 
     k <<
-        k.decl<uint_>("b1_start") << " = get_global_id(0) * block_size * 2;\n" <<
-        k.decl<uint_>("b1_end") << " = min(count, b1_start + block_size);\n" <<
-        k.decl<uint_>("b2_start") << " = min(count, b1_start + block_size);\n" <<
-        k.decl<uint_>("b2_end") << " = min(count, b2_start + block_size);\n" <<
-        k.decl<uint_>("result_idx") << " = b1_start;\n" <<
+        index_type << " b1_start = get_global_id(0) * block_size * 2;\n" <<
+        index_type << " b1_end = min(count, b1_start + block_size);\n" <<
+        index_type << " b2_start = min(count, b1_start + block_size);\n" <<
+        index_type << " b2_end = min(count, b2_start + block_size);\n" <<
+        index_type << " result_idx = b1_start;\n" <<
 
         // merging block 1 and block 2 (stable)
         "while(b1_start < b1_end && b2_start < b2_end){\n" <<
@@ -102,59 +109,196 @@ inline void merge_blocks(KeyIterator keys_first,
 
     const context &context = queue.get_context();
     ::boost::compute::kernel kernel = k.compile(context);
-    kernel.set_arg(count_arg, static_cast<const uint_>(count));
-    kernel.set_arg(block_size_arg, static_cast<uint_>(block_size));
+    k.set_index_arg(kernel, count_arg, count);
+    k.set_index_arg(kernel, block_size_arg, block_size);
 
-    const size_t global_size = static_cast<size_t>(
-        std::ceil(float(count) / (2 * block_size))
-    );
+    const size_t global_size = (count + 2 * block_size - 1) / (2 * block_size);
     queue.enqueue_1d_range_kernel(kernel, 0, global_size, 0);
 }
 
-template<class Iterator, class Compare>
-inline void merge_blocks(Iterator first,
-                         Iterator result,
-                         Compare compare,
-                         size_t count,
-                         const size_t block_size,
-                         const bool sort_by_key,
-                         command_queue &queue)
+// emits code which finds the split of the merge of [a_start, a_end) and
+// [b_start, b_end) at the output position diag (relative to a_start). after
+// the search a_index elements of the first block and diag - a_index
+// elements of the second block are before the split. ties are resolved in
+// favor of the first block which keeps the merge stable.
+template<class KeyIterator, class Compare>
+inline void merge_path_search(meta_kernel &k,
+                              KeyIterator keys_first,
+                              Compare compare,
+                              const std::string &diag,
+                              const std::string &a_index)
 {
-    // dummy iterator as it's not sort by key
-    Iterator dummy;
-    merge_blocks(first, dummy, result, dummy, compare, count, block_size, false, queue);
+    const std::string index_type = k.index_type();
+
+    k <<
+        "lo = " << diag << " > b_size ? " << diag << " - b_size : 0;\n" <<
+        "hi = min(" << diag << ", a_size);\n" <<
+        "while(lo < hi){\n" <<
+        "    const " << index_type << " mid = (lo + hi) / 2;\n" <<
+        "    const " << index_type << " b_mid = b_start + " << diag << " - 1 - mid;\n" <<
+        "    const " << index_type << " a_mid = a_start + mid;\n" <<
+        "    if(" << compare(keys_first[k.var<uint_>("b_mid")],
+                             keys_first[k.var<uint_>("a_mid")]) << "){\n" <<
+        "        hi = mid;\n" <<
+        "    }\n" <<
+        "    else {\n" <<
+        "        lo = mid + 1;\n" <<
+        "    }\n" <<
+        "}\n" <<
+        "const " << index_type << " " << a_index << " = lo;\n";
 }
 
-template<class Iterator, class Compare>
-inline void dispatch_merge_blocks(Iterator first,
-                                  Iterator result,
+// merges pairs of sorted blocks like merge_blocks() but splits every merge
+// into parts of chunk_size elements with merge path so that all compute
+// units take part even when only a few (large) blocks are left. all pairs are
+// merged with a single kernel launch.
+template<class KeyIterator, class ValueIterator, class Compare>
+inline void merge_blocks_with_merge_path(KeyIterator keys_first,
+                                         ValueIterator values_first,
+                                         KeyIterator keys_result,
+                                         ValueIterator values_result,
+                                         Compare compare,
+                                         size_t count,
+                                         const size_t block_size,
+                                         const size_t chunk_size,
+                                         const bool sort_by_key,
+                                         command_queue &queue)
+{
+    (void) values_result;
+    (void) values_first;
+
+    meta_kernel k("merge_sort_on_cpu_merge_blocks_with_merge_path");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t count_arg = k.add_index_arg("count");
+    size_t block_size_arg = k.add_index_arg("block_size");
+    size_t chunk_size_arg = k.add_index_arg("chunk_size");
+    size_t parts_arg = k.add_arg<const uint_>("parts");
+
+    k <<
+        "const " << index_type << " a_start = (get_global_id(0) / parts) * block_size * 2;\n" <<
+        "if(a_start >= count){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "const " << index_type << " b_start = min(count, a_start + block_size);\n" <<
+        "const " << index_type << " b_end = min(count, b_start + block_size);\n" <<
+        "const " << index_type << " a_size = b_start - a_start;\n" <<
+        "const " << index_type << " b_size = b_end - b_start;\n" <<
+        "const " << index_type << " d0 = min((" << index_type << ")(get_global_id(0) % parts) * chunk_size,\n" <<
+        "                    a_size + b_size);\n" <<
+        "const " << index_type << " d1 = min(d0 + chunk_size, a_size + b_size);\n" <<
+        "if(d0 == d1){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        index_type << " lo, hi;\n";
+    merge_path_search(k, keys_first, compare, "d0", "a0");
+    merge_path_search(k, keys_first, compare, "d1", "a1");
+    k <<
+        index_type << " i = a_start + a0;\n" <<
+        index_type << " j = b_start + d0 - a0;\n" <<
+        index_type << " i_end = a_start + a1;\n" <<
+        index_type << " j_end = b_start + d1 - a1;\n" <<
+        index_type << " result_idx = a_start + d0;\n" <<
+
+        // merging the parts of both blocks (stable)
+        "while(i < i_end && j < j_end){\n" <<
+        "    if(" << compare(keys_first[k.var<uint_>("j")],
+                             keys_first[k.var<uint_>("i")]) << "){\n" <<
+        "        " << keys_result[k.var<uint_>("result_idx")] << " = " <<
+                      keys_first[k.var<uint_>("j")] << ";\n";
+    if(sort_by_key){
+        k <<
+        "        " << values_result[k.var<uint_>("result_idx")] << " = " <<
+                      values_first[k.var<uint_>("j")] << ";\n";
+    }
+    k <<
+        "        j++;\n" <<
+        "    }\n" <<
+        "    else {\n" <<
+        "        " << keys_result[k.var<uint_>("result_idx")] << " = " <<
+                      keys_first[k.var<uint_>("i")] << ";\n";
+    if(sort_by_key){
+        k <<
+        "        " << values_result[k.var<uint_>("result_idx")] << " = " <<
+                      values_first[k.var<uint_>("i")] << ";\n";
+    }
+    k <<
+        "        i++;\n" <<
+        "    }\n" <<
+        "    result_idx++;\n" <<
+        "}\n" <<
+        "while(i < i_end){\n" <<
+        "    " << keys_result[k.var<uint_>("result_idx")] << " = " <<
+                 keys_first[k.var<uint_>("i")] << ";\n";
+    if(sort_by_key){
+        k <<
+        "    " << values_result[k.var<uint_>("result_idx")] << " = " <<
+                 values_first[k.var<uint_>("i")] << ";\n";
+    }
+    k <<
+        "    i++;\n" <<
+        "    result_idx++;\n" <<
+        "}\n" <<
+        "while(j < j_end){\n" <<
+        "    " << keys_result[k.var<uint_>("result_idx")] << " = " <<
+                 keys_first[k.var<uint_>("j")] << ";\n";
+    if(sort_by_key){
+        k <<
+        "    " << values_result[k.var<uint_>("result_idx")] << " = " <<
+                 values_first[k.var<uint_>("j")] << ";\n";
+    }
+    k <<
+        "    j++;\n" <<
+        "    result_idx++;\n" <<
+        "}\n";
+
+    const size_t pair_count = (count + 2 * block_size - 1) / (2 * block_size);
+    const size_t parts = (2 * block_size + chunk_size - 1) / chunk_size;
+
+    const context &context = queue.get_context();
+    ::boost::compute::kernel kernel = k.compile(context);
+    k.set_index_arg(kernel, count_arg, count);
+    k.set_index_arg(kernel, block_size_arg, block_size);
+    k.set_index_arg(kernel, chunk_size_arg, chunk_size);
+    kernel.set_arg(parts_arg, static_cast<const uint_>(parts));
+
+    queue.enqueue_1d_range_kernel(kernel, 0, pair_count * parts, 0);
+}
+
+// merges pairs of blocks with one work-item per pair while there are enough
+// pairs to keep every compute unit busy. the final passes (fewer than
+// blocks_no_threshold blocks, by default two per compute unit) split each
+// merge with merge path instead, which avoids running the last passes on a
+// few threads only.
+template<class KeyIterator, class ValueIterator, class Compare>
+inline void dispatch_merge_blocks(KeyIterator keys_first,
+                                  ValueIterator values_first,
+                                  KeyIterator keys_result,
+                                  ValueIterator values_result,
                                   Compare compare,
                                   size_t count,
                                   const size_t block_size,
+                                  const bool sort_by_key,
                                   const size_t input_size_threshold,
                                   const size_t blocks_no_threshold,
+                                  const size_t thread_count,
                                   command_queue &queue)
 {
-    const size_t blocks_no = static_cast<size_t>(
-        std::ceil(float(count) / block_size)
-    );
-    // merge with merge path should used only for the large arrays and at the
-    // end of merging part when there are only a few big blocks left to be merged
+    const size_t blocks_no = (count + block_size - 1) / block_size;
+
     if(blocks_no <= blocks_no_threshold && count >= input_size_threshold){
-        Iterator last = first + count;
-        for(size_t i = 0; i < count; i+= 2*block_size)
-        {
-            Iterator first1 = (std::min)(first + i, last);
-            Iterator last1 = (std::min)(first1 + block_size, last);
-            Iterator first2 = last1;
-            Iterator last2 = (std::min)(first2 + block_size, last);
-            Iterator block_result = (std::min)(result + i, result + count);
-            merge_with_merge_path(first1, last1, first2, last2,
-                                  block_result, compare, queue);
-        }
+        // at least thread_count parts of at least 256 elements
+        const size_t chunk_size = (std::max)(
+            (count + thread_count - 1) / thread_count, size_t(256)
+        );
+        merge_blocks_with_merge_path(keys_first, values_first,
+                                     keys_result, values_result,
+                                     compare, count, block_size, chunk_size,
+                                     sort_by_key, queue);
     }
     else {
-        merge_blocks(first, result, compare, count, block_size, false, queue);
+        merge_blocks(keys_first, values_first, keys_result, values_result,
+                     compare, count, block_size, sort_by_key, queue);
     }
 }
 
@@ -173,15 +317,17 @@ inline void block_insertion_sort(KeyIterator keys_first,
     typedef typename std::iterator_traits<ValueIterator>::value_type T;
 
     meta_kernel k("merge_sort_on_cpu_block_insertion_sort");
-    size_t count_arg = k.add_arg<uint_>("count");
-    size_t block_size_arg = k.add_arg<uint_>("block_size");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t count_arg = k.add_index_arg("count");
+    size_t block_size_arg = k.add_index_arg("block_size");
 
     k <<
-        k.decl<uint_>("start") << " = get_global_id(0) * block_size;\n" <<
-        k.decl<uint_>("end") << " = min(count, start + block_size);\n" <<
+        index_type << " start = get_global_id(0) * block_size;\n" <<
+        index_type << " end = min(count, start + block_size);\n" <<
 
         // block insertion sort (stable)
-        "for(uint i = start+1; i < end; i++){\n" <<
+        "for(" << index_type << " i = start+1; i < end; i++){\n" <<
         "    " << k.decl<const K>("key") << " = " <<
                   keys_first[k.var<uint_>("i")] << ";\n";
     if(sort_by_key){
@@ -190,7 +336,7 @@ inline void block_insertion_sort(KeyIterator keys_first,
                   values_first[k.var<uint_>("i")] << ";\n";
     }
     k <<
-        "    uint pos = i;\n" <<
+        "    " << index_type << " pos = i;\n" <<
         "    while(pos > start && " <<
                    compare(k.var<const K>("key"),
                            keys_first[k.var<uint_>("pos-1")]) << "){\n" <<
@@ -214,10 +360,10 @@ inline void block_insertion_sort(KeyIterator keys_first,
 
     const context &context = queue.get_context();
     ::boost::compute::kernel kernel = k.compile(context);
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
-    kernel.set_arg(block_size_arg, static_cast<uint_>(block_size));
+    k.set_index_arg(kernel, count_arg, count);
+    k.set_index_arg(kernel, block_size_arg, block_size);
 
-    const size_t global_size = static_cast<size_t>(std::ceil(float(count) / block_size));
+    const size_t global_size = (count + block_size - 1) / block_size;
     queue.enqueue_1d_range_kernel(kernel, 0, global_size, 0);
 }
 
@@ -252,7 +398,6 @@ inline void merge_sort_on_cpu(Iterator first,
         return;
     }
 
-    const context &context = queue.get_context();
     const device &device = queue.get_device();
 
     // loading parameters
@@ -263,32 +408,43 @@ inline void merge_sort_on_cpu(Iterator first,
 
     // When there is merge_with_path_blocks_no_threshold or less blocks left to
     // merge AND input size is merge_with_merge_path_input_size_threshold or more
-    // merge_with_merge_path() algorithm is used to merge sorted blocks;
-    // otherwise merge_blocks() is used.
+    // each merge is split with merge path into parts which are merged in
+    // parallel; otherwise one work-item merges each pair of blocks.
     const size_t merge_with_path_blocks_no_threshold =
-        parameters->get(cache_key, "merge_with_merge_path_blocks_no_threshold", 8);
+        parameters->get(cache_key, "merge_with_merge_path_blocks_no_threshold",
+                        2 * device.compute_units());
     const size_t merge_with_path_input_size_threshold =
-        parameters->get(cache_key, "merge_with_merge_path_input_size_threshold", 2097152);
+        parameters->get(cache_key, "merge_with_merge_path_input_size_threshold", 65536);
+    const size_t merge_with_path_threads =
+        device.compute_units() *
+        parameters->get(cache_key, "merge_with_merge_path_threads_per_cu", 4);
 
     const size_t block_size =
         parameters->get(cache_key, "insertion_sort_block_size", 64);
     block_insertion_sort(first, compare, count, block_size, queue);
 
     // temporary buffer for merge result
-    vector<value_type> temp(count, context);
+    scratch_vector<value_type> temp(count, queue);
     bool result_in_temporary_buffer = false;
 
+    // dummy iterator as it's not sort by key
+    Iterator dummy;
+
     for(size_t i = block_size; i < count; i *= 2){
         result_in_temporary_buffer = !result_in_temporary_buffer;
         if(result_in_temporary_buffer) {
-            dispatch_merge_blocks(first, temp.begin(), compare, count, i,
+            dispatch_merge_blocks(first, dummy, temp.begin(), dummy,
+                                  compare, count, i, false,
                                   merge_with_path_input_size_threshold,
                                   merge_with_path_blocks_no_threshold,
+                                  merge_with_path_threads,
                                   queue);
         } else {
-            dispatch_merge_blocks(temp.begin(), first, compare, count, i,
+            dispatch_merge_blocks(temp.begin(), dummy, first, dummy,
+                                  compare, count, i, false,
                                   merge_with_path_input_size_threshold,
                                   merge_with_path_blocks_no_threshold,
+                                  merge_with_path_threads,
                                   queue);
         }
     }
@@ -320,7 +476,6 @@ inline void merge_sort_by_key_on_cpu(KeyIterator keys_first,
         return;
     }
 
-    const context &context = queue.get_context();
     const device &device = queue.get_device();
 
     // loading parameters
@@ -330,26 +485,43 @@ inline void merge_sort_by_key_on_cpu(KeyIterator keys_first,
     boost::shared_ptr<parameter_cache> parameters =
         detail::parameter_cache::get_global_cache(device);
 
+    const size_t merge_with_path_blocks_no_threshold =
+        parameters->get(cache_key, "merge_with_merge_path_blocks_no_threshold",
+                        2 * device.compute_units());
+    const size_t merge_with_path_input_size_threshold =
+        parameters->get(cache_key, "merge_with_merge_path_input_size_threshold", 65536);
+    const size_t merge_with_path_threads =
+        device.compute_units() *
+        parameters->get(cache_key, "merge_with_merge_path_threads_per_cu", 4);
+
     const size_t block_size =
         parameters->get(cache_key, "insertion_sort_by_key_block_size", 64);
     block_insertion_sort(keys_first, values_first, compare,
                          count, block_size, true, queue);
 
     // temporary buffer for merge results
-    vector<value_type> values_temp(count, context);
-    vector<key_type> keys_temp(count, context);
+    scratch_vector<value_type> values_temp(count, queue);
+    scratch_vector<key_type> keys_temp(count, queue);
     bool result_in_temporary_buffer = false;
 
     for(size_t i = block_size; i < count; i *= 2){
         result_in_temporary_buffer = !result_in_temporary_buffer;
         if(result_in_temporary_buffer) {
-            merge_blocks(keys_first, values_first,
-                         keys_temp.begin(), values_temp.begin(),
-                         compare, count, i, true, queue);
+            dispatch_merge_blocks(keys_first, values_first,
+                                  keys_temp.begin(), values_temp.begin(),
+                                  compare, count, i, true,
+                                  merge_with_path_input_size_threshold,
+                                  merge_with_path_blocks_no_threshold,
+                                  merge_with_path_threads,
+                                  queue);
         } else {
-            merge_blocks(keys_temp.begin(), values_temp.begin(),
-                         keys_first, values_first,
-                         compare, count, i, true, queue);
+            dispatch_merge_blocks(keys_temp.begin(), values_temp.begin(),
+                                  keys_first, values_first,
+                                  compare, count, i, true,
+                                  merge_with_path_input_size_threshold,
+                                  merge_with_path_blocks_no_threshold,
+                                  merge_with_path_threads,
+                                  queue);
         }
     }
 
@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_MERGE_SORT_ON_GPU_HPP_
 
 #include <algorithm>
+#include <string>
 
 #include <boost/compute/kernel.hpp>
 #include <boost/compute/program.hpp>
@@ -94,7 +95,9 @@ inline size_t bitonic_block_sort(KeyIterator keys_first,
     typedef typename std::iterator_traits<ValueIterator>::value_type value_type;
 
     meta_kernel k("bitonic_block_sort");
-    size_t count_arg = k.add_arg<const uint_>("count");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t count_arg = k.add_index_arg("count");
 
     size_t local_keys_arg = k.add_arg<key_type *>(memory_object::local_memory, "lkeys");
     size_t local_vals_arg = 0;
@@ -104,7 +107,7 @@ inline size_t bitonic_block_sort(KeyIterator keys_first,
 
     k <<
         // Work item global and local ids
-        k.decl<const uint_>("gid") << " = get_global_id(0);\n" <<
+        "const " << index_type << " gid = get_global_id(0);\n" <<
         k.decl<const uint_>("lid") << " = get_local_id(0);\n";
 
     // declare my_key and my_value
@@ -135,8 +138,10 @@ inline size_t bitonic_block_sort(KeyIterator keys_first,
             "lidx[lid] = my_index;\n";
     }
     k <<
-        k.decl<const uint_>("offset") << " = get_group_id(0) * get_local_size(0);\n" <<
-        k.decl<const uint_>("n") << " = min((uint)(get_local_size(0)),(count - offset));\n";
+        "const " << index_type << " offset = " <<
+            "(" << index_type << ")(get_group_id(0)) * get_local_size(0);\n" <<
+        k.decl<const uint_>("n") << " = (uint)(min(" <<
+            "(" << index_type << ")(get_local_size(0)), count - offset));\n";
 
     // When work group size is a power of 2 bitonic sorter can be used;
     // otherwise, slower odd-even sort is used.
@@ -282,11 +287,9 @@ inline size_t bitonic_block_sort(KeyIterator keys_first,
         );
 
     const size_t global_size =
-        work_group_size * static_cast<size_t>(
-            std::ceil(float(count) / work_group_size)
-        );
+        work_group_size * ((count + work_group_size - 1) / work_group_size);
 
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(kernel, count_arg, count);
     kernel.set_arg(local_keys_arg, local_buffer<key_type>(work_group_size));
     if(sort_by_key) {
         kernel.set_arg(local_vals_arg, local_buffer<uchar_>(work_group_size));
@@ -333,12 +336,14 @@ inline void merge_blocks_on_gpu(KeyIterator keys_first,
     typedef typename std::iterator_traits<ValueIterator>::value_type value_type;
 
     meta_kernel k("merge_blocks");
-    size_t count_arg = k.add_arg<const uint_>("count");
-    size_t block_size_arg = k.add_arg<const uint_>("block_size");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t count_arg = k.add_index_arg("count");
+    size_t block_size_arg = k.add_index_arg("block_size");
 
     k <<
         // get global id
-        k.decl<const uint_>("gid") << " = get_global_id(0);\n" <<
+        "const " << index_type << " gid = get_global_id(0);\n" <<
         "if(gid >= count) {\n" <<
             "return;\n" <<
         "}\n" <<
@@ -354,25 +359,25 @@ inline void merge_blocks_on_gpu(KeyIterator keys_first,
 
     k <<
         // get my block idx
-        k.decl<const uint_>("my_block_idx") << " = gid / block_size;\n" <<
+        "const " << index_type << " my_block_idx = gid / block_size;\n" <<
         k.decl<const bool>("my_block_idx_is_odd") << " = " <<
             "my_block_idx & 0x1;\n" <<
 
-        k.decl<const uint_>("other_block_idx") << " = " <<
+        "const " << index_type << " other_block_idx = " <<
             // if(my_block_idx is odd) {} else {}
             "my_block_idx_is_odd ? my_block_idx - 1 : my_block_idx + 1;\n" <<
 
         // get ranges of my block and the other block
         // [my_block_start; my_block_end)
         // [other_block_start; other_block_end)
-        k.decl<const uint_>("my_block_start") << " = " <<
+        "const " << index_type << " my_block_start = " <<
             "min(my_block_idx * block_size, count);\n" << // including
-        k.decl<const uint_>("my_block_end") << " = " <<
+        "const " << index_type << " my_block_end = " <<
             "min((my_block_idx + 1) * block_size, count);\n" << // excluding
 
-        k.decl<const uint_>("other_block_start") << " = " <<
+        "const " << index_type << " other_block_start = " <<
             "min(other_block_idx * block_size, count);\n" << // including
-        k.decl<const uint_>("other_block_end") << " = " <<
+        "const " << index_type << " other_block_end = " <<
             "min((other_block_idx + 1) * block_size, count);\n" << // excluding
 
         // other block is empty, nothing to merge here
@@ -389,10 +394,10 @@ inline void merge_blocks_on_gpu(KeyIterator keys_first,
 
         // lower bound
         // left_idx - lower bound
-        k.decl<uint_>("left_idx") << " = other_block_start;\n" <<
-        k.decl<uint_>("right_idx") << " = other_block_end;\n" <<
+        index_type << " left_idx = other_block_start;\n" <<
+        index_type << " right_idx = other_block_end;\n" <<
         "while(left_idx < right_idx) {\n" <<
-            k.decl<uint_>("mid_idx") << " = (left_idx + right_idx) / 2;\n" <<
+            index_type << " mid_idx = left_idx + (right_idx - left_idx) / 2;\n" <<
             k.decl<key_type>("mid_key") << " = " <<
                     keys_first[k.var<const uint_>("mid_idx")] << ";\n" <<
             k.decl<bool>("smaller") << " = " <<
@@ -418,7 +423,7 @@ inline void merge_blocks_on_gpu(KeyIterator keys_first,
                      "left_idx < right_idx" <<
                 ")" <<
             "{\n" <<
-                k.decl<uint_>("mid_idx") << " = (left_idx + right_idx) / 2;\n" <<
+                index_type << " mid_idx = left_idx + (right_idx - left_idx) / 2;\n" <<
                 k.decl<key_type>("mid_key") << " = " <<
                     keys_first[k.var<const uint_>("mid_idx")] << ";\n" <<
                 k.decl<bool>("equal") << " = " <<
@@ -435,7 +440,7 @@ inline void merge_blocks_on_gpu(KeyIterator keys_first,
             "}\n" <<
         "}\n" <<
 
-        k.decl<uint_>("offset") << " = 0;\n" <<
+        index_type << " offset = 0;\n" <<
         "offset += gid - my_block_start;\n" <<
         "offset += left_idx - other_block_start;\n" <<
         "offset += min(my_block_start, other_block_start);\n" <<
@@ -455,12 +460,10 @@ inline void merge_blocks_on_gpu(KeyIterator keys_first,
         )
     );
     const size_t global_size =
-        work_group_size * static_cast<size_t>(
-            std::ceil(float(count) / work_group_size)
-        );
+        work_group_size * ((count + work_group_size - 1) / work_group_size);
 
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
-    kernel.set_arg(block_size_arg, static_cast<uint_>(block_size));
+    k.set_index_arg(kernel, count_arg, count);
+    k.set_index_arg(kernel, block_size_arg, block_size);
     queue.enqueue_1d_range_kernel(kernel, 0, global_size, work_group_size);
 }
 
@@ -0,0 +1,104 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
+#include <boost/compute/utility/wait_list.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// helpers for the algorithm overloads which take a vector of command queues
+// and split their range across them. the queues are typically created for
+// the sub-devices of a partitioned device and must all share one context so
+// that every queue can access the buffers of the range.
+
+// checks that queues can be used by a multi-queue algorithm
+inline void check_multi_queue(const std::vector<command_queue> &queues)
+{
+    BOOST_ASSERT(!queues.empty());
+    for(size_t i = 1; i < queues.size(); i++){
+        BOOST_ASSERT(queues[i].get_context() == queues[0].get_context());
+    }
+    (void) queues;
+}
+
+// splits [0, count) into at most parts non-empty chunks of nearly equal size
+// and returns their boundaries. chunk i is [bounds[i], bounds[i + 1]).
+inline std::vector<size_t> multi_queue_partition(size_t count, size_t parts)
+{
+    parts = (std::max)(size_t(1), (std::min)(parts, count));
+
+    std::vector<size_t> bounds(parts + 1);
+    for(size_t i = 0; i <= parts; i++){
+        bounds[i] = (count / parts) * i + (std::min)(i, count % parts);
+    }
+
+    return bounds;
+}
+
+// returns a wait list holding a marker for the commands enqueued to each of
+// the queues so far. the queues are flushed as the markers are waited on by
+// the other queues, which the implementation only has to make progress on
+// once their queue has been flushed.
+inline wait_list multi_queue_markers(std::vector<command_queue> &queues)
+{
+    wait_list events;
+    for(size_t i = 0; i < queues.size(); i++){
+        events.insert(queues[i].enqueue_marker());
+        queues[i].flush();
+    }
+
+    return events;
+}
+
+// makes the commands enqueued to each of the queues from now on wait for
+// the commands enqueued to all of the queues so far. multi-queue algorithms
+// call this on entry so that no chunk starts before the commands producing
+// its input have completed, whichever of the queues they were enqueued to.
+inline void multi_queue_barrier(std::vector<command_queue> &queues)
+{
+    if(queues.size() < 2){
+        return;
+    }
+
+    const wait_list events = multi_queue_markers(queues);
+    for(size_t i = 0; i < queues.size(); i++){
+        enqueue_wait_list(queues[i], events);
+    }
+}
+
+// blocks until the commands enqueued to each of the queues have completed
+inline void multi_queue_finish(std::vector<command_queue> &queues)
+{
+    // submit the commands of every queue before blocking on any of them
+    for(size_t i = 0; i < queues.size(); i++){
+        queues[i].flush();
+    }
+    for(size_t i = 0; i < queues.size(); i++){
+        queues[i].finish();
+    }
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_HPP
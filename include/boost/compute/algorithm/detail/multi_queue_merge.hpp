@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_MERGE_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_MERGE_HPP
+
+#include <iterator>
+#include <vector>
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/merge.hpp>
+#include <boost/compute/algorithm/detail/multi_queue.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// finds where the merge path of each pair of adjacent sorted runs in src
+// crosses the given diagonals. for each diagonal d the parameters are the
+// start of the first run, the sizes of both runs and d. the result is the
+// number of values taken from the first run for the first d merged values.
+template<class Iterator, class Compare>
+inline std::vector<ulong_>
+merge_path_partition(Iterator src,
+                     const std::vector<ulong_> &parameters,
+                     Compare compare,
+                     command_queue &queue)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    const size_t count = parameters.size() / 4;
+    std::vector<ulong_> result(count);
+    if(count == 0){
+        return result;
+    }
+
+    const context &context = queue.get_context();
+    ::boost::compute::vector<ulong_> device_parameters(
+        parameters.begin(), parameters.end(), queue
+    );
+    ::boost::compute::vector<ulong_> device_result(count, context);
+
+    meta_kernel k("merge_path_partition");
+    k.set_index_type_for(parameters.size());
+    const std::string index_type = k.index_type();
+
+    k <<
+        "const " << index_type << " g = get_global_id(0);\n" <<
+        "const ulong a = " << device_parameters.begin()[k.expr<uint_>("4*g")] << ";\n" <<
+        "const ulong a_size = " << device_parameters.begin()[k.expr<uint_>("4*g+1")] << ";\n" <<
+        "const ulong b_size = " << device_parameters.begin()[k.expr<uint_>("4*g+2")] << ";\n" <<
+        "const ulong d = " << device_parameters.begin()[k.expr<uint_>("4*g+3")] << ";\n" <<
+        "ulong lo = d > b_size ? d - b_size : 0;\n" <<
+        "ulong hi = min(d, a_size);\n" <<
+        "while(lo < hi){\n" <<
+        "    const ulong mid = (lo + hi) / 2;\n" <<
+        "    " << k.decl<const value_type>("a_value") << " = " <<
+                    src[k.expr<ulong_>("a + mid")] << ";\n" <<
+        "    " << k.decl<const value_type>("b_value") << " = " <<
+                    src[k.expr<ulong_>("a + a_size + d - 1 - mid")] << ";\n" <<
+        "    if(" << compare(k.var<const value_type>("b_value"),
+                             k.var<const value_type>("a_value")) << "){\n" <<
+        "        hi = mid;\n" <<
+        "    }\n" <<
+        "    else {\n" <<
+        "        lo = mid + 1;\n" <<
+        "    }\n" <<
+        "}\n" <<
+        device_result.begin()[k.var<const uint_>("g")] << " = lo;\n";
+
+    k.exec_1d(queue, 0, count);
+
+    ::boost::compute::copy(
+        device_result.begin(), device_result.end(), result.begin(), queue
+    );
+
+    return result;
+}
+
+// merges each pair of adjacent sorted runs in src into dst, the runs are
+// [runs[i], runs[i + 1]). each merge is split along its merge path into one
+// part for each queue so that every queue has an equal share of the work.
+// returns the boundaries of the merged runs.
+template<class InputIterator, class OutputIterator, class Compare>
+inline std::vector<size_t>
+merge_runs(InputIterator src,
+           OutputIterator dst,
+           const std::vector<size_t> &runs,
+           Compare compare,
+           std::vector<command_queue> &queues)
+{
+    const size_t run_count = runs.size() - 1;
+    const size_t pair_count = run_count / 2;
+    const size_t parts = queues.size();
+
+    // the diagonals at the start of each part, excluding the first one
+    std::vector<ulong_> parameters;
+    parameters.reserve(4 * pair_count * (parts - 1));
+    for(size_t p = 0; p < pair_count; p++){
+        const size_t a = runs[2 * p];
+        const size_t a_size = runs[2 * p + 1] - a;
+        const size_t b_size = runs[2 * p + 2] - runs[2 * p + 1];
+        const std::vector<size_t> diagonals =
+            multi_queue_partition(a_size + b_size, parts);
+
+        for(size_t j = 1; j < parts; j++){
+            const size_t d =
+                j < diagonals.size() ? diagonals[j] : a_size + b_size;
+            parameters.push_back(static_cast<ulong_>(a));
+            parameters.push_back(static_cast<ulong_>(a_size));
+            parameters.push_back(static_cast<ulong_>(b_size));
+            parameters.push_back(static_cast<ulong_>(d));
+        }
+    }
+    const std::vector<ulong_> splits =
+        merge_path_partition(src, parameters, compare, queues[0]);
+
+    std::vector<size_t> merged;
+    for(size_t p = 0; p < pair_count; p++){
+        const size_t a = runs[2 * p];
+        const size_t b = runs[2 * p + 1];
+        const size_t end = runs[2 * p + 2];
+        merged.push_back(a);
+
+        size_t d0 = 0;
+        size_t i0 = 0;
+        for(size_t j = 0; j < parts; j++){
+            size_t d1 = end - a;
+            size_t i1 = b - a;
+            if(j + 1 < parts){
+                const size_t index = 4 * (p * (parts - 1) + j);
+                d1 = static_cast<size_t>(parameters[index + 3]);
+                i1 = static_cast<size_t>(splits[index / 4]);
+            }
+
+            // merge the values taken from each run for this part
+            const size_t j0 = d0 - i0;
+            const size_t j1 = d1 - i1;
+            if(i0 == i1){
+                ::boost::compute::copy(src + b + j0, src + b + j1,
+                                       dst + a + d0, queues[j]);
+            }
+            else if(j0 == j1){
+                ::boost::compute::copy(src + a + i0, src + a + i1,
+                                       dst + a + d0, queues[j]);
+            }
+            else {
+                ::boost::compute::merge(src + a + i0, src + a + i1,
+                                        src + b + j0, src + b + j1,
+                                        dst + a + d0, compare, queues[j]);
+            }
+
+            d0 = d1;
+            i0 = i1;
+        }
+    }
+
+    // an odd run out is copied as it is
+    if(run_count % 2 == 1){
+        merged.push_back(runs[run_count - 1]);
+        ::boost::compute::copy(src + runs[run_count - 1],
+                               src + runs[run_count],
+                               dst + runs[run_count - 1],
+                               queues[parts - 1]);
+    }
+
+    merged.push_back(runs.back());
+    multi_queue_finish(queues);
+
+    return merged;
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_MERGE_HPP
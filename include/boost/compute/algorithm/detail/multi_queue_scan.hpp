@@ -0,0 +1,157 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_SCAN_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_SCAN_HPP
+
+#include <iterator>
+#include <vector>
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
+#include <boost/compute/algorithm/detail/multi_queue.hpp>
+#include <boost/compute/algorithm/detail/scan.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// emits the body of scan_add_carry() with an index variable of IndexType
+template<class IndexType, class Iterator, class BinaryOperator>
+inline void scan_add_carry_body(meta_kernel &k,
+                                Iterator first,
+                                BinaryOperator op)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    k << "const " << type_name<IndexType>() << " i = get_global_id(0);\n" <<
+        k.decl<const value_type>("value") << " = " <<
+            first[k.var<const IndexType>("i")] << ";\n" <<
+        first[k.var<const IndexType>("i")] << " = " <<
+            op(k.var<const value_type>("carry"),
+               k.var<const value_type>("value")) << ";\n";
+}
+
+// combines carry with each of the count values starting at first
+template<class Iterator, class T, class BinaryOperator>
+inline void scan_add_carry(Iterator first,
+                           size_t count,
+                           const T &carry,
+                           BinaryOperator op,
+                           command_queue &queue)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    meta_kernel k("scan_add_carry");
+    k.set_index_type_for(count);
+    k.add_set_arg<const value_type>("carry", static_cast<value_type>(carry));
+
+    if(k.uses_64bit_indices()){
+        scan_add_carry_body<ulong_>(k, first, op);
+    }
+    else {
+        scan_add_carry_body<uint_>(k, first, op);
+    }
+
+    k.exec_1d(queue, 0, count);
+}
+
+// scan() with the range split into one chunk for each of the queues. each
+// chunk is first reduced with its own queue, the chunk totals are scanned
+// to find the value carried into each chunk and then each chunk is scanned
+// starting from its carry.
+template<class InputIterator, class OutputIterator, class T, class BinaryOperator>
+inline OutputIterator multi_queue_scan(InputIterator first,
+                                       InputIterator last,
+                                       OutputIterator result,
+                                       bool exclusive,
+                                       T init,
+                                       BinaryOperator op,
+                                       std::vector<command_queue> &queues)
+{
+    typedef typename
+        std::iterator_traits<OutputIterator>::value_type output_type;
+
+    check_multi_queue(queues);
+    multi_queue_barrier(queues);
+    command_queue &queue = queues[0];
+
+    const size_t count = iterator_range_size(first, last);
+    const std::vector<size_t> bounds =
+        multi_queue_partition(count, queues.size());
+    const size_t parts = bounds.size() - 1;
+    if(parts == 1){
+        return scan(first, last, result, exclusive, init, op, queue);
+    }
+
+    ::boost::compute::vector<output_type> totals(parts, queue.get_context());
+    for(size_t i = 0; i < parts; i++){
+        dispatch_reduce(first + bounds[i],
+                        first + bounds[i + 1],
+                        totals.begin() + i,
+                        op,
+                        queues[i]);
+    }
+
+    // for exclusive scans carries[i] is the value carried into chunk i,
+    // for inclusive scans it is the value carried into chunk i + 1
+    enqueue_wait_list(queue, multi_queue_markers(queues));
+    scan(totals.begin(), totals.end(), totals.begin(), exclusive, init, op, queue);
+
+    std::vector<output_type> carries(parts);
+    queue.enqueue_read_buffer(
+        totals.get_buffer(), 0, parts * sizeof(output_type), &carries[0]
+    );
+
+    for(size_t i = 0; i < parts; i++){
+        const size_t chunk_size = bounds[i + 1] - bounds[i];
+
+        if(exclusive){
+            scan(first + bounds[i],
+                 first + bounds[i + 1],
+                 result + bounds[i],
+                 true,
+                 carries[i],
+                 op,
+                 queues[i]);
+        }
+        else {
+            scan(first + bounds[i],
+                 first + bounds[i + 1],
+                 result + bounds[i],
+                 false,
+                 init,
+                 op,
+                 queues[i]);
+
+            if(i > 0){
+                scan_add_carry(
+                    result + bounds[i], chunk_size, carries[i - 1], op, queues[i]
+                );
+            }
+        }
+    }
+
+    // commands enqueued to the first queue from now on run after every chunk
+    enqueue_wait_list(queue, multi_queue_markers(queues));
+
+    return result + count;
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_MULTI_QUEUE_SCAN_HPP
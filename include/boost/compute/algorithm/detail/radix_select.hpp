@@ -0,0 +1,548 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SELECT_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SELECT_HPP
+
+#include <algorithm>
+#include <climits>
+#include <limits>
+#include <sstream>
+
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+
+#include <boost/compute/kernel.hpp>
+#include <boost/compute/program.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/exception/unsupported_extension_error.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+#include <boost/compute/utility/program_cache.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// radix select kernels. starting with the most significant digit, each pass
+// builds a histogram of the digit over the keys which match the digits found
+// so far and a single work-group picks the bucket which holds the element of
+// the requested rank. no data is moved and the host does not wait for any
+// of the passes. every work-group of the count kernel writes its own
+// histogram, so the counts are summed without global atomics and have the
+// index type INDEX_T (uint or ulong).
+//
+// state layout:
+//   key_state[0]: digits of the selected key found so far
+//   key_state[1]: mask of the digits found so far
+//   key_state[2]: the selected value (after the last pass)
+//   rank_state[0]: rank of the selected key among the matching keys
+//   rank_state[1]: number of keys before the matching keys
+//   rank_state[2]: number of matching keys
+const char radix_select_source[] =
+"#if COUNTER_64BIT\n"
+"#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable\n"
+"#define COUNTER_T ulong\n"
+"#define COUNTER_INC(p) atom_inc(p)\n"
+"#else\n"
+"#define COUNTER_T uint\n"
+"#define COUNTER_INC(p) atomic_inc(p)\n"
+"#endif\n"
+
+// inverse of radix_key()
+"inline T radix_value(T key)\n"
+"{\n"
+"#if !defined(ASC)\n"
+"    key = (T)(~key);\n"
+"#endif\n"
+"#if defined(IS_FLOATING_POINT)\n"
+"    return (key >> SIGN_BIT) ? key ^ (((T)(1)) << SIGN_BIT) : (T)(~key);\n"
+"#elif defined(IS_SIGNED)\n"
+"    return key ^ (((T)(1)) << SIGN_BIT);\n"
+"#else\n"
+"    return key;\n"
+"#endif\n"
+"}\n"
+
+"__kernel void select_count(__global const T *input,\n"
+"                           const INDEX_T input_offset,\n"
+"                           const INDEX_T input_size,\n"
+"                           __global const T *key_state,\n"
+"                           __global INDEX_T *histograms,\n"
+"                           const uint low_bit)\n"
+"{\n"
+"    __local uint local_histogram[K2_BITS];\n"
+"    const uint lid = get_local_id(0);\n"
+"    for(uint i = lid; i < K2_BITS; i += get_local_size(0)){\n"
+"        local_histogram[i] = 0;\n"
+"    }\n"
+"    barrier(CLK_LOCAL_MEM_FENCE);\n"
+
+"    const T prefix = key_state[0];\n"
+"    const T mask = key_state[1];\n"
+"    for(INDEX_T i = get_global_id(0); i < input_size; i += get_global_size(0)){\n"
+"        const T key = radix_key(input[input_offset+i]);\n"
+"        if((key & mask) == prefix){\n"
+"            atomic_inc(local_histogram + ((key >> low_bit) & RADIX_MASK));\n"
+"        }\n"
+"    }\n"
+"    barrier(CLK_LOCAL_MEM_FENCE);\n"
+
+"    for(uint i = lid; i < K2_BITS; i += get_local_size(0)){\n"
+"        histograms[get_group_id(0) * K2_BITS + i] = local_histogram[i];\n"
+"    }\n"
+"}\n"
+
+"__kernel void select_digit(__global T *key_state,\n"
+"                           __global INDEX_T *rank_state,\n"
+"                           __global const INDEX_T *histograms,\n"
+"                           const uint group_count,\n"
+"                           const uint low_bit)\n"
+"{\n"
+"    __local INDEX_T histogram[K2_BITS];\n"
+"    const uint lid = get_local_id(0);\n"
+"    for(uint i = lid; i < K2_BITS; i += get_local_size(0)){\n"
+"        INDEX_T sum = 0;\n"
+"        for(uint g = 0; g < group_count; g++){\n"
+"            sum += histograms[g * K2_BITS + i];\n"
+"        }\n"
+"        histogram[i] = sum;\n"
+"    }\n"
+"    barrier(CLK_LOCAL_MEM_FENCE);\n"
+"    if(lid != 0){\n"
+"        return;\n"
+"    }\n"
+
+"    INDEX_T rank = rank_state[0];\n"
+"    INDEX_T before = rank_state[1];\n"
+"    uint bucket = 0;\n"
+"    for(; bucket < K2_BITS - 1; bucket++){\n"
+"        const INDEX_T bucket_size = histogram[bucket];\n"
+"        if(rank < bucket_size){\n"
+"            break;\n"
+"        }\n"
+"        rank -= bucket_size;\n"
+"        before += bucket_size;\n"
+"    }\n"
+"    rank_state[0] = rank;\n"
+"    rank_state[1] = before;\n"
+"    rank_state[2] = histogram[bucket];\n"
+"    key_state[0] |= ((T)(bucket)) << low_bit;\n"
+"    key_state[1] |= RADIX_MASK << low_bit;\n"
+"    key_state[2] = radix_value(key_state[0]);\n"
+"}\n"
+
+// moves the keys which are not in their region (before, equal to or after
+// the selected key) to the lists of misplaced values and positions
+"__kernel void select_misplaced(__global const T *input,\n"
+"                               const INDEX_T input_offset,\n"
+"                               const INDEX_T input_size,\n"
+"                               __global const T *key_state,\n"
+"                               __global const INDEX_T *rank_state,\n"
+"                               __global COUNTER_T *counters,\n"
+"                               __global T *less_values,\n"
+"                               __global INDEX_T *less_holes,\n"
+"                               __global T *greater_values,\n"
+"                               __global INDEX_T *greater_holes,\n"
+"                               __global INDEX_T *equal_holes)\n"
+"{\n"
+"    const INDEX_T i = get_global_id(0);\n"
+"    if(i >= input_size){\n"
+"        return;\n"
+"    }\n"
+"    const T value = input[input_offset+i];\n"
+"    const T key = radix_key(value);\n"
+"    const T selected = key_state[0];\n"
+"    const INDEX_T less_count = rank_state[1];\n"
+"    const INDEX_T equal_count = rank_state[2];\n"
+"    const uint key_class = key < selected ? 0 : (key == selected ? 1 : 2);\n"
+"    const uint region =\n"
+"        i < less_count ? 0 : (i < less_count + equal_count ? 1 : 2);\n"
+"    if(key_class == region){\n"
+"        return;\n"
+"    }\n"
+
+     // misplaced equal keys are not stored, their holes are filled with
+     // the selected value
+"    if(key_class == 0){\n"
+"        less_values[COUNTER_INC(counters)] = value;\n"
+"    }\n"
+"    else if(key_class == 2){\n"
+"        greater_values[COUNTER_INC(counters + 1)] = value;\n"
+"    }\n"
+
+"    if(region == 0){\n"
+"        less_holes[COUNTER_INC(counters + 2)] = i;\n"
+"    }\n"
+"    else if(region == 1){\n"
+"        equal_holes[COUNTER_INC(counters + 3)] = i;\n"
+"    }\n"
+"    else {\n"
+"        greater_holes[COUNTER_INC(counters + 4)] = i;\n"
+"    }\n"
+"}\n"
+
+"__kernel void select_scatter(__global T *output,\n"
+"                             const INDEX_T output_offset,\n"
+"                             __global const T *key_state,\n"
+"                             __global const COUNTER_T *counters,\n"
+"                             __global const T *less_values,\n"
+"                             __global const INDEX_T *less_holes,\n"
+"                             __global const T *greater_values,\n"
+"                             __global const INDEX_T *greater_holes,\n"
+"                             __global const INDEX_T *equal_holes)\n"
+"{\n"
+"    const INDEX_T i = get_global_id(0);\n"
+"    if(i < counters[0]){\n"
+"        output[output_offset + less_holes[i]] = less_values[i];\n"
+"    }\n"
+"    if(i < counters[1]){\n"
+"        output[output_offset + greater_holes[i]] = greater_values[i];\n"
+"    }\n"
+"    if(i < counters[3]){\n"
+"        output[output_offset + equal_holes[i]] = key_state[2];\n"
+"    }\n"
+"}\n";
+
+// returns the radix select program with sizes and offsets of type IndexType.
+// the counters of misplaced elements are 64-bit if counter_64bit is true,
+// which needs 64-bit atomics.
+template<class IndexType, class T>
+inline program radix_select_program(const bool ascending,
+                                    const bool counter_64bit,
+                                    command_queue &queue)
+{
+    typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
+
+    std::string cache_key =
+        std::string("__boost_radix_select_") + type_name<T>();
+
+    std::stringstream options;
+    options << "-DK_BITS=8";
+    options << " -DT=" << type_name<sort_type>();
+    options << " -DINDEX_T=" << type_name<IndexType>();
+    options << " -DCOUNTER_64BIT=" << (counter_64bit ? 1 : 0);
+    if(boost::is_floating_point<T>::value){
+        options << " -DIS_FLOATING_POINT";
+    }
+    if(boost::is_signed<T>::value){
+        options << " -DIS_SIGNED";
+    }
+    if(ascending){
+        options << " -DASC";
+    }
+
+    boost::shared_ptr<program_cache> cache =
+        program_cache::get_global_cache(queue.get_context());
+    return cache->get_or_build(
+        cache_key,
+        options.str(),
+        std::string(radix_key_source) + radix_select_source,
+        queue.get_context()
+    );
+}
+
+// finds the key of rank rank in [first, last) (in ascending or descending
+// order) on the device. key_state and rank_state receive the state described
+// above. nothing is read back to the host.
+template<class IndexType, class T>
+inline void radix_select_key(const buffer_iterator<T> first,
+                             const buffer_iterator<T> last,
+                             const size_t rank,
+                             const bool ascending,
+                             const buffer_iterator<
+                                 typename radix_sort_value_type<sizeof(T)>::type
+                             > key_state,
+                             const buffer_iterator<IndexType> rank_state,
+                             command_queue &queue)
+{
+    typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
+    typedef IndexType index_type;
+
+    const size_t count = detail::iterator_range_size(first, last);
+    BOOST_ASSERT(rank < count);
+
+    const device &device = queue.get_device();
+    program select_program =
+        radix_select_program<index_type, T>(ascending, false, queue);
+    kernel count_kernel(select_program, "select_count");
+    kernel digit_kernel(select_program, "select_digit");
+
+    boost::shared_ptr<parameter_cache> parameters =
+        detail::parameter_cache::get_global_cache(device);
+    const std::string cache_key =
+        std::string("__boost_radix_select_") + type_name<T>();
+    const size_t tpb = (std::min)(
+        static_cast<size_t>(parameters->get(cache_key, "tpb", 256)),
+        count_kernel.get_work_group_info<size_t>(device, CL_KERNEL_WORK_GROUP_SIZE)
+    );
+
+    // the work-groups count in 32-bit local memory, so none of them may
+    // handle more keys than fit into 32-bit indices
+    const size_t max_group_size =
+        static_cast<size_t>((std::numeric_limits<uint_>::max)() / 2);
+    const size_t groups = (std::max)(
+        (std::min)(
+            (count + tpb - 1) / tpb,
+            static_cast<size_t>(device.compute_units()) *
+                parameters->get(cache_key, "groups_per_cu", 4)
+        ),
+        (count + max_group_size - 1) / max_group_size
+    );
+    const size_t digit_tpb = (std::min)(
+        size_t(256),
+        digit_kernel.get_work_group_info<size_t>(device, CL_KERNEL_WORK_GROUP_SIZE)
+    );
+
+    scratch_vector<index_type> histograms(groups * 256, queue);
+    ::boost::compute::fill(key_state, key_state + 3, sort_type(0), queue);
+    ::boost::compute::fill(rank_state, rank_state + 3, index_type(0), queue);
+    ::boost::compute::fill(rank_state, rank_state + 1, static_cast<index_type>(rank), queue);
+
+    count_kernel.set_arg(0, first.get_buffer());
+    count_kernel.set_arg(1, static_cast<index_type>(first.get_index()));
+    count_kernel.set_arg(2, static_cast<index_type>(count));
+    count_kernel.set_arg(3, key_state.get_buffer());
+    count_kernel.set_arg(4, histograms.get_buffer());
+
+    digit_kernel.set_arg(0, key_state.get_buffer());
+    digit_kernel.set_arg(1, rank_state.get_buffer());
+    digit_kernel.set_arg(2, histograms.get_buffer());
+    digit_kernel.set_arg(3, static_cast<uint_>(groups));
+
+    BOOST_ASSERT(key_state.get_index() == 0 && rank_state.get_index() == 0);
+
+    for(uint_ low_bit = sizeof(T) * CHAR_BIT; low_bit > 0; ){
+        low_bit -= 8;
+
+        count_kernel.set_arg(5, low_bit);
+        queue.enqueue_1d_range_kernel(count_kernel, 0, groups * tpb, tpb);
+
+        digit_kernel.set_arg(4, low_bit);
+        queue.enqueue_1d_range_kernel(digit_kernel, 0, digit_tpb, digit_tpb);
+    }
+}
+
+template<class IndexType, class T>
+inline T radix_select_value_with_index_type(const buffer_iterator<T> first,
+                                            const buffer_iterator<T> last,
+                                            const size_t rank,
+                                            const bool ascending,
+                                            command_queue &queue)
+{
+    typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
+
+    scratch_vector<sort_type> key_state(3, queue);
+    scratch_vector<IndexType> rank_state(3, queue);
+    radix_select_key(first, last, rank, ascending,
+                     key_state.begin(), rank_state.begin(), queue);
+
+    T value;
+    queue.enqueue_read_buffer(key_state.get_buffer(),
+                              2 * sizeof(sort_type),
+                              sizeof(T),
+                              &value);
+    return value;
+}
+
+// returns the element of rank rank in [first, last)
+template<class T>
+inline T radix_select_value(const buffer_iterator<T> first,
+                            const buffer_iterator<T> last,
+                            const size_t rank,
+                            const bool ascending,
+                            command_queue &queue)
+{
+    if(requires_64bit_indices(last.get_index())){
+        return radix_select_value_with_index_type<ulong_>(
+            first, last, rank, ascending, queue
+        );
+    }
+    else {
+        return radix_select_value_with_index_type<uint_>(
+            first, last, rank, ascending, queue
+        );
+    }
+}
+
+// moves the elements which are on the wrong side of the key found by
+// radix_select_key() (or in the range of the elements equal to it). the
+// capacities bound the number of misplaced elements of each class.
+template<class IndexType, class T>
+inline void radix_select_scatter(const buffer_iterator<T> first,
+                                 const buffer_iterator<T> last,
+                                 const bool ascending,
+                                 const buffer_iterator<
+                                     typename radix_sort_value_type<sizeof(T)>::type
+                                 > key_state,
+                                 const buffer_iterator<IndexType> rank_state,
+                                 const size_t less_capacity,
+                                 const size_t greater_capacity,
+                                 const size_t equal_capacity,
+                                 command_queue &queue)
+{
+    typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
+    typedef IndexType index_type;
+
+    const size_t count = detail::iterator_range_size(first, last);
+    const size_t capacity =
+        (std::max)(less_capacity, (std::max)(greater_capacity, equal_capacity));
+    if(capacity == 0){
+        return;
+    }
+
+    // the counters of misplaced elements only need 64-bit atomics if there
+    // can be more of them than fit into 32-bit indices
+    const bool counter_64bit = requires_64bit_indices(capacity);
+    if(counter_64bit &&
+       !queue.get_device().supports_extension("cl_khr_int64_base_atomics")){
+        BOOST_THROW_EXCEPTION(
+            unsupported_extension_error("cl_khr_int64_base_atomics")
+        );
+    }
+
+    // large enough for both uint and ulong counters
+    scratch_vector<ulong_> counters(5, queue);
+    scratch_vector<sort_type> less_values((std::max)(less_capacity, size_t(1)), queue);
+    scratch_vector<index_type> less_holes((std::max)(less_capacity, size_t(1)), queue);
+    scratch_vector<sort_type> greater_values((std::max)(greater_capacity, size_t(1)), queue);
+    scratch_vector<index_type> greater_holes((std::max)(greater_capacity, size_t(1)), queue);
+    scratch_vector<index_type> equal_holes((std::max)(equal_capacity, size_t(1)), queue);
+    ::boost::compute::fill(counters.begin(), counters.end(), ulong_(0), queue);
+
+    program select_program =
+        radix_select_program<index_type, T>(ascending, counter_64bit, queue);
+
+    kernel misplaced_kernel(select_program, "select_misplaced");
+    misplaced_kernel.set_arg(0, first.get_buffer());
+    misplaced_kernel.set_arg(1, static_cast<index_type>(first.get_index()));
+    misplaced_kernel.set_arg(2, static_cast<index_type>(count));
+    misplaced_kernel.set_arg(3, key_state.get_buffer());
+    misplaced_kernel.set_arg(4, rank_state.get_buffer());
+    misplaced_kernel.set_arg(5, counters.get_buffer());
+    misplaced_kernel.set_arg(6, less_values.get_buffer());
+    misplaced_kernel.set_arg(7, less_holes.get_buffer());
+    misplaced_kernel.set_arg(8, greater_values.get_buffer());
+    misplaced_kernel.set_arg(9, greater_holes.get_buffer());
+    misplaced_kernel.set_arg(10, equal_holes.get_buffer());
+    queue.enqueue_1d_range_kernel(misplaced_kernel, 0, count, 0);
+
+    kernel scatter_kernel(select_program, "select_scatter");
+    scatter_kernel.set_arg(0, first.get_buffer());
+    scatter_kernel.set_arg(1, static_cast<index_type>(first.get_index()));
+    scatter_kernel.set_arg(2, key_state.get_buffer());
+    scatter_kernel.set_arg(3, counters.get_buffer());
+    scatter_kernel.set_arg(4, less_values.get_buffer());
+    scatter_kernel.set_arg(5, less_holes.get_buffer());
+    scatter_kernel.set_arg(6, greater_values.get_buffer());
+    scatter_kernel.set_arg(7, greater_holes.get_buffer());
+    scatter_kernel.set_arg(8, equal_holes.get_buffer());
+    queue.enqueue_1d_range_kernel(scatter_kernel, 0, capacity, 0);
+}
+
+// if blocking is true, the sizes of the classes of keys are read back once
+// so that the lists of misplaced elements are only as large as needed.
+// otherwise they are sized for the worst case (half of the range each) and
+// nothing is read back to the host.
+template<class IndexType, class T>
+inline void radix_nth_element_with_index_type(const buffer_iterator<T> first,
+                                              const buffer_iterator<T> nth,
+                                              const buffer_iterator<T> last,
+                                              const bool ascending,
+                                              const bool blocking,
+                                              command_queue &queue)
+{
+    typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
+    typedef IndexType index_type;
+
+    const size_t count = detail::iterator_range_size(first, last);
+    const size_t rank = detail::iterator_range_size(first, nth);
+
+    scratch_vector<sort_type> key_state(3, queue);
+    scratch_vector<index_type> rank_state(3, queue);
+    radix_select_key(first, last, rank, ascending,
+                     key_state.begin(), rank_state.begin(), queue);
+
+    if(!blocking){
+        // no class has more misplaced elements than elements outside of it
+        const size_t capacity = count / 2;
+        radix_select_scatter(first, last, ascending,
+                             key_state.begin(), rank_state.begin(),
+                             capacity, capacity, capacity, queue);
+        return;
+    }
+
+    // the only point where the host waits for the device
+    index_type ranks[3];
+    queue.enqueue_read_buffer(rank_state.get_buffer(), 0, sizeof(ranks), ranks);
+    const size_t less_count = static_cast<size_t>(ranks[1]);
+    const size_t equal_count = static_cast<size_t>(ranks[2]);
+    const size_t greater_count = count - less_count - equal_count;
+
+    // capacities of the lists of misplaced elements
+    radix_select_scatter(first, last, ascending,
+                         key_state.begin(), rank_state.begin(),
+                         (std::min)(less_count, count - less_count),
+                         (std::min)(greater_count, count - greater_count),
+                         (std::min)(equal_count, count - equal_count),
+                         queue);
+}
+
+// nth_element() with radix select. the selected value is found without
+// moving any data, then only the elements which are on the wrong side of
+// it (or in the range of the elements equal to it) are moved.
+template<class T>
+inline void radix_nth_element(const buffer_iterator<T> first,
+                              const buffer_iterator<T> nth,
+                              const buffer_iterator<T> last,
+                              const bool ascending,
+                              const bool blocking,
+                              command_queue &queue)
+{
+    const size_t count = detail::iterator_range_size(first, last);
+    const size_t rank = detail::iterator_range_size(first, nth);
+    if(rank >= count){
+        return;
+    }
+
+    if(requires_64bit_indices(last.get_index())){
+        radix_nth_element_with_index_type<ulong_>(
+            first, nth, last, ascending, blocking, queue
+        );
+    }
+    else {
+        radix_nth_element_with_index_type<uint_>(
+            first, nth, last, ascending, blocking, queue
+        );
+    }
+}
+
+template<class T>
+inline void radix_nth_element(const buffer_iterator<T> first,
+                              const buffer_iterator<T> nth,
+                              const buffer_iterator<T> last,
+                              const bool ascending,
+                              command_queue &queue)
+{
+    radix_nth_element(first, nth, last, ascending, true, queue);
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SELECT_HPP
@@ -11,7 +11,9 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SORT_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SORT_HPP
 
+#include <vector>
 #include <iterator>
+#include <algorithm>
 
 #include <boost/assert.hpp>
 #include <boost/type_traits/is_signed.hpp>
@@ -26,10 +28,13 @@
 #include <boost/compute/algorithm/exclusive_scan.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 #include <boost/compute/type_traits/type_name.hpp>
 #include <boost/compute/type_traits/is_fundamental.hpp>
 #include <boost/compute/type_traits/is_vector_type.hpp>
+#include <boost/compute/type_traits/make_vector_type.hpp>
 #include <boost/compute/utility/program_cache.hpp>
 
 namespace boost {
@@ -87,7 +92,10 @@ inline const char* enable_double<double>()
     return " -DT2_double=1";
 }
 
-const char radix_sort_source[] =
+// defines radix_key() and radix() which map keys to their sort order and the
+// kernel which finds the digits that are the same in every key. the source
+// is shared with the radix sort for cpu devices.
+const char radix_key_source[] =
 "#if T2_double\n"
 "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
 "#endif\n"
@@ -95,49 +103,89 @@ const char radix_sort_source[] =
 "#define RADIX_MASK ((((T)(1)) << K_BITS) - 1)\n"
 "#define SIGN_BIT ((sizeof(T) * CHAR_BIT) - 1)\n"
 
-"#if defined(ASC)\n" // asc order
-
-"inline uint radix(const T x, const uint low_bit)\n"
+// maps x to an unsigned key with the same bit width whose ascending order is
+// the requested sort order. keys are flipped bitwise (rather than negated)
+// for descending order so that bits which are equal for every value stay
+// equal, which allows uniform digits to be skipped.
+"inline T radix_key(const T x)\n"
 "{\n"
 "#if defined(IS_FLOATING_POINT)\n"
 "    const T mask = -(x >> SIGN_BIT) | (((T)(1)) << SIGN_BIT);\n"
-"    return ((x ^ mask) >> low_bit) & RADIX_MASK;\n"
+"    T key = x ^ mask;\n"
 "#elif defined(IS_SIGNED)\n"
-"    return ((x ^ (((T)(1)) << SIGN_BIT)) >> low_bit) & RADIX_MASK;\n"
+"    T key = x ^ (((T)(1)) << SIGN_BIT);\n"
 "#else\n"
-"    return (x >> low_bit) & RADIX_MASK;\n"
+"    T key = x;\n"
+"#endif\n"
+"#if !defined(ASC)\n"
+"    key = (T)(~key);\n"
 "#endif\n"
+"    return key;\n"
 "}\n"
 
-"#else\n" // desc order
-
-// For signed types we just negate the x and for unsigned types we
-// subtract the x from max value of its type ((T)(-1) is a max value
-// of type T when T is an unsigned type).
 "inline uint radix(const T x, const uint low_bit)\n"
 "{\n"
-"#if defined(IS_FLOATING_POINT)\n"
-"    const T mask = -(x >> SIGN_BIT) | (((T)(1)) << SIGN_BIT);\n"
-"    return (((-x) ^ mask) >> low_bit) & RADIX_MASK;\n"
-"#elif defined(IS_SIGNED)\n"
-"    return (((-x) ^ (((T)(1)) << SIGN_BIT)) >> low_bit) & RADIX_MASK;\n"
-"#else\n"
-"    return (((T)(-1) - x) >> low_bit) & RADIX_MASK;\n"
-"#endif\n"
+"    return (radix_key(x) >> low_bit) & RADIX_MASK;\n"
 "}\n"
 
-"#endif\n" // #if defined(ASC)
+// combines the OR and AND of the keys computed by each of the group_count
+// work-groups (or work-items) and stores the bits which differ between the
+// keys in group_bits[0]
+"__kernel void varying_key_bits(__global T *group_bits,\n"
+"                               const uint group_count)\n"
+"{\n"
+"    T or_bits = 0;\n"
+"    T and_bits = (T)(~((T)(0)));\n"
+"    for(uint i = 0; i < group_count; i++){\n"
+"        or_bits |= group_bits[2*i];\n"
+"        and_bits &= group_bits[2*i+1];\n"
+"    }\n"
+"    group_bits[0] = or_bits ^ and_bits;\n"
+"}\n";
+
+const char radix_sort_source[] =
+
+// computes the bitwise OR and AND of the keys handled by each work-group
+"__kernel void key_bits(__global const T *input,\n"
+"                       const INDEX_T input_offset,\n"
+"                       const INDEX_T input_size,\n"
+"                       __global T *output)\n"
+"{\n"
+"    const uint lid = get_local_id(0);\n"
+"    __local T local_or[BLOCK_SIZE];\n"
+"    __local T local_and[BLOCK_SIZE];\n"
+
+"    T or_bits = 0;\n"
+"    T and_bits = (T)(~((T)(0)));\n"
+"    for(INDEX_T i = get_global_id(0); i < input_size; i += get_global_size(0)){\n"
+"        const T key = radix_key(input[input_offset+i]);\n"
+"        or_bits |= key;\n"
+"        and_bits &= key;\n"
+"    }\n"
+"    local_or[lid] = or_bits;\n"
+"    local_and[lid] = and_bits;\n"
+"    barrier(CLK_LOCAL_MEM_FENCE);\n"
+
+"    if(lid == 0){\n"
+"        for(uint i = 1; i < BLOCK_SIZE; i++){\n"
+"            or_bits |= local_or[i];\n"
+"            and_bits &= local_and[i];\n"
+"        }\n"
+"        output[2*get_group_id(0)] = or_bits;\n"
+"        output[2*get_group_id(0)+1] = and_bits;\n"
+"    }\n"
+"}\n"
 
 "__kernel void count(__global const T *input,\n"
-"                    const uint input_offset,\n"
-"                    const uint input_size,\n"
-"                    __global uint *global_counts,\n"
-"                    __global uint *global_offsets,\n"
+"                    const INDEX_T input_offset,\n"
+"                    const INDEX_T input_size,\n"
+"                    __global INDEX_T *global_counts,\n"
+"                    __global INDEX_T *global_offsets,\n"
 "                    __local uint *local_counts,\n"
 "                    const uint low_bit)\n"
 "{\n"
      // work-item parameters
-"    const uint gid = get_global_id(0);\n"
+"    const INDEX_T gid = get_global_id(0);\n"
 "    const uint lid = get_local_id(0);\n"
 
      // zero local counts
@@ -165,17 +213,17 @@ const char radix_sort_source[] =
 "    }\n"
 "}\n"
 
-"__kernel void scan(__global const uint *block_offsets,\n"
-"                   __global uint *global_offsets,\n"
+"__kernel void scan(__global const INDEX_T *block_offsets,\n"
+"                   __global INDEX_T *global_offsets,\n"
 "                   const uint block_count)\n"
 "{\n"
-"    __global const uint *last_block_offsets =\n"
+"    __global const INDEX_T *last_block_offsets =\n"
 "        block_offsets + K2_BITS * (block_count - 1);\n"
 
      // calculate and scan global_offsets
-"    uint sum = 0;\n"
+"    INDEX_T sum = 0;\n"
 "    for(uint i = 0; i < K2_BITS; i++){\n"
-"        uint x = global_offsets[i] + last_block_offsets[i];\n"
+"        INDEX_T x = global_offsets[i] + last_block_offsets[i];\n"
 "        mem_fence(CLK_GLOBAL_MEM_FENCE);\n" // work around the RX 500/Vega bug, see #811
 "        global_offsets[i] = sum;\n"
 "        sum += x;\n"
@@ -184,25 +232,26 @@ const char radix_sort_source[] =
 "}\n"
 
 "__kernel void scatter(__global const T *input,\n"
-"                      const uint input_offset,\n"
-"                      const uint input_size,\n"
+"                      const INDEX_T input_offset,\n"
+"                      const INDEX_T input_size,\n"
 "                      const uint low_bit,\n"
-"                      __global const uint *counts,\n"
-"                      __global const uint *global_offsets,\n"
+"                      __global const INDEX_T *counts,\n"
+"                      __global const INDEX_T *global_offsets,\n"
 "#ifndef SORT_BY_KEY\n"
 "                      __global T *output,\n"
-"                      const uint output_offset)\n"
+"                      const INDEX_T output_offset\n"
 "#else\n"
 "                      __global T *keys_output,\n"
-"                      const uint keys_output_offset,\n"
+"                      const INDEX_T keys_output_offset,\n"
 "                      __global T2 *values_input,\n"
-"                      const uint values_input_offset,\n"
+"                      const INDEX_T values_input_offset,\n"
 "                      __global T2 *values_output,\n"
-"                      const uint values_output_offset)\n"
+"                      const INDEX_T values_output_offset\n"
 "#endif\n"
+"                      )\n"
 "{\n"
      // work-item parameters
-"    const uint gid = get_global_id(0);\n"
+"    const INDEX_T gid = get_global_id(0);\n"
 "    const uint lid = get_local_id(0);\n"
 
      // copy input to local memory
@@ -216,7 +265,7 @@ const char radix_sort_source[] =
 "    }\n"
 
      // copy block counts to local memory
-"    __local uint local_counts[(1 << K_BITS)];\n"
+"    __local INDEX_T local_counts[(1 << K_BITS)];\n"
 "    if(lid < K2_BITS){\n"
 "        local_counts[lid] = counts[get_group_id(0) * K2_BITS + lid];\n"
 "    }\n"
@@ -229,7 +278,7 @@ const char radix_sort_source[] =
 "    }\n"
 
      // get global offset
-"    uint offset = global_offsets[bucket] + local_counts[bucket];\n"
+"    INDEX_T offset = global_offsets[bucket] + local_counts[bucket];\n"
 
      // calculate local offset
 "    uint local_offset = 0;\n"
@@ -249,20 +298,46 @@ const char radix_sort_source[] =
 "#endif\n"
 "}\n";
 
-template<class T, class T2>
-inline void radix_sort_impl(const buffer_iterator<T> first,
-                            const buffer_iterator<T> last,
-                            const buffer_iterator<T2> values_first,
-                            const bool ascending,
-                            command_queue &queue)
+// returns true if the k-bit digit starting at low_bit is not the same in
+// every key, varying_bits holds the bits which differ between the keys
+template<class SortType>
+inline bool is_varying_digit(const SortType varying_bits,
+                             const uint_ low_bit,
+                             const uint_ k)
 {
+    return ((varying_bits >> low_bit) & ((SortType(1) << k) - 1)) != 0;
+}
 
+// sorts on the digits of the keys between begin_bit and end_bit. if
+// skip_uniform_digits is true, a pre-pass computes the bits which differ
+// between the keys on the device and reads them back once. the passes for
+// digits which are the same in every key are then left out completely.
+// IndexType (uint_ or ulong_) is the type of the sizes, offsets and counts
+// in the kernels.
+template<class IndexType, class T, class T2>
+inline void radix_sort_with_index_type(const buffer_iterator<T> first,
+                                       const buffer_iterator<T> last,
+                                       const buffer_iterator<T2> values_first,
+                                       const bool ascending,
+                                       const uint_ begin_bit,
+                                       const uint_ end_bit,
+                                       const bool skip_uniform_digits,
+                                       command_queue &queue)
+{
     typedef T value_type;
+    typedef IndexType index_type;
     typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
 
+    BOOST_ASSERT(begin_bit <= end_bit);
+    BOOST_ASSERT(end_bit <= sizeof(T) * CHAR_BIT);
+
     const device &device = queue.get_device();
     const context &context = queue.get_context();
 
+    size_t count = detail::iterator_range_size(first, last);
+    if(count < 2){
+        return;
+    }
 
     // if we have a valid values iterator then we are doing a
     // sort by key and have to set up the values buffer
@@ -291,6 +366,7 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
     options << "-DK_BITS=" << k;
     options << " -DT=" << type_name<sort_type>();
     options << " -DBLOCK_SIZE=" << block_size;
+    options << " -DINDEX_T=" << type_name<index_type>();
 
     if(boost::is_floating_point<value_type>::value){
         options << " -DIS_FLOATING_POINT";
@@ -315,44 +391,77 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
 
     // load radix sort program
     program radix_sort_program = cache->get_or_build(
-       cache_key, options.str(), custom_type_def + radix_sort_source, context
+       cache_key, options.str(), custom_type_def + radix_key_source + radix_sort_source, context
     );
 
     kernel count_kernel(radix_sort_program, "count");
     kernel scan_kernel(radix_sort_program, "scan");
     kernel scatter_kernel(radix_sort_program, "scatter");
 
-    size_t count = detail::iterator_range_size(first, last);
-
     uint_ block_count = static_cast<uint_>(count / block_size);
     if(block_count * block_size != count){
         block_count++;
     }
 
     // setup temporary buffers
-    vector<value_type> output(count, context);
-    vector<T2> values_output(sort_by_key ? count : 0, context);
-    vector<uint_> offsets(k2, context);
-    vector<uint_> counts(block_count * k2, context);
+    scratch_vector<value_type> output(count, queue);
+    scratch_vector<T2> values_output(sort_by_key ? count : 0, queue);
+    scratch_vector<index_type> offsets(k2, queue);
+    scratch_vector<index_type> counts(block_count * k2, queue);
 
     const buffer *input_buffer = &first.get_buffer();
-    uint_ input_offset = static_cast<uint_>(first.get_index());
+    index_type input_offset = static_cast<index_type>(first.get_index());
     const buffer *output_buffer = &output.get_buffer();
-    uint_ output_offset = 0;
+    index_type output_offset = 0;
     const buffer *values_input_buffer = &values_first.get_buffer();
-    uint_ values_input_offset = static_cast<uint_>(values_first.get_index());
+    index_type values_input_offset = static_cast<index_type>(values_first.get_index());
     const buffer *values_output_buffer = &values_output.get_buffer();
-    uint_ values_output_offset = 0;
+    index_type values_output_offset = 0;
+
+    // find the bits which differ between keys, every digit is sorted on
+    // without the pre-pass
+    sort_type varying_bits = static_cast<sort_type>(~sort_type(0));
+    if(skip_uniform_digits){
+        const uint_ group_count =
+            (std::min)(block_count, uint_(4 * device.compute_units()));
+        scratch_vector<sort_type> group_bits(2 * group_count, queue);
+
+        kernel key_bits_kernel(radix_sort_program, "key_bits");
+        key_bits_kernel.set_arg(0, *input_buffer);
+        key_bits_kernel.set_arg(1, input_offset);
+        key_bits_kernel.set_arg(2, static_cast<index_type>(count));
+        key_bits_kernel.set_arg(3, group_bits.get_buffer());
+        queue.enqueue_1d_range_kernel(key_bits_kernel,
+                                      0,
+                                      group_count * block_size,
+                                      block_size);
+
+        kernel varying_key_bits_kernel(radix_sort_program, "varying_key_bits");
+        varying_key_bits_kernel.set_arg(0, group_bits.get_buffer());
+        varying_key_bits_kernel.set_arg(1, group_count);
+        queue.enqueue_task(varying_key_bits_kernel);
+
+        queue.enqueue_read_buffer(
+            group_bits.get_buffer(), 0, sizeof(sort_type), &varying_bits
+        );
+    }
+
+    uint_ pass_count = 0;
+
+    for(uint_ low_bit = begin_bit; low_bit < end_bit; low_bit += k){
+        if(!is_varying_digit(varying_bits, low_bit, k)){
+            continue;
+        }
+        pass_count++;
 
-    for(uint_ i = 0; i < sizeof(sort_type) * CHAR_BIT / k; i++){
         // write counts
         count_kernel.set_arg(0, *input_buffer);
         count_kernel.set_arg(1, input_offset);
-        count_kernel.set_arg(2, static_cast<uint_>(count));
-        count_kernel.set_arg(3, counts);
-        count_kernel.set_arg(4, offsets);
+        count_kernel.set_arg(2, static_cast<index_type>(count));
+        count_kernel.set_arg(3, counts.get_buffer());
+        count_kernel.set_arg(4, offsets.get_buffer());
         count_kernel.set_arg(5, block_size * sizeof(uint_), 0);
-        count_kernel.set_arg(6, i * k);
+        count_kernel.set_arg(6, low_bit);
         queue.enqueue_1d_range_kernel(count_kernel,
                                       0,
                                       block_count * block_size,
@@ -360,7 +469,7 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
 
         // scan counts
         if(k == 1){
-            typedef uint2_ counter_type;
+            typedef typename make_vector_type<index_type, 2>::type counter_type;
             ::boost::compute::exclusive_scan(
                 make_buffer_iterator<counter_type>(counts.get_buffer(), 0),
                 make_buffer_iterator<counter_type>(counts.get_buffer(), counts.size() / 2),
@@ -369,7 +478,7 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
             );
         }
         else if(k == 2){
-            typedef uint4_ counter_type;
+            typedef typename make_vector_type<index_type, 4>::type counter_type;
             ::boost::compute::exclusive_scan(
                 make_buffer_iterator<counter_type>(counts.get_buffer(), 0),
                 make_buffer_iterator<counter_type>(counts.get_buffer(), counts.size() / 4),
@@ -378,7 +487,7 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
             );
         }
         else if(k == 4){
-            typedef uint16_ counter_type;
+            typedef typename make_vector_type<index_type, 16>::type counter_type;
             ::boost::compute::exclusive_scan(
                 make_buffer_iterator<counter_type>(counts.get_buffer(), 0),
                 make_buffer_iterator<counter_type>(counts.get_buffer(), counts.size() / 16),
@@ -392,18 +501,18 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
         }
 
         // scan global offsets
-        scan_kernel.set_arg(0, counts);
-        scan_kernel.set_arg(1, offsets);
+        scan_kernel.set_arg(0, counts.get_buffer());
+        scan_kernel.set_arg(1, offsets.get_buffer());
         scan_kernel.set_arg(2, block_count);
         queue.enqueue_task(scan_kernel);
 
         // scatter values
         scatter_kernel.set_arg(0, *input_buffer);
         scatter_kernel.set_arg(1, input_offset);
-        scatter_kernel.set_arg(2, static_cast<uint_>(count));
-        scatter_kernel.set_arg(3, i * k);
-        scatter_kernel.set_arg(4, counts);
-        scatter_kernel.set_arg(5, offsets);
+        scatter_kernel.set_arg(2, static_cast<index_type>(count));
+        scatter_kernel.set_arg(3, low_bit);
+        scatter_kernel.set_arg(4, counts.get_buffer());
+        scatter_kernel.set_arg(5, offsets.get_buffer());
         scatter_kernel.set_arg(6, *output_buffer);
         scatter_kernel.set_arg(7, output_offset);
         if(sort_by_key){
@@ -423,6 +532,69 @@ inline void radix_sort_impl(const buffer_iterator<T> first,
         std::swap(input_offset, output_offset);
         std::swap(values_input_offset, values_output_offset);
     }
+
+    // after an odd number of passes the sorted values are in the temporary
+    // buffers and have to be copied back
+    if(pass_count % 2 == 1){
+        queue.enqueue_copy_buffer(*input_buffer,
+                                  first.get_buffer(),
+                                  size_t(input_offset) * sizeof(T),
+                                  first.get_index() * sizeof(T),
+                                  count * sizeof(T));
+        if(sort_by_key){
+            queue.enqueue_copy_buffer(*values_input_buffer,
+                                      values_first.get_buffer(),
+                                      size_t(values_input_offset) * sizeof(T2),
+                                      values_first.get_index() * sizeof(T2),
+                                      count * sizeof(T2));
+        }
+    }
+}
+
+// sorts with 64-bit sizes and offsets if the range (or its offset) does not
+// fit into 32-bit indices
+template<class T, class T2>
+inline void radix_sort_impl(const buffer_iterator<T> first,
+                            const buffer_iterator<T> last,
+                            const buffer_iterator<T2> values_first,
+                            const bool ascending,
+                            const uint_ begin_bit,
+                            const uint_ end_bit,
+                            const bool skip_uniform_digits,
+                            command_queue &queue)
+{
+    const size_t end = (std::max)(
+        last.get_index(),
+        values_first.get_index() + detail::iterator_range_size(first, last)
+    );
+
+    if(requires_64bit_indices(end)){
+        radix_sort_with_index_type<ulong_>(first, last, values_first, ascending,
+                                           begin_bit, end_bit,
+                                           skip_uniform_digits, queue);
+    }
+    else {
+        radix_sort_with_index_type<uint_>(first, last, values_first, ascending,
+                                          begin_bit, end_bit,
+                                          skip_uniform_digits, queue);
+    }
+}
+
+template<class T, class T2>
+inline void radix_sort_impl(const buffer_iterator<T> first,
+                            const buffer_iterator<T> last,
+                            const buffer_iterator<T2> values_first,
+                            const bool ascending,
+                            command_queue &queue)
+{
+    radix_sort_impl(first,
+                    last,
+                    values_first,
+                    ascending,
+                    0,
+                    static_cast<uint_>(sizeof(T) * CHAR_BIT),
+                    false,
+                    queue);
 }
 
 template<class Iterator>
@@ -461,6 +633,85 @@ inline void radix_sort_by_key(KeyIterator keys_first,
     radix_sort_impl(keys_first, keys_last, values_first, ascending, queue);
 }
 
+// sorts the range by the bits [begin_bit, end_bit) of the keys. all keys must
+// have the same value for the bits outside of the range (for signed and
+// floating-point keys of mixed sign this means the range must include the
+// sign bit). with skip_uniform_digits, an extra pass over the keys finds the
+// digits in the range which are the same in every key and skips sorting on
+// them.
+template<class Iterator>
+inline void radix_sort(Iterator first,
+                       Iterator last,
+                       const uint_ begin_bit,
+                       const uint_ end_bit,
+                       const bool ascending,
+                       const bool skip_uniform_digits,
+                       command_queue &queue)
+{
+    radix_sort_impl(first, last, buffer_iterator<int>(), ascending,
+                    begin_bit, end_bit, skip_uniform_digits, queue);
+}
+
+template<class Iterator>
+inline void radix_sort(Iterator first,
+                       Iterator last,
+                       const uint_ begin_bit,
+                       const uint_ end_bit,
+                       const bool ascending,
+                       command_queue &queue)
+{
+    radix_sort(first, last, begin_bit, end_bit, ascending, false, queue);
+}
+
+template<class Iterator>
+inline void radix_sort(Iterator first,
+                       Iterator last,
+                       const uint_ begin_bit,
+                       const uint_ end_bit,
+                       command_queue &queue)
+{
+    radix_sort(first, last, begin_bit, end_bit, true, queue);
+}
+
+template<class KeyIterator, class ValueIterator>
+inline void radix_sort_by_key(KeyIterator keys_first,
+                              KeyIterator keys_last,
+                              ValueIterator values_first,
+                              const uint_ begin_bit,
+                              const uint_ end_bit,
+                              const bool ascending,
+                              const bool skip_uniform_digits,
+                              command_queue &queue)
+{
+    radix_sort_impl(keys_first, keys_last, values_first, ascending,
+                    begin_bit, end_bit, skip_uniform_digits, queue);
+}
+
+template<class KeyIterator, class ValueIterator>
+inline void radix_sort_by_key(KeyIterator keys_first,
+                              KeyIterator keys_last,
+                              ValueIterator values_first,
+                              const uint_ begin_bit,
+                              const uint_ end_bit,
+                              const bool ascending,
+                              command_queue &queue)
+{
+    radix_sort_by_key(keys_first, keys_last, values_first,
+                      begin_bit, end_bit, ascending, false, queue);
+}
+
+template<class KeyIterator, class ValueIterator>
+inline void radix_sort_by_key(KeyIterator keys_first,
+                              KeyIterator keys_last,
+                              ValueIterator values_first,
+                              const uint_ begin_bit,
+                              const uint_ end_bit,
+                              command_queue &queue)
+{
+    radix_sort_by_key(keys_first, keys_last, values_first,
+                      begin_bit, end_bit, true, queue);
+}
+
 
 } // end detail namespace
 } // end compute namespace
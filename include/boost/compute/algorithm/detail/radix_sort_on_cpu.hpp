@@ -0,0 +1,434 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SORT_ON_CPU_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SORT_ON_CPU_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+
+#include <boost/compute/kernel.hpp>
+#include <boost/compute/program.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/exclusive_scan.hpp>
+#include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/detail/vendor.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+#include <boost/compute/utility/program_cache.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// radix sort kernels for cpu devices. each work-item sorts a large contiguous
+// chunk of the input with a private histogram instead of cooperating with the
+// other work-items through local memory. the scatter kernel collects keys in
+// one cache line sized buffer per bucket and only writes whole lines to the
+// output (software write-combining), which avoids touching K2_BITS different
+// cache lines for every key. sizes, offsets and counts have the type INDEX_T
+// which is ulong for ranges too large for uint.
+const char radix_sort_on_cpu_source[] =
+"#define CHUNK_BOUNDS(size)\\\n"
+"    const uint tid = get_global_id(0);\\\n"
+"    const uint threads = get_global_size(0);\\\n"
+"    const INDEX_T chunk = (size + threads - 1) / threads;\\\n"
+"    const INDEX_T start = min((INDEX_T)(tid) * chunk, size);\\\n"
+"    const INDEX_T end = min(start + chunk, size);\n"
+
+"__kernel void key_bits(__global const T *input,\n"
+"                       const INDEX_T input_offset,\n"
+"                       const INDEX_T input_size,\n"
+"                       __global T *output)\n"
+"{\n"
+"    CHUNK_BOUNDS(input_size)\n"
+"    T or_bits = 0;\n"
+"    T and_bits = (T)(~((T)(0)));\n"
+"    for(INDEX_T i = start; i < end; i++){\n"
+"        const T key = radix_key(input[input_offset+i]);\n"
+"        or_bits |= key;\n"
+"        and_bits &= key;\n"
+"    }\n"
+"    output[2*tid] = or_bits;\n"
+"    output[2*tid+1] = and_bits;\n"
+"}\n"
+
+"__kernel void count(__global const T *input,\n"
+"                    const INDEX_T input_offset,\n"
+"                    const INDEX_T input_size,\n"
+"                    __global INDEX_T *counts,\n"
+"                    const uint low_bit)\n"
+"{\n"
+"    CHUNK_BOUNDS(input_size)\n"
+"    INDEX_T local_counts[K2_BITS];\n"
+"    for(uint i = 0; i < K2_BITS; i++){\n"
+"        local_counts[i] = 0;\n"
+"    }\n"
+"    for(INDEX_T i = start; i < end; i++){\n"
+"        local_counts[radix(input[input_offset+i], low_bit)]++;\n"
+"    }\n"
+
+     // counts are stored bucket-major so that an exclusive scan of them
+     // gives the output offset of every (bucket, chunk) pair
+"    for(uint i = 0; i < K2_BITS; i++){\n"
+"        counts[i * threads + tid] = local_counts[i];\n"
+"    }\n"
+"}\n"
+
+"__kernel void scatter(__global const T *input,\n"
+"                      const INDEX_T input_offset,\n"
+"                      const INDEX_T input_size,\n"
+"                      const uint low_bit,\n"
+"                      __global const INDEX_T *offsets,\n"
+"#ifndef SORT_BY_KEY\n"
+"                      __global T *output,\n"
+"                      const INDEX_T output_offset\n"
+"#else\n"
+"                      __global T *output,\n"
+"                      const INDEX_T output_offset,\n"
+"                      __global const T2 *values_input,\n"
+"                      const INDEX_T values_input_offset,\n"
+"                      __global T2 *values_output,\n"
+"                      const INDEX_T values_output_offset\n"
+"#endif\n"
+"                      )\n"
+"{\n"
+"    CHUNK_BOUNDS(input_size)\n"
+
+"#if WC_SIZE > 1\n"
+"    __local T wc_keys[K2_BITS * WC_SIZE];\n"
+"#ifdef SORT_BY_KEY\n"
+"    __local T2 wc_values[K2_BITS * WC_SIZE];\n"
+"#endif\n"
+
+     // index of the first output line of each bucket and the first and
+     // next free slot in its buffer. the buffers start at the position of
+     // the bucket offset in its line so that all flushes after the first
+     // one are aligned to whole lines.
+"    INDEX_T line[K2_BITS];\n"
+"    uint first_slot[K2_BITS];\n"
+"    uint next_slot[K2_BITS];\n"
+"    for(uint i = 0; i < K2_BITS; i++){\n"
+"        const INDEX_T offset = offsets[i * threads + tid];\n"
+"        line[i] = offset & ~((INDEX_T)(WC_SIZE - 1));\n"
+"        first_slot[i] = offset & (WC_SIZE - 1);\n"
+"        next_slot[i] = first_slot[i];\n"
+"    }\n"
+
+"    for(INDEX_T i = start; i < end; i++){\n"
+"        const T key = input[input_offset+i];\n"
+"        const uint bucket = radix(key, low_bit);\n"
+"        const uint slot = next_slot[bucket]++;\n"
+"        wc_keys[bucket * WC_SIZE + slot] = key;\n"
+"#ifdef SORT_BY_KEY\n"
+"        wc_values[bucket * WC_SIZE + slot] = values_input[values_input_offset+i];\n"
+"#endif\n"
+"        if(slot == WC_SIZE - 1){\n"
+"            for(uint j = first_slot[bucket]; j < WC_SIZE; j++){\n"
+"                output[output_offset + line[bucket] + j] =\n"
+"                    wc_keys[bucket * WC_SIZE + j];\n"
+"#ifdef SORT_BY_KEY\n"
+"                values_output[values_output_offset + line[bucket] + j] =\n"
+"                    wc_values[bucket * WC_SIZE + j];\n"
+"#endif\n"
+"            }\n"
+"            line[bucket] += WC_SIZE;\n"
+"            first_slot[bucket] = 0;\n"
+"            next_slot[bucket] = 0;\n"
+"        }\n"
+"    }\n"
+
+     // flush partially filled buffers
+"    for(uint i = 0; i < K2_BITS; i++){\n"
+"        for(uint j = first_slot[i]; j < next_slot[i]; j++){\n"
+"            output[output_offset + line[i] + j] = wc_keys[i * WC_SIZE + j];\n"
+"#ifdef SORT_BY_KEY\n"
+"            values_output[values_output_offset + line[i] + j] =\n"
+"                wc_values[i * WC_SIZE + j];\n"
+"#endif\n"
+"        }\n"
+"    }\n"
+"#else\n"
+"    INDEX_T local_offsets[K2_BITS];\n"
+"    for(uint i = 0; i < K2_BITS; i++){\n"
+"        local_offsets[i] = offsets[i * threads + tid];\n"
+"    }\n"
+"    for(INDEX_T i = start; i < end; i++){\n"
+"        const T key = input[input_offset+i];\n"
+"        const INDEX_T offset = local_offsets[radix(key, low_bit)]++;\n"
+"        output[output_offset + offset] = key;\n"
+"#ifdef SORT_BY_KEY\n"
+"        values_output[values_output_offset + offset] =\n"
+"            values_input[values_input_offset+i];\n"
+"#endif\n"
+"    }\n"
+"#endif\n"
+"}\n";
+
+// radix sort for cpu devices. the input is split into one large chunk per
+// work-item (by default one per compute unit) and each pass runs a count
+// kernel, an exclusive scan of the per-chunk histograms and a scatter kernel.
+// a pre-pass finds the bits which differ between the keys and the passes for
+// digits which are the same in every key are left out. reading the bits back
+// is cheap on cpu devices compared to a pass over the keys.
+// IndexType (uint_ or ulong_) is the type of the sizes, offsets and counts.
+template<class IndexType, class T, class T2>
+inline void radix_sort_on_cpu_with_index_type(const buffer_iterator<T> first,
+                                              const buffer_iterator<T> last,
+                                              const buffer_iterator<T2> values_first,
+                                              const bool ascending,
+                                              command_queue &queue)
+{
+    typedef T value_type;
+    typedef IndexType index_type;
+    typedef typename radix_sort_value_type<sizeof(T)>::type sort_type;
+
+    const device &device = queue.get_device();
+    const context &context = queue.get_context();
+
+    size_t count = detail::iterator_range_size(first, last);
+    if(count < 2){
+        return;
+    }
+
+    bool sort_by_key = (values_first.get_buffer().get() != 0);
+
+    std::string cache_key =
+        std::string("__boost_radix_sort_on_cpu_") + type_name<value_type>();
+
+    if(sort_by_key){
+        cache_key += std::string("_with_") + type_name<T2>();
+    }
+
+    boost::shared_ptr<program_cache> cache =
+        program_cache::get_global_cache(context);
+    boost::shared_ptr<parameter_cache> parameters =
+        detail::parameter_cache::get_global_cache(device);
+
+    // sort parameters
+    const uint_ k = parameters->get(cache_key, "k", 8);
+    const uint_ k2 = 1 << k;
+    const uint_ threads_per_cu = parameters->get(cache_key, "threads_per_cu", 1);
+    const uint_ min_chunk_size = parameters->get(cache_key, "min_chunk_size", 4096);
+
+    // the write-combining buffers hold one cache line per bucket. they are
+    // shrunk (or disabled) if they do not fit into local memory. they are
+    // also disabled on the Apple platform which misbehaves when local
+    // memory is used on cpu devices.
+    const size_t line_size = (std::max<size_t>)(
+        device.get_info<cl_uint>(CL_DEVICE_GLOBAL_MEM_CACHELINE_SIZE), 64
+    );
+    const size_t element_size =
+        sizeof(sort_type) + (sort_by_key ? sizeof(T2) : 0);
+    uint_ wc_size = parameters->get(
+        cache_key, "wc_size", static_cast<uint_>(line_size / sizeof(sort_type))
+    );
+    if(is_apple_platform_device(device)){
+        wc_size = 1;
+    }
+    while(wc_size & (wc_size - 1)){
+        // round down to a power of two
+        wc_size &= wc_size - 1;
+    }
+    while(wc_size > 1 &&
+          k2 * wc_size * element_size > device.local_memory_size()){
+        wc_size /= 2;
+    }
+
+    // split the input into chunks of at least min_chunk_size elements
+    uint_ thread_count = device.compute_units() * threads_per_cu;
+    thread_count = static_cast<uint_>((std::min)(
+        size_t(thread_count),
+        (count + min_chunk_size - 1) / min_chunk_size
+    ));
+    thread_count = (std::max)(thread_count, uint_(1));
+
+    std::stringstream options;
+    options << "-DK_BITS=" << k;
+    options << " -DT=" << type_name<sort_type>();
+    options << " -DINDEX_T=" << type_name<index_type>();
+    options << " -DWC_SIZE=" << wc_size;
+
+    if(boost::is_floating_point<value_type>::value){
+        options << " -DIS_FLOATING_POINT";
+    }
+
+    if(boost::is_signed<value_type>::value){
+        options << " -DIS_SIGNED";
+    }
+
+    if(sort_by_key){
+        options << " -DSORT_BY_KEY";
+        options << " -DT2=" << type_name<T2>();
+        options << enable_double<T2>();
+    }
+
+    if(ascending){
+        options << " -DASC";
+    }
+
+    std::string custom_type_def = boost::compute::type_definition<T2>() + "\n";
+
+    program radix_sort_program = cache->get_or_build(
+        cache_key,
+        options.str(),
+        custom_type_def + radix_key_source + radix_sort_on_cpu_source,
+        context
+    );
+
+    kernel key_bits_kernel(radix_sort_program, "key_bits");
+    kernel varying_key_bits_kernel(radix_sort_program, "varying_key_bits");
+    kernel count_kernel(radix_sort_program, "count");
+    kernel scatter_kernel(radix_sort_program, "scatter");
+
+    // setup temporary buffers
+    scratch_vector<value_type> output(count, queue);
+    scratch_vector<T2> values_output(sort_by_key ? count : 0, queue);
+    scratch_vector<index_type> counts(k2 * thread_count, queue);
+    scratch_vector<sort_type> group_bits(2 * thread_count, queue);
+
+    const buffer *input_buffer = &first.get_buffer();
+    index_type input_offset = static_cast<index_type>(first.get_index());
+    const buffer *output_buffer = &output.get_buffer();
+    index_type output_offset = 0;
+    const buffer *values_input_buffer = &values_first.get_buffer();
+    index_type values_input_offset = static_cast<index_type>(values_first.get_index());
+    const buffer *values_output_buffer = &values_output.get_buffer();
+    index_type values_output_offset = 0;
+
+    // find the bits which differ between keys
+    key_bits_kernel.set_arg(0, *input_buffer);
+    key_bits_kernel.set_arg(1, input_offset);
+    key_bits_kernel.set_arg(2, static_cast<index_type>(count));
+    key_bits_kernel.set_arg(3, group_bits.get_buffer());
+    queue.enqueue_1d_range_kernel(key_bits_kernel, 0, thread_count, 1);
+
+    varying_key_bits_kernel.set_arg(0, group_bits.get_buffer());
+    varying_key_bits_kernel.set_arg(1, thread_count);
+    queue.enqueue_task(varying_key_bits_kernel);
+
+    sort_type varying_bits = 0;
+    queue.enqueue_read_buffer(
+        group_bits.get_buffer(), 0, sizeof(sort_type), &varying_bits
+    );
+
+    const uint_ bits = static_cast<uint_>(sizeof(T) * CHAR_BIT);
+    uint_ pass_count = 0;
+
+    for(uint_ low_bit = 0; low_bit < bits; low_bit += k){
+        if(!is_varying_digit(varying_bits, low_bit, k)){
+            continue;
+        }
+        pass_count++;
+
+        // per-chunk histograms
+        count_kernel.set_arg(0, *input_buffer);
+        count_kernel.set_arg(1, input_offset);
+        count_kernel.set_arg(2, static_cast<index_type>(count));
+        count_kernel.set_arg(3, counts.get_buffer());
+        count_kernel.set_arg(4, low_bit);
+        queue.enqueue_1d_range_kernel(count_kernel, 0, thread_count, 1);
+
+        ::boost::compute::exclusive_scan(
+            counts.begin(), counts.end(), counts.begin(), queue
+        );
+
+        scatter_kernel.set_arg(0, *input_buffer);
+        scatter_kernel.set_arg(1, input_offset);
+        scatter_kernel.set_arg(2, static_cast<index_type>(count));
+        scatter_kernel.set_arg(3, low_bit);
+        scatter_kernel.set_arg(4, counts.get_buffer());
+        scatter_kernel.set_arg(5, *output_buffer);
+        scatter_kernel.set_arg(6, output_offset);
+        if(sort_by_key){
+            scatter_kernel.set_arg(7, *values_input_buffer);
+            scatter_kernel.set_arg(8, values_input_offset);
+            scatter_kernel.set_arg(9, *values_output_buffer);
+            scatter_kernel.set_arg(10, values_output_offset);
+        }
+        queue.enqueue_1d_range_kernel(scatter_kernel, 0, thread_count, 1);
+
+        // swap buffers
+        std::swap(input_buffer, output_buffer);
+        std::swap(values_input_buffer, values_output_buffer);
+        std::swap(input_offset, output_offset);
+        std::swap(values_input_offset, values_output_offset);
+    }
+
+    // after an odd number of passes the sorted values are in the temporary
+    // buffers and have to be copied back
+    if(pass_count % 2 == 1){
+        queue.enqueue_copy_buffer(*input_buffer,
+                                  first.get_buffer(),
+                                  size_t(input_offset) * sizeof(T),
+                                  first.get_index() * sizeof(T),
+                                  count * sizeof(T));
+        if(sort_by_key){
+            queue.enqueue_copy_buffer(*values_input_buffer,
+                                      values_first.get_buffer(),
+                                      size_t(values_input_offset) * sizeof(T2),
+                                      values_first.get_index() * sizeof(T2),
+                                      count * sizeof(T2));
+        }
+    }
+}
+
+// sorts with 64-bit sizes and offsets if the range (or its offset) does not
+// fit into 32-bit indices
+template<class T, class T2>
+inline void radix_sort_on_cpu_impl(const buffer_iterator<T> first,
+                                   const buffer_iterator<T> last,
+                                   const buffer_iterator<T2> values_first,
+                                   const bool ascending,
+                                   command_queue &queue)
+{
+    const size_t end = (std::max)(
+        last.get_index(),
+        values_first.get_index() + detail::iterator_range_size(first, last)
+    );
+
+    if(requires_64bit_indices(end)){
+        radix_sort_on_cpu_with_index_type<ulong_>(first, last, values_first, ascending, queue);
+    }
+    else {
+        radix_sort_on_cpu_with_index_type<uint_>(first, last, values_first, ascending, queue);
+    }
+}
+
+template<class Iterator>
+inline void radix_sort_on_cpu(Iterator first,
+                              Iterator last,
+                              const bool ascending,
+                              command_queue &queue)
+{
+    radix_sort_on_cpu_impl(first, last, buffer_iterator<int>(), ascending, queue);
+}
+
+template<class KeyIterator, class ValueIterator>
+inline void radix_sort_by_key_on_cpu(KeyIterator keys_first,
+                                     KeyIterator keys_last,
+                                     ValueIterator values_first,
+                                     const bool ascending,
+                                     command_queue &queue)
+{
+    radix_sort_on_cpu_impl(keys_first, keys_last, values_first, ascending, queue);
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_RADIX_SORT_ON_CPU_HPP
@@ -22,6 +22,7 @@
 #include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
 #include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/memory/local_buffer.hpp>
 #include <boost/compute/type_traits.hpp>
 #include <boost/compute/utility/program_cache.hpp>
 
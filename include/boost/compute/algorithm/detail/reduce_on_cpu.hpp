@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_REDUCE_ON_CPU_HPP
 
 #include <algorithm>
+#include <string>
 
 #include <boost/compute/buffer.hpp>
 #include <boost/compute/command_queue.hpp>
@@ -65,16 +66,18 @@ inline void reduce_on_cpu(InputIterator first,
 
     meta_kernel k("reduce_on_cpu");
     buffer output(context, sizeof(result_type) * compute_units);
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
 
-    size_t count_arg = k.add_arg<uint_>("count");
+    size_t count_arg = k.add_index_arg("count");
     size_t output_arg =
         k.add_arg<result_type *>(memory_object::global_memory, "output");
 
     k <<
-        "uint block = " <<
-            "(uint)ceil(((float)count)/get_global_size(0));\n" <<
-        "uint index = get_global_id(0) * block;\n" <<
-        "uint end = min(count, index + block);\n" <<
+        index_type << " block = " <<
+            "(count + get_global_size(0) - 1) / get_global_size(0);\n" <<
+        index_type << " index = get_global_id(0) * block;\n" <<
+        index_type << " end = min(count, index + block);\n" <<
 
         k.decl<result_type>("result") << " = " << first[k.var<uint_>("index")] << ";\n" <<
         "index++;\n" <<
@@ -89,7 +92,7 @@ inline void reduce_on_cpu(InputIterator first,
     kernel kernel = k.compile(context);
 
     // reduction to global_work_size elements
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(kernel, count_arg, count);
     kernel.set_arg(output_arg, output);
     queue.enqueue_1d_range_kernel(kernel, 0, global_work_size, 0);
 
@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_REDUCE_ON_GPU_HPP
 
 #include <iterator>
+#include <string>
 
 #include <boost/compute/utility/source.hpp>
 #include <boost/compute/program.hpp>
@@ -20,6 +21,8 @@
 #include <boost/compute/detail/parameter_cache.hpp>
 #include <boost/compute/detail/work_size.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/type_traits/type_name.hpp>
 #include <boost/compute/utility/program_cache.hpp>
 
@@ -85,29 +88,50 @@ struct ReduceBody<T,true>
     }
 };
 
+// returns the largest index the reduce kernel reads for [first, last).
+// the offsets of generic iterators are part of the kernel source, buffer
+// iterators pass theirs as a kernel argument.
+template<class InputIterator>
+inline size_t reduce_index_bound(InputIterator first, InputIterator last)
+{
+    return iterator_range_size(first, last);
+}
+
+template<class T>
+inline size_t reduce_index_bound(const buffer_iterator<T> &first,
+                                 const buffer_iterator<T> &last)
+{
+    (void) first;
+
+    return last.get_index();
+}
+
 template<class InputIterator, class Function>
 inline void initial_reduce(InputIterator first,
                            InputIterator last,
                            buffer result,
                            const Function &function,
                            kernel &reduce_kernel,
+                           const meta_kernel &reduce_source,
                            const uint_ vpt,
                            const uint_ tpb,
                            command_queue &queue)
 {
     (void) function;
     (void) reduce_kernel;
+    (void) reduce_source;
 
     typedef typename std::iterator_traits<InputIterator>::value_type Arg;
     typedef typename boost::tr1_result_of<Function(Arg, Arg)>::type T;
 
     size_t count = std::distance(first, last);
     detail::meta_kernel k("initial_reduce");
-    k.add_set_arg<const uint_>("count", uint_(count));
+    k.set_index_type_for(count);
+    k.add_set_index_arg("count", count);
     size_t output_arg = k.add_arg<T *>(memory_object::global_memory, "output");
 
     k <<
-        k.decl<const uint_>("offset") << " = get_group_id(0) * VPT * TPB;\n" <<
+        "const " << k.index_type() << " offset = get_group_id(0) * VPT * TPB;\n" <<
         k.decl<const uint_>("lid") << " = get_local_id(0);\n" <<
 
         "__local " << type_name<T>() << " scratch[TPB];\n" <<
@@ -147,6 +171,7 @@ inline void initial_reduce(const buffer_iterator<T> &first,
                            const buffer &result,
                            const plus<T> &function,
                            kernel &reduce_kernel,
+                           const meta_kernel &reduce_source,
                            const uint_ vpt,
                            const uint_ tpb,
                            command_queue &queue)
@@ -156,8 +181,8 @@ inline void initial_reduce(const buffer_iterator<T> &first,
     size_t count = std::distance(first, last);
 
     reduce_kernel.set_arg(0, first.get_buffer());
-    reduce_kernel.set_arg(1, uint_(first.get_index()));
-    reduce_kernel.set_arg(2, uint_(count));
+    reduce_source.set_index_arg(reduce_kernel, 1, first.get_index());
+    reduce_source.set_index_arg(reduce_kernel, 2, count);
     reduce_kernel.set_arg(3, result);
     reduce_kernel.set_arg(4, uint_(0));
 
@@ -176,15 +201,17 @@ inline void reduce_on_gpu(InputIterator first,
     const device &device = queue.get_device();
     const context &context = queue.get_context();
 
+    // the offsets and sizes are ulong for ranges past the 32-bit limit
     detail::meta_kernel k("reduce");
+    k.set_index_type_for(reduce_index_bound(first, last));
     k.add_arg<const T*>(memory_object::global_memory, "input");
-    k.add_arg<const uint_>("offset");
-    k.add_arg<const uint_>("count");
+    k.add_index_arg("offset");
+    k.add_index_arg("count");
     k.add_arg<T*>(memory_object::global_memory, "output");
     k.add_arg<const uint_>("output_offset");
 
     k <<
-        k.decl<const uint_>("block_offset") << " = get_group_id(0) * VPT * TPB;\n" <<
+        "const " << k.index_type() << " block_offset = get_group_id(0) * VPT * TPB;\n" <<
         "__global const " << type_name<T>() << " *block = input + offset + block_offset;\n" <<
         k.decl<const uint_>("lid") << " = get_local_id(0);\n" <<
 
@@ -231,20 +258,22 @@ inline void reduce_on_gpu(InputIterator first,
         program_cache::get_global_cache(context);
 
     program reduce_program = cache->get_or_build(
-        cache_key, options.str(), k.source(), context
+        cache_key + "_" + k.index_type(), options.str(), k.source(), context
     );
 
     // create reduce kernel
     kernel reduce_kernel(reduce_program, "reduce");
 
     size_t count = std::distance(first, last);
+    const size_t block_size = size_t(vpt) * tpb;
 
-    // first pass, reduce from input to ping
-    buffer ping(context, std::ceil(float(count) / vpt / tpb) * sizeof(T));
-    initial_reduce(first, last, ping, function, reduce_kernel, vpt, tpb, queue);
+    // first pass, reduce from input to ping. the number of blocks is
+    // computed with integers, a float ceil is off for ranges above 2^24
+    buffer ping(context, (count + block_size - 1) / block_size * sizeof(T));
+    initial_reduce(first, last, ping, function, reduce_kernel, k, vpt, tpb, queue);
 
     // update count after initial reduce
-    count = static_cast<size_t>(std::ceil(float(count) / vpt / tpb));
+    count = (count + block_size - 1) / block_size;
 
     // middle pass(es), reduce between ping and pong
     const buffer *input_buffer = &ping;
@@ -253,8 +282,8 @@ inline void reduce_on_gpu(InputIterator first,
     if(count > vpt * tpb){
         while(count > vpt * tpb){
             reduce_kernel.set_arg(0, *input_buffer);
-            reduce_kernel.set_arg(1, uint_(0));
-            reduce_kernel.set_arg(2, uint_(count));
+            k.set_index_arg(reduce_kernel, 1, 0);
+            k.set_index_arg(reduce_kernel, 2, count);
             reduce_kernel.set_arg(3, *output_buffer);
             reduce_kernel.set_arg(4, uint_(0));
 
@@ -265,14 +294,14 @@ inline void reduce_on_gpu(InputIterator first,
             queue.enqueue_1d_range_kernel(reduce_kernel, 0, work_size, tpb);
 
             std::swap(input_buffer, output_buffer);
-            count = static_cast<size_t>(std::ceil(float(count) / vpt / tpb));
+            count = (count + block_size - 1) / block_size;
         }
     }
 
     // final pass, reduce from ping/pong to result
     reduce_kernel.set_arg(0, *input_buffer);
-    reduce_kernel.set_arg(1, uint_(0));
-    reduce_kernel.set_arg(2, uint_(count));
+    k.set_index_arg(reduce_kernel, 1, 0);
+    k.set_index_arg(reduce_kernel, 2, count);
     reduce_kernel.set_arg(3, result.get_buffer());
     reduce_kernel.set_arg(4, uint_(result.get_index()));
 
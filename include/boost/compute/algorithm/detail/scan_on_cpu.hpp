@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_SCAN_ON_CPU_HPP
 
 #include <iterator>
+#include <string>
 
 #include <boost/compute/device.hpp>
 #include <boost/compute/kernel.hpp>
@@ -68,17 +69,19 @@ inline OutputIterator scan_on_cpu(InputIterator first,
 
     // create scan kernel
     meta_kernel k("scan_on_cpu_block_scan");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
 
     // Arguments
-    size_t count_arg = k.add_arg<uint_>("count");
+    size_t count_arg = k.add_index_arg("count");
     size_t init_arg = k.add_arg<output_type>("initial_value");
     size_t block_partial_sums_arg =
         k.add_arg<output_type *>(memory_object::global_memory, "block_partial_sums");
 
     k <<
-        "uint block = (count + get_global_size(0))/(get_global_size(0) + 1);\n" <<
-        "uint index = get_global_id(0) * block;\n" <<
-        "uint end = min(count, index + block);\n" <<
+        index_type << " block = (count + get_global_size(0))/(get_global_size(0) + 1);\n" <<
+        index_type << " index = get_global_id(0) * block;\n" <<
+        index_type << " end = min(count, index + block);\n" <<
         "if(index >= end) return;\n";
 
     if(!exclusive){
@@ -132,7 +135,7 @@ inline OutputIterator scan_on_cpu(InputIterator first,
     kernel block_scan_kernel = k.compile(context);
 
     // setup kernel arguments
-    block_scan_kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(block_scan_kernel, count_arg, count);
     block_scan_kernel.set_arg(init_arg, static_cast<output_type>(init));
     block_scan_kernel.set_arg(block_partial_sums_arg, block_partial_sums);
 
@@ -147,16 +150,17 @@ inline OutputIterator scan_on_cpu(InputIterator first,
 
     // final scan kernel
     meta_kernel l("scan_on_cpu_final_scan");
+    l.set_index_type_for(count);
 
     // Arguments
-    count_arg = l.add_arg<uint_>("count");
+    count_arg = l.add_index_arg("count");
     block_partial_sums_arg =
         l.add_arg<output_type *>(memory_object::global_memory, "block_partial_sums");
 
     l <<
-        "uint block = (count + get_global_size(0))/(get_global_size(0) + 1);\n" <<
-        "uint index = block + get_global_id(0) * block;\n" <<
-        "uint end = min(count, index + block);\n" <<
+        index_type << " block = (count + get_global_size(0))/(get_global_size(0) + 1);\n" <<
+        index_type << " index = block + get_global_id(0) * block;\n" <<
+        index_type << " end = min(count, index + block);\n" <<
         k.decl<output_type>("sum") << " = block_partial_sums[0];\n" <<
         "for(uint i = 0; i < get_global_id(0); i++) {\n" <<
             "sum = " << op(k.var<output_type>("sum"),
@@ -187,7 +191,7 @@ inline OutputIterator scan_on_cpu(InputIterator first,
     kernel final_scan_kernel = l.compile(context);
 
     // setup kernel arguments
-    final_scan_kernel.set_arg(count_arg, static_cast<uint_>(count));
+    l.set_index_arg(final_scan_kernel, count_arg, count);
     final_scan_kernel.set_arg(block_partial_sums_arg, block_partial_sums);
 
     // execute the kernel
@@ -11,179 +11,223 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_SCAN_ON_GPU_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_SCAN_ON_GPU_HPP
 
+#include <sstream>
+
+#include <boost/lexical_cast.hpp>
+
 #include <boost/compute/kernel.hpp>
-#include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/command_queue.hpp>
-#include <boost/compute/container/vector.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
-#include <boost/compute/memory/local_buffer.hpp>
-#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 
 namespace boost {
 namespace compute {
 namespace detail {
 
+// single-pass scan with decoupled look-back.
+//
+// each work-group scans a tile of TPB * VPT values. tiles are numbered in
+// the order in which work-groups start (using an atomic counter) so that a
+// work-group only ever waits on work-groups which are already running.
+//
+// after scanning its tile a work-group publishes the tile aggregate with
+// the AGGREGATE flag and then looks back at the preceding tiles, combining
+// their aggregates until it finds a tile with the PREFIX flag (whose
+// inclusive prefix covers every tile before it). the tile's inclusive
+// prefix is then published with the PREFIX flag and the work-group writes
+// out its values. the input is read and the output written exactly once.
+//
+// status[0] is the tile counter and status[1 + i] is the flag for tile i.
 template<class InputIterator, class OutputIterator, class BinaryOperator>
-class local_scan_kernel : public meta_kernel
+class single_pass_scan_kernel : public meta_kernel
 {
 public:
-    local_scan_kernel(InputIterator first,
-                      InputIterator last,
-                      OutputIterator result,
-                      bool exclusive,
-                      BinaryOperator op)
-        : meta_kernel("local_scan")
+    single_pass_scan_kernel(InputIterator first,
+                            OutputIterator result,
+                            size_t count,
+                            bool exclusive,
+                            BinaryOperator op)
+        : meta_kernel("single_pass_scan")
     {
-        typedef typename std::iterator_traits<InputIterator>::value_type T;
-
-        (void) last;
+        typedef typename std::iterator_traits<OutputIterator>::value_type T;
 
-        bool checked = true;
+        set_index_type_for(count);
+        const std::string index_type = this->index_type();
 
-        m_block_sums_arg = add_arg<T *>(memory_object::global_memory, "block_sums");
-        m_scratch_arg = add_arg<T *>(memory_object::local_memory, "scratch");
-        m_block_size_arg = add_arg<const cl_uint>("block_size");
-        m_count_arg = add_arg<const cl_uint>("count");
-        m_init_value_arg = add_arg<const T>("init");
+        m_count_arg = add_index_arg("count");
+        m_init_arg = add_arg<const T>("init");
+        m_status_arg = add_arg<uint_ *>(memory_object::global_memory, "status");
+        m_aggregates_arg = add_arg<T *>(memory_object::global_memory, "aggregates");
+        m_prefixes_arg = add_arg<T *>(memory_object::global_memory, "prefixes");
 
-        // work-item parameters
         *this <<
-            "const uint gid = get_global_id(0);\n" <<
-            "const uint lid = get_local_id(0);\n";
-
-        // check against data size
-        if(checked){
-            *this <<
-                "if(gid < count){\n";
-        }
-
-        // copy values from input to local memory
+            "const uint lid = get_local_id(0);\n" <<
+            "__local uint local_tile;\n" <<
+            "__local " << type<T>() << " tile_values[TPB * VPT];\n" <<
+            "__local " << type<T>() << " scratch[TPB];\n" <<
+            "__local " << type<T>() << " tile_prefix;\n" <<
+
+            // acquire tile index
+            "if(lid == 0){\n" <<
+            "    local_tile = atomic_inc(status);\n" <<
+            "}\n" <<
+            "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+            "const uint tile = local_tile;\n" <<
+            "const " << index_type << " tile_offset = (" << index_type << ") tile * TPB * VPT;\n" <<
+            "const uint tile_count = (uint) min((" << index_type << ")(TPB * VPT), count - tile_offset);\n" <<
+
+            // load tile into local memory with coalesced reads
+            "for(uint i = 0; i < VPT; i++){\n" <<
+            "    const uint j = lid + i * TPB;\n" <<
+            "    if(j < tile_count){\n" <<
+            "        const " << index_type << " index = tile_offset + j;\n";
         if(exclusive){
             *this <<
-                decl<const T>("local_init") << "= (gid == 0) ? init : 0;\n" <<
-                "if(lid == 0){ scratch[lid] = local_init; }\n" <<
-                "else { scratch[lid] = " << first[expr<cl_uint>("gid-1")] << "; }\n";
+            "        if(index == 0){\n" <<
+            "            tile_values[j] = init;\n" <<
+            "        }\n" <<
+            "        else {\n" <<
+            "            tile_values[j] = " << first[expr<uint_>("index - 1")] << ";\n" <<
+            "        }\n";
         }
-        else{
-            *this <<
-                "scratch[lid] = " << first[expr<cl_uint>("gid")] << ";\n";
-        }
-
-        if(checked){
+        else {
             *this <<
-                "}\n"
-                "else {\n" <<
-                "    scratch[lid] = 0;\n" <<
-                "}\n";
+            "        tile_values[j] = " << first[expr<uint_>("index")] << ";\n";
         }
-
-        // wait for all threads to read from input
         *this <<
-            "barrier(CLK_LOCAL_MEM_FENCE);\n";
-
-        // perform scan
-        *this <<
-            "for(uint i = 1; i < block_size; i <<= 1){\n" <<
-            "    " << decl<const T>("x") << " = lid >= i ? scratch[lid-i] : 0;\n" <<
+            "    }\n" <<
+            "}\n" <<
+            "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+
+            // serial scan of VPT consecutive values in private memory
+            "const uint thread_offset = lid * VPT;\n" <<
+            "const uint thread_count =\n" <<
+            "    thread_offset < tile_count ? min((uint) VPT, tile_count - thread_offset) : 0;\n" <<
+            decl<T>("items[VPT]") << ";\n" <<
+            "if(thread_count > 0){\n" <<
+            "    items[0] = tile_values[thread_offset];\n" <<
+            "    for(uint i = 1; i < thread_count; i++){\n" <<
+            "        items[i] = " << op(var<T>("items[i-1]"),
+                                        var<T>("tile_values[thread_offset+i]")) << ";\n" <<
+            "    }\n" <<
+            "    scratch[lid] = items[thread_count-1];\n" <<
+            "}\n" <<
+            "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+
+            // inclusive scan of the per-thread sums in local memory. threads
+            // without values only hold garbage in their slot which is never
+            // read by lower threads.
+            "for(uint i = 1; i < TPB; i <<= 1){\n" <<
+            "    " << decl<T>("x") << ";\n" <<
+            "    if(lid >= i){\n" <<
+            "        x = scratch[lid-i];\n" <<
+            "    }\n" <<
             "    barrier(CLK_LOCAL_MEM_FENCE);\n" <<
             "    if(lid >= i){\n" <<
-            "        scratch[lid] = " << op(var<T>("scratch[lid]"), var<T>("x")) << ";\n" <<
+            "        scratch[lid] = " << op(var<T>("x"), var<T>("scratch[lid]")) << ";\n" <<
             "    }\n" <<
             "    barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+            "}\n" <<
+
+            // publish the tile aggregate and look back at preceding tiles
+            "if(lid == 0){\n" <<
+            "    " << decl<const T>("aggregate") <<
+                     " = scratch[(tile_count + VPT - 1) / VPT - 1];\n" <<
+            "    if(tile == 0){\n" <<
+            "        prefixes[0] = aggregate;\n" <<
+            "        mem_fence(CLK_GLOBAL_MEM_FENCE);\n" <<
+            "        atomic_xchg(status + 1, PREFIX);\n" <<
+            "    }\n" <<
+            "    else {\n" <<
+            "        aggregates[tile] = aggregate;\n" <<
+            "        mem_fence(CLK_GLOBAL_MEM_FENCE);\n" <<
+            "        atomic_xchg(status + 1 + tile, AGGREGATE);\n" <<
+            "        " << decl<T>("exclusive_prefix") << ";\n" <<
+            "        " << decl<T>("value") << ";\n" <<
+            "        uint j = tile - 1;\n" <<
+            "        bool first_value = true;\n" <<
+            "        for(;;){\n" <<
+            "            uint flag;\n" <<
+            "            do {\n" <<
+            "                flag = atomic_or(status + 1 + j, 0);\n" <<
+            "            } while(flag == 0);\n" <<
+            "            mem_fence(CLK_GLOBAL_MEM_FENCE);\n" <<
+            "            if(flag == PREFIX){\n" <<
+            "                value = ((volatile __global " << type<T>() << " *) prefixes)[j];\n" <<
+            "            }\n" <<
+            "            else {\n" <<
+            "                value = ((volatile __global " << type<T>() << " *) aggregates)[j];\n" <<
+            "            }\n" <<
+            "            if(first_value){\n" <<
+            "                exclusive_prefix = value;\n" <<
+            "                first_value = false;\n" <<
+            "            }\n" <<
+            "            else {\n" <<
+            "                exclusive_prefix = " << op(var<T>("value"),
+                                                        var<T>("exclusive_prefix")) << ";\n" <<
+            "            }\n" <<
+            "            if(flag == PREFIX){\n" <<
+            "                break;\n" <<
+            "            }\n" <<
+            "            j--;\n" <<
+            "        }\n" <<
+            "        prefixes[tile] = " << op(var<T>("exclusive_prefix"),
+                                             var<T>("aggregate")) << ";\n" <<
+            "        mem_fence(CLK_GLOBAL_MEM_FENCE);\n" <<
+            "        atomic_xchg(status + 1 + tile, PREFIX);\n" <<
+            "        tile_prefix = exclusive_prefix;\n" <<
+            "    }\n" <<
+            "}\n" <<
+            "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+
+            // combine with the prefixes of the preceding threads and tiles
+            "if(thread_count > 0){\n" <<
+            "    " << decl<T>("prefix") << ";\n" <<
+            "    bool has_prefix = true;\n" <<
+            "    if(lid > 0 && tile > 0){\n" <<
+            "        prefix = " << op(var<T>("tile_prefix"), var<T>("scratch[lid-1]")) << ";\n" <<
+            "    }\n" <<
+            "    else if(lid > 0){\n" <<
+            "        prefix = scratch[lid-1];\n" <<
+            "    }\n" <<
+            "    else if(tile > 0){\n" <<
+            "        prefix = tile_prefix;\n" <<
+            "    }\n" <<
+            "    else {\n" <<
+            "        has_prefix = false;\n" <<
+            "    }\n" <<
+            "    for(uint i = 0; i < thread_count; i++){\n" <<
+            "        if(has_prefix){\n" <<
+            "            tile_values[thread_offset+i] = " <<
+                             op(var<T>("prefix"), var<T>("items[i]")) << ";\n" <<
+            "        }\n" <<
+            "        else {\n" <<
+            "            tile_values[thread_offset+i] = items[i];\n" <<
+            "        }\n" <<
+            "    }\n" <<
+            "}\n" <<
+            "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+
+            // write tile to output with coalesced writes
+            "for(uint i = 0; i < VPT; i++){\n" <<
+            "    const uint j = lid + i * TPB;\n" <<
+            "    if(j < tile_count){\n" <<
+            "        " << result[expr<uint_>("tile_offset + j")] << " = tile_values[j];\n" <<
+            "    }\n" <<
             "}\n";
-
-        // copy results to output
-        if(checked){
-            *this <<
-                "if(gid < count){\n";
-        }
-
-        *this <<
-            result[expr<cl_uint>("gid")] << " = scratch[lid];\n";
-
-        if(checked){
-            *this << "}\n";
-        }
-
-        // store sum for the block
-        if(exclusive){
-            *this <<
-                "if(lid == block_size - 1 && gid < count) {\n" <<
-                "    block_sums[get_group_id(0)] = " <<
-                       op(first[expr<cl_uint>("gid")], var<T>("scratch[lid]")) <<
-                       ";\n" <<
-                "}\n";
-        }
-        else {
-            *this <<
-                "if(lid == block_size - 1){\n" <<
-                "    block_sums[get_group_id(0)] = scratch[lid];\n" <<
-                "}\n";
-        }
-    }
-
-    size_t m_block_sums_arg;
-    size_t m_scratch_arg;
-    size_t m_block_size_arg;
-    size_t m_count_arg;
-    size_t m_init_value_arg;
-};
-
-template<class T, class BinaryOperator>
-class write_scanned_output_kernel : public meta_kernel
-{
-public:
-    write_scanned_output_kernel(BinaryOperator op)
-        : meta_kernel("write_scanned_output")
-    {
-        bool checked = true;
-
-        m_output_arg = add_arg<T *>(memory_object::global_memory, "output");
-        m_block_sums_arg = add_arg<const T *>(memory_object::global_memory, "block_sums");
-        m_count_arg = add_arg<const cl_uint>("count");
-
-        // work-item parameters
-        *this <<
-            "const uint gid = get_global_id(0);\n" <<
-            "const uint block_id = get_group_id(0);\n";
-
-        // check against data size
-        if(checked){
-            *this << "if(gid < count){\n";
-        }
-
-        // write output
-        *this <<
-            "output[gid] = " <<
-                op(var<T>("block_sums[block_id]"), var<T>("output[gid] ")) << ";\n";
-
-        if(checked){
-            *this << "}\n";
-        }
     }
 
-    size_t m_output_arg;
-    size_t m_block_sums_arg;
     size_t m_count_arg;
+    size_t m_init_arg;
+    size_t m_status_arg;
+    size_t m_aggregates_arg;
+    size_t m_prefixes_arg;
 };
 
-template<class InputIterator>
-inline size_t pick_scan_block_size(InputIterator first, InputIterator last)
-{
-    size_t count = iterator_range_size(first, last);
-
-    if(count == 0)        { return 0; }
-    else if(count <= 1)   { return 1; }
-    else if(count <= 2)   { return 2; }
-    else if(count <= 4)   { return 4; }
-    else if(count <= 8)   { return 8; }
-    else if(count <= 16)  { return 16; }
-    else if(count <= 32)  { return 32; }
-    else if(count <= 64)  { return 64; }
-    else if(count <= 128) { return 128; }
-    else                  { return 256; }
-}
-
 template<class InputIterator, class OutputIterator, class T, class BinaryOperator>
 inline OutputIterator scan_impl(InputIterator first,
                                 InputIterator last,
@@ -194,74 +238,63 @@ inline OutputIterator scan_impl(InputIterator first,
                                 command_queue &queue)
 {
     typedef typename
-        std::iterator_traits<InputIterator>::value_type
-        input_type;
-    typedef typename
-        std::iterator_traits<InputIterator>::difference_type
+        std::iterator_traits<OutputIterator>::difference_type
         difference_type;
     typedef typename
         std::iterator_traits<OutputIterator>::value_type
         output_type;
 
     const context &context = queue.get_context();
+    const device &device = queue.get_device();
     const size_t count = detail::iterator_range_size(first, last);
 
-    size_t block_size = pick_scan_block_size(first, last);
-    size_t block_count = count / block_size;
+    // load parameters
+    std::string cache_key =
+        "__boost_scan_gpu_" + boost::lexical_cast<std::string>(sizeof(output_type));
+    boost::shared_ptr<parameter_cache> parameters =
+        detail::parameter_cache::get_global_cache(device);
 
-    if(block_count * block_size < count){
-        block_count++;
-    }
+    size_t tpb = parameters->get(cache_key, "tpb", 128);
+    size_t vpt = parameters->get(cache_key, "vpt", 8);
 
-    ::boost::compute::vector<input_type> block_sums(block_count, context);
-
-    // zero block sums
-    input_type zero;
-    std::memset(&zero, 0, sizeof(input_type));
-    ::boost::compute::fill(block_sums.begin(), block_sums.end(), zero, queue);
-
-    // local scan
-    local_scan_kernel<InputIterator, OutputIterator, BinaryOperator>
-        local_scan_kernel(first, last, result, exclusive, op);
-
-    ::boost::compute::kernel kernel = local_scan_kernel.compile(context);
-    kernel.set_arg(local_scan_kernel.m_scratch_arg, local_buffer<input_type>(block_size));
-    kernel.set_arg(local_scan_kernel.m_block_sums_arg, block_sums);
-    kernel.set_arg(local_scan_kernel.m_block_size_arg, static_cast<cl_uint>(block_size));
-    kernel.set_arg(local_scan_kernel.m_count_arg, static_cast<cl_uint>(count));
-    kernel.set_arg(local_scan_kernel.m_init_value_arg, static_cast<output_type>(init));
-
-    queue.enqueue_1d_range_kernel(kernel,
-                                  0,
-                                  block_count * block_size,
-                                  block_size);
-
-    // inclusive scan block sums
-    if(block_count > 1){
-        scan_impl(block_sums.begin(),
-                  block_sums.end(),
-                  block_sums.begin(),
-                  false,
-                  init,
-                  op,
-                  queue
-        );
+    // the tile must fit in local memory and the work-group on the device
+    while(tpb > 1 && tpb > device.max_work_group_size()){
+        tpb /= 2;
     }
-
-    // add block sums to each block
-    if(block_count > 1){
-        write_scanned_output_kernel<input_type, BinaryOperator>
-            write_output_kernel(op);
-        kernel = write_output_kernel.compile(context);
-        kernel.set_arg(write_output_kernel.m_output_arg, result.get_buffer());
-        kernel.set_arg(write_output_kernel.m_block_sums_arg, block_sums);
-        kernel.set_arg(write_output_kernel.m_count_arg, static_cast<cl_uint>(count));
-
-        queue.enqueue_1d_range_kernel(kernel,
-                                      block_size,
-                                      block_count * block_size,
-                                      block_size);
+    const size_t local_memory = static_cast<size_t>(device.local_memory_size());
+    while(vpt > 1 && (tpb * (vpt + 1) + 1) * sizeof(output_type) > local_memory / 2){
+        vpt /= 2;
     }
+    while(tpb > 1 && (tpb * (vpt + 1) + 1) * sizeof(output_type) > local_memory / 2){
+        tpb /= 2;
+    }
+
+    const size_t tile_size = tpb * vpt;
+    const size_t tile_count = (count + tile_size - 1) / tile_size;
+
+    // tile counter and status flags
+    scratch_vector<uint_> status(tile_count + 1, queue);
+    ::boost::compute::fill(status.begin(), status.end(), uint_(0), queue);
+
+    scratch_vector<output_type> aggregates(tile_count, queue);
+    scratch_vector<output_type> prefixes(tile_count, queue);
+
+    single_pass_scan_kernel<InputIterator, OutputIterator, BinaryOperator>
+        scan_kernel(first, result, count, exclusive, op);
+
+    std::stringstream options;
+    options << "-DTPB=" << tpb
+            << " -DVPT=" << vpt
+            << " -DAGGREGATE=1 -DPREFIX=2";
+
+    ::boost::compute::kernel kernel = scan_kernel.compile(context, options.str());
+    scan_kernel.set_index_arg(kernel, scan_kernel.m_count_arg, count);
+    kernel.set_arg(scan_kernel.m_init_arg, static_cast<output_type>(init));
+    kernel.set_arg(scan_kernel.m_status_arg, status.get_buffer());
+    kernel.set_arg(scan_kernel.m_aggregates_arg, aggregates.get_buffer());
+    kernel.set_arg(scan_kernel.m_prefixes_arg, prefixes.get_buffer());
+
+    queue.enqueue_1d_range_kernel(kernel, 0, tile_count * tpb, tpb);
 
     return result + static_cast<difference_type>(count);
 }
@@ -289,13 +322,13 @@ inline InputIterator dispatch_scan(InputIterator first,
 {
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
 
-    if(first == result){
-        // scan input in-place
-        const context &context = queue.get_context();
-
+    // each work-group reads its whole tile before writing to it, so only an
+    // exclusive scan (which reads the last value of the preceding tile)
+    // needs a copy of the input when scanning in-place
+    if(first == result && exclusive){
         // make a temporary copy the input
         size_t count = iterator_range_size(first, last);
-        vector<value_type> tmp(count, context);
+        scratch_vector<value_type> tmp(count, queue);
         copy(first, last, tmp.begin(), queue);
 
         // scan from temporary values
@@ -0,0 +1,240 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_SELECT_TOP_K_HPP
+#define BOOST_COMPUTE_ALGORITHM_DETAIL_SELECT_TOP_K_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/copy_n.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/sort_by_key.hpp>
+#include <boost/compute/iterator/strided_iterator.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// returns true if top_k_filter() can run on ranges of count elements. the
+// candidate counter of ranges past the 32-bit limit needs 64-bit atomics.
+inline bool can_top_k_filter(const size_t count, command_queue &queue)
+{
+    return !requires_64bit_indices(count) ||
+           queue.get_device().supports_extension("cl_khr_int64_base_atomics");
+}
+
+// copies every element x of [first, first + count) for which
+// !compare(*pivot, x) holds (and, if with_indices is true, its position) to
+// the candidate buffers and returns the number of such elements. elements
+// beyond capacity are counted but not written.
+template<class InputIterator, class PivotIterator, class Compare, class IndexType>
+inline size_t top_k_filter(InputIterator first,
+                           const size_t count,
+                           PivotIterator pivot,
+                           Compare compare,
+                           const buffer_iterator<
+                               typename std::iterator_traits<InputIterator>::value_type
+                           > keys,
+                           const buffer_iterator<IndexType> indices,
+                           const size_t capacity,
+                           const bool with_indices,
+                           command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    meta_kernel k("top_k_filter");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    if(k.uses_64bit_indices()){
+        k.add_extension_pragma("cl_khr_int64_base_atomics");
+    }
+    size_t count_arg = k.add_index_arg("count");
+    size_t capacity_arg = k.add_index_arg("capacity");
+    size_t counter_arg = k.uses_64bit_indices() ?
+        k.add_arg<ulong_ *>(memory_object::global_memory, "counter") :
+        k.add_arg<uint_ *>(memory_object::global_memory, "counter");
+
+    k <<
+        "const " << index_type << " gid = get_global_id(0);\n" <<
+        "if(gid >= count){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        k.decl<const value_type>("x") << " = " <<
+            first[k.var<const uint_>("gid")] << ";\n" <<
+        k.decl<const value_type>("pivot") << " = " <<
+            pivot[k.expr<const uint_>("0")] << ";\n" <<
+        "if(!(" << compare(k.var<const value_type>("pivot"),
+                           k.var<const value_type>("x")) << ")){\n" <<
+        "    const " << index_type << " i = " <<
+            (k.uses_64bit_indices() ? "atom_inc(counter)" : "atomic_inc(counter)") <<
+            ";\n" <<
+        "    if(i < capacity){\n" <<
+        "        " << keys[k.var<const uint_>("i")] << " = x;\n";
+    if(with_indices){
+        k <<
+        "        " << indices[k.var<const uint_>("i")] << " = gid;\n";
+    }
+    k <<
+        "    }\n" <<
+        "}\n";
+
+    // ulong is large enough for both counter types
+    scratch_vector<ulong_> counter(1, queue);
+    ::boost::compute::fill(counter.begin(), counter.end(), ulong_(0), queue);
+
+    ::boost::compute::kernel kernel = k.compile(queue.get_context());
+    k.set_index_arg(kernel, count_arg, count);
+    k.set_index_arg(kernel, capacity_arg, capacity);
+    kernel.set_arg(counter_arg, counter.get_buffer());
+
+    const size_t work_group_size = (std::min)(
+        size_t(256),
+        kernel.get_work_group_info<size_t>(
+            queue.get_device(), CL_KERNEL_WORK_GROUP_SIZE
+        )
+    );
+    const size_t global_size =
+        work_group_size * ((count + work_group_size - 1) / work_group_size);
+    queue.enqueue_1d_range_kernel(kernel, 0, global_size, work_group_size);
+
+    if(k.uses_64bit_indices()){
+        return static_cast<size_t>(
+            read_single_value<ulong_>(counter.get_buffer(), queue)
+        );
+    }
+    else {
+        return read_single_value<uint_>(counter.get_buffer(), queue);
+    }
+}
+
+// writes the first k elements of [first, first + count) in the order given by
+// compare to keys_result and, if with_indices is true, their positions to
+// indices_result. IndexType must hold positions up to count.
+//
+// for small k a sorted sample of the input gives a pivot which roughly
+// oversample * k elements come before. one filter pass collects these
+// candidates and only they are sorted. if the pivot turns out to be too
+// tight (fewer than k candidates) the whole range is sorted instead.
+template<class InputIterator, class Compare, class IndexType>
+inline void select_top_k(InputIterator first,
+                         const size_t count,
+                         const size_t k,
+                         Compare compare,
+                         const buffer_iterator<
+                             typename std::iterator_traits<InputIterator>::value_type
+                         > keys_result,
+                         const buffer_iterator<IndexType> indices_result,
+                         const bool with_indices,
+                         command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    if(k == 0){
+        return;
+    }
+
+    std::string cache_key =
+        std::string("__boost_select_top_k_") + type_name<value_type>();
+    boost::shared_ptr<parameter_cache> parameters =
+        detail::parameter_cache::get_global_cache(queue.get_device());
+
+    const size_t sample_size = parameters->get(cache_key, "sample_size", 4096);
+    const size_t oversample = parameters->get(cache_key, "oversample", 2);
+
+    // the filter only pays off if a small part of the input is selected
+    if(k * 16 <= count && count >= 4 * sample_size &&
+       can_top_k_filter(count, queue)){
+        // sort an evenly spaced sample of the input
+        const size_t stride = count / sample_size;
+        scratch_vector<value_type> sample(sample_size, queue);
+        ::boost::compute::copy_n(
+            make_strided_iterator(first, stride), sample_size, sample.begin(), queue
+        );
+        ::boost::compute::sort(sample.begin(), sample.end(), compare, queue);
+
+        // the pivot is expected to have oversample * k elements before it
+        const size_t pivot_index = (std::min)(
+            sample_size - 1,
+            (oversample * k * sample_size + count - 1) / count + 4
+        );
+        size_t capacity = (std::max)(
+            2 * (pivot_index + 1) * (count / sample_size), oversample * k
+        );
+
+        for(;;){
+            scratch_vector<value_type> keys(capacity, queue);
+            scratch_vector<IndexType> indices(with_indices ? capacity : 0, queue);
+
+            const size_t candidates = top_k_filter(
+                first, count, sample.begin() + pivot_index, compare,
+                keys.begin(), indices.begin(), capacity, with_indices, queue
+            );
+
+            if(candidates < k){
+                // the pivot was too tight, sort everything instead
+                break;
+            }
+            else if(candidates > capacity){
+                // many elements are equal to the pivot, run the filter again
+                // with enough space for all of them
+                capacity = candidates;
+                continue;
+            }
+
+            if(with_indices){
+                ::boost::compute::sort_by_key(
+                    keys.begin(), keys.begin() + candidates, indices.begin(),
+                    compare, queue
+                );
+                ::boost::compute::copy_n(indices.begin(), k, indices_result, queue);
+            }
+            else {
+                ::boost::compute::sort(
+                    keys.begin(), keys.begin() + candidates, compare, queue
+                );
+            }
+            ::boost::compute::copy_n(keys.begin(), k, keys_result, queue);
+            return;
+        }
+    }
+
+    // sort a copy of the whole range
+    scratch_vector<value_type> keys(count, queue);
+    ::boost::compute::copy_n(first, count, keys.begin(), queue);
+    if(with_indices){
+        scratch_vector<IndexType> indices(count, queue);
+        ::boost::compute::iota(indices.begin(), indices.end(), IndexType(0), queue);
+        ::boost::compute::sort_by_key(
+            keys.begin(), keys.end(), indices.begin(), compare, queue
+        );
+        ::boost::compute::copy_n(indices.begin(), k, indices_result, queue);
+    }
+    else {
+        ::boost::compute::sort(keys.begin(), keys.end(), compare, queue);
+    }
+    ::boost::compute::copy_n(keys.begin(), k, keys_result, queue);
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_DETAIL_SELECT_TOP_K_HPP
@@ -31,12 +31,13 @@ inline void serial_accumulate(InputIterator first,
     size_t count = detail::iterator_range_size(first, last);
 
     meta_kernel k("serial_accumulate");
+    k.set_index_type_for(count);
     size_t init_arg = k.add_arg<T>("init");
-    size_t count_arg = k.add_arg<cl_uint>("count");
+    size_t count_arg = k.add_index_arg("count");
 
     k <<
         k.decl<T>("result") << " = init;\n" <<
-        "for(uint i = 0; i < count; i++)\n" <<
+        "for(" << k.index_type() << " i = 0; i < count; i++)\n" <<
         "    result = " << function(k.var<T>("result"),
                                     first[k.var<cl_uint>("i")]) << ";\n" <<
         result[0] << " = result;\n";
@@ -44,7 +45,7 @@ inline void serial_accumulate(InputIterator first,
     kernel kernel = k.compile(context);
 
     kernel.set_arg(init_arg, init);
-    kernel.set_arg(count_arg, static_cast<cl_uint>(count));
+    k.set_index_arg(kernel, count_arg, count);
 
     queue.enqueue_task(kernel);
 }
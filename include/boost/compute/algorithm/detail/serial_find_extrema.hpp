@@ -11,6 +11,8 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_DETAIL_SERIAL_FIND_EXTREMA_HPP
 #define BOOST_COMPUTE_ALGORITHM_DETAIL_SERIAL_FIND_EXTREMA_HPP
 
+#include <string>
+
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/types/fundamental.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
@@ -21,24 +23,31 @@ namespace boost {
 namespace compute {
 namespace detail {
 
+// enqueues a single work-item kernel which writes the index of the first
+// extremum of [first, last) to the start of index. the index is a ulong_
+// if requires_64bit_indices() is true for the size of the range and a
+// uint_ otherwise.
 template<class InputIterator, class Compare>
-inline InputIterator serial_find_extrema(InputIterator first,
-                                         InputIterator last,
-                                         Compare compare,
-                                         const bool find_minimum,
-                                         command_queue &queue)
+inline void serial_find_extrema_index(InputIterator first,
+                                      InputIterator last,
+                                      Compare compare,
+                                      const bool find_minimum,
+                                      const buffer &index,
+                                      command_queue &queue)
 {
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
-    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
 
     const context &context = queue.get_context();
+    size_t count = iterator_range_size(first, last);
 
     meta_kernel k("serial_find_extrema");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
 
     k <<
         k.decl<value_type>("value") << " = " << first[k.expr<uint_>("0")] << ";\n" <<
-        k.decl<uint_>("value_index") << " = 0;\n" <<
-        "for(uint i = 1; i < size; i++){\n" <<
+        index_type << " value_index = 0;\n" <<
+        "for(" << index_type << " i = 1; i < size; i++){\n" <<
         "  " << k.decl<value_type>("candidate") << "="
              << first[k.expr<uint_>("i")] << ";\n" <<
 
@@ -56,8 +65,10 @@ inline InputIterator serial_find_extrema(InputIterator first,
         "}\n" <<
         "*index = value_index;\n";
 
-    size_t index_arg_index = k.add_arg<uint_ *>(memory_object::global_memory, "index");
-    size_t size_arg_index = k.add_arg<uint_>("size");
+    size_t index_arg_index = k.uses_64bit_indices() ?
+        k.add_arg<ulong_ *>(memory_object::global_memory, "index") :
+        k.add_arg<uint_ *>(memory_object::global_memory, "index");
+    size_t size_arg_index = k.add_index_arg("size");
 
     std::string options;
     if(!find_minimum){
@@ -66,20 +77,51 @@ inline InputIterator serial_find_extrema(InputIterator first,
     kernel kernel = k.compile(context, options);
 
     // setup index buffer
-    scalar<uint_> index(context);
-    kernel.set_arg(index_arg_index, index.get_buffer());
+    kernel.set_arg(index_arg_index, index);
 
     // setup count
-    size_t count = iterator_range_size(first, last);
-    kernel.set_arg(size_arg_index, static_cast<uint_>(count));
+    k.set_index_arg(kernel, size_arg_index, count);
 
     // run kernel
     queue.enqueue_task(kernel);
+}
+
+template<class IndexType, class InputIterator, class Compare>
+inline InputIterator serial_find_extrema_with_index_type(InputIterator first,
+                                                         InputIterator last,
+                                                         Compare compare,
+                                                         const bool find_minimum,
+                                                         command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::difference_type difference_type;
+
+    scalar<IndexType> index(queue.get_context());
+    serial_find_extrema_index(
+        first, last, compare, find_minimum, index.get_buffer(), queue
+    );
 
     // read index and return iterator
     return first + static_cast<difference_type>(index.read(queue));
 }
 
+template<class InputIterator, class Compare>
+inline InputIterator serial_find_extrema(InputIterator first,
+                                         InputIterator last,
+                                         Compare compare,
+                                         const bool find_minimum,
+                                         command_queue &queue)
+{
+    if(requires_64bit_indices(iterator_range_size(first, last))){
+        return serial_find_extrema_with_index_type<ulong_>(
+            first, last, compare, find_minimum, queue
+        );
+    }
+
+    return serial_find_extrema_with_index_type<uint_>(
+        first, last, compare, find_minimum, queue
+    );
+}
+
 } // end detail namespace
 } // end compute namespace
 } // end boost namespace
@@ -40,18 +40,19 @@ inline void serial_reduce(InputIterator first,
     }
 
     meta_kernel k("serial_reduce");
-    size_t count_arg = k.add_arg<cl_uint>("count");
+    k.set_index_type_for(count);
+    size_t count_arg = k.add_index_arg("count");
 
     k <<
         k.decl<result_type>("result") << " = " << first[0] << ";\n" <<
-        "for(uint i = 1; i < count; i++)\n" <<
+        "for(" << k.index_type() << " i = 1; i < count; i++)\n" <<
         "    result = " << function(k.var<T>("result"),
                                     first[k.var<uint_>("i")]) << ";\n" <<
         result[0] << " = result;\n";
 
     kernel kernel = k.compile(context);
 
-    kernel.set_arg(count_arg, static_cast<uint_>(count));
+    k.set_index_arg(kernel, count_arg, count);
 
     queue.enqueue_task(kernel);
 }
@@ -16,9 +16,11 @@
 #include <boost/compute/lambda.hpp>
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/find_if.hpp>
 #include <boost/compute/type_traits/vector_size.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -57,6 +59,40 @@ inline InputIterator find(InputIterator first,
     }
 }
 
+/// Asynchronous version of find(). The search is enqueued after \p events
+/// and the position of the element is kept in device memory until \c get()
+/// is called on the returned future.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see find()
+template<class InputIterator, class T>
+inline future<InputIterator>
+find_async(InputIterator first,
+           InputIterator last,
+           const T &value,
+           command_queue &queue = system::default_queue(),
+           const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    using ::boost::compute::_1;
+    using ::boost::compute::lambda::all;
+
+    if(vector_size<value_type>::value == 1){
+        return ::boost::compute::find_if_async(
+                   first, last, _1 == value, queue, events
+               );
+    }
+    else {
+        return ::boost::compute::find_if_async(
+                   first, last, all(_1 == value), queue, events
+               );
+    }
+}
+
 } // end compute namespace
 } // end boost namespace
 
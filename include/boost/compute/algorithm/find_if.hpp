@@ -15,8 +15,11 @@
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/detail/find_if_with_atomics.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -35,6 +38,30 @@ inline InputIterator find_if(InputIterator first,
     return detail::find_if_with_atomics(first, last, predicate, queue);
 }
 
+/// Asynchronous version of find_if(). The search is enqueued after
+/// \p events and the position of the element is kept in device memory.
+/// It is only read and turned into an iterator when \c get() is called on
+/// the returned future.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see find_if()
+template<class InputIterator, class UnaryPredicate>
+inline future<InputIterator>
+find_if_async(InputIterator first,
+              InputIterator last,
+              UnaryPredicate predicate,
+              command_queue &queue = system::default_queue(),
+              const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    detail::enqueue_wait_list(queue, events);
+
+    return detail::find_if_with_atomics_async(first, last, predicate, queue);
+}
+
 } // end compute namespace
 } // end boost namespace
 
@@ -11,13 +11,19 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_INCLUSIVE_SCAN_HPP
 #define BOOST_COMPUTE_ALGORITHM_INCLUSIVE_SCAN_HPP
 
+#include <vector>
+
 #include <boost/static_assert.hpp>
 
 #include <boost/compute/functional.hpp>
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
+#include <boost/compute/algorithm/detail/multi_queue_scan.hpp>
 #include <boost/compute/algorithm/detail/scan.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -86,6 +92,99 @@ inclusive_scan(InputIterator first,
                         queue);
 }
 
+/// Performs an inclusive scan of the range [\p first, \p last) using all
+/// of the command queues in \p queues.
+///
+/// The range is split into one chunk for each queue. Each chunk is reduced
+/// and then scanned by its own queue, starting from the combined values of
+/// the chunks before it. The queues must share the context of the ranges.
+/// The scan starts once the commands already enqueued to any of the queues
+/// have completed and commands enqueued to the first queue after this call
+/// run once the whole range is scanned.
+///
+/// \see inclusive_scan(), reduce()
+template<class InputIterator, class OutputIterator, class BinaryOperator>
+inline OutputIterator
+inclusive_scan(InputIterator first,
+               InputIterator last,
+               OutputIterator result,
+               BinaryOperator binary_op,
+               std::vector<command_queue> &queues)
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+    typedef typename
+        std::iterator_traits<OutputIterator>::value_type output_type;
+
+    return detail::multi_queue_scan(first, last, result, false,
+                                    output_type(0), binary_op,
+                                    queues);
+}
+
+/// \overload
+template<class InputIterator, class OutputIterator>
+inline OutputIterator
+inclusive_scan(InputIterator first,
+               InputIterator last,
+               OutputIterator result,
+               std::vector<command_queue> &queues)
+{
+    typedef typename
+        std::iterator_traits<OutputIterator>::value_type output_type;
+
+    return ::boost::compute::inclusive_scan(
+        first, last, result, boost::compute::plus<output_type>(), queues
+    );
+}
+
+/// Asynchronous version of inclusive_scan(). The scan is enqueued after
+/// \p events and the returned future holds the end of the result range.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see inclusive_scan()
+template<class InputIterator, class OutputIterator, class BinaryOperator>
+inline future<OutputIterator>
+inclusive_scan_async(InputIterator first,
+                     InputIterator last,
+                     OutputIterator result,
+                     BinaryOperator binary_op,
+                     command_queue &queue = system::default_queue(),
+                     const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+    typedef typename
+        std::iterator_traits<OutputIterator>::value_type output_type;
+
+    detail::enqueue_wait_list(queue, events);
+
+    return detail::make_queue_future(
+        detail::scan(first, last, result, false,
+                     output_type(0), binary_op,
+                     queue),
+        queue
+    );
+}
+
+/// \overload
+template<class InputIterator, class OutputIterator>
+inline future<OutputIterator>
+inclusive_scan_async(InputIterator first,
+                     InputIterator last,
+                     OutputIterator result,
+                     command_queue &queue = system::default_queue(),
+                     const wait_list &events = wait_list())
+{
+    typedef typename
+        std::iterator_traits<OutputIterator>::value_type output_type;
+
+    return ::boost::compute::inclusive_scan_async(
+        first, last, result, boost::compute::plus<output_type>(), queue, events
+    );
+}
+
 } // end compute namespace
 } // end boost namespace
 
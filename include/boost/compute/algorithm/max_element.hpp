@@ -16,8 +16,11 @@
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/functional.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/detail/find_extrema.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -76,6 +79,44 @@ max_element(InputIterator first,
     );
 }
 
+/// Asynchronous version of max_element(). The search is enqueued after
+/// \p events and the position of the element is kept in device memory
+/// until \c get() is called on the returned future.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see max_element()
+template<class InputIterator, class Compare>
+inline future<InputIterator>
+max_element_async(InputIterator first,
+                  InputIterator last,
+                  Compare compare,
+                  command_queue &queue = system::default_queue(),
+                  const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    detail::enqueue_wait_list(queue, events);
+
+    return detail::find_extrema_async(first, last, compare, false, queue);
+}
+
+/// \overload
+template<class InputIterator>
+inline future<InputIterator>
+max_element_async(InputIterator first,
+                  InputIterator last,
+                  command_queue &queue = system::default_queue(),
+                  const wait_list &events = wait_list())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    return ::boost::compute::max_element_async(
+        first, last, ::boost::compute::less<value_type>(), queue, events
+    );
+}
+
 } // end compute namespace
 } // end boost namespace
 
@@ -0,0 +1,75 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_MEDIAN_HPP
+#define BOOST_COMPUTE_ALGORITHM_MEDIAN_HPP
+
+#include <iterator>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/algorithm/percentile.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+
+/// Returns the median of the values in the range [\p first, \p last) in the
+/// order given by \p compare. For an even number of elements the lower of
+/// the two middle elements is returned. The range must not be empty.
+///
+/// The input range is not modified (see percentile()).
+///
+/// \param first first element in the input range
+/// \param last last element in the input range
+/// \param compare comparison function (by default \c less)
+/// \param queue command queue to perform the operation
+///
+/// Space complexity: \Omega(1) for radix-sortable types, \Omega(n) otherwise
+///
+/// \see percentile(), nth_element()
+template<class InputIterator, class Compare>
+inline typename std::iterator_traits<InputIterator>::value_type
+median(InputIterator first,
+       InputIterator last,
+       Compare compare,
+       command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    const size_t count = detail::iterator_range_size(first, last);
+    BOOST_ASSERT(count > 0);
+
+    return ::boost::compute::detail::dispatch_select_value(
+        first, last, (count - 1) / 2, compare, queue
+    );
+}
+
+/// \overload
+template<class InputIterator>
+inline typename std::iterator_traits<InputIterator>::value_type
+median(InputIterator first,
+       InputIterator last,
+       command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    return ::boost::compute::median(first, last, less<value_type>(), queue);
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_MEDIAN_HPP
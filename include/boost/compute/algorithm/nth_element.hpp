@@ -12,32 +12,35 @@
 #define BOOST_COMPUTE_ALGORITHM_NTH_ELEMENT_HPP
 
 #include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
 
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/fill_n.hpp>
 #include <boost/compute/algorithm/find.hpp>
 #include <boost/compute/algorithm/partition.hpp>
 #include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/detail/radix_select.hpp>
+#include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/functional/bind.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
+namespace detail {
 
-/// Rearranges the elements in the range [\p first, \p last) such that
-/// the \p nth element would be in that position in a sorted sequence.
-///
-/// Space complexity: \Omega(3n)
+// quickselect around the value at nth, used for comparators and iterators
+// the radix select does not handle
 template<class Iterator, class Compare>
-inline void nth_element(Iterator first,
-                        Iterator nth,
-                        Iterator last,
-                        Compare compare,
-                        command_queue &queue = system::default_queue())
+inline void dispatch_nth_element(Iterator first,
+                                 Iterator nth,
+                                 Iterator last,
+                                 Compare compare,
+                                 command_queue &queue)
 {
-    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
-    if(nth == last) return;
-
     typedef typename std::iterator_traits<Iterator>::value_type value_type;
 
     while(1)
@@ -45,16 +48,16 @@ inline void nth_element(Iterator first,
         value_type value = nth.read(queue);
 
         using boost::compute::placeholders::_1;
-        Iterator new_nth = partition(
+        Iterator new_nth = ::boost::compute::partition(
             first, last, ::boost::compute::bind(compare, _1, value), queue
         );
 
-        Iterator old_nth = find(new_nth, last, value, queue);
+        Iterator old_nth = ::boost::compute::find(new_nth, last, value, queue);
 
         value_type new_value = new_nth.read(queue);
 
-        fill_n(new_nth, 1, value, queue);
-        fill_n(old_nth, 1, new_value, queue);
+        ::boost::compute::fill_n(new_nth, 1, value, queue);
+        ::boost::compute::fill_n(old_nth, 1, new_value, queue);
 
         new_value = nth.read(queue);
 
@@ -71,6 +74,103 @@ inline void nth_element(Iterator first,
     }
 }
 
+template<class T>
+inline void dispatch_nth_element(buffer_iterator<T> first,
+                                 buffer_iterator<T> nth,
+                                 buffer_iterator<T> last,
+                                 less<T>,
+                                 command_queue &queue,
+                                 typename boost::enable_if_c<
+                                     is_radix_sortable<T>::value
+                                 >::type* = 0)
+{
+    ::boost::compute::detail::radix_nth_element(first, nth, last, true, queue);
+}
+
+template<class T>
+inline void dispatch_nth_element(buffer_iterator<T> first,
+                                 buffer_iterator<T> nth,
+                                 buffer_iterator<T> last,
+                                 greater<T>,
+                                 command_queue &queue,
+                                 typename boost::enable_if_c<
+                                     is_radix_sortable<T>::value
+                                 >::type* = 0)
+{
+    ::boost::compute::detail::radix_nth_element(first, nth, last, false, queue);
+}
+
+// nth_element_async() for comparators and iterators the radix select does not
+// handle. the quickselect reads the pivots back, so this waits for the device.
+template<class Iterator, class Compare>
+inline void dispatch_nth_element_async(Iterator first,
+                                       Iterator nth,
+                                       Iterator last,
+                                       Compare compare,
+                                       command_queue &queue)
+{
+    dispatch_nth_element(first, nth, last, compare, queue);
+}
+
+template<class T>
+inline void dispatch_nth_element_async(buffer_iterator<T> first,
+                                       buffer_iterator<T> nth,
+                                       buffer_iterator<T> last,
+                                       less<T>,
+                                       command_queue &queue,
+                                       typename boost::enable_if_c<
+                                           is_radix_sortable<T>::value
+                                       >::type* = 0)
+{
+    ::boost::compute::detail::radix_nth_element(
+        first, nth, last, true, false, queue
+    );
+}
+
+template<class T>
+inline void dispatch_nth_element_async(buffer_iterator<T> first,
+                                       buffer_iterator<T> nth,
+                                       buffer_iterator<T> last,
+                                       greater<T>,
+                                       command_queue &queue,
+                                       typename boost::enable_if_c<
+                                           is_radix_sortable<T>::value
+                                       >::type* = 0)
+{
+    ::boost::compute::detail::radix_nth_element(
+        first, nth, last, false, false, queue
+    );
+}
+
+} // end detail namespace
+
+/// Rearranges the elements in the range [\p first, \p last) such that
+/// the \p nth element would be in that position in a sorted sequence.
+///
+/// For radix-sortable types with \c less or \c greater comparison the
+/// element is found with a radix select: each digit of its key is narrowed
+/// down on the device from a histogram of the matching keys, and only the
+/// elements on the wrong side of it are moved afterwards. Other types and
+/// comparators use a quickselect.
+///
+/// Space complexity: \Omega(3n)
+///
+/// \see median(), percentile()
+template<class Iterator, class Compare>
+inline void nth_element(Iterator first,
+                        Iterator nth,
+                        Iterator last,
+                        Compare compare,
+                        command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
+    if(nth == last) return;
+
+    ::boost::compute::detail::dispatch_nth_element(
+        first, nth, last, compare, queue
+    );
+}
+
 /// \overload
 template<class Iterator>
 inline void nth_element(Iterator first,
@@ -88,6 +188,58 @@ inline void nth_element(Iterator first,
     return nth_element(first, nth, last, less_than, queue);
 }
 
+/// Asynchronous version of nth_element(). The commands are enqueued after
+/// \p events and the returned future is ready once the range is
+/// rearranged.
+///
+/// For radix-sortable types with \c less or \c greater comparison nothing
+/// is read back to the host. The lists of misplaced elements are then sized
+/// for the worst case of half of the range each, instead of for the actual
+/// number of misplaced elements.
+/// The quickselect used for other types and comparators reads its pivots
+/// back and blocks the host until it is done.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see nth_element()
+template<class Iterator, class Compare>
+inline future<void>
+nth_element_async(Iterator first,
+                  Iterator nth,
+                  Iterator last,
+                  Compare compare,
+                  command_queue &queue = system::default_queue(),
+                  const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
+
+    ::boost::compute::detail::enqueue_wait_list(queue, events);
+    if(nth != last){
+        ::boost::compute::detail::dispatch_nth_element_async(
+            first, nth, last, compare, queue
+        );
+    }
+
+    return future<void>(queue.enqueue_marker());
+}
+
+/// \overload
+template<class Iterator>
+inline future<void>
+nth_element_async(Iterator first,
+                  Iterator nth,
+                  Iterator last,
+                  command_queue &queue = system::default_queue(),
+                  const wait_list &events = wait_list())
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    return ::boost::compute::nth_element_async(
+        first, nth, last, less<value_type>(), queue, events
+    );
+}
+
 } // end compute namespace
 } // end boost namespace
 
@@ -0,0 +1,204 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_PARTIAL_SORT_HPP
+#define BOOST_COMPUTE_ALGORITHM_PARTIAL_SORT_HPP
+
+#include <iterator>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/algorithm/gather.hpp>
+#include <boost/compute/algorithm/scatter.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/detail/select_top_k.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// given the positions of the k selected elements, finds the positions in
+// [0, k) which hold elements that were not selected (sources) and the
+// positions at or after k which held selected elements (targets). both lists
+// have the same length, which is returned. k must fit into 32-bit indices,
+// the positions are of type IndexType.
+template<class IndexType>
+inline size_t partial_sort_displaced(const buffer_iterator<IndexType> selected,
+                                     const size_t k,
+                                     const buffer_iterator<IndexType> sources,
+                                     const buffer_iterator<IndexType> targets,
+                                     command_queue &queue)
+{
+    BOOST_ASSERT(!requires_64bit_indices(k));
+
+    scratch_vector<uint_> flags(k, queue);
+    scratch_vector<uint_> counters(2, queue);
+    ::boost::compute::fill(flags.begin(), flags.end(), uint_(0), queue);
+    ::boost::compute::fill(counters.begin(), counters.end(), uint_(0), queue);
+
+    meta_kernel mark("partial_sort_mark_selected");
+    size_t mark_k_arg = mark.add_arg<const uint_>("k");
+    size_t mark_counters_arg =
+        mark.add_arg<uint_ *>(memory_object::global_memory, "counters");
+    mark <<
+        "const uint i = get_global_id(0);\n" <<
+        "const " << type_name<IndexType>() << " index = " <<
+            selected[mark.var<const uint_>("i")] << ";\n" <<
+        "if(index < k){\n" <<
+        "    " << flags.begin()[mark.var<const uint_>("index")] << " = 1;\n" <<
+        "}\n" <<
+        "else {\n" <<
+        "    " << targets[mark.expr<const uint_>("atomic_inc(counters)")] <<
+            " = index;\n" <<
+        "}\n";
+
+    ::boost::compute::kernel mark_kernel = mark.compile(queue.get_context());
+    mark_kernel.set_arg(mark_k_arg, static_cast<uint_>(k));
+    mark_kernel.set_arg(mark_counters_arg, counters.get_buffer());
+    queue.enqueue_1d_range_kernel(mark_kernel, 0, k, 0);
+
+    meta_kernel find("partial_sort_find_displaced");
+    size_t find_counters_arg =
+        find.add_arg<uint_ *>(memory_object::global_memory, "counters");
+    find <<
+        "const uint i = get_global_id(0);\n" <<
+        "if(" << flags.begin()[find.var<const uint_>("i")] << " == 0){\n" <<
+        "    " << sources[find.expr<const uint_>("atomic_inc(counters + 1)")] <<
+            " = i;\n" <<
+        "}\n";
+
+    ::boost::compute::kernel find_kernel = find.compile(queue.get_context());
+    find_kernel.set_arg(find_counters_arg, counters.get_buffer());
+    queue.enqueue_1d_range_kernel(find_kernel, 0, k, 0);
+
+    return read_single_value<uint_>(counters.get_buffer(), 0, queue);
+}
+
+// partial_sort() of a range whose positions are of type IndexType
+template<class IndexType, class Iterator, class Compare>
+inline void partial_sort_with_index_type(Iterator first,
+                                         const size_t count,
+                                         const size_t k,
+                                         Compare compare,
+                                         command_queue &queue)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    scratch_vector<value_type> keys(k, queue);
+    scratch_vector<IndexType> indices(k, queue);
+    select_top_k(
+        first, count, k, compare, keys.begin(), indices.begin(), true, queue
+    );
+
+    // move the elements which were not selected out of [first, middle)
+    // to the positions of the selected elements after middle
+    scratch_vector<IndexType> sources(k, queue);
+    scratch_vector<IndexType> targets(k, queue);
+    const size_t displaced = partial_sort_displaced(
+        indices.begin(), k, sources.begin(), targets.begin(), queue
+    );
+
+    scratch_vector<value_type> displaced_values(displaced, queue);
+    if(displaced > 0){
+        ::boost::compute::gather(
+            sources.begin(), sources.begin() + displaced, first,
+            displaced_values.begin(), queue
+        );
+    }
+    ::boost::compute::copy(keys.begin(), keys.end(), first, queue);
+    if(displaced > 0){
+        ::boost::compute::scatter(
+            displaced_values.begin(), displaced_values.end(), targets.begin(),
+            first, queue
+        );
+    }
+}
+
+} // end detail namespace
+
+/// Rearranges the elements in the range [\p first, \p last) such that the
+/// range [\p first, \p middle) contains the first (\p middle - \p first)
+/// elements in the order given by \p compare, sorted. The order of the
+/// elements in the range [\p middle, \p last) is unspecified.
+///
+/// When (\p middle - \p first) is small compared to the size of the range,
+/// partial_sort() reads the input about once and only sorts a few
+/// candidate elements (see top_k()). Otherwise the whole range is sorted.
+///
+/// \param first first element in the range
+/// \param middle end of the sorted part of the range
+/// \param last last element in the range
+/// \param compare comparison function (by default \c less)
+/// \param queue command queue to perform the operation
+///
+/// Space complexity: \Omega(k) where k is (\p middle - \p first)
+///
+/// \see sort(), partial_sort_copy(), top_k()
+template<class Iterator, class Compare>
+inline void partial_sort(Iterator first,
+                         Iterator middle,
+                         Iterator last,
+                         Compare compare,
+                         command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
+
+    const size_t count = detail::iterator_range_size(first, last);
+    const size_t k = detail::iterator_range_size(first, middle);
+    if(k == 0){
+        return;
+    }
+    else if(k * 16 > count || detail::requires_64bit_indices(k)){
+        ::boost::compute::sort(first, last, compare, queue);
+        return;
+    }
+
+    if(detail::requires_64bit_indices(count)){
+        detail::partial_sort_with_index_type<ulong_>(
+            first, count, k, compare, queue
+        );
+    }
+    else {
+        detail::partial_sort_with_index_type<uint_>(
+            first, count, k, compare, queue
+        );
+    }
+}
+
+/// \overload
+template<class Iterator>
+inline void partial_sort(Iterator first,
+                         Iterator middle,
+                         Iterator last,
+                         command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    ::boost::compute::partial_sort(
+        first, middle, last, less<value_type>(), queue
+    );
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_PARTIAL_SORT_HPP
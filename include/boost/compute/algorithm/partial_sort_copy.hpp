@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_PARTIAL_SORT_COPY_HPP
+#define BOOST_COMPUTE_ALGORITHM_PARTIAL_SORT_COPY_HPP
+
+#include <iterator>
+
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/algorithm/top_k.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+
+/// Copies the first N elements of the range [\p first, \p last) in the order
+/// given by \p compare to the range [\p result_first, \p result_first + N)
+/// sorted, where N is the smaller of the sizes of the input range and of the
+/// range [\p result_first, \p result_last).
+///
+/// \param first first element in the input range
+/// \param last last element in the input range
+/// \param result_first first element in the result range
+/// \param result_last last element in the result range
+/// \param compare comparison function (by default \c less)
+/// \param queue command queue to perform the operation
+///
+/// \return \c OutputIterator to the end of the copied elements
+///
+/// Space complexity: \Omega(N)
+///
+/// \see partial_sort(), top_k()
+template<class InputIterator, class OutputIterator, class Compare>
+inline OutputIterator partial_sort_copy(InputIterator first,
+                                        InputIterator last,
+                                        OutputIterator result_first,
+                                        OutputIterator result_last,
+                                        Compare compare,
+                                        command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+    return ::boost::compute::top_k(
+        first, last,
+        detail::iterator_range_size(result_first, result_last),
+        result_first, compare, queue
+    );
+}
+
+/// \overload
+template<class InputIterator, class OutputIterator>
+inline OutputIterator partial_sort_copy(InputIterator first,
+                                        InputIterator last,
+                                        OutputIterator result_first,
+                                        OutputIterator result_last,
+                                        command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    return ::boost::compute::partial_sort_copy(
+        first, last, result_first, result_last, less<value_type>(), queue
+    );
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_PARTIAL_SORT_COPY_HPP
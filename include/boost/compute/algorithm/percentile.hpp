@@ -0,0 +1,158 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_PERCENTILE_HPP
+#define BOOST_COMPUTE_ALGORITHM_PERCENTILE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/algorithm/copy_n.hpp>
+#include <boost/compute/algorithm/nth_element.hpp>
+#include <boost/compute/algorithm/detail/radix_select.hpp>
+#include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// returns the element of rank rank in the order given by compare. the
+// input range is not modified.
+template<class InputIterator, class Compare>
+inline typename std::iterator_traits<InputIterator>::value_type
+dispatch_select_value(InputIterator first,
+                      InputIterator last,
+                      const size_t rank,
+                      Compare compare,
+                      command_queue &queue)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    const size_t count = detail::iterator_range_size(first, last);
+    scratch_vector<value_type> values(count, queue);
+    ::boost::compute::copy_n(first, count, values.begin(), queue);
+    ::boost::compute::nth_element(
+        values.begin(), values.begin() + rank, values.end(), compare, queue
+    );
+    return (values.begin() + rank).read(queue);
+}
+
+template<class T>
+inline T dispatch_select_value(buffer_iterator<T> first,
+                               buffer_iterator<T> last,
+                               const size_t rank,
+                               less<T>,
+                               command_queue &queue,
+                               typename boost::enable_if_c<
+                                   is_radix_sortable<T>::value
+                               >::type* = 0)
+{
+    return radix_select_value(first, last, rank, true, queue);
+}
+
+template<class T>
+inline T dispatch_select_value(buffer_iterator<T> first,
+                               buffer_iterator<T> last,
+                               const size_t rank,
+                               greater<T>,
+                               command_queue &queue,
+                               typename boost::enable_if_c<
+                                   is_radix_sortable<T>::value
+                               >::type* = 0)
+{
+    return radix_select_value(first, last, rank, false, queue);
+}
+
+} // end detail namespace
+
+/// Returns the \p p-th percentile of the values in the range
+/// [\p first, \p last) in the order given by \p compare, using the
+/// nearest-rank method: the smallest element such that at least \p p percent
+/// of the elements are not after it. \p p must be in [0, 100] and the range
+/// must not be empty.
+///
+/// The input range is not modified. For radix-sortable types with \c less or
+/// \c greater comparison the value is found with a radix select directly on
+/// the input (see nth_element()) and the host only waits once for the result.
+/// Otherwise a copy of the range is partitioned with nth_element().
+///
+/// For example, to get the 99th percentile of a set of latencies:
+/// \code
+/// float p99 = boost::compute::percentile(
+///     latencies.begin(), latencies.end(), 99.0, queue
+/// );
+/// \endcode
+///
+/// \param first first element in the input range
+/// \param last last element in the input range
+/// \param p percentile to compute
+/// \param compare comparison function (by default \c less)
+/// \param queue command queue to perform the operation
+///
+/// Space complexity: \Omega(1) for radix-sortable types, \Omega(n) otherwise
+///
+/// \see median(), nth_element()
+template<class InputIterator, class Compare>
+inline typename std::iterator_traits<InputIterator>::value_type
+percentile(InputIterator first,
+           InputIterator last,
+           double p,
+           Compare compare,
+           command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    const size_t count = detail::iterator_range_size(first, last);
+    BOOST_ASSERT(count > 0);
+    BOOST_ASSERT(p >= 0.0 && p <= 100.0);
+
+    // nearest rank, counted from one
+    const double nearest_rank = std::ceil(p / 100.0 * static_cast<double>(count));
+    size_t rank = 0;
+    if(nearest_rank > 1.0){
+        rank = (std::min)(static_cast<size_t>(nearest_rank) - 1, count - 1);
+    }
+
+    return ::boost::compute::detail::dispatch_select_value(
+        first, last, rank, compare, queue
+    );
+}
+
+/// \overload
+template<class InputIterator>
+inline typename std::iterator_traits<InputIterator>::value_type
+percentile(InputIterator first,
+           InputIterator last,
+           double p,
+           command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    return ::boost::compute::percentile(
+        first, last, p, less<value_type>(), queue
+    );
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_PERCENTILE_HPP
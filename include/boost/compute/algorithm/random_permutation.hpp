@@ -0,0 +1,172 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_RANDOM_PERMUTATION_HPP
+#define BOOST_COMPUTE_ALGORITHM_RANDOM_PERMUTATION_HPP
+
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/iterator/counting_iterator.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// number of feistel rounds (and of round keys)
+const size_t random_permutation_rounds = 8;
+
+// bijection on [0, 2^(left_bits + right_bits)) built from an unbalanced
+// feistel network. the halves swap widths after every round. each half has
+// at most 32 bits, INDEX_T (uint or ulong) holds the whole value.
+const char random_permutation_feistel_source[] =
+"inline uint random_permutation_round(uint x, const uint key)\n"
+"{\n"
+"    x ^= key;\n"
+"    x *= 0x9e3779b1;\n"
+"    x ^= x >> 15;\n"
+"    x *= 0x85ebca6b;\n"
+"    x ^= x >> 13;\n"
+"    return x;\n"
+"}\n"
+"INDEX_T random_permutation_feistel(const INDEX_T x,\n"
+"                                   uint left_bits,\n"
+"                                   uint right_bits,\n"
+"                                   __global const uint *keys)\n"
+"{\n"
+"    uint left = (uint)(x >> right_bits);\n"
+"    uint right = (uint)(x & ((((INDEX_T)(1)) << right_bits) - 1));\n"
+"    for(uint i = 0; i < ROUNDS; i++){\n"
+"        const uint new_right =\n"
+"            (left ^ random_permutation_round(right, keys[i])) &\n"
+"            (uint)((((ulong)(1)) << left_bits) - 1);\n"
+"        left = right;\n"
+"        right = new_right;\n"
+"        const uint bits = left_bits;\n"
+"        left_bits = right_bits;\n"
+"        right_bits = bits;\n"
+"    }\n"
+"    return (((INDEX_T)(left)) << right_bits) | right;\n"
+"}\n";
+
+// writes input[p(i)] to output[i] for i in [0, count), where p is the
+// pseudo-random permutation of [0, count) given by the round keys. p is the
+// feistel bijection on the smallest power of two domain holding count,
+// restricted to [0, count) by cycle walking (applying it again until the
+// result is in range), which takes less than two rounds on average.
+template<class InputIterator, class OutputIterator>
+inline void random_permute(InputIterator input,
+                           OutputIterator output,
+                           const size_t count,
+                           const buffer_iterator<uint_> keys,
+                           command_queue &queue)
+{
+    if(count == 0){
+        return;
+    }
+
+    uint_ bits = 0;
+    while(bits < 64 && (static_cast<ulong_>(1) << bits) < count){
+        bits++;
+    }
+
+    meta_kernel k("random_permute");
+    k.set_index_type_for(count);
+    size_t count_arg = k.add_index_arg("count");
+    size_t left_bits_arg = k.add_arg<const uint_>("left_bits");
+    size_t right_bits_arg = k.add_arg<const uint_>("right_bits");
+    size_t keys_arg =
+        k.add_arg<const uint_ *>(memory_object::global_memory, "keys");
+    k.add_function(
+        "random_permutation_feistel",
+        std::string("#define ROUNDS ") +
+            boost::lexical_cast<std::string>(random_permutation_rounds) + "\n" +
+            "#define INDEX_T " + k.index_type() + "\n" +
+            random_permutation_feistel_source
+    );
+
+    k <<
+        "const " << k.index_type() << " i = get_global_id(0);\n" <<
+        "if(i >= count){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        k.index_type() << " p = i;\n" <<
+        "do {\n" <<
+        "    p = random_permutation_feistel(p, left_bits, right_bits, keys);\n" <<
+        "} while(p >= count);\n" <<
+        output[k.var<const uint_>("i")] << " = " <<
+            input[k.var<const uint_>("p")] << ";\n";
+
+    ::boost::compute::kernel kernel = k.compile(queue.get_context());
+    k.set_index_arg(kernel, count_arg, count);
+    kernel.set_arg(left_bits_arg, bits / 2);
+    kernel.set_arg(right_bits_arg, bits - bits / 2);
+    kernel.set_arg(keys_arg, keys.get_buffer());
+
+    queue.enqueue_1d_range_kernel(kernel, 0, count, 0);
+}
+
+} // end detail namespace
+
+/// Writes a random permutation of the indices [0, \p n) to the range
+/// beginning at \p result. The permutation is computed on the device from
+/// a few round keys drawn from \p engine, so the result is reproducible for
+/// a given engine state and no indices are generated on the host.
+///
+/// For example, to draw a random sample of 1000 indices from a data set:
+/// \code
+/// boost::compute::threefry_engine<> engine(queue, seed);
+/// boost::compute::vector<uint_> indices(data.size(), context);
+/// boost::compute::random_permutation(
+///     data.size(), indices.begin(), engine, queue
+/// );
+/// // the first 1000 indices form the sample
+/// \endcode
+///
+/// \param n number of indices
+/// \param result first element in the result range
+/// \param engine random number engine (for example \c threefry_engine)
+/// \param queue command queue to perform the operation
+///
+/// \return \c OutputIterator to the end of the result range
+///
+/// Space complexity: \Omega(1)
+///
+/// \see random_shuffle()
+template<class OutputIterator, class Generator>
+inline OutputIterator random_permutation(size_t n,
+                                         OutputIterator result,
+                                         Generator &engine,
+                                         command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+    detail::scratch_vector<uint_> keys(detail::random_permutation_rounds, queue);
+    engine.generate(keys.begin(), keys.end(), queue);
+
+    detail::random_permute(
+        ::boost::compute::make_counting_iterator<uint_>(0),
+        result, n, keys.begin(), queue
+    );
+    return result + n;
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_RANDOM_PERMUTATION_HPP
@@ -11,77 +11,87 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_RANDOM_SHUFFLE_HPP
 #define BOOST_COMPUTE_ALGORITHM_RANDOM_SHUFFLE_HPP
 
-#include <vector>
-#include <algorithm>
+#include <cstdlib>
 
 #ifdef BOOST_COMPUTE_USE_CPP11
 #include <random>
 #endif
 
 #include <boost/static_assert.hpp>
-#include <boost/range/algorithm_ext/iota.hpp>
 
 #include <boost/compute/system.hpp>
-#include <boost/compute/functional.hpp>
 #include <boost/compute/command_queue.hpp>
-#include <boost/compute/container/vector.hpp>
-#include <boost/compute/algorithm/scatter.hpp>
+#include <boost/compute/algorithm/copy_n.hpp>
+#include <boost/compute/algorithm/random_permutation.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/random/threefry_engine.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
 namespace compute {
 
-/// Randomly shuffles the elements in the range [\p first, \p last).
+/// Randomly shuffles the elements in the range [\p first, \p last). The
+/// same \p seed always gives the same order.
 ///
-/// Space complexity: \Omega(2n)
+/// The permutation is computed on the device (see random_permutation()) and
+/// applied while copying the elements back from a temporary copy, so no
+/// indices are generated on the host or transferred.
 ///
-/// \see scatter()
+/// \param first first element in the range
+/// \param last last element in the range
+/// \param seed seed for the permutation
+/// \param queue command queue to perform the operation
+///
+/// Space complexity: \Omega(n)
+///
+/// \see random_permutation()
 template<class Iterator>
 inline void random_shuffle(Iterator first,
                            Iterator last,
+                           ulong_ seed,
                            command_queue &queue = system::default_queue())
 {
     BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
     typedef typename std::iterator_traits<Iterator>::value_type value_type;
 
     size_t count = detail::iterator_range_size(first, last);
-    if(count == 0){
+    if(count < 2){
         return;
     }
 
-    // generate shuffled indices on the host
-    std::vector<cl_uint> random_indices(count);
-    boost::iota(random_indices, 0);
+    threefry_engine<uint_> engine(queue, seed);
+    detail::scratch_vector<uint_> keys(detail::random_permutation_rounds, queue);
+    engine.generate(keys.begin(), keys.end(), queue);
+
+    // make a copy of the values on the device
+    detail::scratch_vector<value_type> tmp(count, queue);
+    ::boost::compute::copy_n(first, count, tmp.begin(), queue);
+
+    // read values from their new locations
+    detail::random_permute(tmp.begin(), first, count, keys.begin(), queue);
+}
+
+/// Randomly shuffles the elements in the range [\p first, \p last) with a
+/// nondeterministic seed.
+///
+/// Space complexity: \Omega(n)
+template<class Iterator>
+inline void random_shuffle(Iterator first,
+                           Iterator last,
+                           command_queue &queue = system::default_queue())
+{
 #ifdef BOOST_COMPUTE_USE_CPP11
     std::random_device nondeterministic_randomness;
-    std::default_random_engine random_engine(nondeterministic_randomness());
-    std::shuffle(random_indices.begin(), random_indices.end(), random_engine);
+    const ulong_ seed =
+        (static_cast<ulong_>(nondeterministic_randomness()) << 32) |
+        nondeterministic_randomness();
 #else
-    std::random_shuffle(random_indices.begin(), random_indices.end());
+    const ulong_ seed =
+        (static_cast<ulong_>(std::rand()) << 32) | std::rand();
 #endif
 
-    // copy random indices to the device
-    const context &context = queue.get_context();
-    vector<cl_uint> indices(count, context);
-    ::boost::compute::copy(random_indices.begin(),
-                           random_indices.end(),
-                           indices.begin(),
-                           queue);
-
-    // make a copy of the values on the device
-    vector<value_type> tmp(count, context);
-    ::boost::compute::copy(first,
-                           last,
-                           tmp.begin(),
-                           queue);
-
-    // write values to their new locations
-    ::boost::compute::scatter(tmp.begin(),
-                              tmp.end(),
-                              indices.begin(),
-                              first,
-                              queue);
+    ::boost::compute::random_shuffle(first, last, seed, queue);
 }
 
 } // end compute namespace
@@ -12,23 +12,32 @@
 #define BOOST_COMPUTE_ALGORITHM_REDUCE_HPP
 
 #include <iterator>
+#include <vector>
 
 #include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/functional.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/container/array.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/algorithm/copy_n.hpp>
+#include <boost/compute/algorithm/detail/host_stream.hpp>
 #include <boost/compute/algorithm/detail/inplace_reduce.hpp>
+#include <boost/compute/algorithm/detail/multi_queue.hpp>
 #include <boost/compute/algorithm/detail/reduce_on_gpu.hpp>
 #include <boost/compute/algorithm/detail/reduce_on_cpu.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 #include <boost/compute/memory/local_buffer.hpp>
 #include <boost/compute/type_traits/result_of.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -51,16 +60,16 @@ size_t reduce(InputIterator first,
 
     const context &context = queue.get_context();
     size_t block_count = count / 2 / block_size;
-    size_t total_block_count =
-        static_cast<size_t>(std::ceil(float(count) / 2.f / float(block_size)));
+    size_t total_block_count = (count + 2 * block_size - 1) / (2 * block_size);
 
     if(block_count != 0){
         meta_kernel k("block_reduce");
+        k.set_index_type_for(count);
         size_t output_arg = k.add_arg<result_type *>(memory_object::global_memory, "output");
         size_t block_arg = k.add_arg<input_type *>(memory_object::local_memory, "block");
 
         k <<
-            "const uint gid = get_global_id(0);\n" <<
+            "const " << k.index_type() << " gid = get_global_id(0);\n" <<
             "const uint lid = get_local_id(0);\n" <<
 
             // copy values to local memory
@@ -98,25 +107,26 @@ size_t reduce(InputIterator first,
         size_t last_block_start = block_count * block_size * 2;
 
         meta_kernel k("extra_serial_reduce");
-        size_t count_arg = k.add_arg<uint_>("count");
-        size_t offset_arg = k.add_arg<uint_>("offset");
+        k.set_index_type_for(count);
+        size_t count_arg = k.add_index_arg("count");
+        size_t offset_arg = k.add_index_arg("offset");
         size_t output_arg = k.add_arg<result_type *>(memory_object::global_memory, "output");
-        size_t output_offset_arg = k.add_arg<uint_>("output_offset");
+        size_t output_offset_arg = k.add_index_arg("output_offset");
 
         k <<
             k.decl<result_type>("result") << " = \n" <<
                 first[k.expr<uint_>("offset")] << ";\n" <<
-            "for(uint i = offset + 1; i < count; i++)\n" <<
+            "for(" << k.index_type() << " i = offset + 1; i < count; i++)\n" <<
             "    result = " <<
                      function(k.var<result_type>("result"),
                               first[k.var<uint_>("i")]) << ";\n" <<
             "output[output_offset] = result;\n";
 
         kernel kernel = k.compile(context);
-        kernel.set_arg(count_arg, static_cast<uint_>(count));
-        kernel.set_arg(offset_arg, static_cast<uint_>(last_block_start));
+        k.set_index_arg(kernel, count_arg, count);
+        k.set_index_arg(kernel, offset_arg, last_block_start);
         kernel.set_arg(output_arg, result.get_buffer());
-        kernel.set_arg(output_offset_arg, static_cast<uint_>(block_count));
+        k.set_index_arg(kernel, output_offset_arg, block_count);
 
         queue.enqueue_task(kernel);
     }
@@ -124,38 +134,6 @@ size_t reduce(InputIterator first,
     return total_block_count;
 }
 
-template<class InputIterator, class BinaryFunction>
-inline vector<
-    typename boost::compute::result_of<
-        BinaryFunction(
-            typename std::iterator_traits<InputIterator>::value_type,
-            typename std::iterator_traits<InputIterator>::value_type
-        )
-    >::type
->
-block_reduce(InputIterator first,
-             size_t count,
-             size_t block_size,
-             BinaryFunction function,
-             command_queue &queue)
-{
-    typedef typename
-        std::iterator_traits<InputIterator>::value_type
-        input_type;
-    typedef typename
-        boost::compute::result_of<BinaryFunction(input_type, input_type)>::type
-        result_type;
-
-    const context &context = queue.get_context();
-    size_t total_block_count =
-        static_cast<size_t>(std::ceil(float(count) / 2.f / float(block_size)));
-    vector<result_type> result_vector(total_block_count, context);
-
-    reduce(first, count, result_vector.begin(), block_size, function, queue);
-
-    return result_vector;
-}
-
 // Space complexity: O( ceil(n / 2 / 256) )
 template<class InputIterator, class OutputIterator, class BinaryFunction>
 inline void generic_reduce(InputIterator first,
@@ -172,24 +150,21 @@ inline void generic_reduce(InputIterator first,
         result_type;
 
     const device &device = queue.get_device();
-    const context &context = queue.get_context();
 
     size_t count = detail::iterator_range_size(first, last);
 
     if(device.type() & device::cpu){
-        array<result_type, 1> value(context);
+        scratch_vector<result_type> value(1, queue);
         detail::reduce_on_cpu(first, last, value.begin(), function, queue);
         boost::compute::copy_n(value.begin(), 1, result, queue);
     }
     else {
         size_t block_size = 256;
+        size_t block_count = (count + 2 * block_size - 1) / (2 * block_size);
 
         // first pass
-        vector<result_type> results = detail::block_reduce(first,
-                                                           count,
-                                                           block_size,
-                                                           function,
-                                                           queue);
+        scratch_vector<result_type> results(block_count, queue);
+        reduce(first, count, results.begin(), block_size, function, queue);
 
         if(results.size() > 1){
             detail::inplace_reduce(results.begin(),
@@ -209,11 +184,10 @@ inline void dispatch_reduce(InputIterator first,
                             const plus<T> &function,
                             command_queue &queue)
 {
-    const context &context = queue.get_context();
     const device &device = queue.get_device();
 
     // reduce to temporary buffer on device
-    array<T, 1> value(context);
+    scratch_vector<T> value(1, queue);
     if(device.type() & device::cpu){
         detail::reduce_on_cpu(first, last, value.begin(), function, queue);
     }
@@ -235,6 +209,124 @@ inline void dispatch_reduce(InputIterator first,
     generic_reduce(first, last, result, function, queue);
 }
 
+// reduce() with the range split into one chunk for each of the queues
+template<class InputIterator, class OutputIterator, class BinaryFunction>
+inline void multi_queue_reduce(InputIterator first,
+                               InputIterator last,
+                               OutputIterator result,
+                               BinaryFunction function,
+                               std::vector<command_queue> &queues)
+{
+    typedef typename
+        std::iterator_traits<InputIterator>::value_type
+        input_type;
+    typedef typename
+        boost::compute::result_of<BinaryFunction(input_type, input_type)>::type
+        result_type;
+
+    check_multi_queue(queues);
+    multi_queue_barrier(queues);
+    command_queue &queue = queues[0];
+
+    const std::vector<size_t> bounds =
+        multi_queue_partition(iterator_range_size(first, last), queues.size());
+    const size_t parts = bounds.size() - 1;
+    if(parts == 1){
+        dispatch_reduce(first, last, result, function, queue);
+        return;
+    }
+
+    // reduce each chunk to a partial result with its own queue
+    ::boost::compute::vector<result_type> partials(parts, queue.get_context());
+    for(size_t i = 0; i < parts; i++){
+        dispatch_reduce(first + bounds[i],
+                        first + bounds[i + 1],
+                        partials.begin() + i,
+                        function,
+                        queues[i]);
+    }
+
+    // combine the partial results in order once every chunk is reduced
+    enqueue_wait_list(queue, multi_queue_markers(queues));
+    dispatch_reduce(partials.begin(), partials.end(), result, function, queue);
+}
+
+// reduces each chunk of a host range streamed by host_stream_reduce()
+template<class BinaryFunction>
+struct reduce_stream_chunk
+{
+    reduce_stream_chunk(BinaryFunction function)
+        : m_function(function)
+    {
+    }
+
+    template<class InputIterator, class OutputIterator>
+    void operator()(InputIterator first,
+                    InputIterator last,
+                    OutputIterator result,
+                    command_queue &queue) const
+    {
+        dispatch_reduce(first, last, result, m_function, queue);
+    }
+
+    BinaryFunction m_function;
+};
+
+// reduce() for device iterators
+template<class InputIterator, class OutputIterator, class BinaryFunction>
+inline void dispatch_reduce_range(InputIterator first,
+                                  InputIterator last,
+                                  OutputIterator result,
+                                  BinaryFunction function,
+                                  command_queue &queue,
+                                  typename boost::enable_if<
+                                      is_device_iterator<InputIterator>
+                                  >::type* = 0)
+{
+    dispatch_reduce(first, last, result, function, queue);
+}
+
+// reduce() for host iterators
+template<class InputIterator, class OutputIterator, class BinaryFunction>
+inline void dispatch_reduce_range(InputIterator first,
+                                  InputIterator last,
+                                  OutputIterator result,
+                                  BinaryFunction function,
+                                  command_queue &queue,
+                                  typename boost::disable_if<
+                                      is_device_iterator<InputIterator>
+                                  >::type* = 0)
+{
+    typedef typename
+        std::iterator_traits<InputIterator>::value_type
+        input_type;
+    typedef typename
+        boost::compute::result_of<BinaryFunction(input_type, input_type)>::type
+        result_type;
+
+    // reduce each chunk to a partial result while the next ones are
+    // uploaded and then combine the partial results in order
+    ::boost::compute::vector<result_type> partials(queue.get_context());
+    host_stream_reduce(
+        first, last, partials, reduce_stream_chunk<BinaryFunction>(function), queue
+    );
+    dispatch_reduce(partials.begin(), partials.end(), result, function, queue);
+}
+
+// the future returned by reduce_async()
+template<class InputIterator, class BinaryFunction>
+struct reduce_async_future
+{
+    typedef typename
+        std::iterator_traits<InputIterator>::value_type
+        input_type;
+    typedef future<
+        typename boost::compute::result_of<
+            BinaryFunction(input_type, input_type)
+        >::type
+    > type;
+};
+
 } // end detail namespace
 
 /// Returns the result of applying \p function to the elements in the
@@ -258,6 +350,12 @@ inline void dispatch_reduce(InputIterator first,
 /// result argument. This allows for values to be reduced and copied
 /// to the host all with a single function call.
 ///
+/// When [\p first, \p last) is a host range it is streamed through the
+/// device in chunks staged in pinned host memory. The upload of each chunk
+/// overlaps with the reduction of the one before it and the partial results
+/// of the chunks are combined at the end, so the range may be larger than
+/// the device memory.
+///
 /// For example, to calculate the sum of the values in a device vector and
 /// copy the result to a value on the host:
 ///
@@ -279,12 +377,11 @@ inline void reduce(InputIterator first,
                    BinaryFunction function,
                    command_queue &queue = system::default_queue())
 {
-    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
     if(first == last){
         return;
     }
 
-    detail::dispatch_reduce(first, last, result, function, queue);
+    detail::dispatch_reduce_range(first, last, result, function, queue);
 }
 
 /// \overload
@@ -293,6 +390,60 @@ inline void reduce(InputIterator first,
                    InputIterator last,
                    OutputIterator result,
                    command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type T;
+
+    if(first == last){
+        return;
+    }
+
+    detail::dispatch_reduce_range(first, last, result, plus<T>(), queue);
+}
+
+/// Reduces the range [\p first, \p last) with \p function using all of
+/// the command queues in \p queues.
+///
+/// The range is split into one chunk for each queue. The chunks are reduced
+/// concurrently and their partial results are then combined in order with
+/// the first queue, which also writes the result. The queues must share the
+/// context of the range. This is typically used with queues for the
+/// sub-devices of a partitioned device, for example one for each NUMA node
+/// of a multi-socket CPU:
+/// \code
+/// std::vector<boost::compute::device> nodes =
+///     device.partition_by_affinity_domain(CL_DEVICE_AFFINITY_DOMAIN_NUMA);
+/// boost::compute::context context(nodes);
+///
+/// std::vector<boost::compute::command_queue> queues;
+/// for(size_t i = 0; i < nodes.size(); i++){
+///     queues.push_back(boost::compute::command_queue(context, nodes[i]));
+/// }
+///
+/// boost::compute::reduce(vec.begin(), vec.end(), &sum, queues);
+/// \endcode
+///
+/// \see reduce()
+template<class InputIterator, class OutputIterator, class BinaryFunction>
+inline void reduce(InputIterator first,
+                   InputIterator last,
+                   OutputIterator result,
+                   BinaryFunction function,
+                   std::vector<command_queue> &queues)
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    if(first == last){
+        return;
+    }
+
+    detail::multi_queue_reduce(first, last, result, function, queues);
+}
+
+/// \overload
+template<class InputIterator, class OutputIterator>
+inline void reduce(InputIterator first,
+                   InputIterator last,
+                   OutputIterator result,
+                   std::vector<command_queue> &queues)
 {
     BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
     typedef typename std::iterator_traits<InputIterator>::value_type T;
@@ -301,7 +452,76 @@ inline void reduce(InputIterator first,
         return;
     }
 
-    detail::dispatch_reduce(first, last, result, plus<T>(), queue);
+    detail::multi_queue_reduce(first, last, result, plus<T>(), queues);
+}
+
+/// Asynchronous version of reduce() which returns the result in a future
+/// instead of writing it to an output iterator. The commands are enqueued
+/// after \p events and the result is kept in device memory until \c get()
+/// is called on the returned future. For an empty range the result is a
+/// value-initialized object.
+///
+/// For example, to sum the values in a device vector while the host does
+/// other work:
+/// \code
+/// boost::compute::future<int> sum =
+///     boost::compute::reduce_async(vec.begin(), vec.end(), queue);
+///
+/// // ... other work ...
+///
+/// int result = sum.get();
+/// \endcode
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see reduce()
+template<class InputIterator, class BinaryFunction>
+inline typename boost::lazy_disable_if<
+    boost::is_same<BinaryFunction, command_queue>,
+    detail::reduce_async_future<InputIterator, BinaryFunction>
+>::type
+reduce_async(InputIterator first,
+             InputIterator last,
+             BinaryFunction function,
+             command_queue &queue = system::default_queue(),
+             const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    typedef typename
+        std::iterator_traits<InputIterator>::value_type
+        input_type;
+    typedef typename
+        boost::compute::result_of<BinaryFunction(input_type, input_type)>::type
+        result_type;
+
+    detail::enqueue_wait_list(queue, events);
+
+    if(first == last){
+        return detail::make_queue_future(result_type(), queue);
+    }
+
+    buffer result(queue.get_context(), sizeof(result_type));
+    detail::dispatch_reduce(
+        first, last, buffer_iterator<result_type>(result, 0), function, queue
+    );
+
+    return detail::make_device_future<result_type>(result, queue);
+}
+
+/// \overload
+template<class InputIterator>
+inline future<typename std::iterator_traits<InputIterator>::value_type>
+reduce_async(InputIterator first,
+             InputIterator last,
+             command_queue &queue = system::default_queue(),
+             const wait_list &events = wait_list())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type T;
+
+    return ::boost::compute::reduce_async(
+        first, last, plus<T>(), queue, events
+    );
 }
 
 } // end compute namespace
@@ -14,6 +14,7 @@
 #include <boost/compute/system.hpp>
 #include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 
 namespace boost {
 namespace compute {
@@ -42,8 +43,7 @@ inline void rotate(InputIterator first,
     size_t count = detail::iterator_range_size(first, n_first);
     size_t count2 = detail::iterator_range_size(first, last);
 
-    const context &context = queue.get_context();
-    vector<T> temp(count2, context);
+    detail::scratch_vector<T> temp(count2, queue);
     ::boost::compute::copy(first, last, temp.begin(), queue);
 
     ::boost::compute::copy(temp.begin()+count, temp.end(), first, queue);
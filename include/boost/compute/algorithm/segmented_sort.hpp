@@ -0,0 +1,671 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_SEGMENTED_SORT_HPP
+#define BOOST_COMPUTE_ALGORITHM_SEGMENTED_SORT_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/memory/local_buffer.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// emits code which loads the bounds of segment i into start and end
+template<class OffsetIterator>
+inline void segmented_sort_segment_bounds(meta_kernel &k,
+                                          OffsetIterator offsets_first,
+                                          const std::string &i)
+{
+    k <<
+        "const " << k.index_type() << " start = " <<
+            offsets_first[k.expr<uint_>(i)] << ";\n" <<
+        "const " << k.index_type() << " end = " << i << " + 1 < segment_count ? " <<
+            offsets_first[k.expr<uint_>(i + " + 1")] << " : count;\n";
+}
+
+// sorts segments with one work-group each in local memory. the segment is
+// padded to the next power of two and sorted with a bitonic network, as in
+// bitonic_block_sort(). the network sorts the original positions of the keys
+// along with the keys and breaks ties with them, which makes the sort stable
+// and lets the values be gathered from local memory once at the end instead
+// of being swapped in every step.
+//
+// work-group i either sorts segment i given by the offsets if it has between
+// two and capacity elements (chunks is null), or the i-th of the
+// counters[0] (start, length, ...) entries of chunks. positions are uint or
+// ulong as chosen by set_index_type_for(count), the chunks are vectors of
+// four of them.
+template<class KeyIterator, class ValueIterator, class OffsetIterator,
+         class Compare>
+inline void segmented_sort_in_local_memory(KeyIterator keys_first,
+                                           ValueIterator values_first,
+                                           OffsetIterator offsets_first,
+                                           Compare compare,
+                                           const size_t count,
+                                           const size_t segment_count,
+                                           const buffer &chunks,
+                                           const buffer &counters,
+                                           const size_t group_count,
+                                           const size_t capacity,
+                                           const size_t work_group_size,
+                                           const bool sort_by_key,
+                                           command_queue &queue)
+{
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+    typedef typename std::iterator_traits<ValueIterator>::value_type value_type;
+
+    meta_kernel k("segmented_sort_in_local_memory");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t local_keys_arg =
+        k.add_arg<key_type *>(memory_object::local_memory, "lkeys");
+    size_t local_idx_arg =
+        k.add_arg<uint_ *>(memory_object::local_memory, "lidx");
+    size_t local_vals_arg = 0;
+    if(sort_by_key){
+        local_vals_arg =
+            k.add_arg<value_type *>(memory_object::local_memory, "lvals");
+    }
+
+    size_t chunks_arg = 0;
+    size_t counters_arg = 0;
+    if(chunks.get()){
+        chunks_arg = k.uses_64bit_indices() ?
+            k.add_arg<const ulong4_ *>(memory_object::global_memory, "chunks") :
+            k.add_arg<const uint4_ *>(memory_object::global_memory, "chunks");
+        counters_arg =
+            k.add_arg<const uint_ *>(memory_object::global_memory, "counters");
+
+        k <<
+            "if(get_group_id(0) >= counters[0]){\n" <<
+            "    return;\n" <<
+            "}\n" <<
+            "const " << index_type << "4 chunk = chunks[get_group_id(0)];\n" <<
+            "const " << index_type << " start = chunk.x;\n" <<
+            "const " << index_type << " len = chunk.y;\n";
+    }
+    else {
+        k.add_set_index_arg("count", count);
+        k.add_set_index_arg("segment_count", segment_count);
+
+        k << "const " << index_type << " segment = get_group_id(0);\n";
+        segmented_sort_segment_bounds(k, offsets_first, "segment");
+        k <<
+            "const " << index_type << " len = end - start;\n" <<
+            "if(len < 2 || len > " << static_cast<uint_>(capacity) << "){\n" <<
+            "    return;\n" <<
+            "}\n";
+    }
+
+    k <<
+        "const uint lid = get_local_id(0);\n" <<
+        "const uint tpb = get_local_size(0);\n" <<
+        "uint n = 1;\n" <<
+        "while(n < len){\n" <<
+        "    n <<= 1;\n" <<
+        "}\n" <<
+
+        // load keys (and values) to local memory, padding keys have
+        // positions of len or more
+        "for(uint i = lid; i < n; i += tpb){\n" <<
+        "    if(i < len){\n" <<
+        "        lkeys[i] = " << keys_first[k.expr<uint_>("start + i")] << ";\n";
+    if(sort_by_key){
+        k <<
+        "        lvals[i] = " << values_first[k.expr<uint_>("start + i")] << ";\n";
+    }
+    k <<
+        "    }\n" <<
+        "    lidx[i] = i;\n" <<
+        "}\n" <<
+
+        // bitonic sort
+        "for(uint size = 2; size <= n; size <<= 1){\n" <<
+        "    for(uint stride = size >> 1; stride > 0; stride >>= 1){\n" <<
+        "        barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+        "        for(uint t = lid; t < n / 2; t += tpb){\n" <<
+        "            const uint i = 2 * t - (t & (stride - 1));\n" <<
+        "            const uint j = i + stride;\n" <<
+        "            const uint idx_i = lidx[i];\n" <<
+        "            const uint idx_j = lidx[j];\n" <<
+        "            " << k.decl<key_type>("key_i") << " = lkeys[i];\n" <<
+        "            " << k.decl<key_type>("key_j") << " = lkeys[j];\n" <<
+        "            const bool j_first = idx_j < len &&\n" <<
+        "                (idx_i >= len ||\n" <<
+        "                 " << compare(k.var<key_type>("key_j"),
+                                      k.var<key_type>("key_i")) << " ||\n" <<
+        "                 (!(" << compare(k.var<key_type>("key_i"),
+                                         k.var<key_type>("key_j")) << ") &&\n" <<
+        "                  idx_j < idx_i));\n" <<
+        "            if(((i & size) == 0) ? j_first : !j_first){\n" <<
+        "                lkeys[i] = key_j;\n" <<
+        "                lkeys[j] = key_i;\n" <<
+        "                lidx[i] = idx_j;\n" <<
+        "                lidx[j] = idx_i;\n" <<
+        "            }\n" <<
+        "        }\n" <<
+        "    }\n" <<
+        "}\n" <<
+        "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+
+        // store results
+        "for(uint i = lid; i < len; i += tpb){\n" <<
+        "    " << keys_first[k.expr<uint_>("start + i")] << " = lkeys[i];\n";
+    if(sort_by_key){
+        k <<
+        "    " << values_first[k.expr<uint_>("start + i")] << " = lvals[lidx[i]];\n";
+    }
+    k <<
+        "}\n";
+
+    ::boost::compute::kernel kernel = k.compile(queue.get_context());
+    const size_t tpb = (std::min)(
+        work_group_size,
+        kernel.get_work_group_info<size_t>(
+            queue.get_device(), CL_KERNEL_WORK_GROUP_SIZE
+        )
+    );
+
+    kernel.set_arg(local_keys_arg, local_buffer<key_type>(capacity));
+    kernel.set_arg(local_idx_arg, local_buffer<uint_>(capacity));
+    if(sort_by_key){
+        kernel.set_arg(local_vals_arg, local_buffer<value_type>(capacity));
+    }
+    if(chunks.get()){
+        kernel.set_arg(chunks_arg, chunks);
+        kernel.set_arg(counters_arg, counters);
+    }
+
+    queue.enqueue_1d_range_kernel(
+        kernel, 0, group_count * tpb, tpb
+    );
+}
+
+// splits the segments which do not fit into small work-groups into chunks
+// of at most capacity elements, with one work-item per segment. the chunks
+// are stored as (start, length, segment start, segment end) and counted in
+// counters[0]. the chunks of segments longer than capacity are also stored
+// in large_chunks and counted in counters[1], and the number of chunks of
+// the longest of these segments is stored in counters[2]. ChunkType is
+// uint4_ or ulong4_, matching the index type of the kernel for count.
+template<class OffsetIterator, class ChunkType>
+inline void segmented_sort_split_segments(OffsetIterator offsets_first,
+                                          const size_t count,
+                                          const size_t segment_count,
+                                          const size_t small_capacity,
+                                          const size_t capacity,
+                                          const buffer_iterator<ChunkType> chunks,
+                                          const buffer_iterator<ChunkType> large_chunks,
+                                          const buffer_iterator<uint_> counters,
+                                          command_queue &queue)
+{
+    meta_kernel k("segmented_sort_split_segments");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    k.add_set_index_arg("count", count);
+    k.add_set_index_arg("segment_count", segment_count);
+    k.add_set_index_arg("small_capacity", small_capacity);
+    k.add_set_index_arg("capacity", capacity);
+    k.set_arg(k.add_arg<ChunkType *>(memory_object::global_memory, "chunks"),
+              chunks.get_buffer());
+    k.set_arg(k.add_arg<ChunkType *>(memory_object::global_memory, "large_chunks"),
+              large_chunks.get_buffer());
+    k.set_arg(k.add_arg<uint_ *>(memory_object::global_memory, "counters"),
+              counters.get_buffer());
+
+    k << "const " << index_type << " segment = get_global_id(0);\n" <<
+         "if(segment >= segment_count){\n" <<
+         "    return;\n" <<
+         "}\n";
+    segmented_sort_segment_bounds(k, offsets_first, "segment");
+    k <<
+        "const " << index_type << " len = end - start;\n" <<
+        "if(len <= small_capacity){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "if(len <= capacity){\n" <<
+        "    chunks[atomic_inc(counters)] =\n" <<
+        "        (" << index_type << "4)(start, len, start, end);\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "const uint n = (len + capacity - 1) / capacity;\n" <<
+        "const uint slot = atomic_add(counters, n);\n" <<
+        "const uint large_slot = atomic_add(counters + 1, n);\n" <<
+        "atomic_max(counters + 2, n);\n" <<
+        "for(uint c = 0; c < n; c++){\n" <<
+        "    const " << index_type << " chunk_start = start + c * capacity;\n" <<
+        "    const " << index_type << "4 chunk = (" << index_type << "4)(\n" <<
+        "        chunk_start, min(capacity, end - chunk_start), start, end\n" <<
+        "    );\n" <<
+        "    chunks[slot + c] = chunk;\n" <<
+        "    large_chunks[large_slot + c] = chunk;\n" <<
+        "}\n";
+
+    k.exec_1d(queue, 0, segment_count);
+}
+
+// merges pairs of sorted runs of width elements (relative to the start of
+// their segment) from the src ranges to the dst ranges, for the elements of
+// the counters[1] chunks in large_chunks. each element is written to its
+// position in the merged run, which is its position in its own run plus the
+// number of elements of the other run which go before it. ties go to the
+// first run, so the merge is stable. elements whose run has no partner are
+// copied, so a pass with width no less than the longest segment copies the
+// chunks. count is the size of the whole range and selects the index type.
+template<class SrcKeyIterator, class SrcValueIterator,
+         class DstKeyIterator, class DstValueIterator, class Compare>
+inline void segmented_sort_merge_runs(SrcKeyIterator src_keys,
+                                      SrcValueIterator src_values,
+                                      DstKeyIterator dst_keys,
+                                      DstValueIterator dst_values,
+                                      Compare compare,
+                                      const size_t count,
+                                      const buffer &large_chunks,
+                                      const buffer &counters,
+                                      const size_t group_count,
+                                      const size_t width,
+                                      const size_t work_group_size,
+                                      const bool sort_by_key,
+                                      command_queue &queue)
+{
+    typedef typename std::iterator_traits<SrcKeyIterator>::value_type key_type;
+
+    meta_kernel k("segmented_sort_merge_runs");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    k.set_arg(
+        k.uses_64bit_indices() ?
+            k.add_arg<const ulong4_ *>(memory_object::global_memory, "chunks") :
+            k.add_arg<const uint4_ *>(memory_object::global_memory, "chunks"),
+        large_chunks
+    );
+    k.set_arg(k.add_arg<const uint_ *>(memory_object::global_memory, "counters"),
+              counters);
+    k.add_set_index_arg("width", width);
+
+    k <<
+        "if(get_group_id(0) >= counters[1]){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "const " << index_type << "4 chunk = chunks[get_group_id(0)];\n" <<
+        "const " << index_type << " segment_start = chunk.z;\n" <<
+        "const " << index_type << " segment_end = chunk.w;\n" <<
+        "for(" << index_type << " i = chunk.x + get_local_id(0); i < chunk.x + chunk.y; i += get_local_size(0)){\n" <<
+        "    const " << index_type << " run = (i - segment_start) / width;\n" <<
+        "    const " << index_type << " run_start = segment_start + run * width;\n" <<
+        "    const bool first_run = (run & 1) == 0;\n" <<
+        "    " << index_type << " other_start = run_start - width;\n" <<
+        "    " << index_type << " other_size = width;\n" <<
+        "    " << index_type << " merged_start = other_start;\n" <<
+        "    if(first_run){\n" <<
+        "        const " << index_type << " rest = segment_end - run_start;\n" <<
+        "        other_start = run_start + width;\n" <<
+        "        other_size = rest > width ? min(rest - width, width) : 0;\n" <<
+        "        merged_start = run_start;\n" <<
+        "    }\n" <<
+        "    " << k.decl<const key_type>("key") << " = " <<
+                 src_keys[k.expr<uint_>("i")] << ";\n" <<
+        "    " << index_type << " lo = 0;\n" <<
+        "    " << index_type << " hi = other_size;\n" <<
+        "    while(lo < hi){\n" <<
+        "        const " << index_type << " mid = (lo + hi) / 2;\n" <<
+        "        " << k.decl<const key_type>("other") << " = " <<
+                     src_keys[k.expr<uint_>("other_start + mid")] << ";\n" <<
+        "        const bool before = first_run ?\n" <<
+        "            " << compare(k.var<key_type>("other"), k.var<key_type>("key")) << " :\n" <<
+        "            !(" << compare(k.var<key_type>("key"), k.var<key_type>("other")) << ");\n" <<
+        "        if(before){\n" <<
+        "            lo = mid + 1;\n" <<
+        "        }\n" <<
+        "        else {\n" <<
+        "            hi = mid;\n" <<
+        "        }\n" <<
+        "    }\n" <<
+        "    const " << index_type << " j = merged_start + (i - run_start) + lo;\n" <<
+        "    " << dst_keys[k.expr<uint_>("j")] << " = key;\n";
+    if(sort_by_key){
+        k <<
+        "    " << dst_values[k.expr<uint_>("j")] << " = " <<
+                 src_values[k.expr<uint_>("i")] << ";\n";
+    }
+    k <<
+        "}\n";
+
+    ::boost::compute::kernel kernel = k.compile(queue.get_context());
+    const size_t tpb = (std::min)(
+        work_group_size,
+        kernel.get_work_group_info<size_t>(
+            queue.get_device(), CL_KERNEL_WORK_GROUP_SIZE
+        )
+    );
+
+    queue.enqueue_1d_range_kernel(kernel, 0, group_count * tpb, tpb);
+}
+
+// returns the largest power of two which is not greater than n
+inline size_t segmented_sort_floor_pow2(size_t n)
+{
+    size_t result = 1;
+    while(result * 2 <= n){
+        result *= 2;
+    }
+    return result;
+}
+
+// sorts the segments of more than small_capacity elements, see
+// dispatch_segmented_sort(). ChunkType is uint4_, or ulong4_ for ranges
+// past the 32-bit limit.
+template<class ChunkType, class KeyIterator, class ValueIterator,
+         class OffsetIterator, class Compare>
+inline void segmented_sort_large_segments(KeyIterator keys_first,
+                                          ValueIterator values_first,
+                                          OffsetIterator offsets_first,
+                                          Compare compare,
+                                          const size_t count,
+                                          const size_t segment_count,
+                                          const size_t small_capacity,
+                                          const size_t medium_capacity,
+                                          const size_t medium_tpb,
+                                          const bool sort_by_key,
+                                          command_queue &queue)
+{
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+    typedef typename std::iterator_traits<ValueIterator>::value_type value_type;
+
+    // every chunk but the last one of each segment has more than
+    // small_capacity elements and only segments of more than medium_capacity
+    // elements have more than one chunk. a segment of length elements is
+    // split into less than 2 * length / medium_capacity chunks.
+    const size_t max_chunks = (std::min)(
+        count / (small_capacity + 1) + count / (medium_capacity + 1) + 1,
+        count
+    );
+    const size_t max_large_chunks = (std::min)(
+        2 * count / medium_capacity, max_chunks
+    );
+
+    scratch_vector<uint_> counters(3, queue);
+    ::boost::compute::fill(counters.begin(), counters.end(), uint_(0), queue);
+    scratch_vector<ChunkType> chunks(max_chunks, queue);
+    scratch_vector<ChunkType> large_chunks(max_large_chunks, queue);
+    segmented_sort_split_segments(
+        offsets_first, count, segment_count, small_capacity, medium_capacity,
+        chunks.begin(), large_chunks.begin(), counters.begin(), queue
+    );
+
+    // chunk count, large chunk count and chunk count of the longest segment
+    uint_ host_counters[3];
+    queue.enqueue_read_buffer(
+        counters.get_buffer(), 0, sizeof(host_counters), host_counters
+    );
+    if(host_counters[0] == 0){
+        return;
+    }
+
+    segmented_sort_in_local_memory(
+        keys_first, values_first, offsets_first, compare, count, segment_count,
+        chunks.get_buffer(), counters.get_buffer(), host_counters[0],
+        medium_capacity, medium_tpb, sort_by_key, queue
+    );
+
+    const size_t large_chunk_count = host_counters[1];
+    const size_t max_length = size_t(host_counters[2]) * medium_capacity;
+    if(large_chunk_count == 0){
+        return;
+    }
+
+    // merge runs back and forth between the range and temporary buffers
+    // until the runs are at least as long as the longest segment
+    scratch_vector<key_type> tmp_keys(count, queue);
+    scratch_vector<value_type> tmp_values(sort_by_key ? count : 0, queue);
+    bool in_tmp = false;
+    for(size_t width = medium_capacity; width < max_length; width *= 2){
+        if(in_tmp){
+            segmented_sort_merge_runs(
+                tmp_keys.begin(), tmp_values.begin(), keys_first, values_first,
+                compare, count, large_chunks.get_buffer(), counters.get_buffer(),
+                large_chunk_count, width, medium_tpb, sort_by_key, queue
+            );
+        }
+        else {
+            segmented_sort_merge_runs(
+                keys_first, values_first, tmp_keys.begin(), tmp_values.begin(),
+                compare, count, large_chunks.get_buffer(), counters.get_buffer(),
+                large_chunk_count, width, medium_tpb, sort_by_key, queue
+            );
+        }
+        in_tmp = !in_tmp;
+    }
+
+    // a pass with runs at least as long as the longest segment copies the
+    // chunks back
+    if(in_tmp){
+        segmented_sort_merge_runs(
+            tmp_keys.begin(), tmp_values.begin(), keys_first, values_first,
+            compare, count, large_chunks.get_buffer(), counters.get_buffer(),
+            large_chunk_count, max_length, medium_tpb, sort_by_key, queue
+        );
+    }
+}
+
+// segments of up to small_capacity elements are sorted by small work-groups
+// straight from the offsets, longer segments by full work-groups in chunks
+// of up to medium_capacity elements (both in local memory). the sorted
+// chunks of segments longer than medium_capacity are then merged in pairs
+// of runs, all segments at once, until each segment is a single run. the
+// segment offsets are never read on the host. only the number of chunks and
+// the number of chunks of the longest segment are read back, which size the
+// launches and bound the number of merge passes.
+template<class KeyIterator, class ValueIterator, class OffsetIterator,
+         class Compare>
+inline void dispatch_segmented_sort(KeyIterator keys_first,
+                                    KeyIterator keys_last,
+                                    ValueIterator values_first,
+                                    OffsetIterator offsets_first,
+                                    OffsetIterator offsets_last,
+                                    Compare compare,
+                                    const bool sort_by_key,
+                                    command_queue &queue)
+{
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+    typedef typename std::iterator_traits<ValueIterator>::value_type value_type;
+
+    const size_t count = iterator_range_size(keys_first, keys_last);
+    const size_t segment_count = iterator_range_size(offsets_first, offsets_last);
+    if(count < 2 || segment_count == 0){
+        return;
+    }
+
+    const device &device = queue.get_device();
+
+    std::string cache_key =
+        std::string("__boost_segmented_sort_") + type_name<key_type>();
+    if(sort_by_key){
+        cache_key += std::string("_with_") + type_name<value_type>();
+    }
+    boost::shared_ptr<parameter_cache> parameters =
+        detail::parameter_cache::get_global_cache(device);
+
+    const size_t element_size =
+        sizeof(key_type) + sizeof(uint_) + (sort_by_key ? sizeof(value_type) : 0);
+    const size_t max_capacity = segmented_sort_floor_pow2(
+        static_cast<size_t>(device.local_memory_size()) / element_size
+    );
+    const size_t small_capacity = (std::min)(
+        max_capacity,
+        segmented_sort_floor_pow2(parameters->get(cache_key, "small_capacity", 256))
+    );
+    const size_t medium_capacity = (std::max)(
+        small_capacity,
+        (std::min)(
+            max_capacity,
+            segmented_sort_floor_pow2(parameters->get(cache_key, "medium_capacity", 4096))
+        )
+    );
+    const size_t small_tpb = parameters->get(cache_key, "small_tpb", 32);
+    const size_t medium_tpb = parameters->get(cache_key, "medium_tpb", 256);
+
+    segmented_sort_in_local_memory(
+        keys_first, values_first, offsets_first, compare, count, segment_count,
+        buffer(), buffer(), segment_count, small_capacity, small_tpb,
+        sort_by_key, queue
+    );
+    if(count <= small_capacity){
+        return;
+    }
+
+    if(requires_64bit_indices(count)){
+        segmented_sort_large_segments<ulong4_>(
+            keys_first, values_first, offsets_first, compare, count,
+            segment_count, small_capacity, medium_capacity, medium_tpb,
+            sort_by_key, queue
+        );
+    }
+    else {
+        segmented_sort_large_segments<uint4_>(
+            keys_first, values_first, offsets_first, compare, count,
+            segment_count, small_capacity, medium_capacity, medium_tpb,
+            sort_by_key, queue
+        );
+    }
+}
+
+} // end detail namespace
+
+/// Sorts each segment of the range [\p first, \p last) according to
+/// \p compare. The segments are given by their starting positions (relative
+/// to \p first) in the range [\p offsets_first, \p offsets_last), which must
+/// be in ascending order. The last segment ends at \p last. The relative
+/// order of equal values is preserved.
+///
+/// Short segments are sorted in local memory with many segments per kernel
+/// launch, while long segments are sorted in chunks in local memory which
+/// are then merged, with all long segments handled by the same kernel
+/// launches. The segment offsets are only read on the device. This is much
+/// faster than calling sort() for each segment when there are many
+/// segments.
+///
+/// For example, to sort the segments [0, 3) and [3, 6) of a vector:
+/// \code
+/// // vec = { 3, 1, 2, 9, 7, 8 }, offsets = { 0, 3 }
+/// boost::compute::segmented_sort(
+///     vec.begin(), vec.end(), offsets.begin(), offsets.end(), queue
+/// );
+/// // vec = { 1, 2, 3, 7, 8, 9 }
+/// \endcode
+///
+/// \param first first element in the range to sort
+/// \param last last element in the range to sort
+/// \param offsets_first first segment offset
+/// \param offsets_last last segment offset
+/// \param compare comparison function (by default \c less)
+/// \param queue command queue to perform the operation
+///
+/// Space complexity: \Omega(n)
+///
+/// \see sort(), segmented_sort_by_key()
+template<class Iterator, class OffsetIterator, class Compare>
+inline void segmented_sort(Iterator first,
+                           Iterator last,
+                           OffsetIterator offsets_first,
+                           OffsetIterator offsets_last,
+                           Compare compare,
+                           command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OffsetIterator>::value);
+
+    ::boost::compute::detail::dispatch_segmented_sort(
+        first, last, first, offsets_first, offsets_last, compare, false, queue
+    );
+}
+
+/// \overload
+template<class Iterator, class OffsetIterator>
+inline void segmented_sort(Iterator first,
+                           Iterator last,
+                           OffsetIterator offsets_first,
+                           OffsetIterator offsets_last,
+                           command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    ::boost::compute::segmented_sort(
+        first, last, offsets_first, offsets_last, less<value_type>(), queue
+    );
+}
+
+/// Performs a key-value sort of each segment of the keys in the range
+/// [\p keys_first, \p keys_last) on the values in the range
+/// [\p values_first, \p values_first \c + (\p keys_last \c - \p keys_first))
+/// using \p compare. The segments are given by the offsets in the range
+/// [\p offsets_first, \p offsets_last) as for segmented_sort(). The relative
+/// order of values with equal keys is preserved.
+///
+/// Space complexity: \Omega(2n)
+///
+/// \see segmented_sort(), sort_by_key()
+template<class KeyIterator, class ValueIterator, class OffsetIterator,
+         class Compare>
+inline void segmented_sort_by_key(KeyIterator keys_first,
+                                  KeyIterator keys_last,
+                                  ValueIterator values_first,
+                                  OffsetIterator offsets_first,
+                                  OffsetIterator offsets_last,
+                                  Compare compare,
+                                  command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<KeyIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<ValueIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OffsetIterator>::value);
+
+    ::boost::compute::detail::dispatch_segmented_sort(
+        keys_first, keys_last, values_first, offsets_first, offsets_last,
+        compare, true, queue
+    );
+}
+
+/// \overload
+template<class KeyIterator, class ValueIterator, class OffsetIterator>
+inline void segmented_sort_by_key(KeyIterator keys_first,
+                                  KeyIterator keys_last,
+                                  ValueIterator values_first,
+                                  OffsetIterator offsets_first,
+                                  OffsetIterator offsets_last,
+                                  command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<KeyIterator>::value_type key_type;
+
+    ::boost::compute::segmented_sort_by_key(
+        keys_first, keys_last, values_first, offsets_first, offsets_last,
+        less<key_type>(), queue
+    );
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_SEGMENTED_SORT_HPP
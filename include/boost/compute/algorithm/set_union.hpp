@@ -22,6 +22,7 @@
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
 #include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 #include <boost/compute/system.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
 
@@ -159,8 +160,8 @@ inline OutputIterator set_union(InputIterator1 first1,
     int count1 = detail::iterator_range_size(first1, last1);
     int count2 = detail::iterator_range_size(first2, last2);
 
-    vector<uint_> tile_a((count1+count2+tile_size-1)/tile_size+1, queue.get_context());
-    vector<uint_> tile_b((count1+count2+tile_size-1)/tile_size+1, queue.get_context());
+    detail::scratch_vector<uint_> tile_a((count1+count2+tile_size-1)/tile_size+1, queue);
+    detail::scratch_vector<uint_> tile_b((count1+count2+tile_size-1)/tile_size+1, queue);
 
     // Tile the sets
     detail::balanced_path_kernel tiling_kernel;
@@ -174,8 +175,8 @@ inline OutputIterator set_union(InputIterator1 first1,
     fill_n(tile_a.end()-1, 1, count1, queue);
     fill_n(tile_b.end()-1, 1, count2, queue);
 
-    vector<value_type> temp_result(count1+count2, queue.get_context());
-    vector<uint_> counts((count1+count2+tile_size-1)/tile_size + 1, queue.get_context());
+    detail::scratch_vector<value_type> temp_result(count1+count2, queue);
+    detail::scratch_vector<uint_> counts((count1+count2+tile_size-1)/tile_size + 1, queue);
     fill_n(counts.end()-1, 1, 0, queue);
 
     // Find individual unions
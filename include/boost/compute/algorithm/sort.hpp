@@ -12,20 +12,28 @@
 #define BOOST_COMPUTE_ALGORITHM_SORT_HPP
 
 #include <iterator>
+#include <vector>
 
+#include <boost/static_assert.hpp>
 #include <boost/utility/enable_if.hpp>
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/detail/merge_sort_on_cpu.hpp>
 #include <boost/compute/algorithm/detail/merge_sort_on_gpu.hpp>
+#include <boost/compute/algorithm/detail/multi_queue.hpp>
+#include <boost/compute/algorithm/detail/multi_queue_merge.hpp>
 #include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/algorithm/detail/radix_sort_on_cpu.hpp>
 #include <boost/compute/algorithm/detail/insertion_sort.hpp>
 #include <boost/compute/algorithm/reverse.hpp>
 #include <boost/compute/container/mapped_view.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
 #include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
@@ -104,6 +112,58 @@ inline void dispatch_gpu_sort(Iterator first,
     }
 }
 
+template<class T>
+inline void dispatch_cpu_sort(buffer_iterator<T> first,
+                              buffer_iterator<T> last,
+                              less<T> compare,
+                              command_queue &queue,
+                              typename boost::enable_if_c<
+                                  is_radix_sortable<T>::value
+                              >::type* = 0)
+{
+    size_t count = detail::iterator_range_size(first, last);
+
+    if(count <= 512){
+        ::boost::compute::detail::merge_sort_on_cpu(
+            first, last, compare, queue
+        );
+    }
+    else {
+        ::boost::compute::detail::radix_sort_on_cpu(first, last, true, queue);
+    }
+}
+
+template<class T>
+inline void dispatch_cpu_sort(buffer_iterator<T> first,
+                              buffer_iterator<T> last,
+                              greater<T> compare,
+                              command_queue &queue,
+                              typename boost::enable_if_c<
+                                  is_radix_sortable<T>::value
+                              >::type* = 0)
+{
+    size_t count = detail::iterator_range_size(first, last);
+
+    if(count <= 512){
+        ::boost::compute::detail::merge_sort_on_cpu(
+            first, last, compare, queue
+        );
+    }
+    else {
+        // radix sorts in descending order
+        ::boost::compute::detail::radix_sort_on_cpu(first, last, false, queue);
+    }
+}
+
+template<class Iterator, class Compare>
+inline void dispatch_cpu_sort(Iterator first,
+                              Iterator last,
+                              Compare compare,
+                              command_queue &queue)
+{
+    ::boost::compute::detail::merge_sort_on_cpu(first, last, compare, queue);
+}
+
 // sort() for device iterators
 template<class Iterator, class Compare>
 inline void dispatch_sort(Iterator first,
@@ -118,7 +178,7 @@ inline void dispatch_sort(Iterator first,
         dispatch_gpu_sort(first, last, compare, queue);
         return;
     }
-    ::boost::compute::detail::merge_sort_on_cpu(first, last, compare, queue);
+    dispatch_cpu_sort(first, last, compare, queue);
 }
 
 // sort() for host iterators
@@ -147,6 +207,58 @@ inline void dispatch_sort(Iterator first,
     view.map(queue);
 }
 
+// sort() with the range split into one chunk for each of the queues. the
+// chunks are sorted concurrently and then merged in pairs, with every queue
+// merging a part of each pair, until a single sorted run is left.
+template<class Iterator, class Compare>
+inline void multi_queue_sort(Iterator first,
+                             Iterator last,
+                             Compare compare,
+                             std::vector<command_queue> &queues)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    check_multi_queue(queues);
+    multi_queue_barrier(queues);
+
+    const size_t count = iterator_range_size(first, last);
+    std::vector<size_t> runs = multi_queue_partition(count, queues.size());
+    if(runs.size() == 2){
+        dispatch_sort(first, last, compare, queues[0]);
+        return;
+    }
+
+    for(size_t i = 0; i + 1 < runs.size(); i++){
+        dispatch_sort(first + runs[i], first + runs[i + 1], compare, queues[i]);
+    }
+    multi_queue_finish(queues);
+
+    // merge back and forth between the range and a temporary buffer
+    ::boost::compute::vector<value_type> tmp(count, queues[0].get_context());
+    bool in_tmp = false;
+    while(runs.size() > 2){
+        if(in_tmp){
+            runs = merge_runs(tmp.begin(), first, runs, compare, queues);
+        }
+        else {
+            runs = merge_runs(first, tmp.begin(), runs, compare, queues);
+        }
+        in_tmp = !in_tmp;
+    }
+
+    if(in_tmp){
+        const std::vector<size_t> bounds =
+            multi_queue_partition(count, queues.size());
+        for(size_t i = 0; i + 1 < bounds.size(); i++){
+            ::boost::compute::copy(tmp.begin() + bounds[i],
+                                   tmp.begin() + bounds[i + 1],
+                                   first + bounds[i],
+                                   queues[i]);
+        }
+        multi_queue_finish(queues);
+    }
+}
+
 } // end detail namespace
 
 /// Sorts the values in the range [\p first, \p last) according to
@@ -201,6 +313,156 @@ inline void sort(Iterator first,
     );
 }
 
+/// Sorts the values in the range [\p first, \p last) in ascending order
+/// using only the bits [\p begin_bit, \p end_bit) of each value.
+///
+/// The values must be of a built-in scalar type and have the same value
+/// for the bits outside of the range. For signed and floating-point values
+/// of mixed sign this means the range must include the sign bit. Sorting on
+/// fewer bits needs fewer radix sort passes, for example for 64-bit ids
+/// which only use their low 36 bits:
+/// \code
+/// boost::compute::sort(ids.begin(), ids.end(), 0, 36, queue);
+/// \endcode
+///
+/// Space complexity: \Omega(n)
+///
+/// \see sort_by_key()
+template<class T>
+inline void sort(buffer_iterator<T> first,
+                 buffer_iterator<T> last,
+                 uint_ begin_bit,
+                 uint_ end_bit,
+                 command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(detail::is_radix_sortable<T>::value);
+    ::boost::compute::detail::radix_sort(first, last, begin_bit, end_bit, queue);
+}
+
+/// \overload
+///
+/// If \p skip_uniform_digits is \c true, an extra pass over the values
+/// first finds the radix digits in [\p begin_bit, \p end_bit) which are
+/// the same in every value and waits for the result. The sort then skips
+/// these digits. This pays off when many of the bits are the same in all
+/// values but the range holding the differing bits is not known up front:
+/// \code
+/// boost::compute::sort(ids.begin(), ids.end(), 0, 64, true, queue);
+/// \endcode
+template<class T>
+inline void sort(buffer_iterator<T> first,
+                 buffer_iterator<T> last,
+                 uint_ begin_bit,
+                 uint_ end_bit,
+                 bool skip_uniform_digits,
+                 command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(detail::is_radix_sortable<T>::value);
+    ::boost::compute::detail::radix_sort(
+        first, last, begin_bit, end_bit, true, skip_uniform_digits, queue
+    );
+}
+
+/// Sorts the values in the range [\p first, \p last) according to
+/// \p compare using all of the command queues in \p queues.
+///
+/// The range is split into one chunk for each queue and the chunks are
+/// sorted concurrently. The sorted chunks are then merged in pairs until the
+/// whole range is sorted. Each merge is split along its merge path so that
+/// every queue merges an equal share of it. The queues must share the
+/// context of the range and this returns once the range is sorted.
+///
+/// For example, to sort with one queue for each NUMA node of a multi-socket
+/// CPU device:
+/// \code
+/// std::vector<boost::compute::device> nodes =
+///     device.partition_by_affinity_domain(CL_DEVICE_AFFINITY_DOMAIN_NUMA);
+/// boost::compute::context context(nodes);
+///
+/// std::vector<boost::compute::command_queue> queues;
+/// for(size_t i = 0; i < nodes.size(); i++){
+///     queues.push_back(boost::compute::command_queue(context, nodes[i]));
+/// }
+///
+/// boost::compute::sort(vec.begin(), vec.end(), queues);
+/// \endcode
+///
+/// Space complexity: \Omega(n)
+///
+/// \see sort()
+template<class Iterator, class Compare>
+inline void sort(Iterator first,
+                 Iterator last,
+                 Compare compare,
+                 std::vector<command_queue> &queues)
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
+
+    ::boost::compute::detail::multi_queue_sort(first, last, compare, queues);
+}
+
+/// \overload
+template<class Iterator>
+inline void sort(Iterator first,
+                 Iterator last,
+                 std::vector<command_queue> &queues)
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    ::boost::compute::sort(
+        first, last, ::boost::compute::less<value_type>(), queues
+    );
+}
+
+/// Asynchronous version of sort() for device iterators. The sort is
+/// enqueued after \p events and the returned future is ready once the range
+/// is sorted.
+///
+/// On GPUs nothing is read back to the host. The host still waits for the
+/// device in these cases:
+/// \li on CPU devices, built-in key types with more than 512 values are
+///     radix sorted and the mask of the key bits which differ is read back
+///     once to skip the uniform digits,
+/// \li sort() with \c skip_uniform_digits reads the same mask back on all
+///     devices and has no asynchronous version,
+/// \li segmented_sort() reads its chunk counters back to size the merge
+///     passes and has no asynchronous version.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see sort()
+template<class Iterator, class Compare>
+inline future<void>
+sort_async(Iterator first,
+           Iterator last,
+           Compare compare,
+           command_queue &queue = system::default_queue(),
+           const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<Iterator>::value);
+
+    ::boost::compute::detail::enqueue_wait_list(queue, events);
+    ::boost::compute::detail::dispatch_sort(first, last, compare, queue);
+
+    return future<void>(queue.enqueue_marker());
+}
+
+/// \overload
+template<class Iterator>
+inline future<void>
+sort_async(Iterator first,
+           Iterator last,
+           command_queue &queue = system::default_queue(),
+           const wait_list &events = wait_list())
+{
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    return ::boost::compute::sort_async(
+        first, last, ::boost::compute::less<value_type>(), queue, events
+    );
+}
+
 } // end compute namespace
 } // end boost namespace
 
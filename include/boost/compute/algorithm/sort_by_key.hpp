@@ -22,8 +22,10 @@
 #include <boost/compute/algorithm/detail/merge_sort_on_gpu.hpp>
 #include <boost/compute/algorithm/detail/insertion_sort.hpp>
 #include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/algorithm/detail/radix_sort_on_cpu.hpp>
 #include <boost/compute/algorithm/reverse.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
@@ -105,6 +107,73 @@ inline void dispatch_gpu_sort_by_key(KeyIterator keys_first,
     }
 }
 
+template<class KeyIterator, class ValueIterator>
+inline void
+dispatch_cpu_sort_by_key(KeyIterator keys_first,
+                         KeyIterator keys_last,
+                         ValueIterator values_first,
+                         less<typename std::iterator_traits<KeyIterator>::value_type> compare,
+                         command_queue &queue,
+                         typename boost::enable_if_c<
+                             is_radix_sortable<
+                                 typename std::iterator_traits<KeyIterator>::value_type
+                             >::value
+                         >::type* = 0)
+{
+    size_t count = detail::iterator_range_size(keys_first, keys_last);
+
+    if(count <= 512){
+        detail::merge_sort_by_key_on_cpu(
+            keys_first, keys_last, values_first, compare, queue
+        );
+    }
+    else {
+        detail::radix_sort_by_key_on_cpu(
+            keys_first, keys_last, values_first, true, queue
+        );
+    }
+}
+
+template<class KeyIterator, class ValueIterator>
+inline void
+dispatch_cpu_sort_by_key(KeyIterator keys_first,
+                         KeyIterator keys_last,
+                         ValueIterator values_first,
+                         greater<typename std::iterator_traits<KeyIterator>::value_type> compare,
+                         command_queue &queue,
+                         typename boost::enable_if_c<
+                             is_radix_sortable<
+                                 typename std::iterator_traits<KeyIterator>::value_type
+                             >::value
+                         >::type* = 0)
+{
+    size_t count = detail::iterator_range_size(keys_first, keys_last);
+
+    if(count <= 512){
+        detail::merge_sort_by_key_on_cpu(
+            keys_first, keys_last, values_first, compare, queue
+        );
+    }
+    else {
+        // radix sorts in descending order
+        detail::radix_sort_by_key_on_cpu(
+            keys_first, keys_last, values_first, false, queue
+        );
+    }
+}
+
+template<class KeyIterator, class ValueIterator, class Compare>
+inline void dispatch_cpu_sort_by_key(KeyIterator keys_first,
+                                     KeyIterator keys_last,
+                                     ValueIterator values_first,
+                                     Compare compare,
+                                     command_queue &queue)
+{
+    detail::merge_sort_by_key_on_cpu(
+        keys_first, keys_last, values_first, compare, queue
+    );
+}
+
 template<class KeyIterator, class ValueIterator, class Compare>
 inline void dispatch_sort_by_key(KeyIterator keys_first,
                                  KeyIterator keys_last,
@@ -116,9 +185,7 @@ inline void dispatch_sort_by_key(KeyIterator keys_first,
         dispatch_gpu_sort_by_key(keys_first, keys_last, values_first, compare, queue);
         return;
     }
-    ::boost::compute::detail::merge_sort_by_key_on_cpu(
-        keys_first, keys_last, values_first, compare, queue
-    );
+    dispatch_cpu_sort_by_key(keys_first, keys_last, values_first, compare, queue);
 }
 
 } // end detail namespace
@@ -162,6 +229,58 @@ inline void sort_by_key(KeyIterator keys_first,
     );
 }
 
+/// Performs a key-value sort using only the bits [\p begin_bit,
+/// \p end_bit) of the keys in the range [\p keys_first, \p keys_last).
+///
+/// The keys must be of a built-in scalar type and have the same value for
+/// the bits outside of the range. For signed and floating-point keys of
+/// mixed sign this means the range must include the sign bit. Sorting on
+/// fewer bits needs fewer radix sort passes, for example for 64-bit ids
+/// which only use their low 36 bits:
+/// \code
+/// boost::compute::sort_by_key(ids.begin(), ids.end(), values.begin(), 0, 36, queue);
+/// \endcode
+///
+/// The sort is stable.
+///
+/// Space complexity: \Omega(2n)
+///
+/// \see sort()
+template<class KeyType, class ValueType>
+inline void sort_by_key(buffer_iterator<KeyType> keys_first,
+                        buffer_iterator<KeyType> keys_last,
+                        buffer_iterator<ValueType> values_first,
+                        uint_ begin_bit,
+                        uint_ end_bit,
+                        command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(detail::is_radix_sortable<KeyType>::value);
+    ::boost::compute::detail::radix_sort_by_key(
+        keys_first, keys_last, values_first, begin_bit, end_bit, queue
+    );
+}
+
+/// \overload
+///
+/// If \p skip_uniform_digits is \c true, an extra pass over the keys first
+/// finds the radix digits in [\p begin_bit, \p end_bit) which are the same
+/// in every key and waits for the result. The sort then skips these digits.
+template<class KeyType, class ValueType>
+inline void sort_by_key(buffer_iterator<KeyType> keys_first,
+                        buffer_iterator<KeyType> keys_last,
+                        buffer_iterator<ValueType> values_first,
+                        uint_ begin_bit,
+                        uint_ end_bit,
+                        bool skip_uniform_digits,
+                        command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(detail::is_radix_sortable<KeyType>::value);
+    ::boost::compute::detail::radix_sort_by_key(
+        keys_first, keys_last, values_first, begin_bit, end_bit,
+        true, skip_uniform_digits, queue
+    );
+}
+
 } // end compute namespace
 } // end boost namespace
 
@@ -17,8 +17,11 @@
 #include <boost/compute/context.hpp>
 #include <boost/compute/functional.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/algorithm/copy_if.hpp>
 #include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
@@ -50,7 +53,10 @@ inline Iterator stable_partition(Iterator first,
     typedef typename std::iterator_traits<Iterator>::value_type value_type;
 
     // make temporary copy of the input
-    ::boost::compute::vector<value_type> tmp(first, last, queue);
+    detail::scratch_vector<value_type> tmp(
+        detail::iterator_range_size(first, last), queue
+    );
+    ::boost::compute::copy(first, last, tmp.begin(), queue);
 
     // copy true values
     Iterator last_true =
@@ -0,0 +1,217 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALGORITHM_TOP_K_HPP
+#define BOOST_COMPUTE_ALGORITHM_TOP_K_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/gather.hpp>
+#include <boost/compute/algorithm/detail/select_top_k.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// selects the first k keys of [keys_first, keys_first + count) to keys and
+// gathers their values to values_result. the positions of the selected
+// keys are stored as IndexType.
+template<class IndexType, class InputKeyIterator, class InputValueIterator,
+         class OutputValueIterator, class Compare>
+inline void top_k_by_key_with_index_type(InputKeyIterator keys_first,
+                                         const size_t count,
+                                         InputValueIterator values_first,
+                                         const size_t k,
+                                         const buffer_iterator<
+                                             typename std::iterator_traits<
+                                                 InputKeyIterator
+                                             >::value_type
+                                         > keys,
+                                         OutputValueIterator values_result,
+                                         Compare compare,
+                                         command_queue &queue)
+{
+    scratch_vector<IndexType> indices(k, queue);
+    select_top_k(
+        keys_first, count, k, compare, keys, indices.begin(), true, queue
+    );
+
+    ::boost::compute::gather(
+        indices.begin(), indices.end(), values_first, values_result, queue
+    );
+}
+
+} // end detail namespace
+
+/// Copies the first \p k elements of the range [\p first, \p last) in the
+/// order given by \p compare to the range beginning at \p result, sorted by
+/// \p compare. With the default \p compare (\c greater) these are the \p k
+/// largest elements in descending order.
+///
+/// Unlike sorting the whole range, top_k() reads the input about once: a
+/// sample of the input gives a threshold, a single pass collects the
+/// elements before the threshold and only those are sorted. If \p k is
+/// larger than the size of the range, the whole range is copied.
+///
+/// For example, to get the 100 largest scores:
+/// \code
+/// boost::compute::vector<float> top(100, context);
+/// boost::compute::top_k(
+///     scores.begin(), scores.end(), 100, top.begin(),
+///     boost::compute::greater<float>(), queue
+/// );
+/// \endcode
+///
+/// \param first first element in the input range
+/// \param last last element in the input range
+/// \param k number of elements to select
+/// \param result first element in the result range
+/// \param compare comparison function (by default \c greater)
+/// \param queue command queue to perform the operation
+///
+/// \return \c OutputIterator to the end of the result range
+///
+/// Space complexity: \Omega(k)
+///
+/// \see partial_sort(), partial_sort_copy(), top_k_by_key()
+template<class InputIterator, class OutputIterator, class Compare>
+inline OutputIterator top_k(InputIterator first,
+                            InputIterator last,
+                            size_t k,
+                            OutputIterator result,
+                            Compare compare,
+                            command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    const size_t count = detail::iterator_range_size(first, last);
+    k = (std::min)(k, count);
+    if(k == 0){
+        return result;
+    }
+
+    detail::scratch_vector<value_type> keys(k, queue);
+    detail::select_top_k(
+        first, count, k, compare, keys.begin(), buffer_iterator<uint_>(),
+        false, queue
+    );
+    return ::boost::compute::copy(keys.begin(), keys.end(), result, queue);
+}
+
+/// \overload
+template<class InputIterator, class OutputIterator>
+inline OutputIterator top_k(InputIterator first,
+                            InputIterator last,
+                            size_t k,
+                            OutputIterator result,
+                            command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    return ::boost::compute::top_k(
+        first, last, k, result, greater<value_type>(), queue
+    );
+}
+
+/// Copies the first \p k keys of the range [\p keys_first, \p keys_last) in
+/// the order given by \p compare to the range beginning at \p keys_result
+/// and the values associated with them (from the range beginning at
+/// \p values_first) to the range beginning at \p values_result.
+///
+/// Only the selected values are read, so the values do not have to be
+/// copied or sorted along with the keys.
+///
+/// \return a pair of iterators to the ends of the key and value results
+///
+/// Space complexity: \Omega(k)
+///
+/// \see top_k(), sort_by_key()
+template<class InputKeyIterator, class InputValueIterator,
+         class OutputKeyIterator, class OutputValueIterator, class Compare>
+inline std::pair<OutputKeyIterator, OutputValueIterator>
+top_k_by_key(InputKeyIterator keys_first,
+             InputKeyIterator keys_last,
+             InputValueIterator values_first,
+             size_t k,
+             OutputKeyIterator keys_result,
+             OutputValueIterator values_result,
+             Compare compare,
+             command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputKeyIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<InputValueIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputKeyIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputValueIterator>::value);
+    typedef typename std::iterator_traits<InputKeyIterator>::value_type key_type;
+
+    const size_t count = detail::iterator_range_size(keys_first, keys_last);
+    k = (std::min)(k, count);
+    if(k == 0){
+        return std::make_pair(keys_result, values_result);
+    }
+
+    detail::scratch_vector<key_type> keys(k, queue);
+    if(detail::requires_64bit_indices(count)){
+        detail::top_k_by_key_with_index_type<ulong_>(
+            keys_first, count, values_first, k, keys.begin(), values_result,
+            compare, queue
+        );
+    }
+    else {
+        detail::top_k_by_key_with_index_type<uint_>(
+            keys_first, count, values_first, k, keys.begin(), values_result,
+            compare, queue
+        );
+    }
+
+    return std::make_pair(
+        ::boost::compute::copy(keys.begin(), keys.end(), keys_result, queue),
+        values_result + k
+    );
+}
+
+/// \overload
+template<class InputKeyIterator, class InputValueIterator,
+         class OutputKeyIterator, class OutputValueIterator>
+inline std::pair<OutputKeyIterator, OutputValueIterator>
+top_k_by_key(InputKeyIterator keys_first,
+             InputKeyIterator keys_last,
+             InputValueIterator values_first,
+             size_t k,
+             OutputKeyIterator keys_result,
+             OutputValueIterator values_result,
+             command_queue &queue = system::default_queue())
+{
+    typedef typename std::iterator_traits<InputKeyIterator>::value_type key_type;
+
+    return ::boost::compute::top_k_by_key(
+        keys_first, keys_last, values_first, k, keys_result, values_result,
+        greater<key_type>(), queue
+    );
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALGORITHM_TOP_K_HPP
@@ -11,18 +11,101 @@
 #ifndef BOOST_COMPUTE_ALGORITHM_TRANSFORM_HPP
 #define BOOST_COMPUTE_ALGORITHM_TRANSFORM_HPP
 
+#include <vector>
+
 #include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
 #include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/detail/host_stream.hpp>
+#include <boost/compute/algorithm/detail/multi_queue.hpp>
+#include <boost/compute/detail/async_algorithm.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
 #include <boost/compute/iterator/transform_iterator.hpp>
 #include <boost/compute/iterator/zip_iterator.hpp>
 #include <boost/compute/functional/detail/unpack.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/type_traits/result_of.hpp>
+#include <boost/compute/utility/wait_list.hpp>
 
 namespace boost {
 namespace compute {
+namespace detail {
+
+// transforms each chunk of a host range streamed by host_stream_transform()
+template<class UnaryOperator>
+struct transform_stream_chunk
+{
+    transform_stream_chunk(UnaryOperator op)
+        : m_op(op)
+    {
+    }
+
+    template<class InputIterator, class OutputIterator>
+    void operator()(InputIterator first,
+                    InputIterator last,
+                    OutputIterator result,
+                    command_queue &queue) const
+    {
+        ::boost::compute::copy(
+            ::boost::compute::make_transform_iterator(first, m_op),
+            ::boost::compute::make_transform_iterator(last, m_op),
+            result,
+            queue
+        );
+    }
+
+    UnaryOperator m_op;
+};
+
+// transform() for device iterators
+template<class InputIterator, class OutputIterator, class UnaryOperator>
+inline OutputIterator dispatch_transform(InputIterator first,
+                                         InputIterator last,
+                                         OutputIterator result,
+                                         UnaryOperator op,
+                                         command_queue &queue,
+                                         typename boost::enable_if<
+                                             is_device_iterator<InputIterator>
+                                         >::type* = 0)
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+    return ::boost::compute::copy(
+               ::boost::compute::make_transform_iterator(first, op),
+               ::boost::compute::make_transform_iterator(last, op),
+               result,
+               queue
+           );
+}
+
+// transform() for host iterators
+template<class InputIterator, class OutputIterator, class UnaryOperator>
+inline OutputIterator dispatch_transform(InputIterator first,
+                                         InputIterator last,
+                                         OutputIterator result,
+                                         UnaryOperator op,
+                                         command_queue &queue,
+                                         typename boost::disable_if<
+                                             is_device_iterator<InputIterator>
+                                         >::type* = 0)
+{
+    BOOST_STATIC_ASSERT(!is_device_iterator<OutputIterator>::value);
+    typedef typename
+        std::iterator_traits<InputIterator>::value_type
+        input_type;
+    typedef typename
+        boost::compute::result_of<UnaryOperator(input_type)>::type
+        output_type;
+
+    return host_stream_transform<output_type>(
+        first, last, result, transform_stream_chunk<UnaryOperator>(op), queue
+    );
+}
+
+} // end detail namespace
 
 /// Transforms the elements in the range [\p first, \p last) using
 /// operator \p op and stores the results in the range beginning at
@@ -32,6 +115,12 @@ namespace compute {
 ///
 /// \snippet test/test_transform.cpp transform_abs
 ///
+/// When both ranges are host ranges the input is streamed through the
+/// device in chunks staged in pinned host memory. The upload of each chunk
+/// overlaps with the kernel on the chunk before it and with the download
+/// of the results for the chunk before that, so the ranges may be larger
+/// than the device memory.
+///
 /// Space complexity: \Omega(1)
 ///
 /// \see copy()
@@ -42,16 +131,76 @@ inline OutputIterator transform(InputIterator first,
                                 UnaryOperator op,
                                 command_queue &queue = system::default_queue())
 {
-    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    return detail::dispatch_transform(first, last, result, op, queue);
+}
+
+/// \overload
+template<class InputIterator1,
+         class InputIterator2,
+         class OutputIterator,
+         class BinaryOperator>
+inline OutputIterator transform(InputIterator1 first1,
+                                InputIterator1 last1,
+                                InputIterator2 first2,
+                                OutputIterator result,
+                                BinaryOperator op,
+                                command_queue &queue = system::default_queue())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator1>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator2>::value);
     BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
-    return copy(
-               ::boost::compute::make_transform_iterator(first, op),
-               ::boost::compute::make_transform_iterator(last, op),
+
+    typedef typename std::iterator_traits<InputIterator1>::difference_type difference_type;
+
+    difference_type n = std::distance(first1, last1);
+
+    return transform(
+               ::boost::compute::make_zip_iterator(boost::make_tuple(first1, first2)),
+               ::boost::compute::make_zip_iterator(boost::make_tuple(last1, first2 + n)),
                result,
+               detail::unpack(op),
                queue
            );
 }
 
+/// Transforms the elements in the range [\p first, \p last) using all of
+/// the command queues in \p queues.
+///
+/// The range is split into one chunk for each queue and the chunks are
+/// transformed concurrently. The queues must share the context of the
+/// ranges. The chunks start once the commands already enqueued to any of the
+/// queues have completed and commands enqueued to the first queue after this
+/// call run once every chunk has been transformed.
+///
+/// \see transform(), reduce()
+template<class InputIterator, class OutputIterator, class UnaryOperator>
+inline OutputIterator transform(InputIterator first,
+                                InputIterator last,
+                                OutputIterator result,
+                                UnaryOperator op,
+                                std::vector<command_queue> &queues)
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+    detail::check_multi_queue(queues);
+    detail::multi_queue_barrier(queues);
+
+    const size_t count = detail::iterator_range_size(first, last);
+    const std::vector<size_t> bounds =
+        detail::multi_queue_partition(count, queues.size());
+
+    for(size_t i = 0; i + 1 < bounds.size(); i++){
+        ::boost::compute::transform(first + bounds[i],
+                                    first + bounds[i + 1],
+                                    result + bounds[i],
+                                    op,
+                                    queues[i]);
+    }
+    detail::enqueue_wait_list(queues[0], detail::multi_queue_markers(queues));
+
+    return result + count;
+}
+
 /// \overload
 template<class InputIterator1,
          class InputIterator2,
@@ -62,7 +211,7 @@ inline OutputIterator transform(InputIterator1 first1,
                                 InputIterator2 first2,
                                 OutputIterator result,
                                 BinaryOperator op,
-                                command_queue &queue = system::default_queue())
+                                std::vector<command_queue> &queues)
 {
     BOOST_STATIC_ASSERT(is_device_iterator<InputIterator1>::value);
     BOOST_STATIC_ASSERT(is_device_iterator<InputIterator2>::value);
@@ -77,7 +226,66 @@ inline OutputIterator transform(InputIterator1 first1,
                ::boost::compute::make_zip_iterator(boost::make_tuple(last1, first2 + n)),
                result,
                detail::unpack(op),
-               queue
+               queues
+           );
+}
+
+/// Asynchronous version of transform(). The kernel is enqueued after
+/// \p events and the returned future holds the end of the output range.
+///
+/// The wait for \p events is enqueued to \p queue, so the host does not
+/// block on them (see command_queue::enqueue_wait_for_events()).
+///
+/// \see transform()
+template<class InputIterator, class OutputIterator, class UnaryOperator>
+inline future<OutputIterator>
+transform_async(InputIterator first,
+                InputIterator last,
+                OutputIterator result,
+                UnaryOperator op,
+                command_queue &queue = system::default_queue(),
+                const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+    return copy_async(
+               ::boost::compute::make_transform_iterator(first, op),
+               ::boost::compute::make_transform_iterator(last, op),
+               result,
+               queue,
+               events
+           );
+}
+
+/// \overload
+template<class InputIterator1,
+         class InputIterator2,
+         class OutputIterator,
+         class BinaryOperator>
+inline future<OutputIterator>
+transform_async(InputIterator1 first1,
+                InputIterator1 last1,
+                InputIterator2 first2,
+                OutputIterator result,
+                BinaryOperator op,
+                command_queue &queue = system::default_queue(),
+                const wait_list &events = wait_list())
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator1>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator2>::value);
+    BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+    typedef typename std::iterator_traits<InputIterator1>::difference_type difference_type;
+
+    difference_type n = std::distance(first1, last1);
+
+    return transform_async(
+               ::boost::compute::make_zip_iterator(boost::make_tuple(first1, first2)),
+               ::boost::compute::make_zip_iterator(boost::make_tuple(last1, first2 + n)),
+               result,
+               detail::unpack(op),
+               queue,
+               events
            );
 }
 
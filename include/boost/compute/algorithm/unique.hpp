@@ -15,9 +15,12 @@
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/algorithm/unique_copy.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/functional/operator.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
 #include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
@@ -46,7 +49,10 @@ inline InputIterator unique(InputIterator first,
     BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
     typedef typename std::iterator_traits<InputIterator>::value_type value_type;
 
-    vector<value_type> temp(first, last, queue);
+    detail::scratch_vector<value_type> temp(
+        detail::iterator_range_size(first, last), queue
+    );
+    ::boost::compute::copy(first, last, temp.begin(), queue);
 
     return ::boost::compute::unique_copy(
         temp.begin(), temp.end(), first, op, queue
@@ -17,5 +17,6 @@
 
 #include <boost/compute/allocator/buffer_allocator.hpp>
 #include <boost/compute/allocator/pinned_allocator.hpp>
+#include <boost/compute/allocator/pooled_allocator.hpp>
 
 #endif // BOOST_COMPUTE_ALLOCATOR_HPP
@@ -0,0 +1,635 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_ALLOCATOR_POOLED_ALLOCATOR_HPP
+#define BOOST_COMPUTE_ALLOCATOR_POOLED_ALLOCATOR_HPP
+
+#include <map>
+#include <set>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/config.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/event.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/device_ptr.hpp>
+#include <boost/compute/detail/mutex.hpp>
+
+namespace boost {
+namespace compute {
+
+/// \class pooled_allocator_statistics
+/// \brief Statistics for the memory pool used by pooled_allocator.
+///
+/// \see pooled_allocator::statistics()
+struct pooled_allocator_statistics
+{
+    pooled_allocator_statistics()
+        : hits(0),
+          misses(0),
+          bytes_in_use(0),
+          bytes_cached(0)
+    {
+    }
+
+    /// Returns the fraction of allocations which were served from the pool.
+    double hit_rate() const
+    {
+        const size_t total = hits + misses;
+
+        return total == 0 ? 0.0 : double(hits) / double(total);
+    }
+
+    /// Number of allocations served with cached memory.
+    size_t hits;
+
+    /// Number of allocations which required new memory from the OpenCL
+    /// implementation.
+    size_t misses;
+
+    /// Number of bytes currently handed out by the pool.
+    size_t bytes_in_use;
+
+    /// Number of bytes held by the pool for reuse.
+    size_t bytes_cached;
+};
+
+namespace detail {
+
+// caches released buffers in free lists indexed by size class. allocations
+// are rounded up to the next size class (four classes per power of two) so
+// that buffers for similar sizes can be reused.
+//
+// optionally, allocations of up to a quarter of the slab size are served by
+// carving equally-sized sub-buffers out of larger "slab" buffers.
+//
+// when a release queue is set a marker is enqueued to it for each released
+// buffer and the buffer is only reused once its marker has completed.
+class buffer_pool : boost::noncopyable
+{
+private:
+    // a released buffer and the marker which must complete before reuse
+    typedef std::pair<buffer, event> cached_buffer;
+    typedef std::map<size_t, std::vector<cached_buffer> > free_map;
+
+public:
+    buffer_pool(const context &context, cl_mem_flags flags)
+        : m_context(context),
+          m_flags(flags),
+          m_max_cached_size(0),
+          m_slab_size(0),
+          m_released(false)
+    {
+        m_alignment = 128;
+        const std::vector<device> devices = m_context.get_devices();
+        for(size_t i = 0; i < devices.size(); i++){
+            size_t device_alignment =
+                devices[i].get_info<cl_uint>(CL_DEVICE_MEM_BASE_ADDR_ALIGN) / 8;
+            m_alignment = (std::max)(m_alignment, device_alignment);
+        }
+    }
+
+    const context& get_context() const
+    {
+        return m_context;
+    }
+
+    // returns a buffer of at least size bytes. the returned buffer holds
+    // the only reference to its memory object.
+    buffer allocate(size_t size)
+    {
+        const size_t bytes = size_class(size);
+
+        unique_lock lock(m_mutex);
+
+        free_map::iterator i = m_free.find(bytes);
+        if(i != m_free.end()){
+            std::vector<cached_buffer> &free_list = i->second;
+            for(size_t j = free_list.size(); j > 0; j--){
+                const event &marker = free_list[j - 1].second;
+                if(marker.get() && marker.status() != CL_COMPLETE){
+                    continue;
+                }
+
+                buffer buf = free_list[j - 1].first;
+                free_list.erase(free_list.begin() + (j - 1));
+
+                m_statistics.hits++;
+                m_statistics.bytes_cached -= bytes;
+                m_statistics.bytes_in_use += bytes;
+                m_in_use.insert(buf.get());
+                return buf;
+            }
+        }
+
+        m_statistics.misses++;
+        m_statistics.bytes_in_use += bytes;
+
+    #ifdef BOOST_COMPUTE_CL_VERSION_1_1
+        if(m_slab_size != 0 && bytes <= m_slab_size / 4){
+            try {
+                buffer buf = carve_slab(bytes);
+                m_in_use.insert(buf.get());
+                return buf;
+            }
+            catch(...){
+                m_statistics.misses--;
+                m_statistics.bytes_in_use -= bytes;
+                throw;
+            }
+        }
+    #endif // BOOST_COMPUTE_CL_VERSION_1_1
+
+        lock.unlock();
+
+        buffer buf;
+        try {
+            buf = buffer(m_context, bytes, m_flags);
+        }
+        catch(...){
+            lock.lock();
+            m_statistics.misses--;
+            m_statistics.bytes_in_use -= bytes;
+            throw;
+        }
+
+        lock.lock();
+        m_in_use.insert(buf.get());
+        return buf;
+    }
+
+    // returns buf to the pool and resets it
+    void deallocate(buffer &buf)
+    {
+        const bool pooled = try_deallocate(buf);
+        BOOST_ASSERT(pooled);
+        (void) pooled;
+    }
+
+    // returns buf to the pool and resets it if it was allocated from the
+    // pool. otherwise buf is left alone and false is returned.
+    bool try_deallocate(buffer &buf)
+    {
+        // declared before the lock so that sub-buffers are released before
+        // their parent slab and outside of the lock
+        boost::shared_ptr<buffer> slab;
+
+        const size_t bytes = buf.size();
+
+        unique_lock lock(m_mutex);
+
+        if(m_in_use.erase(buf.get()) == 0){
+            return false;
+        }
+
+        m_statistics.bytes_in_use -= bytes;
+
+        if(m_released ||
+           (m_max_cached_size != 0 &&
+            m_statistics.bytes_cached + bytes > m_max_cached_size)){
+            std::map<cl_mem, boost::shared_ptr<buffer> >::iterator i =
+                m_slabs.find(buf.get());
+            if(i != m_slabs.end()){
+                slab = i->second;
+                m_slabs.erase(i);
+            }
+            lock.unlock();
+            buf = buffer();
+            return true;
+        }
+
+        event marker;
+        if(m_release_queue.get()){
+            marker = m_release_queue.enqueue_marker();
+        }
+
+        m_free[bytes].push_back(cached_buffer(buf, marker));
+        m_statistics.bytes_cached += bytes;
+        buf = buffer();
+        return true;
+    }
+
+    // releases all cached memory
+    void trim()
+    {
+        // declared before the lock so that memory is released after the
+        // lock is dropped, sub-buffers before their parent slabs
+        std::vector<boost::shared_ptr<buffer> > slabs;
+        free_map free_buffers;
+
+        unique_lock lock(m_mutex);
+
+        for(free_map::iterator i = m_free.begin(); i != m_free.end(); ++i){
+            for(size_t j = 0; j < i->second.size(); j++){
+                std::map<cl_mem, boost::shared_ptr<buffer> >::iterator k =
+                    m_slabs.find(i->second[j].first.get());
+                if(k != m_slabs.end()){
+                    slabs.push_back(k->second);
+                    m_slabs.erase(k);
+                }
+            }
+        }
+        m_free.swap(free_buffers);
+        m_statistics.bytes_cached = 0;
+    }
+
+    pooled_allocator_statistics statistics() const
+    {
+        unique_lock lock(m_mutex);
+
+        return m_statistics;
+    }
+
+    size_t max_cached_size() const
+    {
+        unique_lock lock(m_mutex);
+
+        return m_max_cached_size;
+    }
+
+    void set_max_cached_size(size_t size)
+    {
+        unique_lock lock(m_mutex);
+
+        m_max_cached_size = size;
+    }
+
+    size_t slab_size() const
+    {
+        unique_lock lock(m_mutex);
+
+        return m_slab_size;
+    }
+
+    void set_slab_size(size_t size)
+    {
+        unique_lock lock(m_mutex);
+
+        m_slab_size = size;
+    }
+
+    command_queue release_queue() const
+    {
+        unique_lock lock(m_mutex);
+
+        return m_release_queue;
+    }
+
+    void set_release_queue(const command_queue &queue)
+    {
+        unique_lock lock(m_mutex);
+
+        m_release_queue = queue;
+    }
+
+    // returns the pool for buffers with flags in context
+    static boost::shared_ptr<buffer_pool>
+    get(const context &context, cl_mem_flags flags)
+    {
+        unique_lock lock(pools_mutex());
+
+        boost::shared_ptr<buffer_pool> &pool =
+            pools()[pool_key(context.get(), flags)];
+        if(!pool){
+            pool = boost::make_shared<buffer_pool>(context, flags);
+        }
+
+        return pool;
+    }
+
+    // returns the pool for buffers with flags in context if there is one
+    static boost::shared_ptr<buffer_pool>
+    find(const context &context, cl_mem_flags flags)
+    {
+        unique_lock lock(pools_mutex());
+
+        pool_map &map = pools();
+        pool_map::iterator i = map.find(pool_key(context.get(), flags));
+        if(i == map.end()){
+            return boost::shared_ptr<buffer_pool>();
+        }
+
+        return i->second;
+    }
+
+    // releases the cached memory of the pools for context and removes them
+    // so that they no longer keep the context alive. memory still in use is
+    // released when it is deallocated.
+    static void release(const context &context)
+    {
+        std::vector<boost::shared_ptr<buffer_pool> > released;
+        {
+            unique_lock lock(pools_mutex());
+
+            pool_map &map = pools();
+            pool_map::iterator i = map.begin();
+            while(i != map.end()){
+                if(i->first.first == context.get()){
+                    released.push_back(i->second);
+                    map.erase(i++);
+                }
+                else {
+                    ++i;
+                }
+            }
+        }
+
+        for(size_t i = 0; i < released.size(); i++){
+            {
+                unique_lock lock(released[i]->m_mutex);
+                released[i]->m_released = true;
+                released[i]->m_release_queue = command_queue();
+            }
+            released[i]->trim();
+        }
+    }
+
+    // returns the number of bytes actually allocated for a request of size
+    // bytes
+    static size_t size_class(size_t size)
+    {
+        const size_t min_size = 256;
+        if(size <= min_size){
+            return min_size;
+        }
+
+        size_t power = min_size;
+        while(power * 2 <= size && power * 2 > power){
+            power *= 2;
+        }
+
+        const size_t step = power / 4;
+        return ((size + step - 1) / step) * step;
+    }
+
+private:
+    typedef std::pair<cl_context, cl_mem_flags> pool_key;
+    typedef std::map<pool_key, boost::shared_ptr<buffer_pool> > pool_map;
+
+    static pool_map& pools()
+    {
+        static pool_map map;
+
+        return map;
+    }
+
+    static mutex& pools_mutex()
+    {
+        static mutex m;
+
+        return m;
+    }
+
+  #ifdef BOOST_COMPUTE_CL_VERSION_1_1
+    // allocates a new slab, splits it into sub-buffers of size bytes and
+    // returns the first one. the others are added to the free list.
+    buffer carve_slab(size_t bytes)
+    {
+        const size_t stride = ((bytes + m_alignment - 1) / m_alignment) * m_alignment;
+        const size_t chunk_count = m_slab_size / stride;
+
+        boost::shared_ptr<buffer> slab =
+            boost::make_shared<buffer>(m_context, chunk_count * stride, m_flags);
+
+        // host pointer flags are inherited from the slab
+        const cl_mem_flags sub_flags =
+            m_flags & (buffer::read_write | buffer::read_only | buffer::write_only);
+
+        std::vector<cached_buffer> &free_list = m_free[bytes];
+        for(size_t i = 1; i < chunk_count; i++){
+            buffer chunk = slab->create_subbuffer(sub_flags, i * stride, bytes);
+            m_slabs[chunk.get()] = slab;
+            free_list.push_back(cached_buffer(chunk, event()));
+            m_statistics.bytes_cached += bytes;
+        }
+
+        buffer chunk = slab->create_subbuffer(sub_flags, 0, bytes);
+        m_slabs[chunk.get()] = slab;
+        return chunk;
+    }
+  #endif // BOOST_COMPUTE_CL_VERSION_1_1
+
+private:
+    context m_context;
+    cl_mem_flags m_flags;
+    size_t m_alignment;
+    size_t m_max_cached_size;
+    size_t m_slab_size;
+    command_queue m_release_queue;
+    bool m_released;
+    free_map m_free;
+    // buffers handed out by the pool
+    std::set<cl_mem> m_in_use;
+    // maps carved sub-buffers to their parent slab
+    std::map<cl_mem, boost::shared_ptr<buffer> > m_slabs;
+    pooled_allocator_statistics m_statistics;
+    mutable mutex m_mutex;
+};
+
+} // end detail namespace
+
+/// \class pooled_allocator
+/// \brief The pooled_allocator class caches memory released by containers.
+///
+/// The pooled_allocator class allocates memory with \ref buffer objects
+/// like buffer_allocator, but instead of releasing memory when it is
+/// deallocated the memory is kept in a pool and reused for later
+/// allocations of a similar size. This avoids calls to the OpenCL
+/// implementation in code which repeatedly creates and destroys
+/// containers, for example:
+///
+/// \code
+/// typedef boost::compute::vector<float, boost::compute::pooled_allocator<float> >
+///     pooled_vector;
+///
+/// for(int i = 0; i < iterations; i++){
+///     pooled_vector temp(size, context); // reuses memory after the first iteration
+///     ...
+/// }
+/// \endcode
+///
+/// Requested sizes are rounded up to one of four size classes per power of
+/// two. All pooled allocators for the same context share a single pool. The
+/// memory held by the pool can be released with trim() and limited with
+/// set_max_cached_size(). The pool keeps its context alive until
+/// release_pool() is called.
+///
+/// By default released memory is handed out again immediately. This is
+/// safe as long as all commands using pooled memory are enqueued to a
+/// single in-order command queue, as any later use of the memory is then
+/// ordered after the pending ones. Otherwise memory could be reused while
+/// commands using it are still pending. In that case set a release queue
+/// with set_release_queue(): a marker is enqueued to it whenever memory is
+/// released and the memory is only reused once the marker has completed.
+///
+/// With OpenCL 1.1 and later, small allocations can be served by carving
+/// sub-buffers out of larger slabs (see set_slab_size()). Slab carving is
+/// disabled by default.
+///
+/// \see buffer_allocator
+template<class T>
+class pooled_allocator
+{
+public:
+    typedef T value_type;
+    typedef detail::device_ptr<T> pointer;
+    typedef const detail::device_ptr<T> const_pointer;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /// Creates a pooled allocator for \p context.
+    explicit pooled_allocator(const context &context)
+        : m_pool(detail::buffer_pool::get(context, buffer::read_write))
+    {
+    }
+
+    /// Creates a new pooled allocator as a copy of \p other.
+    pooled_allocator(const pooled_allocator<T> &other)
+        : m_pool(other.m_pool)
+    {
+    }
+
+    /// Copies the pooled allocator from \p other to \c *this.
+    pooled_allocator<T>& operator=(const pooled_allocator<T> &other)
+    {
+        if(this != &other){
+            m_pool = other.m_pool;
+        }
+
+        return *this;
+    }
+
+    /// Destroys the pooled allocator.
+    ~pooled_allocator()
+    {
+    }
+
+    /// Allocates memory for \p n values of type \c T.
+    pointer allocate(size_type n)
+    {
+        buffer buf = m_pool->allocate(n * sizeof(T));
+        clRetainMemObject(buf.get());
+        return detail::device_ptr<T>(buf);
+    }
+
+    /// Returns the memory for \p p to the pool.
+    void deallocate(pointer p, size_type n)
+    {
+        BOOST_ASSERT(p.get_buffer().get_context() == get_context());
+
+        (void) n;
+
+        // take ownership of the reference acquired in allocate()
+        buffer buf(p.get_buffer().get(), false);
+        m_pool->deallocate(buf);
+    }
+
+    /// Returns the maximum number of values of type \c T which can be
+    /// allocated.
+    size_type max_size() const
+    {
+        return get_context().get_device().max_memory_alloc_size() / sizeof(T);
+    }
+
+    /// Returns the context for the allocator.
+    context get_context() const
+    {
+        return m_pool->get_context();
+    }
+
+    /// Releases all memory cached by the pool.
+    void trim()
+    {
+        m_pool->trim();
+    }
+
+    /// Returns statistics for the pool.
+    pooled_allocator_statistics statistics() const
+    {
+        return m_pool->statistics();
+    }
+
+    /// Returns the maximum number of bytes cached by the pool.
+    size_t max_cached_size() const
+    {
+        return m_pool->max_cached_size();
+    }
+
+    /// Sets the maximum number of bytes cached by the pool to \p size.
+    /// Memory released while the pool is full is returned to the OpenCL
+    /// implementation. A value of \c 0 (the default) means no limit.
+    void set_max_cached_size(size_t size)
+    {
+        m_pool->set_max_cached_size(size);
+    }
+
+    /// Returns the slab size for the pool.
+    size_t slab_size() const
+    {
+        return m_pool->slab_size();
+    }
+
+    /// Sets the slab size for the pool to \p size bytes. Allocations of
+    /// up to a quarter of \p size are served by sub-buffers carved from
+    /// slabs of \p size bytes. A value of \c 0 (the default) disables slab
+    /// carving. Has no effect with OpenCL 1.0.
+    void set_slab_size(size_t size)
+    {
+        m_pool->set_slab_size(size);
+    }
+
+    /// Returns the release queue for the pool.
+    command_queue release_queue() const
+    {
+        return m_pool->release_queue();
+    }
+
+    /// Sets the release queue for the pool to \p queue. Memory released
+    /// to the pool is only reused once every command enqueued to \p queue
+    /// before its release has completed. Passing a null command queue (the
+    /// default) reuses memory immediately.
+    void set_release_queue(const command_queue &queue)
+    {
+        m_pool->set_release_queue(queue);
+    }
+
+    /// Releases the memory cached by the pools for the context of the
+    /// allocator and removes them so that they no longer keep the context
+    /// alive. Memory still in use is released to the OpenCL implementation
+    /// when it is deallocated. Allocators created afterwards use a new pool.
+    void release_pool()
+    {
+        detail::buffer_pool::release(get_context());
+    }
+
+protected:
+    /// \internal_
+    void set_mem_flags(cl_mem_flags flags)
+    {
+        m_pool = detail::buffer_pool::get(get_context(), flags);
+    }
+
+private:
+    boost::shared_ptr<detail::buffer_pool> m_pool;
+};
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_ALLOCATOR_POOLED_ALLOCATOR_HPP
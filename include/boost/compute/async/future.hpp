@@ -11,6 +11,8 @@
 #ifndef BOOST_COMPUTE_ASYNC_FUTURE_HPP
 #define BOOST_COMPUTE_ASYNC_FUTURE_HPP
 
+#include <boost/function.hpp>
+
 #include <boost/compute/event.hpp>
 
 namespace boost {
@@ -35,9 +37,21 @@ public:
     {
     }
 
+    /// \internal_
+    ///
+    /// Creates a future whose result is returned by \p read, which is called
+    /// the first time get() is called. This is used for results which are
+    /// left in device memory until they are needed on the host.
+    future(const boost::function<T ()> &read, const event &event)
+        : m_event(event),
+          m_read(read)
+    {
+    }
+
     future(const future<T> &other)
         : m_result(other.m_result),
-          m_event(other.m_event)
+          m_event(other.m_event),
+          m_read(other.m_read)
     {
     }
 
@@ -46,6 +60,7 @@ public:
         if(this != &other){
             m_result = other.m_result;
             m_event = other.m_event;
+            m_read = other.m_read;
         }
 
         return *this;
@@ -61,6 +76,13 @@ public:
     {
         wait();
 
+        if(m_read){
+            m_result = m_read();
+
+            // the result is only read once
+            m_read.clear();
+        }
+
         return m_result;
     }
 
@@ -100,6 +122,7 @@ public:
 private:
     T m_result;
     event m_event;
+    boost::function<T ()> m_read;
 };
 
 /// \internal_
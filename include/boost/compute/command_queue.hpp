@@ -15,6 +15,8 @@
 #include <algorithm>
 
 #include <boost/assert.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 
 #include <boost/compute/config.hpp>
 #include <boost/compute/event.hpp>
@@ -31,12 +33,26 @@
 #include <boost/compute/detail/get_object_info.hpp>
 #include <boost/compute/detail/assert_cl_success.hpp>
 #include <boost/compute/detail/diagnostic.hpp>
+#include <boost/compute/detail/mutex.hpp>
 #include <boost/compute/utility/extents.hpp>
 
 namespace boost {
 namespace compute {
+
+class scratch_pool;
+
 namespace detail {
 
+// holds the scratch pool of a command queue. it is only created when the
+// pool is first requested (see scratch_pool::get_pool()) and is then shared
+// by the command_queue objects for the same OpenCL queue which use it, so
+// the pool lives as long as the last of them.
+struct command_queue_scratch_slot
+{
+    boost::shared_ptr<scratch_pool> pool;
+    mutex pool_mutex;
+};
+
 inline void BOOST_COMPUTE_CL_CALLBACK
 nullary_native_kernel_trampoline(void *user_func_ptr)
 {
@@ -163,7 +179,8 @@ public:
 
     /// Creates a new command queue object as a copy of \p other.
     command_queue(const command_queue &other)
-        : m_queue(other.m_queue)
+        : m_queue(other.m_queue),
+          m_scratch(other.m_scratch)
     {
         if(m_queue){
             clRetainCommandQueue(m_queue);
@@ -179,6 +196,7 @@ public:
             }
 
             m_queue = other.m_queue;
+            m_scratch = other.m_scratch;
 
             if(m_queue){
                 clRetainCommandQueue(m_queue);
@@ -191,9 +209,11 @@ public:
     #ifndef BOOST_COMPUTE_NO_RVALUE_REFERENCES
     /// Move-constructs a new command queue object from \p other.
     command_queue(command_queue&& other) BOOST_NOEXCEPT
-        : m_queue(other.m_queue)
+        : m_queue(other.m_queue),
+          m_scratch(other.m_scratch)
     {
         other.m_queue = 0;
+        other.m_scratch.reset();
     }
 
     /// Move-assigns the command queue from \p other to \c *this.
@@ -204,7 +224,9 @@ public:
         }
 
         m_queue = other.m_queue;
+        m_scratch = other.m_scratch;
         other.m_queue = 0;
+        other.m_scratch.reset();
 
         return *this;
     }
@@ -1617,6 +1639,45 @@ public:
     }
     #endif // BOOST_COMPUTE_CL_VERSION_1_2
 
+    /// Enqueues a wait for \p events in the queue. Commands enqueued after
+    /// this call only start once all of \p events have completed.
+    ///
+    /// On OpenCL 1.2 devices this enqueues a barrier with \p events as its
+    /// wait list, on older devices it uses the deprecated
+    /// clEnqueueWaitForEvents(). In both cases the host does not wait.
+    ///
+    /// \see_opencl_ref{clEnqueueBarrierWithWaitList}
+    void enqueue_wait_for_events(const wait_list &events)
+    {
+        BOOST_ASSERT(m_queue != 0);
+
+        if(events.empty()){
+            return;
+        }
+
+        cl_int ret = CL_SUCCESS;
+
+        #ifdef BOOST_COMPUTE_CL_VERSION_1_2
+        if(get_device().check_version(1, 2)){
+            ret = clEnqueueBarrierWithWaitList(
+                m_queue, events.size(), events.get_event_ptr(), 0
+            );
+        } else
+        #endif // BOOST_COMPUTE_CL_VERSION_1_2
+        {
+            // Suppress deprecated declarations warning
+            BOOST_COMPUTE_DISABLE_DEPRECATED_DECLARATIONS();
+            ret = clEnqueueWaitForEvents(
+                m_queue, events.size(), events.get_event_ptr()
+            );
+            BOOST_COMPUTE_ENABLE_DEPRECATED_DECLARATIONS();
+        }
+
+        if(ret != CL_SUCCESS){
+            BOOST_THROW_EXCEPTION(opencl_error(ret));
+        }
+    }
+
     /// Enqueues a marker in the queue and returns an event that can be
     /// used to track its progress.
     event enqueue_marker()
@@ -1945,7 +2006,11 @@ public:
     }
 
 private:
+    friend class scratch_pool;
+
     cl_command_queue m_queue;
+    // set by scratch_pool::get_pool() on first use
+    mutable boost::shared_ptr<detail::command_queue_scratch_slot> m_scratch;
 };
 
 inline buffer buffer::clone(command_queue &queue) const
@@ -22,6 +22,8 @@
 #include <boost/compute/container/flat_set.hpp>
 #include <boost/compute/container/mapped_view.hpp>
 #include <boost/compute/container/string.hpp>
+#include <boost/compute/container/unordered_map.hpp>
+#include <boost/compute/container/unordered_set.hpp>
 #include <boost/compute/container/vector.hpp>
 
 #endif // BOOST_COMPUTE_CONTAINER_HPP
@@ -0,0 +1,138 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_CONTAINER_DETAIL_FLAT_SEARCH_HPP
+#define BOOST_COMPUTE_CONTAINER_DETAIL_FLAT_SEARCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/exclusive_scan.hpp>
+#include <boost/compute/algorithm/scatter_if.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// what flat_search() writes for each query
+enum flat_search_mode
+{
+    // index of the first key not less than the query
+    flat_search_lower_bound,
+    // index of the key equal to the query, or size if there is none
+    flat_search_find,
+    // 1 if the query is in the keys, 0 otherwise
+    flat_search_contains,
+    // 0 if the query is in the keys, 1 otherwise
+    flat_search_missing
+};
+
+// searches for each of the count queries in the sorted range of size keys
+// with one binary search per work-item
+template<class KeyIterator, class QueryIterator, class OutputIterator>
+inline void flat_search(KeyIterator keys,
+                        size_t size,
+                        QueryIterator queries,
+                        size_t count,
+                        OutputIterator result,
+                        flat_search_mode mode,
+                        command_queue &queue)
+{
+    typedef typename std::iterator_traits<QueryIterator>::value_type query_type;
+    typedef typename std::iterator_traits<OutputIterator>::value_type result_type;
+
+    if(count == 0){
+        return;
+    }
+
+    meta_kernel k("flat_search");
+    k.set_index_type_for((std::max)(size, count));
+    k.add_set_index_arg("size", size);
+    const std::string index_type = k.index_type();
+
+    k <<
+        "const " << index_type << " i = get_global_id(0);\n" <<
+        k.decl<const query_type>("query") << " = " <<
+            queries[k.var<const uint_>("i")] << ";\n" <<
+        index_type << " first = 0;\n" <<
+        index_type << " last = size;\n" <<
+        "while(first < last){\n" <<
+        "    const " << index_type << " middle = first + (last - first) / 2;\n" <<
+        "    if(" << keys[k.var<const uint_>("middle")] << " < query){\n" <<
+        "        first = middle + 1;\n" <<
+        "    }\n" <<
+        "    else {\n" <<
+        "        last = middle;\n" <<
+        "    }\n" <<
+        "}\n";
+
+    if(mode == flat_search_lower_bound){
+        k << result[k.var<const uint_>("i")] << " = (" <<
+            type_name<result_type>() << ") first;\n";
+    }
+    else {
+        k <<
+            "const bool found = first < size && " <<
+                keys[k.var<const uint_>("first")] << " == query;\n";
+
+        if(mode == flat_search_find){
+            k << result[k.var<const uint_>("i")] << " = (" <<
+                type_name<result_type>() << ")(found ? first : size);\n";
+        }
+        else if(mode == flat_search_contains){
+            k << result[k.var<const uint_>("i")] << " = (" <<
+                type_name<result_type>() << ")(found ? 1 : 0);\n";
+        }
+        else {
+            k << result[k.var<const uint_>("i")] << " = (" <<
+                type_name<result_type>() << ")(found ? 0 : 1);\n";
+        }
+    }
+
+    k.exec_1d(queue, 0, count);
+}
+
+// copies the values in [first, first + count) whose flag is 1 to result,
+// keeping their order, and returns the number of values copied
+template<class InputIterator, class OutputIterator>
+inline size_t flat_compact(InputIterator first,
+                           size_t count,
+                           const buffer_iterator<uint_> flags,
+                           OutputIterator result,
+                           command_queue &queue)
+{
+    if(count == 0){
+        return 0;
+    }
+
+    scratch_vector<uint_> positions(count, queue);
+    ::boost::compute::exclusive_scan(
+        flags, flags + count, positions.begin(), queue
+    );
+    ::boost::compute::scatter_if(
+        first, first + count, positions.begin(), flags, result, queue
+    );
+
+    return read_single_value<uint_>(positions.get_buffer(), count - 1, queue) +
+           read_single_value<uint_>(flags.get_buffer(), flags.get_index() + count - 1, queue);
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_CONTAINER_DETAIL_FLAT_SEARCH_HPP
@@ -0,0 +1,494 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_CONTAINER_DETAIL_HASH_TABLE_HPP
+#define BOOST_COMPUTE_CONTAINER_DETAIL_HASH_TABLE_HPP
+
+#include <cmath>
+#include <cstddef>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/types/fundamental.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/functional/hash.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// the hash tables behind unordered_set and unordered_map use open addressing
+// with linear probing. each slot holds the bit pattern of its key (as a
+// uint) or one of two reserved patterns marking empty and erased slots.
+// keys are inserted by swapping an empty slot with atomic_cmpxchg(). erased
+// slots are never reused, they are dropped when the table is rehashed.
+template<class Key>
+struct hash_table_sentinels;
+
+template<>
+struct hash_table_sentinels<uint_>
+{
+    static uint_ empty() { return 0xffffffff; }
+    static uint_ erased() { return 0xfffffffe; }
+};
+
+template<>
+struct hash_table_sentinels<int_>
+{
+    // INT_MIN and INT_MIN + 1
+    static uint_ empty() { return 0x80000000; }
+    static uint_ erased() { return 0x80000001; }
+};
+
+template<>
+struct hash_table_sentinels<float_>
+{
+    // negative quiet nans
+    static uint_ empty() { return 0xffffffff; }
+    static uint_ erased() { return 0xfffffffe; }
+};
+
+// counters describing the state of a hash table
+struct hash_table_statistics
+{
+    hash_table_statistics()
+        : size(0),
+          erased(0),
+          bucket_count(0),
+          max_probe_length(0)
+    {
+    }
+
+    // fraction of the buckets holding keys
+    double load_factor() const
+    {
+        return bucket_count ? static_cast<double>(size) / bucket_count : 0.0;
+    }
+
+    // fraction of the buckets holding keys or erased markers, which is
+    // what the probe lengths depend on
+    double occupancy() const
+    {
+        return bucket_count ?
+            static_cast<double>(size + erased) / bucket_count : 0.0;
+    }
+
+    size_t size;
+    size_t erased;
+    size_t bucket_count;
+    size_t max_probe_length;
+};
+
+// returns the smallest power of two number of buckets which can hold size
+// keys without exceeding max_load_factor. at least one bucket always stays
+// empty so that probing terminates.
+inline size_t hash_table_bucket_count(size_t size, float max_load_factor)
+{
+    const size_t required =
+        static_cast<size_t>(std::ceil(size / static_cast<double>(max_load_factor))) + 1;
+
+    size_t buckets = 16;
+    while(buckets < required){
+        buckets *= 2;
+    }
+
+    return buckets;
+}
+
+// fills the table with empty slots
+template<class Key>
+inline void hash_table_clear(const buffer &table,
+                             size_t bucket_count,
+                             command_queue &queue)
+{
+    ::boost::compute::fill_n(
+        make_buffer_iterator<uint_>(table), bucket_count,
+        hash_table_sentinels<Key>::empty(), queue
+    );
+}
+
+// declares the sentinel constants and the table mask
+template<class Key>
+inline void hash_table_declare_constants(meta_kernel &k, size_t bucket_count)
+{
+    k <<
+        "const uint empty_key = (uint) " << hash_table_sentinels<Key>::empty() << ";\n" <<
+        "const uint erased_key = (uint) " << hash_table_sentinels<Key>::erased() << ";\n" <<
+        "const uint mask = " << uint_(bucket_count - 1) << ";\n";
+}
+
+// loads the key of work-item i from first and computes its home bucket
+template<class Key, class InputIterator>
+inline void hash_table_load_key(meta_kernel &k, InputIterator first)
+{
+    k <<
+        "const uint i = get_global_id(0);\n" <<
+        k.decl<const Key>("key") << " = " << first[k.var<const uint_>("i")] << ";\n" <<
+        "const uint bits = as_uint(key);\n" <<
+        "uint slot = ((uint) " << hash<Key>()(k.var<const Key>("key")) << ") & mask;\n";
+}
+
+// hooks for tables without mapped values
+struct hash_table_no_values
+{
+    void declare(meta_kernel &) const { }
+    void insert(meta_kernel &) const { }
+    void copy(meta_kernel &) const { }
+};
+
+// stores input[i] to table[slot] when a key is inserted
+template<class TableIterator, class InputIterator>
+struct hash_table_insert_values
+{
+    hash_table_insert_values(TableIterator table_, InputIterator input_)
+        : table(table_),
+          input(input_)
+    {
+    }
+
+    void declare(meta_kernel &) const { }
+
+    void insert(meta_kernel &k) const
+    {
+        k << table[k.var<const uint_>("slot")] << " = " <<
+            input[k.var<const uint_>("i")] << ";\n";
+    }
+
+    TableIterator table;
+    InputIterator input;
+};
+
+// writes 1 to result[i] if the key was found and 0 otherwise
+template<class OutputIterator>
+struct hash_table_contains_result
+{
+    typedef typename std::iterator_traits<OutputIterator>::value_type value_type;
+
+    hash_table_contains_result(OutputIterator result_)
+        : result(result_)
+    {
+    }
+
+    void declare(meta_kernel &) const { }
+
+    void found(meta_kernel &k) const
+    {
+        k << result[k.var<const uint_>("i")] << " = (" <<
+            type_name<value_type>() << ") 1;\n";
+    }
+
+    void missing(meta_kernel &k) const
+    {
+        k << result[k.var<const uint_>("i")] << " = (" <<
+            type_name<value_type>() << ") 0;\n";
+    }
+
+    OutputIterator result;
+};
+
+// writes the mapped value of the key to result[i], or default_value if the
+// key was not found
+template<class TableIterator, class OutputIterator, class T>
+struct hash_table_find_values
+{
+    hash_table_find_values(TableIterator table_,
+                           OutputIterator result_,
+                           const T &default_value_)
+        : table(table_),
+          result(result_),
+          default_value(default_value_)
+    {
+    }
+
+    void declare(meta_kernel &k) const
+    {
+        k.add_set_arg<const T>("default_value", default_value);
+    }
+
+    void found(meta_kernel &k) const
+    {
+        k << result[k.var<const uint_>("i")] << " = " <<
+            table[k.var<const uint_>("slot")] << ";\n";
+    }
+
+    void missing(meta_kernel &k) const
+    {
+        k << result[k.var<const uint_>("i")] << " = default_value;\n";
+    }
+
+    TableIterator table;
+    OutputIterator result;
+    T default_value;
+};
+
+// writes the key in slot to keys_result[index]
+template<class Key, class KeyIterator, class Values>
+struct hash_table_copy_items
+{
+    hash_table_copy_items(KeyIterator keys_result_, const Values &values_)
+        : keys_result(keys_result_),
+          values(values_)
+    {
+    }
+
+    void declare(meta_kernel &k) const
+    {
+        values.declare(k);
+    }
+
+    void copy(meta_kernel &k) const
+    {
+        k << keys_result[k.var<const uint_>("index")] << " = as_" <<
+            type_name<Key>() << "(bits);\n";
+        values.copy(k);
+    }
+
+    KeyIterator keys_result;
+    Values values;
+};
+
+// writes the mapped value in slot to result[index]
+template<class TableIterator, class OutputIterator>
+struct hash_table_copy_values
+{
+    hash_table_copy_values(TableIterator table_, OutputIterator result_)
+        : table(table_),
+          result(result_)
+    {
+    }
+
+    void declare(meta_kernel &) const { }
+
+    void copy(meta_kernel &k) const
+    {
+        k << result[k.var<const uint_>("index")] << " = " <<
+            table[k.var<const uint_>("slot")] << ";\n";
+    }
+
+    TableIterator table;
+    OutputIterator result;
+};
+
+// inserts the count keys starting at first and returns the number of keys
+// which were not in the table before. the table must have room for all of
+// them. reserved keys (the sentinels) are skipped.
+template<class Key, class InputIterator, class Values>
+inline size_t hash_table_insert(const buffer &table,
+                                size_t bucket_count,
+                                InputIterator first,
+                                size_t count,
+                                const Values &values,
+                                command_queue &queue)
+{
+    if(count == 0){
+        return 0;
+    }
+
+    scratch_vector<uint_> counter(1, queue);
+    write_single_value<uint_>(0, counter.get_buffer(), queue);
+
+    meta_kernel k("hash_table_insert");
+    size_t table_arg = k.add_arg<uint_ *>(memory_object::global_memory, "table");
+    size_t counter_arg = k.add_arg<uint_ *>(memory_object::global_memory, "counter");
+    k.set_arg(table_arg, table);
+    k.set_arg(counter_arg, counter.get_buffer());
+    values.declare(k);
+
+    hash_table_declare_constants<Key>(k, bucket_count);
+    hash_table_load_key<Key>(k, first);
+    k <<
+        "if(bits == empty_key || bits == erased_key){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "for(;;){\n" <<
+        "    const uint old = atomic_cmpxchg(table + slot, empty_key, bits);\n" <<
+        "    if(old == empty_key){\n";
+    values.insert(k);
+    k <<
+        "        atomic_inc(counter);\n" <<
+        "        return;\n" <<
+        "    }\n" <<
+        "    else if(old == bits){\n" <<
+        "        return;\n" <<
+        "    }\n" <<
+        "    slot = (slot + 1) & mask;\n" <<
+        "}\n";
+
+    k.exec_1d(queue, 0, count);
+
+    return read_single_value<uint_>(counter.get_buffer(), queue);
+}
+
+// looks up the count keys starting at first, the result hook is called with
+// slot set to the bucket of each key that was found
+template<class Key, class InputIterator, class Result>
+inline void hash_table_find(const buffer &table,
+                            size_t bucket_count,
+                            InputIterator first,
+                            size_t count,
+                            const Result &result,
+                            command_queue &queue)
+{
+    if(count == 0){
+        return;
+    }
+
+    meta_kernel k("hash_table_find");
+    size_t table_arg =
+        k.add_arg<const uint_ *>(memory_object::global_memory, "table");
+    k.set_arg(table_arg, table);
+    result.declare(k);
+
+    hash_table_declare_constants<Key>(k, bucket_count);
+    hash_table_load_key<Key>(k, first);
+    k <<
+        "if(bits != empty_key && bits != erased_key){\n" <<
+        "    for(uint probe = 0; probe <= mask; probe++){\n" <<
+        "        const uint current = table[slot];\n" <<
+        "        if(current == bits){\n";
+    result.found(k);
+    k <<
+        "            return;\n" <<
+        "        }\n" <<
+        "        else if(current == empty_key){\n" <<
+        "            break;\n" <<
+        "        }\n" <<
+        "        slot = (slot + 1) & mask;\n" <<
+        "    }\n" <<
+        "}\n";
+    result.missing(k);
+
+    k.exec_1d(queue, 0, count);
+}
+
+// marks the slots of the count keys starting at first as erased and
+// returns the number of keys which were in the table
+template<class Key, class InputIterator>
+inline size_t hash_table_erase(const buffer &table,
+                               size_t bucket_count,
+                               InputIterator first,
+                               size_t count,
+                               command_queue &queue)
+{
+    if(count == 0){
+        return 0;
+    }
+
+    scratch_vector<uint_> counter(1, queue);
+    write_single_value<uint_>(0, counter.get_buffer(), queue);
+
+    meta_kernel k("hash_table_erase");
+    size_t table_arg = k.add_arg<uint_ *>(memory_object::global_memory, "table");
+    size_t counter_arg = k.add_arg<uint_ *>(memory_object::global_memory, "counter");
+    k.set_arg(table_arg, table);
+    k.set_arg(counter_arg, counter.get_buffer());
+
+    hash_table_declare_constants<Key>(k, bucket_count);
+    hash_table_load_key<Key>(k, first);
+    k <<
+        "if(bits == empty_key || bits == erased_key){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "for(uint probe = 0; probe <= mask; probe++){\n" <<
+        "    const uint current = table[slot];\n" <<
+        "    if(current == bits){\n" <<
+        "        if(atomic_cmpxchg(table + slot, bits, erased_key) == bits){\n" <<
+        "            atomic_inc(counter);\n" <<
+        "        }\n" <<
+        "        return;\n" <<
+        "    }\n" <<
+        "    else if(current == empty_key){\n" <<
+        "        return;\n" <<
+        "    }\n" <<
+        "    slot = (slot + 1) & mask;\n" <<
+        "}\n";
+
+    k.exec_1d(queue, 0, count);
+
+    return read_single_value<uint_>(counter.get_buffer(), queue);
+}
+
+// calls the copy hook with index set to a unique position in [0, size) for
+// each key in the table and returns the number of keys. the order of the
+// keys is unspecified.
+template<class Key, class Items>
+inline size_t hash_table_copy(const buffer &table,
+                              size_t bucket_count,
+                              const Items &items,
+                              command_queue &queue)
+{
+    scratch_vector<uint_> counter(1, queue);
+    write_single_value<uint_>(0, counter.get_buffer(), queue);
+
+    meta_kernel k("hash_table_copy");
+    size_t table_arg =
+        k.add_arg<const uint_ *>(memory_object::global_memory, "table");
+    size_t counter_arg = k.add_arg<uint_ *>(memory_object::global_memory, "counter");
+    k.set_arg(table_arg, table);
+    k.set_arg(counter_arg, counter.get_buffer());
+    items.declare(k);
+
+    hash_table_declare_constants<Key>(k, bucket_count);
+    k <<
+        "const uint slot = get_global_id(0);\n" <<
+        "const uint bits = table[slot];\n" <<
+        "if(bits == empty_key || bits == erased_key){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        "const uint index = atomic_inc(counter);\n";
+    items.copy(k);
+
+    k.exec_1d(queue, 0, bucket_count);
+
+    return read_single_value<uint_>(counter.get_buffer(), queue);
+}
+
+// returns the largest number of slots visited to find a key in the table
+template<class Key>
+inline size_t hash_table_max_probe_length(const buffer &table,
+                                          size_t bucket_count,
+                                          command_queue &queue)
+{
+    scratch_vector<uint_> counter(1, queue);
+    write_single_value<uint_>(0, counter.get_buffer(), queue);
+
+    meta_kernel k("hash_table_max_probe_length");
+    size_t table_arg =
+        k.add_arg<const uint_ *>(memory_object::global_memory, "table");
+    size_t counter_arg = k.add_arg<uint_ *>(memory_object::global_memory, "counter");
+    k.set_arg(table_arg, table);
+    k.set_arg(counter_arg, counter.get_buffer());
+
+    hash_table_declare_constants<Key>(k, bucket_count);
+    k <<
+        "const uint slot = get_global_id(0);\n" <<
+        "const uint bits = table[slot];\n" <<
+        "if(bits == empty_key || bits == erased_key){\n" <<
+        "    return;\n" <<
+        "}\n" <<
+        k.decl<const Key>("key") << " = as_" << type_name<Key>() << "(bits);\n" <<
+        "const uint home = ((uint) " << hash<Key>()(k.var<const Key>("key")) << ") & mask;\n" <<
+        "atomic_max(counter, ((slot - home) & mask) + 1);\n";
+
+    k.exec_1d(queue, 0, bucket_count);
+
+    return read_single_value<uint_>(counter.get_buffer(), queue);
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_CONTAINER_DETAIL_HASH_TABLE_HPP
@@ -0,0 +1,336 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_CONTAINER_DETAIL_VALARRAY_EXPRESSION_HPP
+#define BOOST_COMPUTE_CONTAINER_DETAIL_VALARRAY_EXPRESSION_HPP
+
+#include <cstddef>
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/type_traits/is_fundamental.hpp>
+
+namespace boost {
+namespace compute {
+
+template<class T>
+class valarray;
+
+namespace detail {
+
+// base class for valarray and the lazy expressions built from valarrays by
+// the valarray operators. the expression nodes are only evaluated when they
+// are assigned to a valarray, at which point the whole expression tree is
+// written out as a single kernel (see valarray_assign()).
+//
+// each node provides:
+//   - value_type: the type of the element computed by the node
+//   - size() and get_context(): taken from its first non-scalar operand
+//     (scalar nodes have neither)
+//   - emit(kernel, scalars): writes the element at index 'i' to the kernel
+//     source, scalars counts the scalar arguments added to the kernel so far
+template<class Derived>
+class valarray_expression
+{
+public:
+    const Derived& derived() const
+    {
+        return static_cast<const Derived &>(*this);
+    }
+};
+
+// reads the elements of a buffer
+template<class T>
+class valarray_terminal : public valarray_expression<valarray_terminal<T> >
+{
+public:
+    typedef T value_type;
+
+    explicit valarray_terminal(const buffer &buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    size_t size() const
+    {
+        return m_buffer.size() / sizeof(T);
+    }
+
+    context get_context() const
+    {
+        return m_buffer.get_context();
+    }
+
+    void emit(meta_kernel &k, size_t &) const
+    {
+        k << k.get_buffer_identifier<T>(m_buffer) << "[i]";
+    }
+
+private:
+    // holds a reference to the buffer so that the valarray it came from can
+    // be reallocated by the assignment which evaluates the expression
+    buffer m_buffer;
+};
+
+// a scalar value which is passed to the kernel as an argument
+template<class T>
+class valarray_scalar : public valarray_expression<valarray_scalar<T> >
+{
+public:
+    typedef T value_type;
+
+    explicit valarray_scalar(const T &value)
+        : m_value(value)
+    {
+    }
+
+    void emit(meta_kernel &k, size_t &scalars) const
+    {
+        const std::string name =
+            "_scalar" + boost::lexical_cast<std::string>(scalars++);
+        k.add_set_arg<const T>(name, m_value);
+
+        k << name;
+    }
+
+private:
+    T m_value;
+};
+
+// true for the value types of valarray expressions, which are the OpenCL
+// built-in types and char (the result of comparisons)
+template<class T>
+struct valarray_is_fundamental :
+    public boost::integral_constant<
+        bool, is_fundamental<T>::value || boost::is_same<T, char>::value
+    >
+{
+};
+
+// maps an operand of a valarray operator to the expression node stored in
+// the resulting expression
+template<class Expr>
+struct valarray_operand
+{
+    typedef Expr type;
+
+    static type get(const Expr &expr)
+    {
+        return expr;
+    }
+};
+
+template<class T>
+struct valarray_operand<valarray<T> >
+{
+    typedef valarray_terminal<T> type;
+
+    static type get(const valarray<T> &array)
+    {
+        return type(array.get_buffer());
+    }
+};
+
+// applies the prefix operator Op to its operand
+template<class Op, class Operand>
+class valarray_unary :
+    public valarray_expression<valarray_unary<Op, Operand> >
+{
+public:
+    typedef typename Op::template result<
+        typename Operand::value_type
+    >::type value_type;
+
+    explicit valarray_unary(const Operand &operand)
+        : m_operand(operand)
+    {
+    }
+
+    size_t size() const
+    {
+        return m_operand.size();
+    }
+
+    context get_context() const
+    {
+        return m_operand.get_context();
+    }
+
+    void emit(meta_kernel &k, size_t &scalars) const
+    {
+        k << "(" << Op::symbol();
+        m_operand.emit(k, scalars);
+        k << ")";
+    }
+
+private:
+    Operand m_operand;
+};
+
+// applies the infix operator Op to its operands, at most one of which is
+// a scalar
+template<class Op, class Lhs, class Rhs>
+class valarray_binary :
+    public valarray_expression<valarray_binary<Op, Lhs, Rhs> >
+{
+public:
+    typedef typename Op::template result<
+        typename Lhs::value_type
+    >::type value_type;
+
+    valarray_binary(const Lhs &lhs, const Rhs &rhs)
+        : m_lhs(lhs),
+          m_rhs(rhs)
+    {
+    }
+
+    size_t size() const
+    {
+        return first_size(m_lhs, m_rhs);
+    }
+
+    context get_context() const
+    {
+        return first_context(m_lhs, m_rhs);
+    }
+
+    void emit(meta_kernel &k, size_t &scalars) const
+    {
+        k << "(";
+        m_lhs.emit(k, scalars);
+        k << " " << Op::symbol() << " ";
+        m_rhs.emit(k, scalars);
+        k << ")";
+    }
+
+private:
+    template<class T, class Expr>
+    static size_t first_size(const valarray_scalar<T> &, const Expr &expr)
+    {
+        return expr.size();
+    }
+
+    template<class Expr1, class Expr2>
+    static size_t first_size(const Expr1 &expr, const Expr2 &)
+    {
+        return expr.size();
+    }
+
+    template<class T, class Expr>
+    static context first_context(const valarray_scalar<T> &, const Expr &expr)
+    {
+        return expr.get_context();
+    }
+
+    template<class Expr1, class Expr2>
+    static context first_context(const Expr1 &expr, const Expr2 &)
+    {
+        return expr.get_context();
+    }
+
+private:
+    Lhs m_lhs;
+    Rhs m_rhs;
+};
+
+// operators computing a value of their operand type
+#define BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(name, op) \
+    struct valarray_##name \
+    { \
+        template<class T> \
+        struct result \
+        { \
+            typedef T type; \
+        }; \
+        \
+        static const char* symbol() \
+        { \
+            return #op; \
+        } \
+    };
+
+// comparison and logical operators, there are no bool buffers in OpenCL so
+// their result is stored as a char (1 for true and 0 for false)
+#define BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(name, op) \
+    struct valarray_##name \
+    { \
+        template<class T> \
+        struct result \
+        { \
+            typedef char type; \
+        }; \
+        \
+        static const char* symbol() \
+        { \
+            return #op; \
+        } \
+    };
+
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(negate, -)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(bit_not, ~)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(plus, +)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(minus, -)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(multiplies, *)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(divides, /)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(modulus, %)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(bit_xor, ^)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(bit_and, &)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(bit_or, |)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(shift_left, <<)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR(shift_right, >>)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(logical_not, !)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(equal_to, ==)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(not_equal_to, !=)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(greater, >)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(less, <)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(greater_equal, >=)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(less_equal, <=)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(logical_and, &&)
+BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE(logical_or, ||)
+
+#undef BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_OPERATOR
+#undef BOOST_COMPUTE_DETAIL_DEFINE_VALARRAY_PREDICATE
+
+// evaluates expr into the buffer result (which may also be read by expr)
+// with a single kernel
+template<class T, class Expr>
+inline void valarray_assign(const buffer &result,
+                            const Expr &expr,
+                            command_queue &queue)
+{
+    const size_t size = expr.size();
+    if(size == 0){
+        return;
+    }
+
+    meta_kernel k("valarray_expression");
+    k.set_index_type_for(size);
+
+    size_t scalars = 0;
+    k << "const " << k.index_type() << " i = get_global_id(0);\n" <<
+         k.get_buffer_identifier<T>(result) << "[i] = ";
+    expr.emit(k, scalars);
+    k << ";\n";
+
+    k.exec_1d(queue, 0, size);
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_CONTAINER_DETAIL_VALARRAY_EXPRESSION_HPP
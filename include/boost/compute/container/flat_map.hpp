@@ -16,17 +16,28 @@
 #include <exception>
 
 #include <boost/config.hpp>
+#include <boost/static_assert.hpp>
 #include <boost/throw_exception.hpp>
 
 #include <boost/compute/exception.hpp>
-#include <boost/compute/algorithm/find.hpp>
+#include <boost/compute/lambda.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/count.hpp>
 #include <boost/compute/algorithm/lower_bound.hpp>
+#include <boost/compute/algorithm/merge.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/unique.hpp>
 #include <boost/compute/algorithm/upper_bound.hpp>
 #include <boost/compute/container/vector.hpp>
+#include <boost/compute/container/detail/flat_search.hpp>
 #include <boost/compute/functional/get.hpp>
 #include <boost/compute/iterator/transform_iterator.hpp>
 #include <boost/compute/types/pair.hpp>
 #include <boost/compute/detail/buffer_value.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
 namespace compute {
@@ -200,6 +211,90 @@ public:
         return result;
     }
 
+    /// Inserts the key-value pairs in the range [\p first, \p last) whose
+    /// keys are not already in the map. Keys which are already in the map
+    /// keep their current value. If the range contains the same key more
+    /// than once, which of its values is inserted is unspecified.
+    ///
+    /// The new pairs are sorted by key and deduplicated, the ones whose key
+    /// is already in the map are removed with a batched binary search and
+    /// the rest is merged with the current pairs, so the cost is
+    /// O(n log n + size()) for n new pairs.
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last, command_queue &queue)
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        using ::boost::compute::lambda::_1;
+        using ::boost::compute::lambda::_2;
+        using ::boost::compute::lambda::get;
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return;
+        }
+
+        // sort and deduplicate the new pairs by key
+        detail::scratch_vector<value_type> values(count, queue);
+        ::boost::compute::copy(first, last, values.begin(), queue);
+        ::boost::compute::sort(
+            values.begin(), values.end(), get<0>(_1) < get<0>(_2), queue
+        );
+        const size_type unique_count = detail::iterator_range_size(
+            values.begin(),
+            ::boost::compute::unique(
+                values.begin(), values.end(), get<0>(_1) == get<0>(_2), queue
+            )
+        );
+
+        // drop the pairs whose keys are already in the map
+        ::boost::compute::get<0> get_key;
+        detail::scratch_vector<uint_> missing(unique_count, queue);
+        detail::flat_search(
+            ::boost::compute::make_transform_iterator(begin(), get_key),
+            size(),
+            ::boost::compute::make_transform_iterator(values.begin(), get_key),
+            unique_count,
+            missing.begin(),
+            detail::flat_search_missing,
+            queue
+        );
+        detail::scratch_vector<value_type> new_values(unique_count, queue);
+        const size_type new_count = detail::flat_compact(
+            values.begin(), unique_count, missing.begin(), new_values.begin(), queue
+        );
+        if(new_count == 0){
+            return;
+        }
+
+        vector_type merged(size() + new_count, m_vector.get_allocator().get_context());
+        if(empty()){
+            ::boost::compute::copy(
+                new_values.begin(), new_values.begin() + new_count,
+                merged.begin(), queue
+            );
+        }
+        else {
+            ::boost::compute::merge(
+                begin(), end(),
+                new_values.begin(), new_values.begin() + new_count,
+                merged.begin(),
+                get<0>(_1) < get<0>(_2),
+                queue
+            );
+        }
+        m_vector.swap(merged);
+    }
+
+    /// \overload
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        command_queue queue = m_vector.default_queue();
+        insert(first, last, queue);
+        queue.finish();
+    }
+
     iterator erase(const const_iterator &position, command_queue &queue)
     {
         return erase(position, position + 1, queue);
@@ -241,16 +336,65 @@ public:
         }
     }
 
-    iterator find(const key_type &value, command_queue &queue)
+    /// Removes the pairs whose keys are in the range [\p first, \p last)
+    /// from the map and returns the number of pairs which were removed.
+    ///
+    /// The keys of the map are looked up in the sorted range of keys to
+    /// remove and the remaining pairs are compacted, which takes
+    /// O(n log n + size() log n) work for n keys.
+    template<class InputIterator>
+    size_type erase_keys(InputIterator first,
+                         InputIterator last,
+                         command_queue &queue)
     {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0 || empty()){
+            return 0;
+        }
+
+        detail::scratch_vector<Key> keys(count, queue);
+        ::boost::compute::copy(first, last, keys.begin(), queue);
+        ::boost::compute::sort(keys.begin(), keys.end(), queue);
+
+        // keep the pairs whose keys are not in the sorted range
         ::boost::compute::get<0> get_key;
+        detail::scratch_vector<uint_> keep(size(), queue);
+        detail::flat_search(
+            keys.begin(),
+            count,
+            ::boost::compute::make_transform_iterator(begin(), get_key),
+            size(),
+            keep.begin(),
+            detail::flat_search_missing,
+            queue
+        );
+
+        vector_type kept(size(), m_vector.get_allocator().get_context());
+        const size_type kept_count = detail::flat_compact(
+            begin(), size(), keep.begin(), kept.begin(), queue
+        );
+        kept.resize(kept_count, queue);
+
+        const size_type erased = size() - kept_count;
+        m_vector.swap(kept);
+        return erased;
+    }
+
+    /// \overload
+    template<class InputIterator>
+    size_type erase_keys(InputIterator first, InputIterator last)
+    {
+        command_queue queue = m_vector.default_queue();
+        size_type result = erase_keys(first, last, queue);
+        queue.finish();
+        return result;
+    }
 
-        return ::boost::compute::find(
-                   ::boost::compute::make_transform_iterator(begin(), get_key),
-                   ::boost::compute::make_transform_iterator(end(), get_key),
-                   value,
-                   queue
-               ).base();
+    iterator find(const key_type &value, command_queue &queue)
+    {
+        return begin() + find_index(value, queue);
     }
 
     iterator find(const key_type &value)
@@ -263,14 +407,7 @@ public:
 
     const_iterator find(const key_type &value, command_queue &queue) const
     {
-        ::boost::compute::get<0> get_key;
-
-        return ::boost::compute::find(
-                   ::boost::compute::make_transform_iterator(begin(), get_key),
-                   ::boost::compute::make_transform_iterator(end(), get_key),
-                   value,
-                   queue
-               ).base();
+        return begin() + find_index(value, queue);
     }
 
     const_iterator find(const key_type &value) const
@@ -294,6 +431,81 @@ public:
         return result;
     }
 
+    /// Writes the position of each key in [\p first, \p last) in the map
+    /// to the range beginning at \p result, or size() for keys which are
+    /// not in the map. Each key is found with a binary search.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find(InputIterator first,
+                        InputIterator last,
+                        OutputIterator result,
+                        command_queue &queue) const
+    {
+        return search(first, last, result, detail::flat_search_find, queue);
+    }
+
+    /// \overload
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find(InputIterator first,
+                        InputIterator last,
+                        OutputIterator result) const
+    {
+        command_queue queue = m_vector.default_queue();
+        OutputIterator end = find(first, last, result, queue);
+        queue.finish();
+        return end;
+    }
+
+    /// Writes \c 1 to the range beginning at \p result for each key in
+    /// [\p first, \p last) which is in the map and \c 0 for the others.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator contains(InputIterator first,
+                            InputIterator last,
+                            OutputIterator result,
+                            command_queue &queue) const
+    {
+        return search(first, last, result, detail::flat_search_contains, queue);
+    }
+
+    /// \overload
+    template<class InputIterator, class OutputIterator>
+    OutputIterator contains(InputIterator first,
+                            InputIterator last,
+                            OutputIterator result) const
+    {
+        command_queue queue = m_vector.default_queue();
+        OutputIterator end = contains(first, last, result, queue);
+        queue.finish();
+        return end;
+    }
+
+    /// Returns the number of keys in [\p first, \p last) which are in the
+    /// map.
+    template<class InputIterator>
+    size_type count(InputIterator first,
+                    InputIterator last,
+                    command_queue &queue) const
+    {
+        const size_type query_count = detail::iterator_range_size(first, last);
+        if(query_count == 0){
+            return 0;
+        }
+
+        detail::scratch_vector<uint_> found(query_count, queue);
+        contains(first, last, found.begin(), queue);
+
+        return ::boost::compute::count(found.begin(), found.end(), uint_(1), queue);
+    }
+
+    /// \overload
+    template<class InputIterator>
+    size_type count(InputIterator first, InputIterator last) const
+    {
+        command_queue queue = m_vector.default_queue();
+        size_type result = count(first, last, queue);
+        queue.finish();
+        return result;
+    }
+
     iterator lower_bound(const key_type &value, command_queue &queue)
     {
         ::boost::compute::get<0> get_key;
@@ -396,6 +608,50 @@ public:
         return detail::buffer_value<mapped_type>(m_vector.get_buffer(), index);
     }
 
+private:
+    // returns the index of key in the map, or size() if it is not in it
+    size_type find_index(const key_type &key, command_queue &queue) const
+    {
+        if(empty()){
+            return 0;
+        }
+
+        detail::scratch_vector<Key> query(1, queue);
+        detail::write_single_value<Key>(key, query.get_buffer(), queue);
+
+        detail::scratch_vector<uint_> index(1, queue);
+        detail::flat_search(
+            ::boost::compute::make_transform_iterator(
+                begin(), ::boost::compute::get<0>()
+            ),
+            size(), query.begin(), 1, index.begin(),
+            detail::flat_search_find, queue
+        );
+
+        return detail::read_single_value<uint_>(index.get_buffer(), queue);
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator search(InputIterator first,
+                          InputIterator last,
+                          OutputIterator result,
+                          detail::flat_search_mode mode,
+                          command_queue &queue) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        detail::flat_search(
+            ::boost::compute::make_transform_iterator(
+                begin(), ::boost::compute::get<0>()
+            ),
+            size(), first, count, result, mode, queue
+        );
+
+        return result + count;
+    }
+
 private:
     ::boost::compute::vector<std::pair<Key, T> > m_vector;
 };
@@ -14,10 +14,21 @@
 #include <cstddef>
 #include <utility>
 
-#include <boost/compute/algorithm/find.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/count.hpp>
 #include <boost/compute/algorithm/lower_bound.hpp>
+#include <boost/compute/algorithm/merge.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/unique.hpp>
 #include <boost/compute/algorithm/upper_bound.hpp>
 #include <boost/compute/container/vector.hpp>
+#include <boost/compute/container/detail/flat_search.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
 
 namespace boost {
 namespace compute {
@@ -189,6 +200,72 @@ public:
         return result;
     }
 
+    /// Inserts the values in the range [\p first, \p last) which are not
+    /// already in the set.
+    ///
+    /// The new values are sorted and deduplicated, the ones already in the
+    /// set are removed with a batched binary search and the rest is merged
+    /// with the current values, so the cost is O(n log n + size()) for n new
+    /// values instead of O(n * size()) for n calls to insert(value).
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last, command_queue &queue)
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return;
+        }
+
+        // sort and deduplicate the new values
+        detail::scratch_vector<T> values(count, queue);
+        ::boost::compute::copy(first, last, values.begin(), queue);
+        ::boost::compute::sort(values.begin(), values.end(), queue);
+        const size_type unique_count = detail::iterator_range_size(
+            values.begin(),
+            ::boost::compute::unique(values.begin(), values.end(), queue)
+        );
+
+        // drop the values which are already in the set
+        detail::scratch_vector<uint_> missing(unique_count, queue);
+        detail::flat_search(
+            begin(), size(), values.begin(), unique_count, missing.begin(),
+            detail::flat_search_missing, queue
+        );
+        detail::scratch_vector<T> new_values(unique_count, queue);
+        const size_type new_count = detail::flat_compact(
+            values.begin(), unique_count, missing.begin(), new_values.begin(), queue
+        );
+        if(new_count == 0){
+            return;
+        }
+
+        vector<T> merged(size() + new_count, m_vector.get_allocator().get_context());
+        if(empty()){
+            ::boost::compute::copy(
+                new_values.begin(), new_values.begin() + new_count,
+                merged.begin(), queue
+            );
+        }
+        else {
+            ::boost::compute::merge(
+                begin(), end(),
+                new_values.begin(), new_values.begin() + new_count,
+                merged.begin(), queue
+            );
+        }
+        m_vector.swap(merged);
+    }
+
+    /// \overload
+    template<class InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        command_queue queue = m_vector.default_queue();
+        insert(first, last, queue);
+        queue.finish();
+    }
+
     iterator erase(const const_iterator &position, command_queue &queue)
     {
         return erase(position, position + 1, queue);
@@ -238,9 +315,59 @@ public:
         return result;
     }
 
+    /// Removes the values in the range [\p first, \p last) from the set and
+    /// returns the number of values which were removed.
+    ///
+    /// The values of the set are looked up in the sorted range of values to
+    /// remove and the remaining ones are compacted, which takes
+    /// O(n log n + size() log n) work for n values.
+    template<class InputIterator>
+    size_type erase_keys(InputIterator first,
+                         InputIterator last,
+                         command_queue &queue)
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0 || empty()){
+            return 0;
+        }
+
+        detail::scratch_vector<T> values(count, queue);
+        ::boost::compute::copy(first, last, values.begin(), queue);
+        ::boost::compute::sort(values.begin(), values.end(), queue);
+
+        // keep the values which are not in the sorted range
+        detail::scratch_vector<uint_> keep(size(), queue);
+        detail::flat_search(
+            values.begin(), count, begin(), size(), keep.begin(),
+            detail::flat_search_missing, queue
+        );
+
+        vector<T> kept(size(), m_vector.get_allocator().get_context());
+        const size_type kept_count = detail::flat_compact(
+            begin(), size(), keep.begin(), kept.begin(), queue
+        );
+        kept.resize(kept_count, queue);
+
+        const size_type erased = size() - kept_count;
+        m_vector.swap(kept);
+        return erased;
+    }
+
+    /// \overload
+    template<class InputIterator>
+    size_type erase_keys(InputIterator first, InputIterator last)
+    {
+        command_queue queue = m_vector.default_queue();
+        size_type result = erase_keys(first, last, queue);
+        queue.finish();
+        return result;
+    }
+
     iterator find(const key_type &value, command_queue &queue)
     {
-        return ::boost::compute::find(begin(), end(), value, queue);
+        return begin() + find_index(value, queue);
     }
 
     iterator find(const key_type &value)
@@ -253,7 +380,7 @@ public:
 
     const_iterator find(const key_type &value, command_queue &queue) const
     {
-        return ::boost::compute::find(begin(), end(), value, queue);
+        return begin() + find_index(value, queue);
     }
 
     const_iterator find(const key_type &value) const
@@ -277,6 +404,81 @@ public:
         return result;
     }
 
+    /// Writes the position of each value in [\p first, \p last) in the set
+    /// to the range beginning at \p result, or size() for values which are
+    /// not in the set. Each value is found with a binary search.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find(InputIterator first,
+                        InputIterator last,
+                        OutputIterator result,
+                        command_queue &queue) const
+    {
+        return search(first, last, result, detail::flat_search_find, queue);
+    }
+
+    /// \overload
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find(InputIterator first,
+                        InputIterator last,
+                        OutputIterator result) const
+    {
+        command_queue queue = m_vector.default_queue();
+        OutputIterator end = find(first, last, result, queue);
+        queue.finish();
+        return end;
+    }
+
+    /// Writes \c 1 to the range beginning at \p result for each value in
+    /// [\p first, \p last) which is in the set and \c 0 for the others.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator contains(InputIterator first,
+                            InputIterator last,
+                            OutputIterator result,
+                            command_queue &queue) const
+    {
+        return search(first, last, result, detail::flat_search_contains, queue);
+    }
+
+    /// \overload
+    template<class InputIterator, class OutputIterator>
+    OutputIterator contains(InputIterator first,
+                            InputIterator last,
+                            OutputIterator result) const
+    {
+        command_queue queue = m_vector.default_queue();
+        OutputIterator end = contains(first, last, result, queue);
+        queue.finish();
+        return end;
+    }
+
+    /// Returns the number of values in [\p first, \p last) which are in
+    /// the set.
+    template<class InputIterator>
+    size_type count(InputIterator first,
+                    InputIterator last,
+                    command_queue &queue) const
+    {
+        const size_type query_count = detail::iterator_range_size(first, last);
+        if(query_count == 0){
+            return 0;
+        }
+
+        detail::scratch_vector<uint_> found(query_count, queue);
+        contains(first, last, found.begin(), queue);
+
+        return ::boost::compute::count(found.begin(), found.end(), uint_(1), queue);
+    }
+
+    /// \overload
+    template<class InputIterator>
+    size_type count(InputIterator first, InputIterator last) const
+    {
+        command_queue queue = m_vector.default_queue();
+        size_type result = count(first, last, queue);
+        queue.finish();
+        return result;
+    }
+
     iterator lower_bound(const key_type &value, command_queue &queue)
     {
         return ::boost::compute::lower_bound(begin(), end(), value, queue);
@@ -329,6 +531,42 @@ public:
         return iter;
     }
 
+private:
+    // returns the index of value in the set, or size() if it is not in it
+    size_type find_index(const key_type &value, command_queue &queue) const
+    {
+        if(empty()){
+            return 0;
+        }
+
+        detail::scratch_vector<T> query(1, queue);
+        detail::write_single_value<T>(value, query.get_buffer(), queue);
+
+        detail::scratch_vector<uint_> index(1, queue);
+        detail::flat_search(
+            begin(), size(), query.begin(), 1, index.begin(),
+            detail::flat_search_find, queue
+        );
+
+        return detail::read_single_value<uint_>(index.get_buffer(), queue);
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator search(InputIterator first,
+                          InputIterator last,
+                          OutputIterator result,
+                          detail::flat_search_mode mode,
+                          command_queue &queue) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        detail::flat_search(begin(), size(), first, count, result, mode, queue);
+
+        return result + count;
+    }
+
 private:
     vector<T> m_vector;
 };
@@ -0,0 +1,445 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_CONTAINER_UNORDERED_MAP_HPP
+#define BOOST_COMPUTE_CONTAINER_UNORDERED_MAP_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/fill_n.hpp>
+#include <boost/compute/container/detail/hash_table.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+
+/// \class unordered_map
+/// \brief A hash map stored on a compute device.
+///
+/// The unordered_map class maps unique keys to values with an open
+/// addressing hash table. Like unordered_set, all operations work on ranges
+/// of keys and run as a single kernel with one work-item per key.
+///
+/// For example, to look up the values for a range of keys:
+/// \code
+/// boost::compute::unordered_map<int, float> map(context);
+/// map.insert(keys.begin(), keys.end(), values.begin(), queue);
+///
+/// // write the value of each query key, or -1 if the key is not in the map
+/// map.find(queries.begin(), queries.end(), results.begin(), -1.f, queue);
+/// \endcode
+///
+/// The same restrictions on keys as for unordered_set apply: keys are
+/// 32-bit types with a hash function, compared by their bit pattern, and
+/// two values of each key type are reserved.
+///
+/// \see unordered_set, flat_map, hash
+template<class Key, class T>
+class unordered_map
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key, T> value_type;
+    typedef size_t size_type;
+    typedef detail::hash_table_statistics statistics_type;
+
+    BOOST_STATIC_ASSERT(sizeof(Key) == sizeof(uint_));
+
+    /// Creates a new, empty unordered map in \p context.
+    explicit unordered_map(const context &context = system::default_context())
+        : m_context(context),
+          m_size(0),
+          m_erased(0),
+          m_bucket_count(0),
+          m_max_load_factor(0.5f)
+    {
+    }
+
+    /// Creates a new, empty unordered map with at least \p bucket_count
+    /// buckets.
+    unordered_map(size_type bucket_count,
+                  command_queue &queue = system::default_queue())
+        : m_context(queue.get_context()),
+          m_size(0),
+          m_erased(0),
+          m_bucket_count(0),
+          m_max_load_factor(0.5f)
+    {
+        rehash(bucket_count, queue);
+    }
+
+    /// Creates a new unordered map as a copy of \p other.
+    unordered_map(const unordered_map<Key, T> &other)
+        : m_context(other.m_context),
+          m_size(other.m_size),
+          m_erased(other.m_erased),
+          m_bucket_count(other.m_bucket_count),
+          m_max_load_factor(other.m_max_load_factor)
+    {
+        copy_table(other);
+    }
+
+    /// Copies the keys and values from \p other to \c *this.
+    unordered_map<Key, T>& operator=(const unordered_map<Key, T> &other)
+    {
+        if(this != &other){
+            m_context = other.m_context;
+            m_size = other.m_size;
+            m_erased = other.m_erased;
+            m_bucket_count = other.m_bucket_count;
+            m_max_load_factor = other.m_max_load_factor;
+            copy_table(other);
+        }
+
+        return *this;
+    }
+
+    /// Destroys the unordered map.
+    ~unordered_map()
+    {
+    }
+
+    /// Returns the number of keys in the map.
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /// Returns \c true if the map is empty.
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// Returns the number of buckets in the hash table.
+    size_type bucket_count() const
+    {
+        return m_bucket_count;
+    }
+
+    /// Returns the number of keys per bucket.
+    float load_factor() const
+    {
+        return m_bucket_count ? static_cast<float>(m_size) / m_bucket_count : 0.f;
+    }
+
+    /// Returns the maximum fraction of occupied buckets (including the
+    /// buckets of erased keys) before the table is rehashed.
+    float max_load_factor() const
+    {
+        return m_max_load_factor;
+    }
+
+    /// Sets the maximum load factor to \p ml, which must be in (0, 1).
+    /// The default is 0.5.
+    void max_load_factor(float ml)
+    {
+        BOOST_ASSERT(ml > 0.f && ml < 1.f);
+
+        m_max_load_factor = ml;
+    }
+
+    /// Returns the sizes and the longest probe sequence of the hash table.
+    statistics_type statistics(command_queue &queue = system::default_queue()) const
+    {
+        statistics_type stats;
+        stats.size = m_size;
+        stats.erased = m_erased;
+        stats.bucket_count = m_bucket_count;
+        if(m_size > 0){
+            stats.max_probe_length = detail::hash_table_max_probe_length<Key>(
+                m_table, m_bucket_count, queue
+            );
+        }
+
+        return stats;
+    }
+
+    /// Removes all keys from the map. The number of buckets is kept.
+    void clear(command_queue &queue = system::default_queue())
+    {
+        if(m_bucket_count > 0){
+            detail::hash_table_clear<Key>(m_table, m_bucket_count, queue);
+        }
+        m_size = 0;
+        m_erased = 0;
+    }
+
+    /// Rebuilds the hash table with at least \p count buckets (and at least
+    /// enough buckets for the current keys). Erased keys are dropped.
+    void rehash(size_type count, command_queue &queue = system::default_queue())
+    {
+        size_type new_bucket_count =
+            detail::hash_table_bucket_count(m_size, m_max_load_factor);
+        while(new_bucket_count < count){
+            new_bucket_count *= 2;
+        }
+
+        buffer table(m_context, new_bucket_count * sizeof(uint_));
+        buffer values(m_context, new_bucket_count * sizeof(T));
+        detail::hash_table_clear<Key>(table, new_bucket_count, queue);
+
+        if(m_size > 0){
+            detail::hash_table_insert<Key>(
+                table, new_bucket_count,
+                make_buffer_iterator<Key>(m_table), m_bucket_count,
+                detail::hash_table_insert_values<buffer_iterator<T>, buffer_iterator<T> >(
+                    make_buffer_iterator<T>(values), make_buffer_iterator<T>(m_values)
+                ),
+                queue
+            );
+        }
+
+        m_table = table;
+        m_values = values;
+        m_bucket_count = new_bucket_count;
+        m_erased = 0;
+    }
+
+    /// Makes room for at least \p count keys without further rehashing.
+    void reserve(size_type count, command_queue &queue = system::default_queue())
+    {
+        if(m_bucket_count == 0 ||
+           count + m_erased > m_max_load_factor * m_bucket_count){
+            rehash(detail::hash_table_bucket_count(count, m_max_load_factor), queue);
+        }
+    }
+
+    /// Inserts the keys in the range [\p keys_first, \p keys_last) with the
+    /// values in the range beginning at \p values_first into the map and
+    /// returns the number of keys which were not already in it.
+    ///
+    /// Keys which are already in the map keep their value. If the range
+    /// contains a key more than once, it is unspecified which of its values
+    /// is stored.
+    template<class KeyIterator, class ValueIterator>
+    size_type insert(KeyIterator keys_first,
+                     KeyIterator keys_last,
+                     ValueIterator values_first,
+                     command_queue &queue = system::default_queue())
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<KeyIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<ValueIterator>::value);
+
+        const size_type count = detail::iterator_range_size(keys_first, keys_last);
+        if(count == 0){
+            return 0;
+        }
+
+        reserve(m_size + count, queue);
+
+        const size_type inserted = detail::hash_table_insert<Key>(
+            m_table, m_bucket_count, keys_first, count,
+            detail::hash_table_insert_values<buffer_iterator<T>, ValueIterator>(
+                make_buffer_iterator<T>(m_values), values_first
+            ),
+            queue
+        );
+        m_size += inserted;
+
+        return inserted;
+    }
+
+    /// Inserts \p key with \p value into the map. Returns \c true if the key
+    /// was not already in the map.
+    bool insert(const key_type &key,
+                const mapped_type &value,
+                command_queue &queue = system::default_queue())
+    {
+        detail::scratch_vector<Key> keys(1, queue);
+        detail::scratch_vector<T> values(1, queue);
+        detail::write_single_value<Key>(key, keys.get_buffer(), queue);
+        detail::write_single_value<T>(value, values.get_buffer(), queue);
+
+        return insert(keys.begin(), keys.end(), values.begin(), queue) == 1;
+    }
+
+    /// Removes the keys in the range [\p first, \p last) from the map and
+    /// returns the number of keys which were removed.
+    template<class InputIterator>
+    size_type erase(InputIterator first,
+                    InputIterator last,
+                    command_queue &queue = system::default_queue())
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0 || m_size == 0){
+            return 0;
+        }
+
+        const size_type erased = detail::hash_table_erase<Key>(
+            m_table, m_bucket_count, first, count, queue
+        );
+        m_size -= erased;
+        m_erased += erased;
+
+        return erased;
+    }
+
+    /// Removes \p key from the map and returns the number of keys which were
+    /// removed (either 0 or 1).
+    size_type erase(const key_type &key, command_queue &queue = system::default_queue())
+    {
+        detail::scratch_vector<Key> keys(1, queue);
+        detail::write_single_value<Key>(key, keys.get_buffer(), queue);
+
+        return erase(keys.begin(), keys.end(), queue);
+    }
+
+    /// Writes the value of each key in [\p first, \p last) to the range
+    /// beginning at \p result, or \p default_value for keys which are not in
+    /// the map.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator find(InputIterator first,
+                        InputIterator last,
+                        OutputIterator result,
+                        const mapped_type &default_value,
+                        command_queue &queue = system::default_queue()) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return result;
+        }
+
+        if(m_bucket_count == 0){
+            ::boost::compute::fill_n(result, count, default_value, queue);
+            return result + count;
+        }
+
+        detail::hash_table_find<Key>(
+            m_table, m_bucket_count, first, count,
+            detail::hash_table_find_values<buffer_iterator<T>, OutputIterator, T>(
+                make_buffer_iterator<T>(m_values), result, default_value
+            ),
+            queue
+        );
+
+        return result + count;
+    }
+
+    /// Writes \c 1 to the range beginning at \p result for each key in
+    /// [\p first, \p last) which is in the map and \c 0 for the others.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator contains(InputIterator first,
+                            InputIterator last,
+                            OutputIterator result,
+                            command_queue &queue = system::default_queue()) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return result;
+        }
+
+        if(m_bucket_count == 0){
+            typedef typename std::iterator_traits<OutputIterator>::value_type result_type;
+
+            ::boost::compute::fill_n(result, count, result_type(0), queue);
+            return result + count;
+        }
+
+        detail::hash_table_find<Key>(
+            m_table, m_bucket_count, first, count,
+            detail::hash_table_contains_result<OutputIterator>(result), queue
+        );
+
+        return result + count;
+    }
+
+    /// Returns the number of keys equal to \p key in the map (either 0 or 1).
+    size_type count(const key_type &key, command_queue &queue = system::default_queue()) const
+    {
+        detail::scratch_vector<Key> keys(1, queue);
+        detail::write_single_value<Key>(key, keys.get_buffer(), queue);
+
+        detail::scratch_vector<uint_> found(1, queue);
+        contains(keys.begin(), keys.end(), found.begin(), queue);
+
+        return detail::read_single_value<uint_>(found.get_buffer(), queue);
+    }
+
+    /// Copies the keys and values in the map to the ranges beginning at
+    /// \p keys_result and \p values_result. The order of the keys is
+    /// unspecified, but the value of each key is at the same position.
+    template<class KeyIterator, class ValueIterator>
+    std::pair<KeyIterator, ValueIterator>
+    copy_items(KeyIterator keys_result,
+               ValueIterator values_result,
+               command_queue &queue = system::default_queue()) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<KeyIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<ValueIterator>::value);
+
+        if(m_size == 0){
+            return std::make_pair(keys_result, values_result);
+        }
+
+        typedef detail::hash_table_copy_values<buffer_iterator<T>, ValueIterator> values_type;
+
+        const size_type count = detail::hash_table_copy<Key>(
+            m_table, m_bucket_count,
+            detail::hash_table_copy_items<Key, KeyIterator, values_type>(
+                keys_result, values_type(make_buffer_iterator<T>(m_values), values_result)
+            ),
+            queue
+        );
+
+        return std::make_pair(keys_result + count, values_result + count);
+    }
+
+private:
+    void copy_table(const unordered_map<Key, T> &other)
+    {
+        if(m_bucket_count > 0){
+            command_queue queue(m_context, m_context.get_device());
+            m_table = other.m_table.clone(queue);
+            m_values = other.m_values.clone(queue);
+            queue.finish();
+        }
+        else {
+            m_table = buffer();
+            m_values = buffer();
+        }
+    }
+
+private:
+    context m_context;
+    buffer m_table;
+    buffer m_values;
+    size_type m_size;
+    size_type m_erased;
+    size_type m_bucket_count;
+    float m_max_load_factor;
+};
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_CONTAINER_UNORDERED_MAP_HPP
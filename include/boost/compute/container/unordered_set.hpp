@@ -0,0 +1,386 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_CONTAINER_UNORDERED_SET_HPP
+#define BOOST_COMPUTE_CONTAINER_UNORDERED_SET_HPP
+
+#include <cstddef>
+#include <iterator>
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/fill_n.hpp>
+#include <boost/compute/container/detail/hash_table.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+
+namespace boost {
+namespace compute {
+
+/// \class unordered_set
+/// \brief A hash set stored on a compute device.
+///
+/// The unordered_set class stores unique keys in an open addressing hash
+/// table with linear probing. All operations work on ranges of keys and
+/// run as a single kernel with one work-item per key, so looking up or
+/// inserting millions of keys takes O(1) work per key.
+///
+/// For example, to remove duplicates from a range of keys:
+/// \code
+/// boost::compute::unordered_set<int> set(context);
+/// set.insert(keys.begin(), keys.end(), queue);
+/// size_t unique_keys = set.size();
+/// \endcode
+///
+/// Keys must be 32-bit types with a hash function (\c int_, \c uint_ or
+/// \c float_) and are compared by their bit pattern. Two values of each
+/// type are reserved to mark empty and erased buckets (the two largest
+/// values for \c uint_, the two smallest for \c int_ and two negative NaNs
+/// for \c float_); such keys are ignored.
+///
+/// The table grows on the device (see rehash()) so that the number of
+/// occupied buckets never exceeds max_load_factor(). Erased keys leave a
+/// marker in their bucket until the next rehash.
+///
+/// \see unordered_map, flat_set, hash
+template<class Key>
+class unordered_set
+{
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef size_t size_type;
+    typedef detail::hash_table_statistics statistics_type;
+
+    BOOST_STATIC_ASSERT(sizeof(Key) == sizeof(uint_));
+
+    /// Creates a new, empty unordered set in \p context.
+    explicit unordered_set(const context &context = system::default_context())
+        : m_context(context),
+          m_size(0),
+          m_erased(0),
+          m_bucket_count(0),
+          m_max_load_factor(0.5f)
+    {
+    }
+
+    /// Creates a new, empty unordered set with at least \p bucket_count
+    /// buckets.
+    unordered_set(size_type bucket_count,
+                  command_queue &queue = system::default_queue())
+        : m_context(queue.get_context()),
+          m_size(0),
+          m_erased(0),
+          m_bucket_count(0),
+          m_max_load_factor(0.5f)
+    {
+        rehash(bucket_count, queue);
+    }
+
+    /// Creates a new unordered set as a copy of \p other.
+    unordered_set(const unordered_set<Key> &other)
+        : m_context(other.m_context),
+          m_size(other.m_size),
+          m_erased(other.m_erased),
+          m_bucket_count(other.m_bucket_count),
+          m_max_load_factor(other.m_max_load_factor)
+    {
+        copy_table(other);
+    }
+
+    /// Copies the keys from \p other to \c *this.
+    unordered_set<Key>& operator=(const unordered_set<Key> &other)
+    {
+        if(this != &other){
+            m_context = other.m_context;
+            m_size = other.m_size;
+            m_erased = other.m_erased;
+            m_bucket_count = other.m_bucket_count;
+            m_max_load_factor = other.m_max_load_factor;
+            copy_table(other);
+        }
+
+        return *this;
+    }
+
+    /// Destroys the unordered set.
+    ~unordered_set()
+    {
+    }
+
+    /// Returns the number of keys in the set.
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /// Returns \c true if the set is empty.
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// Returns the number of buckets in the hash table.
+    size_type bucket_count() const
+    {
+        return m_bucket_count;
+    }
+
+    /// Returns the number of keys per bucket.
+    float load_factor() const
+    {
+        return m_bucket_count ? static_cast<float>(m_size) / m_bucket_count : 0.f;
+    }
+
+    /// Returns the maximum fraction of occupied buckets (including the
+    /// buckets of erased keys) before the table is rehashed.
+    float max_load_factor() const
+    {
+        return m_max_load_factor;
+    }
+
+    /// Sets the maximum load factor to \p ml, which must be in (0, 1).
+    /// The default is 0.5.
+    void max_load_factor(float ml)
+    {
+        BOOST_ASSERT(ml > 0.f && ml < 1.f);
+
+        m_max_load_factor = ml;
+    }
+
+    /// Returns the sizes and the longest probe sequence of the hash table.
+    statistics_type statistics(command_queue &queue = system::default_queue()) const
+    {
+        statistics_type stats;
+        stats.size = m_size;
+        stats.erased = m_erased;
+        stats.bucket_count = m_bucket_count;
+        if(m_size > 0){
+            stats.max_probe_length = detail::hash_table_max_probe_length<Key>(
+                m_table, m_bucket_count, queue
+            );
+        }
+
+        return stats;
+    }
+
+    /// Removes all keys from the set. The number of buckets is kept.
+    void clear(command_queue &queue = system::default_queue())
+    {
+        if(m_bucket_count > 0){
+            detail::hash_table_clear<Key>(m_table, m_bucket_count, queue);
+        }
+        m_size = 0;
+        m_erased = 0;
+    }
+
+    /// Rebuilds the hash table with at least \p count buckets (and at least
+    /// enough buckets for the current keys). Erased keys are dropped.
+    void rehash(size_type count, command_queue &queue = system::default_queue())
+    {
+        size_type new_bucket_count =
+            detail::hash_table_bucket_count(m_size, m_max_load_factor);
+        while(new_bucket_count < count){
+            new_bucket_count *= 2;
+        }
+
+        buffer table(m_context, new_bucket_count * sizeof(uint_));
+        detail::hash_table_clear<Key>(table, new_bucket_count, queue);
+
+        if(m_size > 0){
+            detail::hash_table_insert<Key>(
+                table, new_bucket_count,
+                make_buffer_iterator<Key>(m_table), m_bucket_count,
+                detail::hash_table_no_values(), queue
+            );
+        }
+
+        m_table = table;
+        m_bucket_count = new_bucket_count;
+        m_erased = 0;
+    }
+
+    /// Makes room for at least \p count keys without further rehashing.
+    void reserve(size_type count, command_queue &queue = system::default_queue())
+    {
+        if(m_bucket_count == 0 ||
+           count + m_erased > m_max_load_factor * m_bucket_count){
+            rehash(detail::hash_table_bucket_count(count, m_max_load_factor), queue);
+        }
+    }
+
+    /// Inserts the keys in the range [\p first, \p last) into the set and
+    /// returns the number of keys which were not already in it.
+    template<class InputIterator>
+    size_type insert(InputIterator first,
+                     InputIterator last,
+                     command_queue &queue = system::default_queue())
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return 0;
+        }
+
+        reserve(m_size + count, queue);
+
+        const size_type inserted = detail::hash_table_insert<Key>(
+            m_table, m_bucket_count, first, count,
+            detail::hash_table_no_values(), queue
+        );
+        m_size += inserted;
+
+        return inserted;
+    }
+
+    /// Inserts \p key into the set. Returns \c true if it was not already in
+    /// the set.
+    bool insert(const key_type &key, command_queue &queue = system::default_queue())
+    {
+        detail::scratch_vector<Key> keys(1, queue);
+        detail::write_single_value<Key>(key, keys.get_buffer(), queue);
+
+        return insert(keys.begin(), keys.end(), queue) == 1;
+    }
+
+    /// Removes the keys in the range [\p first, \p last) from the set and
+    /// returns the number of keys which were removed.
+    template<class InputIterator>
+    size_type erase(InputIterator first,
+                    InputIterator last,
+                    command_queue &queue = system::default_queue())
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0 || m_size == 0){
+            return 0;
+        }
+
+        const size_type erased = detail::hash_table_erase<Key>(
+            m_table, m_bucket_count, first, count, queue
+        );
+        m_size -= erased;
+        m_erased += erased;
+
+        return erased;
+    }
+
+    /// Removes \p key from the set and returns the number of keys which were
+    /// removed (either 0 or 1).
+    size_type erase(const key_type &key, command_queue &queue = system::default_queue())
+    {
+        detail::scratch_vector<Key> keys(1, queue);
+        detail::write_single_value<Key>(key, keys.get_buffer(), queue);
+
+        return erase(keys.begin(), keys.end(), queue);
+    }
+
+    /// Writes \c 1 to the range beginning at \p result for each key in
+    /// [\p first, \p last) which is in the set and \c 0 for the others.
+    template<class InputIterator, class OutputIterator>
+    OutputIterator contains(InputIterator first,
+                            InputIterator last,
+                            OutputIterator result,
+                            command_queue &queue = system::default_queue()) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        const size_type count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return result;
+        }
+
+        if(m_bucket_count == 0){
+            typedef typename std::iterator_traits<OutputIterator>::value_type value_type;
+
+            ::boost::compute::fill_n(result, count, value_type(0), queue);
+            return result + count;
+        }
+
+        detail::hash_table_find<Key>(
+            m_table, m_bucket_count, first, count,
+            detail::hash_table_contains_result<OutputIterator>(result), queue
+        );
+
+        return result + count;
+    }
+
+    /// Returns the number of keys equal to \p key in the set (either 0 or 1).
+    size_type count(const key_type &key, command_queue &queue = system::default_queue()) const
+    {
+        detail::scratch_vector<Key> keys(1, queue);
+        detail::write_single_value<Key>(key, keys.get_buffer(), queue);
+
+        detail::scratch_vector<uint_> found(1, queue);
+        contains(keys.begin(), keys.end(), found.begin(), queue);
+
+        return detail::read_single_value<uint_>(found.get_buffer(), queue);
+    }
+
+    /// Copies the keys in the set to the range beginning at \p result. The
+    /// order of the keys is unspecified.
+    template<class OutputIterator>
+    OutputIterator copy_keys(OutputIterator result,
+                             command_queue &queue = system::default_queue()) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        if(m_size == 0){
+            return result;
+        }
+
+        const size_type count = detail::hash_table_copy<Key>(
+            m_table, m_bucket_count,
+            detail::hash_table_copy_items<Key, OutputIterator, detail::hash_table_no_values>(
+                result, detail::hash_table_no_values()
+            ),
+            queue
+        );
+
+        return result + count;
+    }
+
+private:
+    void copy_table(const unordered_set<Key> &other)
+    {
+        if(m_bucket_count > 0){
+            command_queue queue(m_context, m_context.get_device());
+            m_table = other.m_table.clone(queue);
+            queue.finish();
+        }
+        else {
+            m_table = buffer();
+        }
+    }
+
+private:
+    context m_context;
+    buffer m_table;
+    size_type m_size;
+    size_type m_erased;
+    size_type m_bucket_count;
+    float m_max_load_factor;
+};
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_CONTAINER_UNORDERED_SET_HPP
@@ -24,19 +24,38 @@
 #include <boost/compute/algorithm/min_element.hpp>
 #include <boost/compute/algorithm/transform.hpp>
 #include <boost/compute/algorithm/accumulate.hpp>
+#include <boost/compute/container/detail/valarray_expression.hpp>
 #include <boost/compute/detail/buffer_value.hpp>
 #include <boost/compute/functional.hpp>
-#include <boost/compute/functional/bind.hpp>
 #include <boost/compute/iterator/buffer_iterator.hpp>
 #include <boost/compute/type_traits.hpp>
 
 namespace boost {
 namespace compute {
 
+/// \class valarray
+/// \brief An array of values for numeric computations on a compute device.
+///
+/// The arithmetic, bitwise, comparison and logical operators on valarrays
+/// do not compute their result immediately. Instead they return a
+/// lightweight expression object which is evaluated when it is assigned to
+/// (or used to construct) a valarray. The whole expression is evaluated by
+/// a single kernel without any temporary arrays. For example:
+/// \code
+/// boost::compute::valarray<float> r = a * b + c * d - e;
+/// \endcode
+/// runs one kernel which reads \c a, \c b, \c c, \c d and \c e once and
+/// writes \c r once.
+///
+/// Expressions refer to the arrays they were built from and are meant to
+/// be assigned right away. Assigning an expression to one of its own
+/// operands (e.g. <tt>a = a * b + a</tt>) is allowed.
 template<class T>
-class valarray
+class valarray : public detail::valarray_expression<valarray<T> >
 {
 public:
+    typedef T value_type;
+
     explicit valarray(const context &context = system::default_context())
         : m_buffer(context, 0)
     {
@@ -77,6 +96,23 @@ public:
         copy(&valarray[0], &valarray[valarray.size()], begin());
     }
 
+    /// Creates a new valarray with the values of \p expr in the context of
+    /// the arrays in the expression.
+    template<class Expr>
+    valarray(const detail::valarray_expression<Expr> &expr)
+    {
+        typedef detail::valarray_operand<Expr> operand;
+
+        BOOST_STATIC_ASSERT_MSG(
+            (is_same<typename Expr::value_type, T>::value),
+            "The value type of the expression must be the value type of the valarray"
+        );
+
+        const typename operand::type e = operand::get(expr.derived());
+        m_buffer = buffer(e.get_context(), e.size() * sizeof(T));
+        assign(e);
+    }
+
     valarray<T>& operator=(const valarray<T> &other)
     {
         if(this != &other){
@@ -96,72 +132,35 @@ public:
         return *this;
     }
 
-    valarray<T>& operator*=(const T&);
-
-    valarray<T>& operator/=(const T&);
-
-    valarray<T>& operator%=(const T& val);
-
-    valarray<T> operator+() const
+    /// Evaluates \p expr with a single kernel and stores its values in
+    /// \c *this, which may also appear in \p expr.
+    template<class Expr>
+    valarray<T>& operator=(const detail::valarray_expression<Expr> &expr)
     {
-        //  This operator can be used with any type.
-        valarray<T> result(size());
-        copy(begin(), end(), result.begin());
-        return result;
-    }
+        typedef detail::valarray_operand<Expr> operand;
 
-    valarray<T> operator-() const
-    {
         BOOST_STATIC_ASSERT_MSG(
-            is_fundamental<T>::value,
-            "This operator can be used with all OpenCL built-in scalar"
-            " and vector types"
+            (is_same<typename Expr::value_type, T>::value),
+            "The value type of the expression must be the value type of the valarray"
         );
-        valarray<T> result(size());
-        BOOST_COMPUTE_FUNCTION(T, unary_minus, (T x),
-        {
-            return -x;
-        });
-        transform(begin(), end(), result.begin(), unary_minus);
-        return result;
-    }
 
-    valarray<T> operator~() const
-    {
-        BOOST_STATIC_ASSERT_MSG(
-            is_fundamental<T>::value &&
-                !is_floating_point<typename scalar_type<T>::type>::value,
-            "This operator can be used with all OpenCL built-in scalar"
-            " and vector types except the built-in scalar and vector float types"
-        );
-        valarray<T> result(size());
-        BOOST_COMPUTE_FUNCTION(T, bitwise_not, (T x),
-        {
-            return ~x;
-        });
-        transform(begin(), end(), result.begin(), bitwise_not);
-        return result;
-    }
+        const typename operand::type e = operand::get(expr.derived());
+        if(e.size() != size() || e.get_context() != m_buffer.get_context()){
+            // the expression holds on to the buffers it reads so they stay
+            // valid even if one of them is the current buffer
+            m_buffer = buffer(e.get_context(), e.size() * sizeof(T));
+        }
+        assign(e);
 
-    /// In OpenCL there cannot be memory buffer with bool type, for
-    /// this reason return type is valarray<char> instead of valarray<bool>.
-    /// 1 means true, 0 means false.
-    valarray<char> operator!() const
-    {
-        BOOST_STATIC_ASSERT_MSG(
-            is_fundamental<T>::value,
-            "This operator can be used with all OpenCL built-in scalar"
-            " and vector types"
-        );
-        valarray<char> result(size());
-        BOOST_COMPUTE_FUNCTION(char, logical_not, (T x),
-        {
-            return !x;
-        });
-        transform(begin(), end(), &result[0], logical_not);
-        return result;
+        return *this;
     }
 
+    valarray<T>& operator*=(const T&);
+
+    valarray<T>& operator/=(const T&);
+
+    valarray<T>& operator%=(const T& val);
+
     valarray<T>& operator+=(const T&);
 
     valarray<T>& operator-=(const T&);
@@ -176,25 +175,35 @@ public:
 
     valarray<T>& operator>>=(const T&);
 
-    valarray<T>& operator*=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator*=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator/=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator/=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator%=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator%=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator+=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator+=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator-=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator-=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator^=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator^=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator&=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator&=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator|=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator|=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator<<=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator<<=(const detail::valarray_expression<Expr>&);
 
-    valarray<T>& operator>>=(const valarray<T>&);
+    template<class Expr>
+    valarray<T>& operator>>=(const detail::valarray_expression<Expr>&);
 
     ~valarray()
     {
@@ -252,6 +261,13 @@ public:
 
 
 private:
+    template<class Expr>
+    void assign(const Expr &expr)
+    {
+        command_queue queue = system::default_queue();
+        detail::valarray_assign<T>(m_buffer, expr, queue);
+    }
+
     buffer_iterator<T> begin() const
     {
         return buffer_iterator<T>(m_buffer, 0);
@@ -267,232 +283,235 @@ private:
 };
 
 /// \internal_
-#define BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(op, op_name, assert) \
-    template<class T> \
-    inline valarray<T>& \
-    valarray<T>::operator op##=(const T& val) \
-    { \
-        assert \
-        transform(begin(), end(), begin(), \
-            ::boost::compute::bind(op_name<T>(), placeholders::_1, val)); \
-        return *this; \
-    } \
-    \
-    template<class T> \
-    inline valarray<T>& \
-    valarray<T>::operator op##=(const valarray<T> &rhs) \
-    { \
-        assert \
-        transform(begin(), end(), rhs.begin(), begin(), op_name<T>()); \
-        return *this; \
-    }
-
-/// \internal_
-#define BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_ANY(op, op_name) \
-    BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(op, op_name, \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types" \
-        ); \
-    )
+/// Asserts used by the valarray operators, T is the value type of the
+/// operands.
+#define BOOST_COMPUTE_VALARRAY_ASSERT_ANY \
+    BOOST_STATIC_ASSERT_MSG( \
+        detail::valarray_is_fundamental<T>::value, \
+        "This operator can be used with all OpenCL built-in scalar" \
+        " and vector types" \
+    );
 
 /// \internal_
 /// For some operators class T can't be floating point type.
 /// See OpenCL specification, operators chapter.
-#define BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP(op, op_name) \
-    BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(op, op_name, \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value && \
-                !is_floating_point<typename scalar_type<T>::type>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types except the built-in scalar and vector float types" \
-        ); \
-    )
+#define BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP \
+    BOOST_STATIC_ASSERT_MSG( \
+        detail::valarray_is_fundamental<T>::value && \
+            !is_floating_point<typename scalar_type<T>::type>::value, \
+        "This operator can be used with all OpenCL built-in scalar" \
+        " and vector types except the built-in scalar and vector float types" \
+    );
 
-// defining operators
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_ANY(+, plus)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_ANY(-, minus)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_ANY(*, multiplies)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_ANY(/, divides)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP(^, bit_xor)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP(&, bit_and)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP(|, bit_or)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP(<<, shift_left)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP(>>, shift_right)
-
-// The remainder (%) operates on
-// integer scalar and integer vector data types only.
-// See OpenCL specification.
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(%, modulus,
-    BOOST_STATIC_ASSERT_MSG(
-        is_integral<typename scalar_type<T>::type>::value,
-        "This operator can be used only with OpenCL built-in integer types"
+/// \internal_
+/// The remainder (%) operates on
+/// integer scalar and integer vector data types only.
+/// See OpenCL specification.
+#define BOOST_COMPUTE_VALARRAY_ASSERT_INTEGRAL \
+    BOOST_STATIC_ASSERT_MSG( \
+        is_integral<typename scalar_type<T>::type>::value, \
+        "This operator can be used only with OpenCL built-in integer types" \
     );
-)
 
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_ANY
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT_NO_FP
+namespace detail {
 
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT
+// the operators for valarray expressions are declared in the detail
+// namespace, which is an associated namespace of valarray (through its
+// valarray_expression base class) and of all expression types
+
+// returns the values of expr, this operator can be used with any type
+template<class Expr>
+inline typename detail::valarray_operand<Expr>::type
+operator+(const detail::valarray_expression<Expr> &expr)
+{
+    return detail::valarray_operand<Expr>::get(expr.derived());
+}
 
 /// \internal_
-/// Macro for defining binary operators for valarray
+/// Macro for defining unary operators for valarray expressions
+#define BOOST_COMPUTE_DEFINE_VALARRAY_UNARY_OPERATOR(op, op_name, assert) \
+    template<class Expr> \
+    inline detail::valarray_unary< \
+        detail::valarray_##op_name, \
+        typename detail::valarray_operand<Expr>::type \
+    > \
+    operator op (const detail::valarray_expression<Expr> &expr) \
+    { \
+        typedef typename Expr::value_type T; \
+        assert \
+        typedef detail::valarray_operand<Expr> operand; \
+        typedef detail::valarray_unary< \
+            detail::valarray_##op_name, typename operand::type \
+        > result_type; \
+        return result_type(operand::get(expr.derived())); \
+    }
+
+BOOST_COMPUTE_DEFINE_VALARRAY_UNARY_OPERATOR(-, negate,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_UNARY_OPERATOR(~, bit_not,
+    BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP)
+
+/// In OpenCL there cannot be memory buffer with bool type, for
+/// this reason the value type of the expression is char instead of bool.
+/// 1 means true, 0 means false.
+BOOST_COMPUTE_DEFINE_VALARRAY_UNARY_OPERATOR(!, logical_not,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+
+#undef BOOST_COMPUTE_DEFINE_VALARRAY_UNARY_OPERATOR
+
+/// \internal_
+/// Macro for defining binary operators for valarray expressions. Each
+/// operand may be a valarray, an expression or (for one of them) a scalar.
 #define BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(op, op_name, assert) \
-    template<class T> \
-    valarray<T> operator op (const valarray<T>& lhs, const valarray<T>& rhs) \
+    template<class Lhs, class Rhs> \
+    inline detail::valarray_binary< \
+        detail::valarray_##op_name, \
+        typename detail::valarray_operand<Lhs>::type, \
+        typename detail::valarray_operand<Rhs>::type \
+    > \
+    operator op (const detail::valarray_expression<Lhs> &lhs, \
+                 const detail::valarray_expression<Rhs> &rhs) \
     { \
+        typedef typename Lhs::value_type T; \
+        BOOST_STATIC_ASSERT_MSG( \
+            (is_same<T, typename Rhs::value_type>::value), \
+            "The operands must have the same value type" \
+        ); \
         assert \
-        valarray<T> result(lhs.size()); \
-        transform(buffer_iterator<T>(lhs.get_buffer(), 0), \
-                  buffer_iterator<T>(lhs.get_buffer(), lhs.size()), \
-                  buffer_iterator<T>(rhs.get_buffer(), 0), \
-                  buffer_iterator<T>(result.get_buffer(), 0), \
-                  op_name<T>()); \
-        return result; \
+        typedef detail::valarray_operand<Lhs> lhs_operand; \
+        typedef detail::valarray_operand<Rhs> rhs_operand; \
+        typedef detail::valarray_binary< \
+            detail::valarray_##op_name, \
+            typename lhs_operand::type, \
+            typename rhs_operand::type \
+        > result_type; \
+        return result_type(lhs_operand::get(lhs.derived()), \
+                           rhs_operand::get(rhs.derived())); \
     } \
     \
-    template<class T> \
-    valarray<T> operator op (const T& val, const valarray<T>& rhs) \
+    template<class Rhs> \
+    inline detail::valarray_binary< \
+        detail::valarray_##op_name, \
+        detail::valarray_scalar<typename Rhs::value_type>, \
+        typename detail::valarray_operand<Rhs>::type \
+    > \
+    operator op (const typename Rhs::value_type &val, \
+                 const detail::valarray_expression<Rhs> &rhs) \
     { \
+        typedef typename Rhs::value_type T; \
         assert \
-        valarray<T> result(rhs.size()); \
-        transform(buffer_iterator<T>(rhs.get_buffer(), 0), \
-                  buffer_iterator<T>(rhs.get_buffer(), rhs.size()), \
-                  buffer_iterator<T>(result.get_buffer(), 0), \
-                  ::boost::compute::bind(op_name<T>(), val, placeholders::_1)); \
-        return result; \
+        typedef detail::valarray_operand<Rhs> rhs_operand; \
+        typedef detail::valarray_binary< \
+            detail::valarray_##op_name, \
+            detail::valarray_scalar<T>, \
+            typename rhs_operand::type \
+        > result_type; \
+        return result_type(detail::valarray_scalar<T>(val), \
+                           rhs_operand::get(rhs.derived())); \
     } \
     \
-    template<class T> \
-    valarray<T> operator op (const valarray<T>& lhs, const T& val) \
+    template<class Lhs> \
+    inline detail::valarray_binary< \
+        detail::valarray_##op_name, \
+        typename detail::valarray_operand<Lhs>::type, \
+        detail::valarray_scalar<typename Lhs::value_type> \
+    > \
+    operator op (const detail::valarray_expression<Lhs> &lhs, \
+                 const typename Lhs::value_type &val) \
     { \
+        typedef typename Lhs::value_type T; \
         assert \
-        valarray<T> result(lhs.size()); \
-        transform(buffer_iterator<T>(lhs.get_buffer(), 0), \
-                  buffer_iterator<T>(lhs.get_buffer(), lhs.size()), \
-                  buffer_iterator<T>(result.get_buffer(), 0), \
-                  ::boost::compute::bind(op_name<T>(), placeholders::_1, val)); \
-        return result; \
+        typedef detail::valarray_operand<Lhs> lhs_operand; \
+        typedef detail::valarray_binary< \
+            detail::valarray_##op_name, \
+            typename lhs_operand::type, \
+            detail::valarray_scalar<T> \
+        > result_type; \
+        return result_type(lhs_operand::get(lhs.derived()), \
+                           detail::valarray_scalar<T>(val)); \
     }
 
-/// \internal_
-#define BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_ANY(op, op_name) \
-    BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(op, op_name, \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types" \
-        ); \
-    )
-
-/// \internal_
-/// For some operators class T can't be floating point type.
-/// See OpenCL specification, operators chapter.
-#define BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP(op, op_name) \
-    BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(op, op_name, \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value && \
-                !is_floating_point<typename scalar_type<T>::type>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types except the built-in scalar and vector float types" \
-        ); \
-    )
-
 // defining binary operators for valarray
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_ANY(+, plus)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_ANY(-, minus)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_ANY(*, multiplies)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_ANY(/, divides)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP(^, bit_xor)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP(&, bit_and)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP(|, bit_or)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP(<<, shift_left)
-BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP(>>, shift_right)
-
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_ANY
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR_NO_FP
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(+, plus,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(-, minus,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(*, multiplies,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(/, divides,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(%, modulus,
+    BOOST_COMPUTE_VALARRAY_ASSERT_INTEGRAL)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(^, bit_xor,
+    BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(&, bit_and,
+    BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(|, bit_or,
+    BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(<<, shift_left,
+    BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(>>, shift_right,
+    BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP)
+
+// comparison and binary logical operators, for the same reason as for
+// operator! the value type of their expressions is char instead of bool
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(==, equal_to,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(!=, not_equal_to,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(>, greater,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(<, less,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(>=, greater_equal,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(<=, less_equal,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(&&, logical_and,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
+BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR(||, logical_or,
+    BOOST_COMPUTE_VALARRAY_ASSERT_ANY)
 
 #undef BOOST_COMPUTE_DEFINE_VALARRAY_BINARY_OPERATOR
 
+} // end detail namespace
+
 /// \internal_
-/// Macro for defining valarray comparison operators.
-/// For return type valarray<char> is used instead of valarray<bool> because
-/// in OpenCL there cannot be memory buffer with bool type.
-///
-/// Note it's also used for defining binary logical operators (==, &&)
-#define BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(op, op_name) \
-    template<class T> \
-    valarray<char> operator op (const valarray<T>& lhs, const valarray<T>& rhs) \
-    { \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types" \
-        ); \
-        valarray<char> result(lhs.size()); \
-        transform(buffer_iterator<T>(lhs.get_buffer(), 0), \
-                  buffer_iterator<T>(lhs.get_buffer(), lhs.size()), \
-                  buffer_iterator<T>(rhs.get_buffer(), 0), \
-                  buffer_iterator<char>(result.get_buffer(), 0), \
-                  op_name<T>()); \
-        return result; \
-    } \
-    \
+/// Macro for defining compound assignment operators for valarray. They
+/// evaluate <tt>*this op rhs</tt> with a single kernel.
+#define BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(op) \
     template<class T> \
-    valarray<char> operator op (const T& val, const valarray<T>& rhs) \
+    inline valarray<T>& \
+    valarray<T>::operator op##=(const T& val) \
     { \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types" \
-        ); \
-        valarray<char> result(rhs.size()); \
-        transform(buffer_iterator<T>(rhs.get_buffer(), 0), \
-                  buffer_iterator<T>(rhs.get_buffer(), rhs.size()), \
-                  buffer_iterator<char>(result.get_buffer(), 0), \
-                  ::boost::compute::bind(op_name<T>(), val, placeholders::_1)); \
-        return result; \
+        return *this = *this op val; \
     } \
     \
     template<class T> \
-    valarray<char> operator op (const valarray<T>& lhs, const T& val) \
+    template<class Expr> \
+    inline valarray<T>& \
+    valarray<T>::operator op##=(const detail::valarray_expression<Expr> &rhs) \
     { \
-        BOOST_STATIC_ASSERT_MSG( \
-            is_fundamental<T>::value, \
-            "This operator can be used with all OpenCL built-in scalar" \
-            " and vector types" \
-        ); \
-        valarray<char> result(lhs.size()); \
-        transform(buffer_iterator<T>(lhs.get_buffer(), 0), \
-                  buffer_iterator<T>(lhs.get_buffer(), lhs.size()), \
-                  buffer_iterator<char>(result.get_buffer(), 0), \
-                  ::boost::compute::bind(op_name<T>(), placeholders::_1, val)); \
-        return result; \
+        return *this = *this op rhs; \
     }
 
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(==, equal_to)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(!=, not_equal_to)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(>, greater)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(<, less)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(>=, greater_equal)
-BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(<=, less_equal)
-
-/// \internal_
-/// Macro for defining binary logical operators for valarray.
-///
-/// For return type valarray<char> is used instead of valarray<bool> because
-/// in OpenCL there cannot be memory buffer with bool type.
-/// 1 means true, 0 means false.
-#define BOOST_COMPUTE_DEFINE_VALARRAY_LOGICAL_OPERATOR(op, op_name) \
-    BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR(op, op_name)
-
-BOOST_COMPUTE_DEFINE_VALARRAY_LOGICAL_OPERATOR(&&, logical_and)
-BOOST_COMPUTE_DEFINE_VALARRAY_LOGICAL_OPERATOR(||, logical_or)
+// defining operators
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(+)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(-)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(*)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(/)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(%)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(^)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(&)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(|)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(<<)
+BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT(>>)
 
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_LOGICAL_OPERATOR
+#undef BOOST_COMPUTE_DEFINE_VALARRAY_COMPOUND_ASSIGNMENT
 
-#undef BOOST_COMPUTE_DEFINE_VALARRAY_COMPARISON_OPERATOR
+#undef BOOST_COMPUTE_VALARRAY_ASSERT_ANY
+#undef BOOST_COMPUTE_VALARRAY_ASSERT_NO_FP
+#undef BOOST_COMPUTE_VALARRAY_ASSERT_INTEGRAL
 
 } // end compute namespace
 } // end boost namespace
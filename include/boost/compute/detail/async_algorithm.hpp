@@ -0,0 +1,123 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_DETAIL_ASYNC_ALGORITHM_HPP
+#define BOOST_COMPUTE_DETAIL_ASYNC_ALGORITHM_HPP
+
+#include <iterator>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/config.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/async/future.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/utility/wait_list.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// makes the commands enqueued to queue after this call wait for events
+// without blocking the host (see command_queue::enqueue_wait_for_events())
+inline void enqueue_wait_list(command_queue &queue, const wait_list &events)
+{
+    queue.enqueue_wait_for_events(events);
+}
+
+// returns a future for result which is ready once the commands enqueued to
+// queue so far have completed
+template<class Result>
+inline future<Result> make_queue_future(const Result &result,
+                                        command_queue &queue)
+{
+    return future<Result>(result, queue.enqueue_marker());
+}
+
+// reads the value of type T at the start of a device buffer
+template<class T>
+class device_value_reader
+{
+public:
+    device_value_reader(const buffer &result, command_queue &queue)
+        : m_result(result),
+          m_queue(queue)
+    {
+    }
+
+    T operator()()
+    {
+        return read_single_value<T>(m_result, m_queue);
+    }
+
+private:
+    buffer m_result;
+    command_queue m_queue;
+};
+
+// reads the index of type IndexType at the start of a device buffer and
+// returns the iterator at that index from first
+template<class Iterator, class IndexType>
+class device_index_reader
+{
+public:
+    device_index_reader(const Iterator &first,
+                        const buffer &index,
+                        command_queue &queue)
+        : m_first(first),
+          m_index(index),
+          m_queue(queue)
+    {
+    }
+
+    Iterator operator()()
+    {
+        typedef typename std::iterator_traits<Iterator>::difference_type
+            difference_type;
+
+        return m_first + static_cast<difference_type>(
+            read_single_value<IndexType>(m_index, m_queue)
+        );
+    }
+
+private:
+    Iterator m_first;
+    buffer m_index;
+    command_queue m_queue;
+};
+
+// returns a future for the value of type T which the commands enqueued to
+// queue so far write to the start of the device buffer result
+template<class T>
+inline future<T> make_device_future(const buffer &result, command_queue &queue)
+{
+    return future<T>(
+        device_value_reader<T>(result, queue), queue.enqueue_marker()
+    );
+}
+
+// returns a future for the iterator at the index of type IndexType from
+// first which the commands enqueued to queue so far write to the start of
+// the device buffer index
+template<class IndexType, class Iterator>
+inline future<Iterator> make_device_index_future(const Iterator &first,
+                                                 const buffer &index,
+                                                 command_queue &queue)
+{
+    return future<Iterator>(
+        device_index_reader<Iterator, IndexType>(first, index, queue),
+        queue.enqueue_marker()
+    );
+}
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_DETAIL_ASYNC_ALGORITHM_HPP
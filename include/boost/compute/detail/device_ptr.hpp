@@ -30,7 +30,7 @@ struct device_ptr_index_expr
     typedef T result_type;
 
     device_ptr_index_expr(const buffer &buffer,
-                          uint_ index,
+                          size_t index,
                           const IndexExpr &expr)
         : m_buffer(buffer),
           m_index(index),
@@ -53,7 +53,7 @@ struct device_ptr_index_expr
     }
 
     const buffer &m_buffer;
-    uint_ m_index;
+    size_t m_index;
     IndexExpr m_expr;
 };
 
@@ -182,7 +182,7 @@ public:
         BOOST_ASSERT(m_buffer.get());
 
         return detail::device_ptr_index_expr<T, Expr>(m_buffer,
-                                                      uint_(m_index),
+                                                      m_index,
                                                       expr);
     }
 
@@ -26,7 +26,7 @@
         if(!BOOST_PP_CAT(name, _tls_ptr_).get()){ \
             BOOST_PP_CAT(name, _tls_ptr_).reset(new type ctor); \
         } \
-        static type &name = *BOOST_PP_CAT(name, _tls_ptr_);
+        type &name = *BOOST_PP_CAT(name, _tls_ptr_);
 #  endif
 #else
    // no thread-safety, just use static
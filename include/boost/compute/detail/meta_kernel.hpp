@@ -12,6 +12,7 @@
 #define BOOST_COMPUTE_DETAIL_META_KERNEL_HPP
 
 #include <set>
+#include <limits>
 #include <string>
 #include <vector>
 #include <iomanip>
@@ -36,6 +37,8 @@
 #include <boost/compute/memory_object.hpp>
 #include <boost/compute/memory/svm_ptr.hpp>
 #include <boost/compute/detail/device_ptr.hpp>
+#include <boost/compute/detail/global_static.hpp>
+#include <boost/compute/detail/lru_cache.hpp>
 #include <boost/compute/detail/sha1.hpp>
 #include <boost/compute/utility/program_cache.hpp>
 
@@ -225,6 +228,65 @@ struct meta_kernel_svm_info
     size_t index;
 };
 
+// hit/miss counters for the meta_kernel kernel object cache
+struct meta_kernel_cache_statistics
+{
+    meta_kernel_cache_statistics()
+        : hits(0),
+          misses(0)
+    {
+    }
+
+    double hit_rate() const
+    {
+        const size_t total = hits + misses;
+
+        return total ? static_cast<double>(hits) / total : 0.0;
+    }
+
+    size_t hits;
+    size_t misses;
+};
+
+// stores kernel objects created by meta_kernel::exec_1d() keyed on their
+// context, build options and source so that repeated executions of the
+// same meta-kernel only need to rebind their arguments. the source is the
+// only identity a generated kernel has. it is compared as it is (the keys
+// are kept in a std::map) and only hashed when a kernel is built.
+struct meta_kernel_cache
+{
+    typedef std::pair<cl_context, std::pair<std::string, std::string> > key_type;
+
+    meta_kernel_cache(size_t capacity)
+        : kernels(capacity)
+    {
+    }
+
+    lru_cache<key_type, kernel> kernels;
+    meta_kernel_cache_statistics statistics;
+};
+
+// returns true if the indices into a range of count elements need to be
+// stored in ulong variables. half of the uint range is left as headroom for
+// index arithmetic like "index + block" or "count + get_global_size(0)".
+inline bool requires_64bit_indices(size_t count)
+{
+    return static_cast<ulong_>(count) >
+           static_cast<ulong_>((std::numeric_limits<uint_>::max)() / 2);
+}
+
+// returns the literal for the constant offset of an index expression like
+// "buffer[offset+(i)]". offsets too large for 32-bit indices get a ulong
+// suffix so that the sum is computed with 64 bits.
+inline std::string index_offset_literal(size_t offset)
+{
+    std::string literal = boost::lexical_cast<std::string>(offset);
+    if(requires_64bit_indices(offset)){
+        literal += "UL";
+    }
+
+    return literal;
+}
 
 class meta_kernel;
 
@@ -296,7 +358,8 @@ public:
     };
 
     explicit meta_kernel(const std::string &name)
-        : m_name(name)
+        : m_name(name),
+          m_64bit_indices(false)
     {
     }
 
@@ -304,6 +367,7 @@ public:
     {
         m_source.str(other.m_source.str());
         m_options = other.m_options;
+        m_64bit_indices = other.m_64bit_indices;
     }
 
     meta_kernel& operator=(const meta_kernel &other)
@@ -311,6 +375,7 @@ public:
         if(this != &other){
             m_source.str(other.m_source.str());
             m_options = other.m_options;
+            m_64bit_indices = other.m_64bit_indices;
         }
 
         return *this;
@@ -356,50 +421,24 @@ public:
 
     kernel compile(const context &context, const std::string &options = std::string())
     {
-        // generate the program source
-        std::string source = this->source();
-
-        // generate cache key
-        std::string cache_key = "__boost_meta_kernel_" +
-            static_cast<std::string>(detail::sha1(source));
-
-        // load program cache
-        boost::shared_ptr<program_cache> cache =
-            program_cache::get_global_cache(context);
-
-        std::string compile_options = m_options + options;
-
-        // load (or build) program from cache
-        ::boost::compute::program program =
-            cache->get_or_build(cache_key, compile_options, source, context);
-
-        // create kernel
-        ::boost::compute::kernel kernel = program.create_kernel(name());
-
-        // bind stored args
-        for(size_t i = 0; i < m_stored_args.size(); i++){
-            const detail::meta_kernel_stored_arg &arg = m_stored_args[i];
-
-            if(arg.m_size != 0){
-                kernel.set_arg(i, arg.m_size, arg.m_value);
-            }
-        }
-
-        // bind buffer args
-        for(size_t i = 0; i < m_stored_buffers.size(); i++){
-            const detail::meta_kernel_buffer_info &bi = m_stored_buffers[i];
-
-            kernel.set_arg(bi.index, bi.m_mem);
-        }
+        return compile_source(context, this->source(), options);
+    }
 
-        // bind svm args
-        for(size_t i = 0; i < m_stored_svm_ptrs.size(); i++){
-            const detail::meta_kernel_svm_info &spi = m_stored_svm_ptrs[i];
+    /// Returns the hit/miss counters for the kernel object cache used by
+    /// exec() and exec_1d(). When \c BOOST_COMPUTE_THREAD_SAFE is defined
+    /// the cache and its counters are per-thread.
+    static meta_kernel_cache_statistics kernel_cache_statistics()
+    {
+        return get_kernel_cache().statistics;
+    }
 
-            kernel.set_arg_svm_ptr(spi.index, spi.ptr);
-        }
+    /// Clears the kernel object cache and resets its counters.
+    static void clear_kernel_cache()
+    {
+        meta_kernel_cache &cache = get_kernel_cache();
 
-        return kernel;
+        cache.kernels.clear();
+        cache.statistics = meta_kernel_cache_statistics();
     }
 
     template<class T>
@@ -450,6 +489,61 @@ public:
         return index;
     }
 
+    // selects the type returned by index_type() for a range of count
+    // elements. must be called before any index variables or arguments
+    // are added to the kernel.
+    void set_index_type_for(size_t count)
+    {
+        m_64bit_indices = requires_64bit_indices(count);
+    }
+
+    bool uses_64bit_indices() const
+    {
+        return m_64bit_indices;
+    }
+
+    // returns the type name to use for indices and sizes in the kernel,
+    // "uint" unless the range set with set_index_type_for() is too large
+    std::string index_type() const
+    {
+        return m_64bit_indices ? "ulong" : "uint";
+    }
+
+    // adds a constant argument of the index type
+    size_t add_index_arg(const std::string &name)
+    {
+        m_args.push_back("const " + index_type() + " " + name);
+
+        return m_args.size() - 1;
+    }
+
+    void set_index_arg(size_t index, size_t value)
+    {
+        if(m_64bit_indices){
+            set_arg<ulong_>(index, static_cast<ulong_>(value));
+        }
+        else {
+            set_arg<uint_>(index, static_cast<uint_>(value));
+        }
+    }
+
+    void set_index_arg(kernel &kernel, size_t index, size_t value) const
+    {
+        if(m_64bit_indices){
+            kernel.set_arg(index, static_cast<ulong_>(value));
+        }
+        else {
+            kernel.set_arg(index, static_cast<uint_>(value));
+        }
+    }
+
+    size_t add_set_index_arg(const std::string &name, size_t value)
+    {
+        size_t index = add_index_arg(name);
+        set_index_arg(index, value);
+        return index;
+    }
+
     void add_extension_pragma(const std::string &extension,
                               const std::string &value = "enable")
     {
@@ -670,7 +764,7 @@ public:
     {
         const context &context = queue.get_context();
 
-        ::boost::compute::kernel kernel = compile(context);
+        ::boost::compute::kernel kernel = compile_cached(context);
 
         return queue.enqueue_1d_range_kernel(
                    kernel,
@@ -689,7 +783,7 @@ public:
     {
         const context &context = queue.get_context();
 
-        ::boost::compute::kernel kernel = compile(context);
+        ::boost::compute::kernel kernel = compile_cached(context);
 
         return queue.enqueue_1d_range_kernel(
                    kernel,
@@ -949,6 +1043,99 @@ private:
         return index;
     }
 
+    // builds (or loads from the program cache) the program for source,
+    // the generated source of the meta-kernel, and creates its kernel
+    ::boost::compute::kernel compile_source(const context &context,
+                                            const std::string &source,
+                                            const std::string &options)
+    {
+        // generate cache key
+        std::string cache_key = "__boost_meta_kernel_" +
+            static_cast<std::string>(detail::sha1(source));
+
+        // load program cache
+        boost::shared_ptr<program_cache> cache =
+            program_cache::get_global_cache(context);
+
+        std::string compile_options = m_options + options;
+
+        // load (or build) program from cache
+        ::boost::compute::program program =
+            cache->get_or_build(cache_key, compile_options, source, context);
+
+        // create kernel
+        ::boost::compute::kernel kernel = program.create_kernel(name());
+
+        // bind stored args
+        bind_args(kernel);
+
+        return kernel;
+    }
+
+    // returns a kernel object for the meta-kernel, reusing the kernel
+    // created by a previous call with identical source and options. the
+    // returned kernel is shared with other meta_kernel instances so it must
+    // be enqueued before another meta-kernel is executed.
+    ::boost::compute::kernel compile_cached(const context &context)
+    {
+        meta_kernel_cache &cache = get_kernel_cache();
+
+        // the source is generated once and reused to build the kernel on a
+        // miss, so it is only hashed when the kernel is not cached
+        const std::string source = this->source();
+        const meta_kernel_cache::key_type key(
+            context.get(), std::make_pair(m_options, source)
+        );
+
+        boost::optional< ::boost::compute::kernel> kernel = cache.kernels.get(key);
+        if(kernel){
+            cache.statistics.hits++;
+
+            bind_args(*kernel);
+        }
+        else {
+            cache.statistics.misses++;
+
+            kernel = compile_source(context, source, std::string());
+            cache.kernels.insert(key, *kernel);
+        }
+
+        return *kernel;
+    }
+
+    void bind_args(::boost::compute::kernel &kernel) const
+    {
+        // bind stored args
+        for(size_t i = 0; i < m_stored_args.size(); i++){
+            const detail::meta_kernel_stored_arg &arg = m_stored_args[i];
+
+            if(arg.m_size != 0){
+                kernel.set_arg(i, arg.m_size, arg.m_value);
+            }
+        }
+
+        // bind buffer args
+        for(size_t i = 0; i < m_stored_buffers.size(); i++){
+            const detail::meta_kernel_buffer_info &bi = m_stored_buffers[i];
+
+            kernel.set_arg(bi.index, bi.m_mem);
+        }
+
+        // bind svm args
+        for(size_t i = 0; i < m_stored_svm_ptrs.size(); i++){
+            const detail::meta_kernel_svm_info &spi = m_stored_svm_ptrs[i];
+
+            kernel.set_arg_svm_ptr(spi.index, spi.ptr);
+        }
+    }
+
+    static meta_kernel_cache& get_kernel_cache()
+    {
+        BOOST_COMPUTE_DETAIL_GLOBAL_STATIC(meta_kernel_cache, cache, (128));
+
+        return cache;
+    }
+
 private:
     std::string m_name;
     std::stringstream m_source;
@@ -961,6 +1148,7 @@ private:
     std::vector<detail::meta_kernel_stored_arg> m_stored_args;
     std::vector<detail::meta_kernel_buffer_info> m_stored_buffers;
     std::vector<detail::meta_kernel_svm_info> m_stored_svm_ptrs;
+    bool m_64bit_indices;
 };
 
 template<class ResultType, class ArgTuple>
@@ -1017,7 +1205,7 @@ inline meta_kernel& operator<<(meta_kernel &kernel,
     else {
         return kernel <<
                    kernel.get_buffer_identifier<T>(expr.m_buffer) <<
-                   '[' << expr.m_index << "+(" << expr.m_expr << ")]";
+                   '[' << index_offset_literal(expr.m_index) << "+(" << expr.m_expr << ")]";
     }
 }
 
@@ -1035,7 +1223,7 @@ inline meta_kernel& operator<<(meta_kernel &kernel,
     else {
         return kernel <<
                    kernel.get_buffer_identifier<T>(expr.m_buffer) <<
-                   '[' << expr.m_index << "+(" << expr.m_expr << ")]";
+                   '[' << index_offset_literal(expr.m_index) << "+(" << expr.m_expr << ")]";
     }
 }
 
@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_DETAIL_MUTEX_HPP
+#define BOOST_COMPUTE_DETAIL_MUTEX_HPP
+
+#include <boost/compute/config.hpp>
+
+#ifdef BOOST_COMPUTE_THREAD_SAFE
+#  ifdef BOOST_COMPUTE_HAVE_THREAD_LOCAL
+     // use c++11 threading primitives
+#    include <mutex>
+#    include <condition_variable>
+#  else
+     // use threading primitives from boost.thread
+#    include <boost/thread/locks.hpp>
+#    include <boost/thread/mutex.hpp>
+#    include <boost/thread/condition_variable.hpp>
+#  endif
+#endif
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+#ifdef BOOST_COMPUTE_THREAD_SAFE
+#  ifdef BOOST_COMPUTE_HAVE_THREAD_LOCAL
+typedef std::mutex mutex;
+typedef std::unique_lock<std::mutex> unique_lock;
+typedef std::condition_variable condition_variable;
+#  else
+typedef ::boost::mutex mutex;
+typedef ::boost::unique_lock< ::boost::mutex> unique_lock;
+typedef ::boost::condition_variable condition_variable;
+#  endif
+#else
+// no thread-safety, all locking operations are no-ops
+class mutex
+{
+public:
+    void lock() { }
+    void unlock() { }
+};
+
+class unique_lock
+{
+public:
+    explicit unique_lock(mutex &) { }
+
+    void lock() { }
+    void unlock() { }
+};
+
+class condition_variable
+{
+public:
+    void wait(unique_lock &) { }
+    void notify_one() { }
+    void notify_all() { }
+};
+#endif
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_DETAIL_MUTEX_HPP
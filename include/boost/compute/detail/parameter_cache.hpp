@@ -20,7 +20,7 @@
 
 #include <boost/compute/config.hpp>
 #include <boost/compute/device.hpp>
-#include <boost/compute/detail/global_static.hpp>
+#include <boost/compute/detail/mutex.hpp>
 #include <boost/compute/version.hpp>
 
 #ifdef BOOST_COMPUTE_USE_OFFLINE_CACHE
@@ -62,6 +62,8 @@ public:
 
     void set(const std::string &object, const std::string &parameter, uint_ value)
     {
+        detail::unique_lock lock(m_mutex);
+
         m_cache[std::make_pair(object, parameter)] = value;
 
         // set the dirty flag to true. this will cause the updated parameters
@@ -71,6 +73,8 @@ public:
 
     uint_ get(const std::string &object, const std::string &parameter, uint_ default_value)
     {
+        detail::unique_lock lock(m_mutex);
+
         std::map<std::pair<std::string, std::string>, uint_>::iterator
             iter = m_cache.find(std::make_pair(object, parameter));
         if(iter != m_cache.end()){
@@ -81,12 +85,27 @@ public:
         }
     }
 
+    // stores the current parameters to the offline cache file now rather
+    // than when the cache is destroyed
+    void flush()
+    {
+    #ifdef BOOST_COMPUTE_USE_OFFLINE_CACHE
+        detail::unique_lock lock(m_mutex);
+
+        write_to_disk();
+    #endif // BOOST_COMPUTE_USE_OFFLINE_CACHE
+    }
+
     static boost::shared_ptr<parameter_cache> get_global_cache(const device &device)
     {
         // device name -> parameter cache
         typedef std::map<std::string, boost::shared_ptr<parameter_cache> > cache_map;
 
-        BOOST_COMPUTE_DETAIL_GLOBAL_STATIC(cache_map, caches, ((std::less<std::string>())));
+        // the global caches are shared by all threads in the process
+        static cache_map caches;
+        static detail::mutex caches_mutex;
+
+        detail::unique_lock lock(caches_mutex);
 
         cache_map::iterator iter = caches.find(device.name());
         if(iter == caches.end()){
@@ -214,6 +233,7 @@ private:
     std::string m_device_name;
     std::string m_file_name;
     std::map<std::pair<std::string, std::string>, uint_> m_cache;
+    detail::mutex m_mutex;
 };
 
 } // end detail namespace
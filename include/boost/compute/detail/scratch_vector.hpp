@@ -0,0 +1,78 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_DETAIL_SCRATCH_VECTOR_HPP
+#define BOOST_COMPUTE_DETAIL_SCRATCH_VECTOR_HPP
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/iterator/buffer_iterator.hpp>
+#include <boost/compute/memory/scratch_pool.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// fixed-size temporary storage for count values of type T allocated from
+// the scratch pool of a command queue. the memory is returned to the pool
+// when the scratch_vector is destroyed.
+template<class T>
+class scratch_vector : boost::noncopyable
+{
+public:
+    typedef T value_type;
+    typedef buffer_iterator<T> iterator;
+
+    scratch_vector(size_t count, command_queue &queue)
+        : m_pool(scratch_pool::get_pool(queue)),
+          m_size(count)
+    {
+        m_allocation = m_pool->allocate(count * sizeof(T));
+    }
+
+    ~scratch_vector()
+    {
+        m_pool->deallocate(m_allocation);
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    iterator begin() const
+    {
+        return iterator(get_buffer(), 0);
+    }
+
+    iterator end() const
+    {
+        return iterator(get_buffer(), m_size);
+    }
+
+    const buffer& get_buffer() const
+    {
+        return m_allocation.get_buffer();
+    }
+
+private:
+    boost::shared_ptr<scratch_pool> m_pool;
+    scratch_pool::allocation m_allocation;
+    size_t m_size;
+};
+
+} // end detail namespace
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_DETAIL_SCRATCH_VECTOR_HPP
@@ -14,6 +14,7 @@
 #include <boost/compute/buffer.hpp>
 #include <boost/compute/system.hpp>
 #include <boost/compute/context.hpp>
+#include <boost/compute/allocator/pooled_allocator.hpp>
 #include <boost/compute/detail/device_ptr.hpp>
 
 namespace boost {
@@ -23,13 +24,16 @@ namespace experimental {
 // bring device_ptr into the experimental namespace
 using detail::device_ptr;
 
+// memory is allocated from the pool shared with pooled_allocator, so the
+// size of the underlying buffer is rounded up to the pool's size class.
+// memory released with free() is kept in the pool for reuse until it is
+// returned to the OpenCL implementation with pooled_allocator<T>::trim()
+// or release_pool().
 template<class T>
 inline device_ptr<T>
 malloc(std::size_t size, const context &context = system::default_context())
 {
-    buffer buf(context, size * sizeof(T));
-    clRetainMemObject(buf.get());
-    return device_ptr<T>(buf);
+    return pooled_allocator<T>(context).allocate(size);
 }
 
 inline device_ptr<char>
@@ -38,10 +42,19 @@ malloc(std::size_t size, const context &context = system::default_context())
     return malloc<char>(size, context);
 }
 
+// memory which was not allocated from a pool (or whose pool has been
+// released since) is released directly
 template<class T>
 inline void free(device_ptr<T> &ptr)
 {
-    clReleaseMemObject(ptr.get_buffer().get());
+    // take ownership of the reference acquired in malloc()
+    buffer buf(ptr.get_buffer().get(), false);
+
+    boost::shared_ptr<detail::buffer_pool> pool =
+        detail::buffer_pool::find(buf.get_context(), buffer::read_write);
+    if(pool){
+        pool->try_deallocate(buf);
+    }
 }
 
 } // end experimental namespace
@@ -106,7 +106,7 @@ inline meta_kernel& operator<<(meta_kernel &kernel,
     else {
         return kernel <<
                    kernel.get_buffer_identifier<T>(expr.m_buffer, expr.m_address_space) <<
-                   '[' << uint_(expr.m_index) << "+(" << expr.m_expr << ")]";
+                   '[' << index_offset_literal(expr.m_index) << "+(" << expr.m_expr << ")]";
     }
 }
 
@@ -0,0 +1,540 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_MEMORY_SCRATCH_POOL_HPP
+#define BOOST_COMPUTE_MEMORY_SCRATCH_POOL_HPP
+
+#include <list>
+#include <map>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/optional.hpp>
+#include <boost/make_shared.hpp>
+
+#include <boost/compute/cl.hpp>
+#include <boost/compute/event.hpp>
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/device.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/mutex.hpp>
+
+namespace boost {
+namespace compute {
+
+/// \class scratch_pool
+/// \brief A pool of device memory for temporary algorithm storage.
+///
+/// The scratch_pool class manages a set of large device buffers ("slabs")
+/// which are carved up into the temporary buffers needed by algorithms such
+/// as sort(), stable_partition() and set_union(). Once an algorithm is done
+/// with its temporary storage the memory is returned to the pool and reused
+/// by the next algorithm executed on the same command queue instead of
+/// being released back to the OpenCL implementation.
+///
+/// Each command queue has its own pool which can be retrieved with the
+/// get_pool() function. For in-order command queues memory is reused
+/// immediately (any later use is ordered after the previous one by the
+/// queue). For out-of-order command queues a marker is enqueued when memory
+/// is released and the memory is not reused until the marker has completed.
+///
+/// The pool can be preallocated with reserve() to avoid allocating memory
+/// inside a time-critical loop, and its total size is capped with
+/// set_max_size(). By default the pool holds at most a quarter of the global
+/// memory of the device. Requests which do not fit under the cap are served
+/// with dedicated buffers which are released as soon as they are no longer
+/// used. Unused slabs can be released at any time with trim().
+///
+/// The pool is created the first time it is requested for a queue and is
+/// shared by all command_queue objects for the same OpenCL command queue
+/// which have used it, including their copies. It is released along with
+/// the last of them (once the algorithms still using its memory are done
+/// with it), so the pools do not keep destroyed queues and their memory
+/// alive. Creating a command_queue object does not allocate anything for
+/// the pool.
+///
+/// For example, to preallocate 64 MB of scratch memory for sorting:
+/// \code
+/// boost::shared_ptr<boost::compute::scratch_pool> pool =
+///     boost::compute::scratch_pool::get_pool(queue);
+/// pool->reserve(64 * 1024 * 1024);
+/// \endcode
+///
+/// Sub-buffers are used to hand out regions of the slabs and thus the pool
+/// requires OpenCL 1.1. With OpenCL 1.0 every allocation is served with a
+/// dedicated buffer.
+///
+/// \see buffer
+class scratch_pool : boost::noncopyable
+{
+private:
+    struct slab
+    {
+        explicit slab(const buffer &memory_)
+            : memory(memory_),
+              used(0)
+        {
+            free_blocks[0] = memory.size();
+        }
+
+        buffer memory;
+        size_t used;
+        // maps block offset to block size
+        std::map<size_t, size_t> free_blocks;
+    };
+
+    typedef std::list<slab> slab_list;
+
+public:
+    /// \internal_
+    class allocation
+    {
+    public:
+        allocation()
+            : m_pooled(false),
+              m_offset(0),
+              m_size(0)
+        {
+        }
+
+        const buffer& get_buffer() const
+        {
+            return m_buffer;
+        }
+
+    private:
+        friend class scratch_pool;
+
+        buffer m_buffer;
+        bool m_pooled;
+        slab_list::iterator m_slab;
+        size_t m_offset;
+        size_t m_size;
+    };
+
+    /// Creates a new scratch pool for \p queue.
+    ///
+    /// Most users should use get_pool() instead of creating pools directly.
+    explicit scratch_pool(const command_queue &queue)
+        : m_queue(queue),
+          m_context(queue.get_context()),
+          m_max_size(default_max_size(queue.get_device())),
+          m_size(0),
+          m_used(0),
+          m_out_of_order(false)
+    {
+        m_out_of_order = (queue.get_properties() &
+                          CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) != 0;
+
+        // sub-buffer origins must satisfy the base address alignment of
+        // every device in the context
+        m_alignment = 128;
+        const std::vector<device> devices = m_context.get_devices();
+        for(size_t i = 0; i < devices.size(); i++){
+            size_t device_alignment =
+                devices[i].get_info<cl_uint>(CL_DEVICE_MEM_BASE_ADDR_ALIGN) / 8;
+            m_alignment = (std::max)(m_alignment, device_alignment);
+        }
+
+        m_max_alloc_size =
+            static_cast<size_t>(queue.get_device().max_memory_alloc_size());
+    }
+
+    /// Destroys the scratch pool.
+    ~scratch_pool()
+    {
+    }
+
+    /// Returns the command queue for the pool.
+    command_queue& get_queue()
+    {
+        return m_queue;
+    }
+
+    /// Returns the total number of bytes of device memory held by the pool.
+    size_t size() const
+    {
+        detail::unique_lock lock(m_mutex);
+
+        return m_size;
+    }
+
+    /// Returns the number of bytes currently handed out by the pool.
+    size_t used() const
+    {
+        detail::unique_lock lock(m_mutex);
+
+        return m_used;
+    }
+
+    /// Returns the number of slabs allocated by the pool.
+    size_t slab_count() const
+    {
+        detail::unique_lock lock(m_mutex);
+
+        return m_slabs.size();
+    }
+
+    /// Returns the maximum number of bytes the pool will hold. A value of
+    /// \c 0 indicates that the pool size is not limited. By default this is
+    /// a quarter of the global memory of the device.
+    size_t max_size() const
+    {
+        detail::unique_lock lock(m_mutex);
+
+        return m_max_size;
+    }
+
+    /// Sets the maximum number of bytes the pool will hold to \p size. A
+    /// value of \c 0 removes the limit.
+    ///
+    /// Unused slabs are released if the pool is currently larger than
+    /// \p size.
+    void set_max_size(size_t size)
+    {
+        detail::unique_lock lock(m_mutex);
+
+        m_max_size = size;
+
+        if(m_max_size != 0 && m_size > m_max_size){
+            trim_unlocked();
+        }
+    }
+
+    /// Ensures that the pool holds at least \p size bytes of free memory in
+    /// a single slab so that a subsequent allocation of up to \p size bytes
+    /// will not need to allocate memory from the OpenCL implementation.
+    void reserve(size_t size)
+    {
+    #ifdef BOOST_COMPUTE_CL_VERSION_1_1
+        detail::unique_lock lock(m_mutex);
+
+        retire_pending();
+
+        size = align(size);
+        for(slab_list::iterator i = m_slabs.begin(); i != m_slabs.end(); ++i){
+            if(largest_free_block(*i) >= size){
+                return;
+            }
+        }
+
+        add_slab(size);
+    #else
+        (void) size;
+    #endif // BOOST_COMPUTE_CL_VERSION_1_1
+    }
+
+    /// Releases all slabs which are not currently in use.
+    void trim()
+    {
+        detail::unique_lock lock(m_mutex);
+
+        trim_unlocked();
+    }
+
+    /// \internal_
+    ///
+    /// Allocates a buffer of at least \p size bytes from the pool.
+    allocation allocate(size_t size)
+    {
+        detail::unique_lock lock(m_mutex);
+
+        retire_pending();
+
+        allocation a;
+        a.m_size = align((std::max)(size, size_t(1)));
+
+    #ifdef BOOST_COMPUTE_CL_VERSION_1_1
+        // first-fit search through the existing slabs
+        for(slab_list::iterator i = m_slabs.begin(); i != m_slabs.end(); ++i){
+            if(take_block(i, a)){
+                return a;
+            }
+        }
+
+        // grow the pool, doubling its size each time so that the number of
+        // slabs stays small
+        size_t slab_size = (std::max)(a.m_size, (std::max)(m_size, min_slab_size()));
+        slab_size = (std::min)(slab_size, m_max_alloc_size);
+        if(m_max_size != 0 && m_size + slab_size > m_max_size){
+            slab_size = a.m_size;
+        }
+
+        if(slab_size >= a.m_size &&
+           (m_max_size == 0 || m_size + slab_size <= m_max_size)){
+            if(take_block(add_slab(slab_size), a)){
+                return a;
+            }
+        }
+    #endif // BOOST_COMPUTE_CL_VERSION_1_1
+
+        // fall back to a dedicated buffer
+        a.m_buffer = buffer(m_context, a.m_size);
+        a.m_pooled = false;
+        return a;
+    }
+
+    /// \internal_
+    ///
+    /// Returns the memory for \p a to the pool.
+    void deallocate(allocation &a)
+    {
+        if(!a.m_pooled){
+            a.m_buffer = buffer();
+            return;
+        }
+
+        if(m_out_of_order){
+            // the memory can only be reused once every command enqueued
+            // before this point has completed
+            event marker = m_queue.enqueue_marker();
+
+            detail::unique_lock lock(m_mutex);
+            m_pending.push_back(std::make_pair(marker, a));
+        }
+        else {
+            detail::unique_lock lock(m_mutex);
+            release_block(a);
+        }
+
+        a.m_buffer = buffer();
+        a.m_pooled = false;
+    }
+
+    /// Returns the scratch pool for \p queue.
+    static boost::shared_ptr<scratch_pool> get_pool(const command_queue &queue)
+    {
+        BOOST_ASSERT(queue.get() != 0);
+
+        boost::shared_ptr<detail::command_queue_scratch_slot> slot =
+            get_slot(queue);
+        detail::unique_lock lock(slot->pool_mutex);
+
+        if(!slot->pool){
+            // the pool refers to the queue through its own command_queue
+            // object, which never requests a pool, so that it does not keep
+            // the slot (and itself) alive
+            slot->pool =
+                boost::make_shared<scratch_pool>(command_queue(queue.get()));
+        }
+
+        return slot->pool;
+    }
+
+private:
+    typedef std::map<
+        cl_command_queue, boost::weak_ptr<detail::command_queue_scratch_slot>
+    > slot_map;
+
+    // returns the scratch slot of queue. the first request creates it or
+    // looks up the slot of another command_queue object for the same OpenCL
+    // queue, which is then kept by queue and its later copies.
+    static boost::shared_ptr<detail::command_queue_scratch_slot>
+    get_slot(const command_queue &queue)
+    {
+        detail::unique_lock lock(slots_mutex());
+
+        if(queue.m_scratch){
+            return queue.m_scratch;
+        }
+
+        slot_map &slots = slot_registry();
+        boost::shared_ptr<detail::command_queue_scratch_slot> slot;
+
+        slot_map::iterator i = slots.find(queue.get());
+        if(i != slots.end()){
+            slot = i->second.lock();
+        }
+
+        if(!slot){
+            // drop the entries of slots which have been released
+            for(i = slots.begin(); i != slots.end();){
+                if(i->second.expired()){
+                    slots.erase(i++);
+                }
+                else {
+                    ++i;
+                }
+            }
+
+            slot = boost::make_shared<detail::command_queue_scratch_slot>();
+            slots[queue.get()] = slot;
+        }
+
+        queue.m_scratch = slot;
+        return slot;
+    }
+
+    static slot_map& slot_registry()
+    {
+        static slot_map slots;
+        return slots;
+    }
+
+    static detail::mutex& slots_mutex()
+    {
+        static detail::mutex m;
+        return m;
+    }
+
+    static size_t min_slab_size()
+    {
+        return 1024 * 1024;
+    }
+
+    static size_t default_max_size(const device &device)
+    {
+        const ulong_ size = device.global_memory_size() / 4;
+
+        return static_cast<size_t>(
+            (std::min)(size, ulong_((std::numeric_limits<size_t>::max)()))
+        );
+    }
+
+    size_t align(size_t size) const
+    {
+        return ((size + m_alignment - 1) / m_alignment) * m_alignment;
+    }
+
+    static size_t largest_free_block(const slab &s)
+    {
+        size_t largest = 0;
+        for(std::map<size_t, size_t>::const_iterator i = s.free_blocks.begin();
+            i != s.free_blocks.end(); ++i){
+            largest = (std::max)(largest, i->second);
+        }
+        return largest;
+    }
+
+    slab_list::iterator add_slab(size_t size)
+    {
+        m_slabs.push_back(slab(buffer(m_context, size)));
+        m_size += size;
+        return --m_slabs.end();
+    }
+
+    bool take_block(slab_list::iterator s, allocation &a)
+    {
+    #ifdef BOOST_COMPUTE_CL_VERSION_1_1
+        for(std::map<size_t, size_t>::iterator i = s->free_blocks.begin();
+            i != s->free_blocks.end(); ++i){
+            if(i->second < a.m_size){
+                continue;
+            }
+
+            const size_t offset = i->first;
+            const size_t remaining = i->second - a.m_size;
+            s->free_blocks.erase(i);
+            if(remaining > 0){
+                s->free_blocks[offset + a.m_size] = remaining;
+            }
+
+            a.m_buffer =
+                s->memory.create_subbuffer(buffer::read_write, offset, a.m_size);
+            a.m_slab = s;
+            a.m_offset = offset;
+            a.m_pooled = true;
+
+            s->used += a.m_size;
+            m_used += a.m_size;
+            return true;
+        }
+    #else
+        (void) s;
+        (void) a;
+    #endif // BOOST_COMPUTE_CL_VERSION_1_1
+
+        return false;
+    }
+
+    void release_block(const allocation &a)
+    {
+        slab &s = *a.m_slab;
+        s.used -= a.m_size;
+        m_used -= a.m_size;
+
+        // insert the block and merge it with its neighbors
+        std::map<size_t, size_t>::iterator block =
+            s.free_blocks.insert(std::make_pair(a.m_offset, a.m_size)).first;
+
+        std::map<size_t, size_t>::iterator next = block;
+        ++next;
+        if(next != s.free_blocks.end() &&
+           block->first + block->second == next->first){
+            block->second += next->second;
+            s.free_blocks.erase(next);
+        }
+
+        if(block != s.free_blocks.begin()){
+            std::map<size_t, size_t>::iterator prev = block;
+            --prev;
+            if(prev->first + prev->second == block->first){
+                prev->second += block->second;
+                s.free_blocks.erase(block);
+            }
+        }
+    }
+
+    // returns memory released on out-of-order queues whose marker has
+    // completed back to the free lists
+    void retire_pending()
+    {
+        std::vector<std::pair<event, allocation> >::iterator i = m_pending.begin();
+        while(i != m_pending.end()){
+            if(i->first.status() == CL_COMPLETE){
+                release_block(i->second);
+                i = m_pending.erase(i);
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    void trim_unlocked()
+    {
+        retire_pending();
+
+        slab_list::iterator i = m_slabs.begin();
+        while(i != m_slabs.end()){
+            if(i->used == 0){
+                m_size -= i->memory.size();
+                i = m_slabs.erase(i);
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+private:
+    command_queue m_queue;
+    context m_context;
+    size_t m_alignment;
+    size_t m_max_alloc_size;
+    size_t m_max_size;
+    size_t m_size;
+    size_t m_used;
+    bool m_out_of_order;
+    slab_list m_slabs;
+    std::vector<std::pair<event, allocation> > m_pending;
+    mutable detail::mutex m_mutex;
+};
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_MEMORY_SCRATCH_POOL_HPP
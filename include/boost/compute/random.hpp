@@ -22,6 +22,7 @@
 #include <boost/compute/random/mersenne_twister_engine.hpp>
 #include <boost/compute/random/threefry_engine.hpp>
 #include <boost/compute/random/normal_distribution.hpp>
+#include <boost/compute/random/philox_engine.hpp>
 #include <boost/compute/random/uniform_int_distribution.hpp>
 #include <boost/compute/random/uniform_real_distribution.hpp>
 
@@ -64,11 +64,6 @@ public:
                   Generator &generator,
                   command_queue &queue)
     {
-        size_t count = detail::iterator_range_size(first, last);
-
-        vector<uint_> tmp(count, queue.get_context());
-        generator.generate(tmp.begin(), tmp.end(), queue);
-
         BOOST_COMPUTE_FUNCTION(bool, scale_random, (const uint_ x),
         {
             return (convert_RealType(x) / MAX_RANDOM) < PARAM;
@@ -80,9 +75,7 @@ public:
             "convert_RealType", std::string("convert_") + type_name<RealType>()
         );
 
-        transform(
-            tmp.begin(), tmp.end(), first, scale_random, queue
-        );
+        generator.generate(first, last, scale_random, queue);
     }
 
 private:
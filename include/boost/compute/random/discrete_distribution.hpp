@@ -12,17 +12,19 @@
 #define BOOST_COMPUTE_RANDOM_DISCRETE_DISTRIBUTION_HPP
 
 #include <numeric>
+#include <vector>
 
 #include <boost/config.hpp>
 #include <boost/type_traits.hpp>
 #include <boost/static_assert.hpp>
 
+#include <boost/compute/buffer.hpp>
+#include <boost/compute/context.hpp>
 #include <boost/compute/command_queue.hpp>
-#include <boost/compute/function.hpp>
-#include <boost/compute/algorithm/accumulate.hpp>
-#include <boost/compute/algorithm/copy.hpp>
-#include <boost/compute/algorithm/transform.hpp>
-#include <boost/compute/detail/literal.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
 #include <boost/compute/types/fundamental.hpp>
 
 namespace boost {
@@ -38,6 +40,12 @@ namespace compute {
 ///
 /// \snippet test/test_discrete_distribution.cpp generate
 ///
+/// Values are sampled in constant time with the alias method: the weights
+/// are turned into a table (built once, on the host, when the distribution
+/// is created) which is passed to the sampling kernel as a buffer. The
+/// table is uploaded by the first call to generate() and kept on the device
+/// for later calls with the same context. The same compiled program is used
+/// for all distributions with the same result type.
 template<class IntType = uint_>
 class discrete_distribution
 {
@@ -47,40 +55,34 @@ public:
     /// Creates a new discrete distribution with a single weight p = { 1 }.
     /// This distribution produces only zeroes.
     discrete_distribution()
-        : m_probabilities(1, double(1)),
-          m_scanned_probabilities(1, double(1))
+        : m_probabilities(1, double(1))
     {
-
+        build_alias_table();
     }
 
     /// Creates a new discrete distribution with weights given by
     /// the range [\p first, \p last).
     template<class InputIterator>
     discrete_distribution(InputIterator first, InputIterator last)
-        : m_probabilities(first, last),
-          m_scanned_probabilities(std::distance(first, last))
+        : m_probabilities(first, last)
     {
         if(first != last) {
-            // after this m_scanned_probabilities.back() is a sum of all
-            // weights from the range [first, last)
-            std::partial_sum(first, last, m_scanned_probabilities.begin());
+            const double sum = std::accumulate(
+                m_probabilities.begin(), m_probabilities.end(), double(0)
+            );
 
+            // dividing each weight by sum of all weights to get probabilities
             std::vector<double>::iterator i = m_probabilities.begin();
-            std::vector<double>::iterator j = m_scanned_probabilities.begin();
-            for(; i != m_probabilities.end(); ++i, ++j)
+            for(; i != m_probabilities.end(); ++i)
             {
-                // dividing each weight by sum of all weights to
-                // get probabilities
-                *i = *i / m_scanned_probabilities.back();
-                // dividing each partial sum of weights by sum of
-                // all weights to get partial sums of probabilities
-                *j = *j / m_scanned_probabilities.back();
+                *i = *i / sum;
             }
         }
         else {
             m_probabilities.push_back(double(1));
-            m_scanned_probabilities.push_back(double(1));
         }
+
+        build_alias_table();
     }
 
     /// Destroys the discrete_distribution object.
@@ -120,33 +122,120 @@ public:
                   Generator &generator,
                   command_queue &queue)
     {
-        std::string source = "inline IntType scale_random(uint x)\n";
-
-        source = source +
-            "{\n" +
-            "float rno = convert_float(x) / UINT_MAX;\n";
-        for(size_t i = 0; i < m_scanned_probabilities.size() - 1; i++)
-        {
-            source = source +
-                "if(rno <= " + detail::make_literal<float>(m_scanned_probabilities[i]) + ")\n" +
-                "   return " + detail::make_literal(i) + ";\n";
+        const size_t size = detail::iterator_range_size(first, last);
+        if(size == 0){
+            return;
         }
 
-        source = source +
-            "return " + detail::make_literal(m_scanned_probabilities.size() - 1) + ";\n" +
-            "}\n";
+        const context &context = queue.get_context();
+
+        vector<uint_> random_values(size, context);
+        generator.generate(random_values.begin(), random_values.end(), queue);
+
+        const buffer &alias_table = device_alias_table(context);
+
+        // the high bits of x * n select a column, the low bits decide
+        // between the column and its alias
+        detail::meta_kernel k("discrete_distribution_alias");
+        size_t n_arg = k.add_arg<const uint_>("n");
+        size_t table_arg =
+            k.add_arg<const uint2_ *>(memory_object::global_memory, "table");
+        k <<
+            "const uint i = get_global_id(0);\n" <<
+            "const ulong x = (ulong)(" <<
+                random_values.begin()[k.var<const uint_>("i")] << ") * n;\n" <<
+            "const uint column = (uint)(x >> 32);\n" <<
+            "const uint2 entry = table[column];\n" <<
+            first[k.var<const uint_>("i")] << " = (" <<
+                type_name<result_type>() << ")" <<
+                "((uint)(x) < entry.x ? column : entry.y);\n";
+
+        kernel sample_kernel = k.compile(context);
+        sample_kernel.set_arg(n_arg, static_cast<uint_>(m_alias_table.size()));
+        sample_kernel.set_arg(table_arg, alias_table);
+
+        queue.enqueue_1d_range_kernel(sample_kernel, 0, size, 0);
+    }
+
+private:
+    /// \internal_
+    /// Returns the alias table in device memory for \p context. It is
+    /// copied from the host table when the buffer is created, so the host
+    /// does not wait for the queue.
+    const buffer& device_alias_table(const context &context)
+    {
+        if(m_device_alias_table.get() == 0 ||
+           m_device_alias_table_context.get() != context.get()){
+            m_device_alias_table = buffer(
+                context,
+                m_alias_table.size() * sizeof(uint2_),
+                buffer::read_only | buffer::copy_host_ptr,
+                &m_alias_table[0]
+            );
+            m_device_alias_table_context = context;
+        }
+
+        return m_device_alias_table;
+    }
 
-        BOOST_COMPUTE_FUNCTION(IntType, scale_random, (const uint_ x), {});
+    /// \internal_
+    /// Builds the alias table with Vose's method. Each column i holds the
+    /// probability (scaled to 2^32) of returning i rather than its alias.
+    void build_alias_table()
+    {
+        const size_t n = m_probabilities.size();
+
+        std::vector<double> scaled(n);
+        std::vector<size_t> small;
+        std::vector<size_t> large;
+        for(size_t i = 0; i < n; i++){
+            scaled[i] = m_probabilities[i] * n;
+            if(scaled[i] < 1.0){
+                small.push_back(i);
+            }
+            else {
+                large.push_back(i);
+            }
+        }
 
-        scale_random.set_source(source);
-        scale_random.define("IntType", type_name<IntType>());
+        m_alias_table.resize(n);
+        while(!small.empty() && !large.empty()){
+            const size_t less = small.back();
+            small.pop_back();
+            const size_t more = large.back();
+            large.pop_back();
+
+            m_alias_table[less] = uint2_(
+                static_cast<uint_>(scaled[less] * 4294967296.0),
+                static_cast<uint_>(more)
+            );
+
+            scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+            if(scaled[more] < 1.0){
+                small.push_back(more);
+            }
+            else {
+                large.push_back(more);
+            }
+        }
 
-        generator.generate(first, last, scale_random, queue);
+        // the remaining columns (only rounding errors keep them out of
+        // large) always return themselves
+        for(size_t i = 0; i < large.size(); i++){
+            m_alias_table[large[i]] =
+                uint2_(uint_(0xFFFFFFFF), static_cast<uint_>(large[i]));
+        }
+        for(size_t i = 0; i < small.size(); i++){
+            m_alias_table[small[i]] =
+                uint2_(uint_(0xFFFFFFFF), static_cast<uint_>(small[i]));
+        }
     }
 
 private:
     ::std::vector<double> m_probabilities;
-    ::std::vector<double> m_scanned_probabilities;
+    ::std::vector<uint2_> m_alias_table;
+    buffer m_device_alias_table;
+    context m_device_alias_table_context;
 
     BOOST_STATIC_ASSERT_MSG(
         boost::is_integral<IntType>::value,
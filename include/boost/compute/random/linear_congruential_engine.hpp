@@ -22,8 +22,8 @@
 #include <boost/compute/algorithm/transform.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
 #include <boost/compute/iterator/discard_iterator.hpp>
-#include <boost/compute/utility/program_cache.hpp>
 
 namespace boost {
 namespace compute {
@@ -44,30 +44,20 @@ public:
     typedef T result_type;
     static const T default_seed = 1;
     static const T a = 1099087573;
-    static const size_t threads = 1024;
 
     /// Creates a new linear_congruential_engine and seeds it with \p value.
     explicit linear_congruential_engine(command_queue &queue,
                                         result_type value = default_seed)
-        : m_context(queue.get_context()),
-          m_multiplicands(m_context, threads * sizeof(result_type))
+        : m_context(queue.get_context())
     {
-        // setup program
-        load_program();
-
         // seed state
         seed(value, queue);
-
-        // generate multiplicands
-        generate_multiplicands(queue);
     }
 
     /// Creates a new linear_congruential_engine object as a copy of \p other.
     linear_congruential_engine(const linear_congruential_engine<T> &other)
         : m_context(other.m_context),
-          m_program(other.m_program),
-          m_seed(other.m_seed),
-          m_multiplicands(other.m_multiplicands)
+          m_seed(other.m_seed)
     {
     }
 
@@ -77,9 +67,7 @@ public:
     {
         if(this != &other){
             m_context = other.m_context;
-            m_program = other.m_program;
             m_seed = other.m_seed;
-            m_multiplicands = other.m_multiplicands;
         }
 
         return *this;
@@ -110,37 +98,57 @@ public:
     }
 
     /// Generates random numbers and stores them to the range [\p first, \p last).
+    ///
+    /// Each work-item jumps directly to its first value (the i-th value is
+    /// the seed times \c a to the power of i + 1) and then strides over the
+    /// range, so any number of values is produced with one kernel launch.
     template<class OutputIterator>
     void generate(OutputIterator first, OutputIterator last, command_queue &queue)
     {
-        size_t size = detail::iterator_range_size(first, last);
-
-        kernel fill_kernel(m_program, "fill");
-        fill_kernel.set_arg(1, m_multiplicands);
-        fill_kernel.set_arg(2, first.get_buffer());
-
-        size_t offset = 0;
-
-        for(;;){
-            size_t count = 0;
-            if(size > threads){
-                count = (std::min)(static_cast<size_t>(threads), size - offset);
-            }
-            else {
-                count = size;
-            }
-            fill_kernel.set_arg(0, static_cast<const uint_>(m_seed));
-            fill_kernel.set_arg(3, static_cast<const uint_>(offset));
-            queue.enqueue_1d_range_kernel(fill_kernel, 0, count, 0);
+        const size_t size = detail::iterator_range_size(first, last);
+        if(size == 0){
+            return;
+        }
 
-            offset += count;
+        const size_t global_size = (std::min)(size, size_t(65536));
+
+        // the offset and count are ulong for ranges past the 32-bit limit
+        detail::meta_kernel k("linear_congruential_engine_fill");
+        k.set_index_type_for(first.get_index() + size);
+        size_t seed_arg = k.add_arg<const uint_>("seed");
+        size_t result_arg =
+            k.add_arg<uint_ *>(memory_object::global_memory, "result");
+        size_t offset_arg = k.add_index_arg("offset");
+        size_t count_arg = k.add_index_arg("count");
+        size_t stride_arg = k.add_arg<const uint_>("stride_multiplicand");
+
+        k <<
+            "const uint gid = get_global_id(0);\n" <<
+
+            // x = seed * a^(gid+1)
+            "uint x = seed;\n" <<
+            "uint base = " << uint_(a) << ";\n" <<
+            "for(uint e = gid + 1; e != 0; e >>= 1){\n" <<
+            "    if(e & 1){\n" <<
+            "        x *= base;\n" <<
+            "    }\n" <<
+            "    base *= base;\n" <<
+            "}\n" <<
+
+            "for(" << k.index_type() << " i = gid; i < count; i += get_global_size(0)){\n" <<
+            "    result[offset+i] = x;\n" <<
+            "    x *= stride_multiplicand;\n" <<
+            "}\n";
 
-            if(offset >= size){
-                break;
-            }
+        kernel fill_kernel = k.compile(m_context);
+        fill_kernel.set_arg(seed_arg, static_cast<const uint_>(m_seed));
+        fill_kernel.set_arg(result_arg, first.get_buffer());
+        k.set_index_arg(fill_kernel, offset_arg, first.get_index());
+        k.set_index_arg(fill_kernel, count_arg, size);
+        fill_kernel.set_arg(stride_arg, static_cast<const uint_>(power(a, global_size)));
+        queue.enqueue_1d_range_kernel(fill_kernel, 0, global_size, 0);
 
-            update_seed(queue);
-        }
+        m_seed *= power(a, size);
     }
 
     /// \internal_
@@ -148,15 +156,7 @@ public:
     {
         (void) queue;
 
-        size_t size = detail::iterator_range_size(first, last);
-        uint_ max_mult =
-            detail::read_single_value<T>(m_multiplicands, threads-1, queue);
-        while(size >= threads) {
-            m_seed *= max_mult;
-            size -= threads;
-        }
-        m_seed *=
-            detail::read_single_value<T>(m_multiplicands, size-1, queue);
+        m_seed *= power(a, detail::iterator_range_size(first, last));
     }
 
     /// Generates random numbers, transforms them with \p op, and then stores
@@ -177,59 +177,22 @@ public:
 
 private:
     /// \internal_
-    /// Generates the multiplicands for each thread
-    void generate_multiplicands(command_queue &queue)
+    static T power(T base, size_t exponent)
     {
-        kernel multiplicand_kernel =
-            m_program.create_kernel("multiplicand");
-        multiplicand_kernel.set_arg(0, m_multiplicands);
-
-        queue.enqueue_task(multiplicand_kernel);
-    }
-
-    /// \internal_
-    void update_seed(command_queue &queue)
-    {
-        m_seed *=
-            detail::read_single_value<T>(m_multiplicands, threads-1, queue);
-    }
-
-    /// \internal_
-    void load_program()
-    {
-        boost::shared_ptr<program_cache> cache =
-            program_cache::get_global_cache(m_context);
-
-        std::string cache_key =
-            std::string("__boost_linear_congruential_engine_") + type_name<T>();
-
-        const char source[] =
-            "__kernel void multiplicand(__global uint *multiplicands)\n"
-            "{\n"
-            "    uint a = 1099087573;\n"
-            "    multiplicands[0] = a;\n"
-            "    for(uint i = 1; i < 1024; i++){\n"
-            "        multiplicands[i] = a * multiplicands[i-1];\n"
-            "    }\n"
-            "}\n"
-
-            "__kernel void fill(const uint seed,\n"
-            "                   __global uint *multiplicands,\n"
-            "                   __global uint *result,"
-            "                   const uint offset)\n"
-            "{\n"
-            "    const uint i = get_global_id(0);\n"
-            "    result[offset+i] = seed * multiplicands[i];\n"
-            "}\n";
-
-        m_program = cache->get_or_build(cache_key, std::string(), source, m_context);
+        T result = 1;
+        while(exponent > 0){
+            if(exponent & 1){
+                result *= base;
+            }
+            base *= base;
+            exponent >>= 1;
+        }
+        return result;
     }
 
 private:
     context m_context;
-    program m_program;
     T m_seed;
-    buffer m_multiplicands;
 };
 
 } // end compute namespace
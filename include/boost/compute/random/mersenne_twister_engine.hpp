@@ -103,40 +103,44 @@ public:
     }
 
     /// Generates random numbers and stores them to the range [\p first, \p last).
+    ///
+    /// The numbers are generated by a single work-group which keeps the
+    /// state in local memory and regenerates it in parallel, so any number
+    /// of values is produced with one kernel launch. The sequence is the
+    /// same as the one of \c std::mt19937.
+    ///
+    /// As the sequence has a single state, only one compute unit of the
+    /// device is used. Engines with a counter based state like
+    /// \c threefry_engine or \c philox_engine use the whole device and
+    /// should be preferred for generating large ranges.
     template<class OutputIterator>
     void generate(OutputIterator first, OutputIterator last, command_queue &queue)
     {
         const size_t size = detail::iterator_range_size(first, last);
-
-        kernel fill_kernel(m_program, "fill");
-        fill_kernel.set_arg(0, m_state_buffer);
-        fill_kernel.set_arg(2, first.get_buffer());
-
-        size_t offset = 0;
-        size_t &p = m_state_index;
-
-        for(;;){
-            size_t count = 0;
-            if(size > n){
-                count = (std::min)(static_cast<size_t>(n), size - offset);
-            }
-            else {
-                count = size;
-            }
-            fill_kernel.set_arg(1, static_cast<const uint_>(p));
-            fill_kernel.set_arg(3, static_cast<const uint_>(offset));
-            queue.enqueue_1d_range_kernel(fill_kernel, 0, count, 0);
-
-            p += count;
-            offset += count;
-
-            if(offset >= size){
-                break;
-            }
-
-            generate_state(queue);
-            p = 0;
+        if(size == 0){
+            return;
         }
+
+        kernel generate_kernel(m_program, "generate");
+        generate_kernel.set_arg(0, m_state_buffer);
+        generate_kernel.set_arg(1, static_cast<const uint_>(m_state_index));
+        generate_kernel.set_arg(2, first.get_buffer());
+        generate_kernel.set_arg(3, static_cast<const ulong_>(first.get_index()));
+        generate_kernel.set_arg(4, static_cast<const ulong_>(size));
+
+        const size_t work_group_size = (std::min)(
+            size_t(256),
+            generate_kernel.get_work_group_info<size_t>(
+                queue.get_device(), CL_KERNEL_WORK_GROUP_SIZE
+            )
+        );
+        queue.enqueue_1d_range_kernel(
+            generate_kernel, 0, work_group_size, work_group_size
+        );
+
+        // the state is regenerated once the index reaches n, so the index
+        // stays in [1, n] after generating at least one value
+        m_state_index = (m_state_index + size - 1) % n + 1;
     }
 
     /// \internal_
@@ -171,15 +175,6 @@ public:
     }
 
 private:
-    /// \internal_
-    void generate_state(command_queue &queue)
-    {
-        kernel generate_state_kernel =
-            m_program.create_kernel("generate_state");
-        generate_state_kernel.set_arg(0, m_state_buffer);
-        queue.enqueue_task(generate_state_kernel);
-    }
-
     /// \internal_
     void load_program()
     {
@@ -218,22 +213,87 @@ private:
             "    generate_state(state);\n"
             "}\n"
 
-            "static uint random_number(__global uint *state, const uint p)\n"
+            // regenerates the state in local memory with all work-items of
+            // the work-group. the recurrence only depends on values from
+            // earlier phases: [0, n-m) reads old values, [n-m, 2(n-m)) reads
+            // the first phase and [2(n-m), n-1) the second one.
+            "static void generate_local_state(__local uint *state)\n"
+            "{\n"
+            "    const uint n = 624;\n"
+            "    const uint m = 397;\n"
+            "    const uint lid = get_local_id(0);\n"
+            "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+            "    if(get_local_size(0) < n - m){\n"
+            "        if(lid == 0){\n"
+            "            for(uint i = 0; i < (n - m); i++)\n"
+            "                state[i] = state[i+m] ^ twiddle(state[i], state[i+1]);\n"
+            "            for(uint i = n - m; i < (n - 1); i++)\n"
+            "                state[i] = state[i+m-n] ^ twiddle(state[i], state[i+1]);\n"
+            "            state[n-1] = state[m-1] ^ twiddle(state[n-1], state[0]);\n"
+            "        }\n"
+            "        barrier(CLK_LOCAL_MEM_FENCE);\n"
+            "        return;\n"
+            "    }\n"
+            "    for(uint begin = 0; begin < n - 1; begin += n - m){\n"
+            "        const uint i = begin + lid;\n"
+            "        const bool active = lid < (n - m) && i < n - 1;\n"
+            "        uint x = 0;\n"
+            "        if(active){\n"
+            "            x = state[i < n - m ? i + m : i + m - n] ^\n"
+            "                twiddle(state[i], state[i+1]);\n"
+            "        }\n"
+            "        barrier(CLK_LOCAL_MEM_FENCE);\n"
+            "        if(active){\n"
+            "            state[i] = x;\n"
+            "        }\n"
+            "        barrier(CLK_LOCAL_MEM_FENCE);\n"
+            "    }\n"
+            "    if(lid == 0){\n"
+            "        state[n-1] = state[m-1] ^ twiddle(state[n-1], state[0]);\n"
+            "    }\n"
+            "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+            "}\n"
+
+            "static uint temper(uint x)\n"
             "{\n"
-            "    uint x = state[p];\n"
             "    x ^= (x >> 11);\n"
             "    x ^= (x << 7) & 0x9D2C5680U;\n"
             "    x ^= (x << 15) & 0xEFC60000U;\n"
             "    return x ^ (x >> 18);\n"
             "}\n"
 
-            "__kernel void fill(__global uint *state,\n"
-            "                   const uint state_index,\n"
-            "                   __global uint *vector,\n"
-            "                   const uint offset)\n"
+            // run by a single work-group, writes count values starting
+            // at state index p and leaves the updated state in global memory
+            "__kernel void generate(__global uint *global_state,\n"
+            "                       uint p,\n"
+            "                       __global uint *output,\n"
+            "                       const ulong output_offset,\n"
+            "                       const ulong count)\n"
             "{\n"
-            "    const uint i = get_global_id(0);\n"
-            "    vector[offset+i] = random_number(state, state_index + i);\n"
+            "    const uint n = 624;\n"
+            "    const uint lid = get_local_id(0);\n"
+            "    const uint lsize = get_local_size(0);\n"
+            "    __local uint state[624];\n"
+            "    for(uint i = lid; i < n; i += lsize){\n"
+            "        state[i] = global_state[i];\n"
+            "    }\n"
+            "    ulong written = 0;\n"
+            "    while(written < count){\n"
+            "        while(p >= n){\n"
+            "            generate_local_state(state);\n"
+            "            p -= n;\n"
+            "        }\n"
+            "        const uint block = (uint) min((ulong)(n - p), count - written);\n"
+            "        for(uint i = lid; i < block; i += lsize){\n"
+            "            output[output_offset+written+i] = temper(state[p+i]);\n"
+            "        }\n"
+            "        p += block;\n"
+            "        written += block;\n"
+            "    }\n"
+            "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+            "    for(uint i = lid; i < n; i += lsize){\n"
+            "        global_state[i] = state[i];\n"
+            "    }\n"
             "}\n";
 
         m_program = cache->get_or_build(cache_key, std::string(), source, m_context);
@@ -18,6 +18,7 @@
 
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/function.hpp>
+#include <boost/compute/random/philox_engine.hpp>
 #include <boost/compute/types/fundamental.hpp>
 #include <boost/compute/type_traits/make_vector_type.hpp>
 
@@ -84,13 +85,39 @@ public:
                   Generator &generator,
                   command_queue &queue)
     {
-        typedef typename make_vector_type<RealType, 2>::type RealType2;
-
         size_t count = detail::iterator_range_size(first, last);
 
         vector<uint_> tmp(count, queue.get_context());
         generator.generate(tmp.begin(), tmp.end(), queue);
 
+        transform(
+            make_buffer_iterator<uint2_>(tmp.get_buffer(), 0),
+            make_buffer_iterator<uint2_>(tmp.get_buffer(), count / 2),
+            make_buffer_iterator<RealType2>(first.get_buffer(), 0),
+            box_muller(),
+            queue
+        );
+    }
+
+    /// Generates normally-distributed floating-point numbers with a
+    /// philox_engine. The transform is fused into the generating kernel and
+    /// both values of each Box-Muller transform are kept.
+    template<class OutputIterator, class T>
+    void generate(OutputIterator first,
+                  OutputIterator last,
+                  philox_engine<T> &generator,
+                  command_queue &queue)
+    {
+        generator.generate(first, last, box_muller(), queue);
+    }
+
+private:
+    typedef typename make_vector_type<RealType, 2>::type RealType2;
+
+    /// \internal_
+    /// Returns the Box-Muller transform of two uniform random numbers.
+    function<RealType2(uint2_)> box_muller() const
+    {
         BOOST_COMPUTE_FUNCTION(RealType2, box_muller, (const uint2_ x),
         {
             const RealType one = 1;
@@ -115,13 +142,7 @@ public:
         box_muller.define("RealType", type_name<RealType>());
         box_muller.define("RealType2", type_name<RealType2>());
 
-        transform(
-            make_buffer_iterator<uint2_>(tmp.get_buffer(), 0),
-            make_buffer_iterator<uint2_>(tmp.get_buffer(), count / 2),
-            make_buffer_iterator<RealType2>(first.get_buffer(), 0),
-            box_muller,
-            queue
-        );
+        return box_muller;
     }
 
 private:
@@ -0,0 +1,376 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_RANDOM_PHILOX_ENGINE_HPP
+#define BOOST_COMPUTE_RANDOM_PHILOX_ENGINE_HPP
+
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/function_types/parameter_types.hpp>
+#include <boost/function_types/result_type.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/mpl/front.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+
+#include <boost/compute/types.hpp>
+#include <boost/compute/function.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/iterator/discard_iterator.hpp>
+#include <boost/compute/type_traits/make_vector_type.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+#include <boost/compute/type_traits/vector_size.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// philox4x32-10 from "Parallel Random Numbers: As Easy as 1, 2, 3"
+// (Salmon et al.), maps a 128-bit counter and a 64-bit key to four values
+const char philox4x32_10_source[] =
+"uint4 philox4x32_10(uint4 counter, uint2 key)\n"
+"{\n"
+"    for(uint i = 0; i < 10; i++){\n"
+"        if(i > 0){\n"
+"            key.x += 0x9E3779B9;\n"
+"            key.y += 0xBB67AE85;\n"
+"        }\n"
+"        const uint hi0 = mul_hi((uint) 0xD2511F53, counter.x);\n"
+"        const uint lo0 = 0xD2511F53 * counter.x;\n"
+"        const uint hi1 = mul_hi((uint) 0xCD9E8D57, counter.z);\n"
+"        const uint lo1 = 0xCD9E8D57 * counter.z;\n"
+"        counter = (uint4)(hi1 ^ counter.y ^ key.x, lo1,\n"
+"                          hi0 ^ counter.w ^ key.y, lo0);\n"
+"    }\n"
+"    return counter;\n"
+"}\n";
+
+// number of random values (input lanes) a function takes per call and
+// number of results (output lanes) it returns. functions without a known
+// signature (e.g. lambda expressions) take and return one value.
+template<class Function, class OutputType>
+struct philox_function_lanes
+{
+    typedef OutputType result_type;
+
+    static const size_t input = 1;
+    static const size_t output = 1;
+};
+
+template<class Signature, class OutputType>
+struct philox_function_lanes<function<Signature>, OutputType>
+{
+    typedef typename boost::remove_cv<
+        typename boost::mpl::front<
+            typename boost::function_types::parameter_types<Signature>::type
+        >::type
+    >::type argument_type;
+    typedef typename
+        boost::function_types::result_type<Signature>::type result_type;
+
+    static const size_t input =
+        boost::is_same<argument_type, uint2_>::value ? 2 : 1;
+    static const size_t output =
+        vector_size<result_type>::value / vector_size<OutputType>::value;
+
+    // the function must return one or two whole output values
+    BOOST_STATIC_ASSERT(
+        vector_size<result_type>::value % vector_size<OutputType>::value == 0
+    );
+    BOOST_STATIC_ASSERT(output == 1 || output == 2);
+};
+
+// stores the values of one counter block. lanes is the list of the
+// scalar results, full blocks are written with a single vector store if
+// the output type allows it.
+template<class OutputIterator>
+inline void philox_store(meta_kernel &k,
+                         OutputIterator first,
+                         const std::vector<std::string> &lanes)
+{
+    typedef typename std::iterator_traits<OutputIterator>::value_type value_type;
+
+    const size_t n = lanes.size();
+    const bool vector_store =
+        (n == 2 || n == 4 || n == 8) &&
+        is_fundamental<value_type>::value &&
+        !is_vector_type<value_type>::value &&
+        !boost::is_same<value_type, bool>::value;
+
+    k << "if(index + " << uint_(n) << " <= count){\n";
+    if(vector_store){
+        k << "    vstore" << uint_(n) << "((" << type_name<value_type>() << uint_(n) << ")(";
+        for(size_t i = 0; i < n; i++){
+            k << (i ? ", " : "") << lanes[i];
+        }
+        k << "), 0, &" << first[k.expr<uint_>("index")] << ");\n";
+    }
+    else {
+        for(size_t i = 0; i < n; i++){
+            k << "    " << first[k.expr<uint_>("index + " + boost::lexical_cast<std::string>(i))] <<
+                " = " << lanes[i] << ";\n";
+        }
+    }
+    k << "}\n"
+      << "else {\n";
+    for(size_t i = 0; i < n; i++){
+        const std::string index = "index + " + boost::lexical_cast<std::string>(i);
+        k << "    if(" << index << " < count) " <<
+            first[k.expr<uint_>(index)] << " = " << lanes[i] << ";\n";
+    }
+    k << "}\n";
+}
+
+// enqueues the fill kernel. one work-item computes one counter block and
+// writes block_size values.
+inline void philox_enqueue(meta_kernel &k,
+                           size_t count_arg,
+                           size_t key_arg,
+                           size_t counter_arg,
+                           const size_t count,
+                           const size_t block_size,
+                           const ulong_ key,
+                           const ulong_ counter,
+                           command_queue &queue)
+{
+    ::boost::compute::kernel kernel = k.compile(queue.get_context());
+    k.set_index_arg(kernel, count_arg, count);
+    kernel.set_arg(key_arg, uint2_(static_cast<uint_>(key),
+                                   static_cast<uint_>(key >> 32)));
+    kernel.set_arg(counter_arg, counter);
+
+    queue.enqueue_1d_range_kernel(
+        kernel, 0, (count + block_size - 1) / block_size, 0
+    );
+}
+
+// emits the start of the fill kernel for count values, up to the random
+// block r. the count and the output index have the index type of k.
+inline void philox_kernel_begin(meta_kernel &k,
+                                size_t &count_arg,
+                                size_t &key_arg,
+                                size_t &counter_arg,
+                                const size_t count,
+                                const size_t block_size)
+{
+    k.set_index_type_for(count + block_size);
+    count_arg = k.add_index_arg("count");
+    key_arg = k.add_arg<const uint2_>("key");
+    counter_arg = k.add_arg<const ulong_>("counter");
+    k.add_function("philox4x32_10", philox4x32_10_source);
+
+    k <<
+        "const " << k.index_type() << " gid = get_global_id(0);\n" <<
+        "const " << k.index_type() << " index = gid * " << uint_(block_size) << ";\n" <<
+        "const ulong block = counter + gid;\n" <<
+        "const uint4 r = philox4x32_10(\n" <<
+        "    (uint4)((uint) block, (uint)(block >> 32), 0, 0), key\n" <<
+        ");\n";
+}
+
+} // end detail namespace
+
+/// \class philox_engine
+/// \brief Philox4x32-10 counter-based pseudorandom number generator.
+///
+/// Each work-item turns one counter into four random values, which are
+/// written with a single vector store. Since the values only depend on the
+/// key and the counter, any part of the sequence can be computed directly.
+///
+/// Distributions are fused into the generating kernel: generate() with a
+/// function applies it to the random values before they are stored, so
+/// no temporary range is needed. Functions taking a \c uint2_ receive two
+/// random values per call, functions returning a two-component vector of
+/// the output type store both components.
+///
+/// Each call to generate() starts at a new counter, so the values of one
+/// call do not depend on how earlier calls split their ranges into blocks.
+///
+/// \see threefry_engine
+template<class T = uint_>
+class philox_engine
+{
+public:
+    typedef T result_type;
+    static const ulong_ default_seed = 0UL;
+
+    /// Creates a new philox_engine and seeds it with \p value.
+    explicit philox_engine(command_queue &queue,
+                           ulong_ value = default_seed)
+        : m_key(value),
+          m_counter(0)
+    {
+        (void) queue;
+    }
+
+    /// Creates a new philox_engine object as a copy of \p other.
+    philox_engine(const philox_engine<T> &other)
+        : m_key(other.m_key),
+          m_counter(other.m_counter)
+    {
+    }
+
+    /// Copies \p other to \c *this.
+    philox_engine<T>& operator=(const philox_engine<T> &other)
+    {
+        if(this != &other){
+            m_key = other.m_key;
+            m_counter = other.m_counter;
+        }
+
+        return *this;
+    }
+
+    /// Destroys the philox_engine object.
+    ~philox_engine()
+    {
+    }
+
+    /// Seeds the random number generator with \p value.
+    ///
+    /// \param value seed value for the random-number generator
+    /// \param queue command queue to perform the operation
+    ///
+    /// If no seed value is provided, \c default_seed is used.
+    void seed(ulong_ value, command_queue &queue)
+    {
+        (void) queue;
+
+        m_key = value;
+        m_counter = 0;
+    }
+
+    /// \overload
+    void seed(command_queue &queue)
+    {
+        seed(default_seed, queue);
+    }
+
+    /// Generates random numbers and stores them to the range [\p first, \p last).
+    template<class OutputIterator>
+    void generate(OutputIterator first, OutputIterator last, command_queue &queue)
+    {
+        const size_t count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return;
+        }
+
+        detail::meta_kernel k("philox_fill");
+        size_t count_arg, key_arg, counter_arg;
+        detail::philox_kernel_begin(
+            k, count_arg, key_arg, counter_arg, count, 4
+        );
+
+        std::vector<std::string> lanes;
+        lanes.push_back("r.x");
+        lanes.push_back("r.y");
+        lanes.push_back("r.z");
+        lanes.push_back("r.w");
+        detail::philox_store(k, first, lanes);
+
+        detail::philox_enqueue(
+            k, count_arg, key_arg, counter_arg, count, 4, m_key, m_counter, queue
+        );
+        m_counter += (count + 3) / 4;
+    }
+
+    /// \internal_
+    void generate(discard_iterator first, discard_iterator last, command_queue &queue)
+    {
+        (void) queue;
+
+        m_counter += (std::distance(first, last) + 3) / 4;
+    }
+
+    /// Generates random numbers, transforms them with \p op, and then stores
+    /// them to the range [\p first, \p last). The random numbers are only
+    /// kept in registers.
+    template<class OutputIterator, class Function>
+    void generate(OutputIterator first, OutputIterator last, Function op, command_queue &queue)
+    {
+        typedef typename std::iterator_traits<OutputIterator>::value_type value_type;
+        typedef detail::philox_function_lanes<Function, value_type> lanes_type;
+
+        const size_t input_lanes = lanes_type::input;
+        const size_t output_lanes = lanes_type::output;
+        const size_t calls = 4 / input_lanes;
+        const size_t block_size = calls * output_lanes;
+
+        const size_t count = detail::iterator_range_size(first, last);
+        if(count == 0){
+            return;
+        }
+
+        detail::meta_kernel k("philox_fill_function");
+        size_t count_arg, key_arg, counter_arg;
+        detail::philox_kernel_begin(
+            k, count_arg, key_arg, counter_arg, count, block_size
+        );
+
+        const char *inputs[2][4] = {
+            { "r.x", "r.y", "r.z", "r.w" },
+            { "r.xy", "r.zw", 0, 0 }
+        };
+        const char *components[] = { ".x", ".y" };
+
+        std::vector<std::string> lanes;
+        for(size_t i = 0; i < calls; i++){
+            const std::string y = "y" + boost::lexical_cast<std::string>(i);
+            if(input_lanes == 2){
+                k << "const " << type_name<typename lanes_type::result_type>() << " " << y << " = " <<
+                    op(k.expr<uint2_>(inputs[1][i])) << ";\n";
+            }
+            else {
+                k << "const " << type_name<typename lanes_type::result_type>() << " " << y << " = " <<
+                    op(k.expr<uint_>(inputs[0][i])) << ";\n";
+            }
+
+            if(output_lanes == 1){
+                lanes.push_back(y);
+            }
+            else {
+                for(size_t j = 0; j < output_lanes; j++){
+                    lanes.push_back(y + components[j]);
+                }
+            }
+        }
+        detail::philox_store(k, first, lanes);
+
+        detail::philox_enqueue(
+            k, count_arg, key_arg, counter_arg, count, block_size,
+            m_key, m_counter, queue
+        );
+        m_counter += (count + block_size - 1) / block_size;
+    }
+
+    /// Generates \p z random numbers and discards them.
+    void discard(size_t z, command_queue &queue)
+    {
+        generate(discard_iterator(0), discard_iterator(z), queue);
+    }
+
+private:
+    ulong_ m_key; // 2 x 32bit
+    ulong_ m_counter; // in blocks of four values
+};
+
+/// The Philox4x32-10 engine.
+typedef philox_engine<uint_> philox4x32_10;
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_RANDOM_PHILOX_ENGINE_HPP
@@ -12,14 +12,18 @@
 #define BOOST_COMPUTE_RANDOM_UNIFORM_INT_DISTRIBUTION_HPP
 
 #include <limits>
+#include <string>
 
+#include <boost/lexical_cast.hpp>
 #include <boost/type_traits.hpp>
 #include <boost/static_assert.hpp>
 
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/function.hpp>
+#include <boost/compute/random/philox_engine.hpp>
 #include <boost/compute/types/fundamental.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
 #include <boost/compute/algorithm/copy_if.hpp>
 #include <boost/compute/algorithm/transform.hpp>
 
@@ -97,13 +101,62 @@ public:
             return LO + (x % (HI-LO+1));
         });
 
-        scale_random.define("LO", boost::lexical_cast<std::string>(m_a));
-        scale_random.define("HI", boost::lexical_cast<std::string>(m_b));
+        scale_random.define("LO", int_literal(m_a));
+        scale_random.define("HI", int_literal(m_b));
 
         transform(tmp2.begin(), tmp2.end(), first, scale_random, queue);
     }
 
+    /// Generates uniformily distributed integers with a philox_engine. The
+    /// scaling is fused into the generating kernel: two random numbers form
+    /// a 64-bit fraction which is multiplied by the size of the interval,
+    /// which makes the bias negligible without rejecting values. For the
+    /// full range of a 64-bit type the fraction is used as it is.
+    template<class OutputIterator, class T>
+    void generate(OutputIterator first,
+                  OutputIterator last,
+                  philox_engine<T> &generator,
+                  command_queue &queue)
+    {
+        // the offset from a and the size of the interval are computed in
+        // ulong, the size is 0 for the full range of a 64-bit type
+        BOOST_COMPUTE_FUNCTION(IntType, scale_random, (const uint2_ x),
+        {
+            const ulong fraction = upsample(x.y, x.x);
+            return (IntType)(LO + (RANGE == 0 ? fraction : mul_hi(fraction, RANGE)));
+        });
+
+        const ulong_ range =
+            static_cast<ulong_>(m_b) - static_cast<ulong_>(m_a) + 1;
+
+        scale_random.define(
+            "LO", boost::lexical_cast<std::string>(static_cast<ulong_>(m_a)) + "UL"
+        );
+        scale_random.define(
+            "RANGE", boost::lexical_cast<std::string>(range) + "UL"
+        );
+        scale_random.define("IntType", type_name<IntType>());
+
+        generator.generate(first, last, scale_random, queue);
+    }
+
 private:
+    // returns value as an OpenCL literal. 64-bit values get a UL suffix,
+    // signed ones are cast back so the most negative value stays valid.
+    static std::string int_literal(IntType value)
+    {
+        if(sizeof(IntType) < 8){
+            return boost::lexical_cast<std::string>(value);
+        }
+
+        const std::string literal =
+            boost::lexical_cast<std::string>(static_cast<ulong_>(value)) + "UL";
+        if(boost::is_signed<IntType>::value){
+            return "((" + type_name<IntType>() + ")" + literal + ")";
+        }
+        return literal;
+    }
+
     IntType m_a;
     IntType m_b;
 
@@ -14,6 +14,8 @@
 #include <boost/compute/utility/dim.hpp>
 #include <boost/compute/utility/extents.hpp>
 #include <boost/compute/utility/invoke.hpp>
+#include <boost/compute/utility/pipeline.hpp>
+#include <boost/compute/utility/prewarm.hpp>
 #include <boost/compute/utility/program_cache.hpp>
 #include <boost/compute/utility/source.hpp>
 #include <boost/compute/utility/wait_list.hpp>
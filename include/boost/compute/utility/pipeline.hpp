@@ -0,0 +1,586 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_UTILITY_PIPELINE_HPP
+#define BOOST_COMPUTE_UTILITY_PIPELINE_HPP
+
+#include <string>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/assert.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/compute/device.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/inclusive_scan.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/iterator_range_size.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/memory/local_buffer.hpp>
+#include <boost/compute/type_traits/is_device_iterator.hpp>
+#include <boost/compute/type_traits/result_of.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+namespace boost {
+namespace compute {
+namespace detail {
+
+// the stages of a pipeline form a chain ending in the stage which produces
+// the pipeline's values. each stage provides:
+//   - value_type: the type of the values it produces
+//   - filters: true if the stage (or one before it) can drop values
+//   - prepare(queue): runs the work needed before the chain can be
+//     evaluated (only the scan stage has any) and returns the number of
+//     elements entering the chain
+//   - emit(kernel, n): writes the code computing the value for the element
+//     at index 'i' and returns the name of the variable holding it. stages
+//     which drop the element set the 'keep' variable to false, n counts the
+//     variables declared so far.
+
+inline std::string pipeline_variable(size_t &n)
+{
+    return "_v" + boost::lexical_cast<std::string>(n++);
+}
+
+// reads the elements of an input range
+template<class InputIterator>
+class pipeline_source
+{
+public:
+    typedef typename std::iterator_traits<InputIterator>::value_type value_type;
+
+    static const bool filters = false;
+
+    pipeline_source(InputIterator first, InputIterator last)
+        : m_first(first),
+          m_count(iterator_range_size(first, last))
+    {
+    }
+
+    size_t prepare(command_queue &) const
+    {
+        return m_count;
+    }
+
+    std::string emit(meta_kernel &k, size_t &n) const
+    {
+        const std::string name = pipeline_variable(n);
+        k << k.decl<const value_type>(name) << " = " <<
+            m_first[k.var<const uint_>("i")] << ";\n";
+
+        return name;
+    }
+
+private:
+    InputIterator m_first;
+    size_t m_count;
+};
+
+// applies a function to each value
+template<class Previous, class Function>
+class pipeline_transform
+{
+public:
+    typedef typename Previous::value_type input_type;
+    typedef typename
+        ::boost::compute::result_of<Function(input_type)>::type value_type;
+
+    static const bool filters = Previous::filters;
+
+    pipeline_transform(const Previous &previous, Function function)
+        : m_previous(previous),
+          m_function(function)
+    {
+    }
+
+    size_t prepare(command_queue &queue) const
+    {
+        return m_previous.prepare(queue);
+    }
+
+    std::string emit(meta_kernel &k, size_t &n) const
+    {
+        const std::string input = m_previous.emit(k, n);
+        const std::string name = pipeline_variable(n);
+        k << k.decl<const value_type>(name) << " = " <<
+            m_function(k.var<const input_type>(input)) << ";\n";
+
+        return name;
+    }
+
+private:
+    Previous m_previous;
+    Function m_function;
+};
+
+// drops the values for which the predicate returns false
+template<class Previous, class Predicate>
+class pipeline_filter
+{
+public:
+    typedef typename Previous::value_type value_type;
+
+    static const bool filters = true;
+
+    pipeline_filter(const Previous &previous, Predicate predicate)
+        : m_previous(previous),
+          m_predicate(predicate)
+    {
+    }
+
+    size_t prepare(command_queue &queue) const
+    {
+        return m_previous.prepare(queue);
+    }
+
+    std::string emit(meta_kernel &k, size_t &n) const
+    {
+        const std::string name = m_previous.emit(k, n);
+        k << "keep = keep && " <<
+            m_predicate(k.var<const value_type>(name)) << ";\n";
+
+        return name;
+    }
+
+private:
+    Previous m_previous;
+    Predicate m_predicate;
+};
+
+// writes the values kept by the prepared stages for count elements to
+// result in order and returns their number. one kernel writes the keep
+// flags, they are scanned to get the output positions and a second kernel
+// evaluates the stages again and scatters the kept values. the positions are
+// of type PositionType, which must hold count.
+template<class PositionType, class Stage, class OutputIterator>
+inline size_t pipeline_compact(const Stage &stage,
+                               size_t count,
+                               OutputIterator result,
+                               command_queue &queue)
+{
+    typedef typename Stage::value_type value_type;
+
+    scratch_vector<PositionType> positions(count, queue);
+    const std::string position_type = type_name<PositionType>();
+
+    meta_kernel flags_kernel("pipeline_filter");
+    flags_kernel.set_index_type_for(count);
+    size_t n = 0;
+    flags_kernel <<
+        "const " << flags_kernel.index_type() << " i = get_global_id(0);\n" <<
+        "bool keep = true;\n";
+    stage.emit(flags_kernel, n);
+    flags_kernel <<
+        positions.begin()[flags_kernel.var<const uint_>("i")] <<
+        " = keep ? 1 : 0;\n";
+    flags_kernel.exec_1d(queue, 0, count);
+
+    ::boost::compute::inclusive_scan(
+        positions.begin(), positions.end(), positions.begin(), queue
+    );
+
+    meta_kernel compact_kernel("pipeline_compact");
+    compact_kernel.set_index_type_for(count);
+    n = 0;
+    compact_kernel <<
+        "const " << compact_kernel.index_type() << " i = get_global_id(0);\n" <<
+        "bool keep = true;\n";
+    const std::string value = stage.emit(compact_kernel, n);
+    compact_kernel <<
+        "if(keep){\n" <<
+        "    const " << position_type << " position = " <<
+            positions.begin()[compact_kernel.var<const uint_>("i")] << " - 1;\n" <<
+        "    " << result[compact_kernel.var<const uint_>("position")] << " = " <<
+            compact_kernel.var<const value_type>(value) << ";\n" <<
+        "}\n";
+    compact_kernel.exec_1d(queue, 0, count);
+
+    return static_cast<size_t>(
+        read_single_value<PositionType>(positions.get_buffer(), count - 1, queue)
+    );
+}
+
+// evaluates the prepared stages for count elements into result and returns
+// the number of values written. without filters this is a single kernel,
+// otherwise the kept values are compacted by pipeline_compact()
+template<class Stage, class OutputIterator>
+inline size_t pipeline_evaluate(const Stage &stage,
+                                size_t count,
+                                OutputIterator result,
+                                command_queue &queue)
+{
+    typedef typename Stage::value_type value_type;
+
+    if(count == 0){
+        return 0;
+    }
+
+    if(!Stage::filters){
+        meta_kernel k("pipeline_transform");
+        k.set_index_type_for(count);
+
+        size_t n = 0;
+        k << "const " << k.index_type() << " i = get_global_id(0);\n" <<
+             "bool keep = true;\n";
+        const std::string value = stage.emit(k, n);
+        k << result[k.var<const uint_>("i")] << " = " <<
+            k.var<const value_type>(value) << ";\n";
+
+        k.exec_1d(queue, 0, count);
+        return count;
+    }
+
+    if(requires_64bit_indices(count)){
+        return pipeline_compact<ulong_>(stage, count, result, queue);
+    }
+    else {
+        return pipeline_compact<uint_>(stage, count, result, queue);
+    }
+}
+
+template<class Stage, class OutputIterator>
+inline size_t pipeline_copy(const Stage &stage,
+                            OutputIterator result,
+                            command_queue &queue)
+{
+    return pipeline_evaluate(stage, stage.prepare(queue), result, queue);
+}
+
+// reduces the values produced by the stages. each work-item folds its
+// values in registers, the work-items of a group combine their results in
+// local memory and a single work-item folds the results of the groups into
+// init. on gpus the work-items read the input with a stride of the global
+// size so that neighbouring work-items read neighbouring values, on cpus
+// each work-item folds a contiguous block. in both cases the values are not
+// folded in input order, so the function must be commutative.
+template<class Stage, class BinaryFunction>
+inline typename Stage::value_type
+pipeline_reduce(const Stage &stage,
+                const typename Stage::value_type &init,
+                BinaryFunction function,
+                command_queue &queue)
+{
+    typedef typename Stage::value_type T;
+
+    const size_t count = stage.prepare(queue);
+    if(count == 0){
+        return init;
+    }
+
+    const device &device = queue.get_device();
+    const bool is_gpu = (device.type() & device::gpu) != 0;
+    const size_t max_groups =
+        size_t(device.compute_units()) * (is_gpu ? 4 : 1);
+
+    scratch_vector<T> partials(max_groups, queue);
+    scratch_vector<uchar_> have(max_groups, queue);
+
+    meta_kernel k("pipeline_reduce");
+    k.set_index_type_for(count);
+    const std::string index_type = k.index_type();
+    size_t count_arg = k.add_index_arg("count");
+    size_t group_acc_arg =
+        k.add_arg<T *>(memory_object::local_memory, "group_acc");
+    size_t group_have_arg =
+        k.add_arg<uchar_ *>(memory_object::local_memory, "group_have");
+
+    size_t n = 0;
+    if(is_gpu){
+        k <<
+            "const " << index_type << " start = get_global_id(0);\n" <<
+            "const " << index_type << " end = count;\n" <<
+            "const " << index_type << " step = get_global_size(0);\n";
+    }
+    else {
+        k <<
+            "const " << index_type << " block = " <<
+                "(count + get_global_size(0) - 1) / get_global_size(0);\n" <<
+            "const " << index_type << " start = get_global_id(0) * block;\n" <<
+            "const " << index_type << " end = min(count, start + block);\n" <<
+            "const " << index_type << " step = 1;\n";
+    }
+    k <<
+        k.decl<T>("acc") << ";\n" <<
+        "bool have = false;\n" <<
+        "for(" << index_type << " i = start; i < end; i += step){\n" <<
+        "bool keep = true;\n";
+    const std::string value = stage.emit(k, n);
+    k <<
+        "if(keep){\n" <<
+        "    acc = have ? " <<
+            function(k.var<T>("acc"), k.var<const T>(value)) << " : " <<
+            value << ";\n" <<
+        "    have = true;\n" <<
+        "}\n" <<
+        "}\n" <<
+
+        // combine the results of the group
+        "const uint lid = get_local_id(0);\n" <<
+        "const uint tpb = get_local_size(0);\n" <<
+        "group_acc[lid] = acc;\n" <<
+        "group_have[lid] = have;\n" <<
+        "barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+        "for(uint s = 1; s < tpb; s <<= 1){\n" <<
+        "    if((lid & (2 * s - 1)) == 0 && lid + s < tpb && group_have[lid + s]){\n" <<
+        "        group_acc[lid] = group_have[lid] ? " <<
+                    function(k.expr<T>("group_acc[lid]"),
+                             k.expr<T>("group_acc[lid + s]")) <<
+                    " : group_acc[lid + s];\n" <<
+        "        group_have[lid] = 1;\n" <<
+        "    }\n" <<
+        "    barrier(CLK_LOCAL_MEM_FENCE);\n" <<
+        "}\n" <<
+        "if(lid == 0){\n" <<
+        "    " << partials.begin()[k.expr<const uint_>("get_group_id(0)")] <<
+            " = group_acc[0];\n" <<
+        "    " << have.begin()[k.expr<const uint_>("get_group_id(0)")] <<
+            " = group_have[0];\n" <<
+        "}\n";
+
+    // the work-group size is limited by the registers and local memory the
+    // fused stages need, so it is clamped to what the kernel supports
+    kernel reduce_kernel = k.compile(queue.get_context());
+    const size_t work_group_size = is_gpu ?
+        (std::min)(
+            size_t(256),
+            reduce_kernel.get_work_group_info<size_t>(
+                device, CL_KERNEL_WORK_GROUP_SIZE
+            )
+        ) : 1;
+    const size_t group_count =
+        (std::max)(size_t(1), (std::min)(max_groups, count / work_group_size));
+
+    k.set_index_arg(reduce_kernel, count_arg, count);
+    reduce_kernel.set_arg(group_acc_arg, local_buffer<T>(work_group_size));
+    reduce_kernel.set_arg(group_have_arg, local_buffer<uchar_>(work_group_size));
+    queue.enqueue_1d_range_kernel(
+        reduce_kernel, 0, group_count * work_group_size, work_group_size
+    );
+
+    // fold the results of the groups into init
+    scratch_vector<T> result(1, queue);
+
+    meta_kernel final_kernel("pipeline_reduce_final");
+    final_kernel.add_set_arg<const T>("init", init);
+    final_kernel.add_set_arg<const uint_>("group_count", uint_(group_count));
+    final_kernel <<
+        final_kernel.decl<T>("acc") << " = init;\n" <<
+        "for(uint i = 0; i < group_count; i++){\n" <<
+        "    if(" << have.begin()[final_kernel.var<const uint_>("i")] << "){\n" <<
+        "        acc = " <<
+                    function(final_kernel.var<T>("acc"),
+                             partials.begin()[final_kernel.var<const uint_>("i")]) <<
+                    ";\n" <<
+        "    }\n" <<
+        "}\n" <<
+        result.begin()[final_kernel.expr<const uint_>("0")] << " = acc;\n";
+    final_kernel.exec(queue);
+
+    return read_single_value<T>(result.get_buffer(), queue);
+}
+
+// computes the inclusive scan of the values. a scan cannot be fused with
+// the stages before it, so they are evaluated into a temporary vector
+// (without the dropped values) which is scanned and read by the next
+// stages
+template<class Previous, class BinaryFunction>
+class pipeline_inclusive_scan
+{
+public:
+    typedef typename Previous::value_type value_type;
+
+    static const bool filters = false;
+
+    pipeline_inclusive_scan(const Previous &previous, BinaryFunction function)
+        : m_previous(previous),
+          m_function(function)
+    {
+    }
+
+    size_t prepare(command_queue &queue) const
+    {
+        const size_t count = m_previous.prepare(queue);
+
+        m_values.reset(
+            new ::boost::compute::vector<value_type>(count, queue.get_context())
+        );
+        if(count == 0){
+            return 0;
+        }
+
+        const size_t size =
+            pipeline_evaluate(m_previous, count, m_values->begin(), queue);
+        ::boost::compute::inclusive_scan(
+            m_values->begin(),
+            m_values->begin() + size,
+            m_values->begin(),
+            m_function,
+            queue
+        );
+
+        return size;
+    }
+
+    std::string emit(meta_kernel &k, size_t &n) const
+    {
+        BOOST_ASSERT(m_values);
+
+        const std::string name = pipeline_variable(n);
+        k << k.decl<const value_type>(name) << " = " <<
+            m_values->begin()[k.var<const uint_>("i")] << ";\n";
+
+        return name;
+    }
+
+private:
+    Previous m_previous;
+    BinaryFunction m_function;
+    mutable boost::shared_ptr< ::boost::compute::vector<value_type> > m_values;
+};
+
+} // end detail namespace
+
+/// \class pipeline
+/// \brief A chain of data-parallel operations which is evaluated lazily.
+///
+/// A pipeline records transform, filter and scan stages over an input range
+/// without running them. When it is evaluated with copy() or reduce() the
+/// stages are lowered to as few kernels as possible:
+///
+/// \li consecutive transform and filter stages are fused into one kernel in
+///     which the intermediate values stay in registers,
+/// \li filtered results are compacted in order by two passes over the fused
+///     stages with a scan of the keep flags in between (no intermediate
+///     values are stored),
+/// \li a reduction is fused into the kernel evaluating the stages and
+///     combines the results of each work-group in local memory,
+/// \li an inclusive scan is the only stage which needs its input to be
+///     stored, it ends the fused kernel before it.
+///
+/// For example, the following runs a single kernel (plus a tiny one for
+/// the final combine) instead of four algorithms with three temporaries:
+/// \code
+/// using boost::compute::lambda::_1;
+///
+/// float sum = boost::compute::make_pipeline(input.begin(), input.end())
+///                 .transform(_1 * scale)
+///                 .filter(_1 > threshold)
+///                 .transform(_1 - threshold)
+///                 .reduce(0.f, boost::compute::plus<float>(), queue);
+/// \endcode
+///
+/// The function objects are the same as for the corresponding algorithms.
+/// Scan functions must be associative, reduction functions must also be
+/// commutative as the values are not folded in input order.
+///
+/// \see make_pipeline()
+template<class Stage>
+class pipeline
+{
+public:
+    typedef Stage stage_type;
+    typedef typename Stage::value_type value_type;
+
+    /// Creates a pipeline ending with \p stage.
+    explicit pipeline(const Stage &stage)
+        : m_stage(stage)
+    {
+    }
+
+    /// Returns a pipeline which applies \p function to each value.
+    template<class UnaryFunction>
+    pipeline<detail::pipeline_transform<Stage, UnaryFunction> >
+    transform(UnaryFunction function) const
+    {
+        typedef detail::pipeline_transform<Stage, UnaryFunction> next_stage;
+
+        return pipeline<next_stage>(next_stage(m_stage, function));
+    }
+
+    /// Returns a pipeline which only keeps the values for which
+    /// \p predicate returns \c true.
+    template<class Predicate>
+    pipeline<detail::pipeline_filter<Stage, Predicate> >
+    filter(Predicate predicate) const
+    {
+        typedef detail::pipeline_filter<Stage, Predicate> next_stage;
+
+        return pipeline<next_stage>(next_stage(m_stage, predicate));
+    }
+
+    /// Returns a pipeline which computes the inclusive scan of the values
+    /// with \p function.
+    template<class BinaryFunction>
+    pipeline<detail::pipeline_inclusive_scan<Stage, BinaryFunction> >
+    inclusive_scan(BinaryFunction function) const
+    {
+        typedef detail::pipeline_inclusive_scan<Stage, BinaryFunction> next_stage;
+
+        return pipeline<next_stage>(next_stage(m_stage, function));
+    }
+
+    /// Evaluates the pipeline, writes the values to the range beginning at
+    /// \p result and returns an iterator to the end of the written values.
+    template<class OutputIterator>
+    OutputIterator copy(OutputIterator result,
+                        command_queue &queue = system::default_queue()) const
+    {
+        BOOST_STATIC_ASSERT(is_device_iterator<OutputIterator>::value);
+
+        return result + detail::pipeline_copy(m_stage, result, queue);
+    }
+
+    /// Evaluates the pipeline and returns the values folded into \p init
+    /// with \p function.
+    ///
+    /// \p function must be associative and commutative.
+    template<class BinaryFunction>
+    value_type reduce(const value_type &init,
+                      BinaryFunction function,
+                      command_queue &queue = system::default_queue()) const
+    {
+        return detail::pipeline_reduce(m_stage, init, function, queue);
+    }
+
+    /// Returns the last stage of the pipeline.
+    const Stage& stage() const
+    {
+        return m_stage;
+    }
+
+private:
+    Stage m_stage;
+};
+
+/// Returns a pipeline which reads the values in the range
+/// [\p first, \p last).
+///
+/// \see pipeline
+template<class InputIterator>
+inline pipeline<detail::pipeline_source<InputIterator> >
+make_pipeline(InputIterator first, InputIterator last)
+{
+    BOOST_STATIC_ASSERT(is_device_iterator<InputIterator>::value);
+
+    return pipeline<detail::pipeline_source<InputIterator> >(
+        detail::pipeline_source<InputIterator>(first, last)
+    );
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_UTILITY_PIPELINE_HPP
@@ -0,0 +1,478 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#ifndef BOOST_COMPUTE_UTILITY_PREWARM_HPP
+#define BOOST_COMPUTE_UTILITY_PREWARM_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/function.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include <boost/compute/config.hpp>
+#include <boost/compute/context.hpp>
+#include <boost/compute/device.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional/operator.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/sort_by_key.hpp>
+#include <boost/compute/algorithm/inclusive_scan.hpp>
+#include <boost/compute/algorithm/exclusive_scan.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+#include <boost/compute/detail/mutex.hpp>
+
+#ifdef BOOST_COMPUTE_THREAD_SAFE
+#  ifdef BOOST_COMPUTE_HAVE_THREAD_LOCAL
+#    include <thread>
+#  else
+#    include <boost/thread/thread.hpp>
+#  endif
+#endif
+
+namespace boost {
+namespace compute {
+
+/// \class prewarm_task
+/// \brief A unit of work executed by prewarm().
+///
+/// A prewarm task runs an algorithm on a small temporary input so that all
+/// of the programs it uses are compiled and stored in the global
+/// \ref program_cache (and in the offline cache when
+/// \c BOOST_COMPUTE_USE_OFFLINE_CACHE is defined).
+///
+/// Tasks for the common algorithms are created with the \c prewarm_*()
+/// functions (e.g. prewarm_sort()). Custom tasks can be created from any
+/// function object with the signature \c void(command_queue&, size_t) where
+/// the second argument is the number of elements to run the algorithm on.
+///
+/// \see prewarm()
+class prewarm_task
+{
+public:
+    typedef boost::function<void(command_queue &, size_t)> function_type;
+
+    /// Creates a new prewarm task named \p name which runs \p function.
+    prewarm_task(const std::string &name, const function_type &function)
+        : m_name(name),
+          m_function(function)
+    {
+    }
+
+    /// Returns the name of the task.
+    const std::string& name() const
+    {
+        return m_name;
+    }
+
+    /// Runs the task on \p queue with an input of \p size elements.
+    void operator()(command_queue &queue, size_t size) const
+    {
+        m_function(queue, size);
+    }
+
+private:
+    std::string m_name;
+    function_type m_function;
+};
+
+namespace detail {
+
+template<class T, class Compare>
+struct prewarm_sort_function
+{
+    prewarm_sort_function(Compare compare)
+        : m_compare(compare)
+    {
+    }
+
+    void operator()(command_queue &queue, size_t size) const
+    {
+        ::boost::compute::vector<T> vector(size, T(), queue);
+        ::boost::compute::sort(vector.begin(), vector.end(), m_compare, queue);
+    }
+
+    Compare m_compare;
+};
+
+template<class Key, class Value, class Compare>
+struct prewarm_sort_by_key_function
+{
+    prewarm_sort_by_key_function(Compare compare)
+        : m_compare(compare)
+    {
+    }
+
+    void operator()(command_queue &queue, size_t size) const
+    {
+        ::boost::compute::vector<Key> keys(size, Key(), queue);
+        ::boost::compute::vector<Value> values(size, Value(), queue);
+        ::boost::compute::sort_by_key(
+            keys.begin(), keys.end(), values.begin(), m_compare, queue
+        );
+    }
+
+    Compare m_compare;
+};
+
+template<class T, class BinaryOperator>
+struct prewarm_scan_function
+{
+    prewarm_scan_function(bool exclusive, BinaryOperator op)
+        : m_exclusive(exclusive),
+          m_op(op)
+    {
+    }
+
+    void operator()(command_queue &queue, size_t size) const
+    {
+        ::boost::compute::vector<T> input(size, T(), queue);
+        ::boost::compute::vector<T> output(size, queue.get_context());
+        if(m_exclusive){
+            ::boost::compute::exclusive_scan(
+                input.begin(), input.end(), output.begin(), T(), m_op, queue
+            );
+        }
+        else {
+            ::boost::compute::inclusive_scan(
+                input.begin(), input.end(), output.begin(), m_op, queue
+            );
+        }
+    }
+
+    bool m_exclusive;
+    BinaryOperator m_op;
+};
+
+template<class T, class BinaryFunction>
+struct prewarm_reduce_function
+{
+    prewarm_reduce_function(BinaryFunction function)
+        : m_function(function)
+    {
+    }
+
+    void operator()(command_queue &queue, size_t size) const
+    {
+        ::boost::compute::vector<T> input(size, T(), queue);
+        T result;
+        ::boost::compute::reduce(
+            input.begin(), input.end(), &result, m_function, queue
+        );
+    }
+
+    BinaryFunction m_function;
+};
+
+template<class T>
+struct prewarm_copy_function
+{
+    void operator()(command_queue &queue, size_t size) const
+    {
+        std::vector<T> host(size, T());
+        ::boost::compute::vector<T> input(size, queue.get_context());
+        ::boost::compute::vector<T> output(size, queue.get_context());
+
+        // host -> device, device -> device and device -> host
+        ::boost::compute::copy(host.begin(), host.end(), input.begin(), queue);
+        ::boost::compute::copy(input.begin(), input.end(), output.begin(), queue);
+        ::boost::compute::copy(output.begin(), output.end(), host.begin(), queue);
+    }
+};
+
+// runs the (device, task, size) jobs of a prewarm() call. jobs are handed
+// out to the worker threads one at a time
+class prewarm_runner
+{
+public:
+    prewarm_runner(const context &context,
+                   const std::vector<prewarm_task> &tasks,
+                   const std::vector<size_t> &sizes)
+        : m_context(context),
+          m_devices(context.get_devices()),
+          m_tasks(tasks),
+          m_sizes(sizes),
+          m_next(0)
+    {
+    }
+
+    size_t job_count() const
+    {
+        return m_devices.size() * m_tasks.size();
+    }
+
+    void operator()()
+    {
+        // the queues are created in the worker thread so errors creating
+        // them must be captured as well, an exception escaping the thread
+        // would terminate the program
+        try {
+            run();
+        }
+        catch(...){
+            detail::unique_lock lock(m_mutex);
+            if(!m_error){
+                m_error = boost::current_exception();
+            }
+        }
+    }
+
+    void rethrow_error() const
+    {
+        if(m_error){
+            boost::rethrow_exception(m_error);
+        }
+    }
+
+private:
+    void run()
+    {
+        std::vector<command_queue> queues;
+        for(size_t i = 0; i < m_devices.size(); i++){
+            queues.push_back(command_queue(m_context, m_devices[i]));
+        }
+
+        for(;;){
+            size_t job = 0;
+            {
+                detail::unique_lock lock(m_mutex);
+                if(m_next == job_count() || m_error){
+                    return;
+                }
+                job = m_next++;
+            }
+
+            command_queue &queue = queues[job % m_devices.size()];
+            const prewarm_task &task = m_tasks[job / m_devices.size()];
+
+            for(size_t i = 0; i < m_sizes.size(); i++){
+                task(queue, m_sizes[i]);
+            }
+            queue.finish();
+        }
+    }
+
+    context m_context;
+    std::vector<device> m_devices;
+    const std::vector<prewarm_task> &m_tasks;
+    const std::vector<size_t> &m_sizes;
+    size_t m_next;
+    boost::exception_ptr m_error;
+    detail::mutex m_mutex;
+};
+
+// ref-wrapper so that the runner can be passed to a thread by value
+struct prewarm_runner_ref
+{
+    prewarm_runner_ref(prewarm_runner &runner)
+        : m_runner(&runner)
+    {
+    }
+
+    void operator()() const
+    {
+        (*m_runner)();
+    }
+
+    prewarm_runner *m_runner;
+};
+
+} // end detail namespace
+
+/// Returns a task which prewarms sort() for values of type \c T with
+/// \p compare.
+template<class T, class Compare>
+inline prewarm_task prewarm_sort(Compare compare)
+{
+    return prewarm_task(
+        std::string("sort<") + type_name<T>() + ">",
+        detail::prewarm_sort_function<T, Compare>(compare)
+    );
+}
+
+/// \overload
+template<class T>
+inline prewarm_task prewarm_sort()
+{
+    return prewarm_sort<T>(less<T>());
+}
+
+/// Returns a task which prewarms sort_by_key() for keys of type \c Key and
+/// values of type \c Value with \p compare.
+template<class Key, class Value, class Compare>
+inline prewarm_task prewarm_sort_by_key(Compare compare)
+{
+    return prewarm_task(
+        std::string("sort_by_key<") + type_name<Key>() + "," + type_name<Value>() + ">",
+        detail::prewarm_sort_by_key_function<Key, Value, Compare>(compare)
+    );
+}
+
+/// \overload
+template<class Key, class Value>
+inline prewarm_task prewarm_sort_by_key()
+{
+    return prewarm_sort_by_key<Key, Value>(less<Key>());
+}
+
+/// Returns a task which prewarms inclusive_scan() for values of type \c T
+/// with \p op.
+template<class T, class BinaryOperator>
+inline prewarm_task prewarm_inclusive_scan(BinaryOperator op)
+{
+    return prewarm_task(
+        std::string("inclusive_scan<") + type_name<T>() + ">",
+        detail::prewarm_scan_function<T, BinaryOperator>(false, op)
+    );
+}
+
+/// \overload
+template<class T>
+inline prewarm_task prewarm_inclusive_scan()
+{
+    return prewarm_inclusive_scan<T>(plus<T>());
+}
+
+/// Returns a task which prewarms exclusive_scan() for values of type \c T
+/// with \p op.
+template<class T, class BinaryOperator>
+inline prewarm_task prewarm_exclusive_scan(BinaryOperator op)
+{
+    return prewarm_task(
+        std::string("exclusive_scan<") + type_name<T>() + ">",
+        detail::prewarm_scan_function<T, BinaryOperator>(true, op)
+    );
+}
+
+/// \overload
+template<class T>
+inline prewarm_task prewarm_exclusive_scan()
+{
+    return prewarm_exclusive_scan<T>(plus<T>());
+}
+
+/// Returns a task which prewarms reduce() for values of type \c T with
+/// \p function.
+template<class T, class BinaryFunction>
+inline prewarm_task prewarm_reduce(BinaryFunction function)
+{
+    return prewarm_task(
+        std::string("reduce<") + type_name<T>() + ">",
+        detail::prewarm_reduce_function<T, BinaryFunction>(function)
+    );
+}
+
+/// \overload
+template<class T>
+inline prewarm_task prewarm_reduce()
+{
+    return prewarm_reduce<T>(plus<T>());
+}
+
+/// Returns a task which prewarms copy() between host and device memory and
+/// between device buffers for values of type \c T.
+template<class T>
+inline prewarm_task prewarm_copy()
+{
+    return prewarm_task(
+        std::string("copy<") + type_name<T>() + ">",
+        detail::prewarm_copy_function<T>()
+    );
+}
+
+/// Returns the default input sizes used by prewarm().
+///
+/// Algorithms select different kernels for small and large inputs so each
+/// task is run once per size in order to compile all of them.
+inline std::vector<size_t> prewarm_default_sizes()
+{
+    std::vector<size_t> sizes;
+    sizes.push_back(32);
+    sizes.push_back(4096);
+    sizes.push_back(size_t(1) << 18);
+    return sizes;
+}
+
+/// Compiles the programs used by \p tasks for every device in \p context
+/// ahead of time.
+///
+/// Each task is run on a temporary input of each size in \p sizes. All of
+/// the compiled programs are stored in the global \ref program_cache for
+/// \p context (and in the offline cache when
+/// \c BOOST_COMPUTE_USE_OFFLINE_CACHE is defined) so that the first real
+/// call of the algorithm does not need to wait for the OpenCL compiler.
+///
+/// When \c BOOST_COMPUTE_THREAD_SAFE is defined, the tasks are distributed
+/// over \p thread_count host threads (by default one per hardware thread)
+/// and the programs are compiled concurrently. Otherwise they are run
+/// serially on the calling thread.
+///
+/// If any task throws, the remaining tasks are skipped and the first
+/// exception is rethrown after all threads have finished.
+///
+/// For example:
+/// \code
+/// std::vector<boost::compute::prewarm_task> tasks;
+/// tasks.push_back(boost::compute::prewarm_sort<float>());
+/// tasks.push_back(boost::compute::prewarm_exclusive_scan<int>());
+/// tasks.push_back(boost::compute::prewarm_reduce<double>(boost::compute::plus<double>()));
+///
+/// boost::compute::prewarm(context, tasks);
+/// \endcode
+///
+/// \see program_cache
+inline void prewarm(const context &context,
+                    const std::vector<prewarm_task> &tasks,
+                    const std::vector<size_t> &sizes = prewarm_default_sizes(),
+                    size_t thread_count = 0)
+{
+    detail::prewarm_runner runner(context, tasks, sizes);
+
+#ifdef BOOST_COMPUTE_THREAD_SAFE
+#  ifdef BOOST_COMPUTE_HAVE_THREAD_LOCAL
+    typedef std::thread thread_type;
+#  else
+    typedef ::boost::thread thread_type;
+#  endif
+    if(thread_count == 0){
+        thread_count = (std::max)(size_t(thread_type::hardware_concurrency()), size_t(1));
+    }
+    thread_count = (std::min)(thread_count, runner.job_count());
+
+    std::vector<thread_type *> threads;
+    for(size_t i = 1; i < thread_count; i++){
+        threads.push_back(new thread_type(detail::prewarm_runner_ref(runner)));
+    }
+
+    // the calling thread works too
+    runner();
+
+    for(size_t i = 0; i < threads.size(); i++){
+        threads[i]->join();
+        delete threads[i];
+    }
+#else
+    (void) thread_count;
+
+    runner();
+#endif
+
+    runner.rethrow_error();
+}
+
+} // end compute namespace
+} // end boost namespace
+
+#endif // BOOST_COMPUTE_UTILITY_PREWARM_HPP
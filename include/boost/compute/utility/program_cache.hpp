@@ -11,6 +11,7 @@
 #ifndef BOOST_COMPUTE_UTILITY_PROGRAM_CACHE_HPP
 #define BOOST_COMPUTE_UTILITY_PROGRAM_CACHE_HPP
 
+#include <set>
 #include <string>
 #include <utility>
 
@@ -21,7 +22,7 @@
 #include <boost/compute/context.hpp>
 #include <boost/compute/program.hpp>
 #include <boost/compute/detail/lru_cache.hpp>
-#include <boost/compute/detail/global_static.hpp>
+#include <boost/compute/detail/mutex.hpp>
 
 namespace boost {
 namespace compute {
@@ -48,6 +49,12 @@ namespace compute {
 /// }
 /// \endcode
 ///
+/// When compiled with \c BOOST_COMPUTE_THREAD_SAFE defined, all member
+/// functions may be called concurrently from multiple threads. In that mode
+/// get_or_build() guarantees that each program is built only once even if
+/// many threads miss in the cache at the same time: the first thread builds
+/// the program while the others wait for it and then share the result.
+///
 /// \see program
 class program_cache : boost::noncopyable
 {
@@ -67,6 +74,8 @@ public:
     /// Returns the number of program objects currently stored in the cache.
     size_t size() const
     {
+        detail::unique_lock lock(m_mutex);
+
         return m_cache.size();
     }
 
@@ -79,6 +88,8 @@ public:
     /// Clears the program cache.
     void clear()
     {
+        detail::unique_lock lock(m_mutex);
+
         m_cache.clear();
     }
 
@@ -86,13 +97,15 @@ public:
     /// program with \p key exists in the cache.
     boost::optional<program> get(const std::string &key)
     {
-        return m_cache.get(std::make_pair(key, std::string()));
+        return get(key, std::string());
     }
 
     /// Returns the program object with \p key and \p options. Returns a null
     /// optional if no program with \p key and \p options exists in the cache.
     boost::optional<program> get(const std::string &key, const std::string &options)
     {
+        detail::unique_lock lock(m_mutex);
+
         return m_cache.get(std::make_pair(key, options));
     }
 
@@ -105,6 +118,8 @@ public:
     /// Inserts \p program into the cache with \p key and \p options.
     void insert(const std::string &key, const std::string &options, const program &program)
     {
+        detail::unique_lock lock(m_mutex);
+
         m_cache.insert(std::make_pair(key, options), program);
     }
 
@@ -131,13 +146,49 @@ public:
                          const std::string &source,
                          const context &context)
     {
-        boost::optional<program> p = get(key, options);
-        if(!p){
-            p = program::build_with_source(source, context, options);
+        const key_type cache_key(key, options);
+
+        detail::unique_lock lock(m_mutex);
+
+        for(;;){
+            boost::optional<program> p = m_cache.get(cache_key);
+            if(p){
+                return *p;
+            }
 
-            insert(key, options, *p);
+            if(m_building.find(cache_key) == m_building.end()){
+                break;
+            }
+
+            // another thread is currently building the program, wait for
+            // it to finish and then check the cache again
+            m_built.wait(lock);
         }
-        return *p;
+
+        // mark the program as being built and release the lock while
+        // compiling so that lookups for other programs are not blocked
+        m_building.insert(cache_key);
+        lock.unlock();
+
+        program p;
+        try {
+            p = program::build_with_source(source, context, options);
+        }
+        catch(...){
+            // wake up any waiting threads so that they can retry the build
+            // (and receive the build error themselves)
+            lock.lock();
+            m_building.erase(cache_key);
+            m_built.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        m_cache.insert(cache_key, p);
+        m_building.erase(cache_key);
+        m_built.notify_all();
+
+        return p;
     }
 
     /// Returns the global program cache for \p context.
@@ -146,11 +197,19 @@ public:
     /// program objects used by its algorithms. All Boost.Compute programs are
     /// stored with a cache key beginning with \c "__boost". User programs
     /// should avoid using the same prefix in order to prevent collisions.
+    ///
+    /// The global cache is shared by all threads in the process. When
+    /// \c BOOST_COMPUTE_THREAD_SAFE is defined, it may be accessed
+    /// concurrently.
     static boost::shared_ptr<program_cache> get_global_cache(const context &context)
     {
         typedef detail::lru_cache<cl_context, boost::shared_ptr<program_cache> > cache_map;
 
-        BOOST_COMPUTE_DETAIL_GLOBAL_STATIC(cache_map, caches, (8));
+        // the global caches are shared by all threads in the process
+        static cache_map caches(8);
+        static detail::mutex caches_mutex;
+
+        detail::unique_lock lock(caches_mutex);
 
         boost::optional<boost::shared_ptr<program_cache> > cache = caches.get(context.get());
         if(!cache){
@@ -163,7 +222,12 @@ public:
     }
 
 private:
-    detail::lru_cache<std::pair<std::string, std::string>, program> m_cache;
+    typedef std::pair<std::string, std::string> key_type;
+
+    detail::lru_cache<key_type, program> m_cache;
+    std::set<key_type> m_building;
+    mutable detail::mutex m_mutex;
+    detail::condition_variable m_built;
 };
 
 } // end compute namespace
@@ -0,0 +1,235 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestAsyncAlgorithms
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/async/future.hpp>
+#include <boost/compute/algorithm/accumulate.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/count.hpp>
+#include <boost/compute/algorithm/count_if.hpp>
+#include <boost/compute/algorithm/exclusive_scan.hpp>
+#include <boost/compute/algorithm/find.hpp>
+#include <boost/compute/algorithm/find_if.hpp>
+#include <boost/compute/algorithm/inclusive_scan.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/algorithm/max_element.hpp>
+#include <boost/compute/algorithm/min_element.hpp>
+#include <boost/compute/algorithm/nth_element.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/transform.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/utility/wait_list.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace compute = boost::compute;
+
+BOOST_AUTO_TEST_CASE(reduce_async)
+{
+    compute::vector<int> vector(1000, context);
+    compute::iota(vector.begin(), vector.end(), 1, queue);
+
+    compute::future<int> sum =
+        compute::reduce_async(vector.begin(), vector.end(), queue);
+    compute::future<int> max =
+        compute::reduce_async(vector.begin(), vector.end(),
+                              compute::max<int>(), queue);
+    BOOST_CHECK(sum.valid());
+    BOOST_CHECK_EQUAL(sum.get(), 500500);
+    BOOST_CHECK_EQUAL(max.get(), 1000);
+
+    // the value is only read from the device once
+    BOOST_CHECK_EQUAL(sum.get(), 500500);
+
+    // empty range
+    compute::future<int> empty =
+        compute::reduce_async(vector.begin(), vector.begin(), queue);
+    BOOST_CHECK_EQUAL(empty.get(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(accumulate_and_count_async)
+{
+    int data[] = { 1, 5, 2, 5, 3, 5, 4, 5 };
+    compute::vector<int> vector(data, data + 8, queue);
+
+    compute::future<int> sum =
+        compute::accumulate_async(vector.begin(), vector.end(), 10, queue);
+    compute::future<int> product =
+        compute::accumulate_async(vector.begin(), vector.end(), 1,
+                                  compute::multiplies<int>(), queue);
+    compute::future<size_t> fives =
+        compute::count_async(vector.begin(), vector.end(), 5, queue);
+
+    using compute::_1;
+    compute::future<size_t> small =
+        compute::count_if_async(vector.begin(), vector.end(), _1 < 3, queue);
+
+    BOOST_CHECK_EQUAL(sum.get(), 40);
+    BOOST_CHECK_EQUAL(product.get(), 15000);
+    BOOST_CHECK_EQUAL(fives.get(), size_t(4));
+    BOOST_CHECK_EQUAL(small.get(), size_t(2));
+}
+
+BOOST_AUTO_TEST_CASE(transform_and_scan_async)
+{
+    int data[] = { 1, -2, 3, -4, 5 };
+    compute::vector<int> input(data, data + 5, queue);
+    compute::vector<int> output(5, context);
+
+    compute::future<compute::vector<int>::iterator> transformed =
+        compute::transform_async(input.begin(), input.end(), output.begin(),
+                                 compute::abs<int>(), queue);
+    BOOST_CHECK(transformed.get() == output.end());
+    CHECK_RANGE_EQUAL(int, 5, output, (1, 2, 3, 4, 5));
+
+    compute::future<compute::vector<int>::iterator> scanned =
+        compute::inclusive_scan_async(output.begin(), output.end(),
+                                      output.begin(), queue);
+    BOOST_CHECK(scanned.get() == output.end());
+    CHECK_RANGE_EQUAL(int, 5, output, (1, 3, 6, 10, 15));
+
+    compute::exclusive_scan_async(
+        input.begin(), input.end(), output.begin(), 10, queue
+    ).wait();
+    CHECK_RANGE_EQUAL(int, 5, output, (10, 11, 9, 12, 8));
+}
+
+BOOST_AUTO_TEST_CASE(chain_with_wait_list)
+{
+    const size_t size = 100000;
+
+    std::vector<int> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() % 1000;
+    }
+
+    compute::vector<int> vector(size, context);
+
+    // each stage waits on the event of the previous one
+    compute::future<compute::vector<int>::iterator> copied =
+        compute::copy_async(host.begin(), host.end(), vector.begin(), queue);
+
+    compute::wait_list events;
+    events.insert(copied.get_event());
+    compute::future<void> sorted =
+        compute::sort_async(vector.begin(), vector.end(), queue, events);
+
+    events.clear();
+    events.insert(sorted.get_event());
+    compute::future<int> sum =
+        compute::reduce_async(vector.begin(), vector.end(), queue, events);
+
+    int expected_sum = 0;
+    for(size_t i = 0; i < size; i++){
+        expected_sum += host[i];
+    }
+    BOOST_CHECK_EQUAL(sum.get(), expected_sum);
+
+    std::sort(host.begin(), host.end());
+    std::vector<int> result(size);
+    compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK(result == host);
+}
+
+BOOST_AUTO_TEST_CASE(sort_async_descending)
+{
+    compute::vector<float> vector(1000, context);
+    compute::iota(vector.begin(), vector.end(), -500.f, queue);
+
+    compute::sort_async(
+        vector.begin(), vector.end(), compute::greater<float>(), queue
+    ).wait();
+
+    std::vector<float> result(1000);
+    compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK_EQUAL(result.front(), 499.f);
+    BOOST_CHECK_EQUAL(result.back(), -500.f);
+    for(size_t i = 1; i < result.size(); i++){
+        BOOST_CHECK_GE(result[i - 1], result[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_and_extrema_async)
+{
+    using compute::_1;
+
+    int data[] = { 4, 9, 2, 7, 2, 9, 5, 1, 8, 1 };
+    compute::vector<int> vector(data, data + 10, queue);
+
+    compute::future<compute::vector<int>::iterator> found =
+        compute::find_async(vector.begin(), vector.end(), 7, queue);
+    compute::future<compute::vector<int>::iterator> found_if =
+        compute::find_if_async(vector.begin(), vector.end(), _1 > 7, queue);
+    compute::future<compute::vector<int>::iterator> missing =
+        compute::find_async(vector.begin(), vector.end(), 3, queue);
+    compute::future<compute::vector<int>::iterator> min =
+        compute::min_element_async(vector.begin(), vector.end(), queue);
+    compute::future<compute::vector<int>::iterator> max =
+        compute::max_element_async(vector.begin(), vector.end(), queue);
+
+    BOOST_CHECK(found.get() == vector.begin() + 3);
+    BOOST_CHECK(found_if.get() == vector.begin() + 1);
+    BOOST_CHECK(missing.get() == vector.end());
+    BOOST_CHECK(min.get() == vector.begin() + 7);
+    BOOST_CHECK(max.get() == vector.begin() + 1);
+
+    // large enough for the reduce-based search
+    compute::vector<int> large(10000, context);
+    compute::iota(large.begin(), large.end(), -5000, queue);
+    BOOST_CHECK(
+        compute::min_element_async(large.begin(), large.end(), queue).get() ==
+        large.begin()
+    );
+    BOOST_CHECK(
+        compute::max_element_async(large.begin(), large.end(), queue).get() ==
+        large.end() - 1
+    );
+}
+
+BOOST_AUTO_TEST_CASE(nth_element_async)
+{
+    const size_t size = 10000;
+
+    std::vector<int> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() % 1000;
+    }
+
+    compute::vector<int> vector(host.begin(), host.end(), queue);
+    compute::nth_element_async(
+        vector.begin(), vector.begin() + 1234, vector.end(), queue
+    ).wait();
+
+    std::nth_element(host.begin(), host.begin() + 1234, host.end());
+    const int nth = host[1234];
+
+    std::vector<int> result(size);
+    compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK_EQUAL(result[1234], nth);
+    for(size_t i = 0; i < 1234; i++){
+        BOOST_CHECK_LE(result[i], nth);
+    }
+    for(size_t i = 1235; i < size; i++){
+        BOOST_CHECK_GE(result[i], nth);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
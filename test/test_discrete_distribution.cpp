@@ -234,4 +234,67 @@ BOOST_AUTO_TEST_CASE(discrete_distribution_uchar)
     );
 }
 
+BOOST_AUTO_TEST_CASE(discrete_distribution_zero_weights)
+{
+    using boost::compute::uint_;
+    using boost::compute::lambda::_1;
+
+    size_t size = 100000;
+    boost::compute::vector<uint_> vec(size, context);
+
+    boost::compute::default_random_engine engine(queue);
+
+    int weights[] = {0, 1, 0, 3};
+    boost::compute::discrete_distribution<uint_> distribution(
+        weights, weights + 4
+    );
+    distribution.generate(vec.begin(), vec.end(), engine, queue);
+
+    // zero weights are never produced
+    BOOST_CHECK_EQUAL(
+        boost::compute::count_if(
+            vec.begin(), vec.end(), _1 == 0 || _1 == 2, queue
+        ),
+        size_t(0)
+    );
+
+    // about three quarters of the values are 3
+    size_t threes = boost::compute::count_if(
+        vec.begin(), vec.end(), _1 == 3, queue
+    );
+    BOOST_CHECK(threes > size * 70 / 100);
+    BOOST_CHECK(threes < size * 80 / 100);
+}
+
+BOOST_AUTO_TEST_CASE(discrete_distribution_many_weights)
+{
+    using boost::compute::uint_;
+    using boost::compute::lambda::_1;
+
+    size_t size = 100000;
+    boost::compute::vector<uint_> vec(size, context);
+
+    boost::compute::default_random_engine engine(queue);
+
+    // 10000 categories, half of the mass on the last one
+    std::vector<double> weights(10000, 1.0);
+    weights.back() = 9999.0;
+    boost::compute::discrete_distribution<uint_> distribution(
+        weights.begin(), weights.end()
+    );
+    distribution.generate(vec.begin(), vec.end(), engine, queue);
+
+    BOOST_CHECK_EQUAL(
+        boost::compute::count_if(
+            vec.begin(), vec.end(), _1 < 10000, queue
+        ),
+        size
+    );
+    size_t last = boost::compute::count_if(
+        vec.begin(), vec.end(), _1 == 9999, queue
+    );
+    BOOST_CHECK(last > size * 45 / 100);
+    BOOST_CHECK(last < size * 55 / 100);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
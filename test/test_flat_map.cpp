@@ -12,14 +12,18 @@
 #include <boost/test/unit_test.hpp>
 
 #include <utility>
+#include <vector>
 
 #include <boost/concept_check.hpp>
 
 #include <boost/compute/source.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/container/flat_map.hpp>
+#include <boost/compute/container/vector.hpp>
 #include <boost/compute/type_traits/type_name.hpp>
 #include <boost/compute/type_traits/type_definition.hpp>
 
+#include "check_macros.hpp"
 #include "context_setup.hpp"
 
 BOOST_AUTO_TEST_CASE(concept_check)
@@ -48,6 +52,57 @@ BOOST_AUTO_TEST_CASE(insert)
     BOOST_CHECK_EQUAL(map.size(), size_t(4));
 }
 
+BOOST_AUTO_TEST_CASE(bulk_insert)
+{
+    boost::compute::flat_map<int, float> map(context);
+    map.insert(std::make_pair(2, 2.2f), queue);
+
+    std::vector<std::pair<int, float> > data;
+    data.push_back(std::make_pair(4, 4.4f));
+    data.push_back(std::make_pair(2, -2.2f));
+    data.push_back(std::make_pair(1, 1.1f));
+    data.push_back(std::make_pair(3, 3.3f));
+    boost::compute::vector<std::pair<int, float> > pairs(data.size(), context);
+    boost::compute::copy(data.begin(), data.end(), pairs.begin(), queue);
+
+    map.insert(pairs.begin(), pairs.end(), queue);
+    BOOST_CHECK_EQUAL(map.size(), size_t(4));
+    BOOST_CHECK(map.find(1, queue) == map.begin() + 0);
+    BOOST_CHECK(map.find(4, queue) == map.begin() + 3);
+    BOOST_CHECK(map.find(5, queue) == map.end());
+
+    // existing keys keep their values
+    BOOST_CHECK_EQUAL(float(map.at(2)), float(2.2f));
+    BOOST_CHECK_EQUAL(float(map.at(3)), float(3.3f));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_erase_and_contains)
+{
+    std::vector<std::pair<int, float> > data;
+    for(int i = 0; i < 8; i++){
+        data.push_back(std::make_pair(i, i * 1.5f));
+    }
+    boost::compute::vector<std::pair<int, float> > pairs(data.size(), context);
+    boost::compute::copy(data.begin(), data.end(), pairs.begin(), queue);
+
+    boost::compute::flat_map<int, float> map(context);
+    map.insert(pairs.begin(), pairs.end(), queue);
+    BOOST_CHECK_EQUAL(map.size(), size_t(8));
+
+    int erase_data[] = { 6, 1, 9, 3 };
+    boost::compute::vector<int> keys(erase_data, erase_data + 4, queue);
+    BOOST_CHECK_EQUAL(map.erase_keys(keys.begin(), keys.end(), queue), size_t(3));
+    BOOST_CHECK_EQUAL(map.size(), size_t(5));
+    BOOST_CHECK_EQUAL(float(map.at(7)), float(10.5f));
+
+    int query_data[] = { 0, 1, 2, 3, 7, 9 };
+    boost::compute::vector<int> queries(query_data, query_data + 6, queue);
+    boost::compute::vector<int> found(6, context);
+    map.contains(queries.begin(), queries.end(), found.begin(), queue);
+    CHECK_RANGE_EQUAL(int, 6, found, (1, 0, 1, 0, 1, 0));
+    BOOST_CHECK_EQUAL(map.count(queries.begin(), queries.end(), queue), size_t(3));
+}
+
 BOOST_AUTO_TEST_CASE(at)
 {
     boost::compute::flat_map<int, float> map(context);
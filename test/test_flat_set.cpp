@@ -17,8 +17,11 @@
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/container/flat_set.hpp>
+#include <boost/compute/container/vector.hpp>
 
+#include "check_macros.hpp"
 #include "context_setup.hpp"
 
 namespace bc = boost::compute;
@@ -133,4 +136,58 @@ BOOST_AUTO_TEST_CASE(clear)
     BOOST_CHECK_EQUAL(set.size(), size_t(0));
 }
 
+BOOST_AUTO_TEST_CASE(bulk_insert)
+{
+    bc::flat_set<int> set(context);
+    set.insert(5, queue);
+    set.insert(1, queue);
+
+    int data[] = { 9, 3, 5, 7, 3, -2, 1, 9 };
+    bc::vector<int> values(data, data + 8, queue);
+    set.insert(values.begin(), values.end(), queue);
+    BOOST_CHECK_EQUAL(set.size(), size_t(6));
+    CHECK_RANGE_EQUAL(int, 6, set, (-2, 1, 3, 5, 7, 9));
+
+    // inserting the same values again adds nothing
+    set.insert(values.begin(), values.end(), queue);
+    BOOST_CHECK_EQUAL(set.size(), size_t(6));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_erase)
+{
+    int data[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    bc::vector<int> values(data, data + 8, queue);
+    bc::flat_set<int> set(context);
+    set.insert(values.begin(), values.end(), queue);
+
+    int erase_data[] = { 8, 2, 10, 5, 2 };
+    bc::vector<int> keys(erase_data, erase_data + 5, queue);
+    BOOST_CHECK_EQUAL(set.erase_keys(keys.begin(), keys.end(), queue), size_t(3));
+    BOOST_CHECK_EQUAL(set.size(), size_t(5));
+    CHECK_RANGE_EQUAL(int, 5, set, (1, 3, 4, 6, 7));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_find)
+{
+    int data[] = { 10, 20, 30, 40 };
+    bc::vector<int> values(data, data + 4, queue);
+    bc::flat_set<int> set(context);
+    set.insert(values.begin(), values.end(), queue);
+    BOOST_CHECK(set.find(30, queue) == set.begin() + 2);
+    BOOST_CHECK(set.find(35, queue) == set.end());
+
+    int query_data[] = { 40, 5, 10, 35, 20 };
+    bc::vector<int> queries(query_data, query_data + 5, queue);
+
+    bc::vector<bc::uint_> indices(5, context);
+    set.find(queries.begin(), queries.end(), indices.begin(), queue);
+    CHECK_RANGE_EQUAL(bc::uint_, 5, indices, (3, 4, 0, 4, 1));
+
+    bc::vector<int> found(5, context);
+    set.contains(queries.begin(), queries.end(), found.begin(), queue);
+    CHECK_RANGE_EQUAL(int, 5, found, (1, 0, 1, 0, 1));
+
+    BOOST_CHECK_EQUAL(set.count(queries.begin(), queries.end(), queue), size_t(3));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestHostStream
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/function.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/lambda.hpp>
+#include <boost/compute/algorithm/count.hpp>
+#include <boost/compute/algorithm/count_if.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
+#include <boost/compute/algorithm/transform.hpp>
+#include <boost/compute/algorithm/detail/host_stream.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+// splits host ranges into small chunks so that the tests stream many chunks
+// through each of the slots
+struct small_chunks
+{
+    small_chunks(const bc::device &device)
+        : parameters(bc::detail::parameter_cache::get_global_cache(device)),
+          chunk_bytes(static_cast<bc::uint_>(
+              bc::detail::host_stream_chunk_bytes(device)))
+    {
+        parameters->set("__boost_host_stream", "chunk_bytes", 4096);
+    }
+
+    ~small_chunks()
+    {
+        parameters->set("__boost_host_stream", "chunk_bytes", chunk_bytes);
+    }
+
+    boost::shared_ptr<bc::detail::parameter_cache> parameters;
+    bc::uint_ chunk_bytes;
+};
+
+std::vector<int> random_values(size_t size)
+{
+    std::vector<int> values(size);
+    for(size_t i = 0; i < size; i++){
+        values[i] = std::rand() % 2000 - 1000;
+    }
+    return values;
+}
+
+BOOST_AUTO_TEST_CASE(stream_transform)
+{
+    small_chunks chunks(device);
+
+    const std::vector<int> input = random_values(10007);
+    std::vector<int> output(input.size());
+
+    BOOST_CHECK(
+        bc::transform(input.begin(), input.end(), output.begin(),
+                      bc::abs<int>(), queue) == output.end()
+    );
+    for(size_t i = 0; i < input.size(); i++){
+        BOOST_REQUIRE_EQUAL(output[i], std::abs(input[i]));
+    }
+
+    // a different output type and an output iterator without a size
+    BOOST_COMPUTE_FUNCTION(float, half_of, (int x),
+    {
+        return x * 0.5f;
+    });
+
+    std::vector<float> converted;
+    bc::transform(input.begin(), input.end(), std::back_inserter(converted),
+                  half_of, queue);
+    BOOST_REQUIRE_EQUAL(converted.size(), input.size());
+    for(size_t i = 0; i < input.size(); i++){
+        BOOST_REQUIRE_EQUAL(converted[i], input[i] * 0.5f);
+    }
+
+    // fewer values than slots
+    int small[] = { -1, 2 };
+    int small_output[2];
+    bc::transform(small, small + 2, small_output, bc::abs<int>(), queue);
+    BOOST_CHECK_EQUAL(small_output[0], 1);
+    BOOST_CHECK_EQUAL(small_output[1], 2);
+}
+
+BOOST_AUTO_TEST_CASE(stream_reduce)
+{
+    small_chunks chunks(device);
+
+    const std::vector<int> input = random_values(10007);
+
+    bc::long_ expected_sum = 0;
+    for(size_t i = 0; i < input.size(); i++){
+        expected_sum += input[i];
+    }
+
+    int sum = 0;
+    bc::reduce(input.begin(), input.end(), &sum, queue);
+    BOOST_CHECK_EQUAL(sum, expected_sum);
+
+    int max = 0;
+    bc::reduce(input.begin(), input.end(), &max, bc::max<int>(), queue);
+    BOOST_CHECK_EQUAL(max, *std::max_element(input.begin(), input.end()));
+
+    // the range only needs forward iterators
+    std::list<int> list(input.begin(), input.end());
+    int min = 0;
+    bc::reduce(list.begin(), list.end(), &min, bc::min<int>(), queue);
+    BOOST_CHECK_EQUAL(min, *std::min_element(input.begin(), input.end()));
+}
+
+BOOST_AUTO_TEST_CASE(stream_count_if)
+{
+    small_chunks chunks(device);
+
+    const std::vector<int> input = random_values(10007);
+
+    size_t negative = 0;
+    for(size_t i = 0; i < input.size(); i++){
+        if(input[i] < 0){
+            negative++;
+        }
+    }
+
+    using bc::lambda::_1;
+    BOOST_CHECK_EQUAL(
+        bc::count_if(input.begin(), input.end(), _1 < 0, queue), negative
+    );
+    BOOST_CHECK_EQUAL(
+        bc::count(input.begin(), input.end(), 7, queue),
+        size_t(std::count(input.begin(), input.end(), 7))
+    );
+    BOOST_CHECK_EQUAL(
+        bc::count(input.begin(), input.begin(), 7, queue), size_t(0)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(stream_default_chunks)
+{
+    // more chunks of the default size than there are slots, so the queues
+    // wait on each other for every chunk
+    const size_t chunk_size =
+        bc::detail::host_stream_chunk_size(device, 2 * sizeof(int));
+    const size_t size = (bc::detail::host_stream_slots + 2) * chunk_size + 3;
+
+    std::vector<int> input(size);
+    for(size_t i = 0; i < size; i++){
+        input[i] = static_cast<int>(i % 2000) - 1000;
+    }
+
+    std::vector<int> output(size);
+    bc::transform(input.begin(), input.end(), output.begin(),
+                  bc::abs<int>(), queue);
+    for(size_t i = 0; i < size; i++){
+        BOOST_REQUIRE_EQUAL(output[i], std::abs(input[i]));
+    }
+
+    int max = 0;
+    bc::reduce(input.begin(), input.end(), &max, bc::max<int>(), queue);
+    BOOST_CHECK_EQUAL(max, 999);
+}
+
+BOOST_AUTO_TEST_CASE(stream_single_chunk)
+{
+    // ranges which fit into one chunk are computed without the slots
+    const std::vector<int> input = random_values(1000);
+    BOOST_REQUIRE_LT(
+        input.size() * 2 * sizeof(int), bc::detail::host_stream_chunk_bytes(device)
+    );
+
+    std::vector<int> output(input.size());
+    bc::transform(input.begin(), input.end(), output.begin(),
+                  bc::abs<int>(), queue);
+    for(size_t i = 0; i < input.size(); i++){
+        BOOST_REQUIRE_EQUAL(output[i], std::abs(input[i]));
+    }
+
+    int max = 0;
+    bc::reduce(input.begin(), input.end(), &max, bc::max<int>(), queue);
+    BOOST_CHECK_EQUAL(max, *std::max_element(input.begin(), input.end()));
+
+    std::list<int> list(input.begin(), input.end());
+    BOOST_CHECK_EQUAL(
+        bc::count(list.begin(), list.end(), 7, queue),
+        size_t(std::count(input.begin(), input.end(), 7))
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
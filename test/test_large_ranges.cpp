@@ -0,0 +1,278 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestLargeRanges
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <string>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/lambda.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/count.hpp>
+#include <boost/compute/algorithm/find_if.hpp>
+#include <boost/compute/algorithm/inclusive_scan.hpp>
+#include <boost/compute/algorithm/max_element.hpp>
+#include <boost/compute/algorithm/min_element.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/transform.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
+#include <boost/compute/detail/read_write_single_value.hpp>
+#include <boost/compute/iterator/constant_iterator.hpp>
+
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+// number of elements in the large ranges, just above the 32-bit limit
+static size_t large_range_size()
+{
+    return static_cast<size_t>((bc::ulong_(1) << 32) + 1024);
+}
+
+// returns true if the device can hold the given number of large uchar
+// ranges, otherwise prints a message and returns false
+static bool can_allocate_large_ranges(const bc::device &device,
+                                      size_t ranges,
+                                      const char *test)
+{
+    const bc::ulong_ size = large_range_size();
+
+    if(sizeof(size_t) < 8 ||
+       device.address_bits() < 64 ||
+       device.max_memory_alloc_size() < size ||
+       device.global_memory_size() < size * ranges){
+        std::cerr << "skipping " << test << " test: "
+                  << "not enough device memory" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(index_type)
+{
+    BOOST_CHECK(!bc::detail::requires_64bit_indices(0));
+    BOOST_CHECK(!bc::detail::requires_64bit_indices(1000000));
+
+    bc::detail::meta_kernel small("small");
+    small.set_index_type_for(1000);
+    small.add_index_arg("count");
+    BOOST_CHECK(!small.uses_64bit_indices());
+    BOOST_CHECK_EQUAL(small.index_type(), std::string("uint"));
+    BOOST_CHECK(small.source().find("const uint count") != std::string::npos);
+
+    if(sizeof(size_t) < 8){
+        return;
+    }
+
+    BOOST_CHECK(bc::detail::requires_64bit_indices(large_range_size()));
+
+    bc::detail::meta_kernel large("large");
+    large.set_index_type_for(large_range_size());
+    large.add_index_arg("count");
+    BOOST_CHECK(large.uses_64bit_indices());
+    BOOST_CHECK_EQUAL(large.index_type(), std::string("ulong"));
+    BOOST_CHECK(large.source().find("const ulong count") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(large_iterator_offset)
+{
+    if(sizeof(size_t) < 8){
+        return;
+    }
+
+    // the offset of a buffer iterator past the 32-bit limit is emitted as a
+    // ulong literal instead of being truncated
+    bc::buffer buffer(context, 16);
+    bc::buffer_iterator<bc::uchar_> iter(buffer, large_range_size());
+
+    bc::detail::meta_kernel k("large_offset");
+    k << iter[k.var<bc::uint_>("i")];
+    BOOST_CHECK(k.source().find("[4294968320UL+(i)]") != std::string::npos);
+
+    bc::detail::meta_kernel small("small_offset");
+    small << (iter - large_range_size() + 1024)[small.var<bc::uint_>("i")];
+    BOOST_CHECK(small.source().find("[1024+(i)]") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_count_above_4g)
+{
+    if(!can_allocate_large_ranges(device, 1, "copy_and_count_above_4g")){
+        return;
+    }
+
+    const size_t size = large_range_size();
+    bc::vector<bc::uchar_> vector(size, context);
+
+    bc::copy(
+        bc::make_constant_iterator<bc::uchar_>(3, 0),
+        bc::make_constant_iterator<bc::uchar_>(3, size),
+        vector.begin(),
+        queue
+    );
+
+    // the last values are only reachable with 64-bit indices
+    bc::detail::write_single_value<bc::uchar_>(
+        7, vector.get_buffer(), size - 1, queue
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(vector.get_buffer(), size - 2, queue),
+        bc::uchar_(3)
+    );
+
+    // a kernel reading through an iterator with an offset past 2^32
+    bc::vector<bc::uchar_> tail(1024, context);
+    bc::transform(
+        vector.end() - 1024, vector.end(), tail.begin(),
+        bc::identity<bc::uchar_>(), queue
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(tail.get_buffer(), 0, queue),
+        bc::uchar_(3)
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(tail.get_buffer(), 1023, queue),
+        bc::uchar_(7)
+    );
+
+    BOOST_CHECK_EQUAL(
+        bc::count(vector.begin(), vector.end(), bc::uchar_(3), queue),
+        size - 1
+    );
+    BOOST_CHECK_EQUAL(
+        bc::count(vector.begin(), vector.end(), bc::uchar_(7), queue),
+        size_t(1)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(reduce_and_scan_above_4g)
+{
+    if(!can_allocate_large_ranges(device, 2, "reduce_and_scan_above_4g")){
+        return;
+    }
+
+    const size_t size = large_range_size();
+    bc::vector<bc::uchar_> input(size, context);
+    bc::copy(
+        bc::make_constant_iterator<bc::uchar_>(1, 0),
+        bc::make_constant_iterator<bc::uchar_>(1, size),
+        input.begin(),
+        queue
+    );
+    bc::detail::write_single_value<bc::uchar_>(
+        9, input.get_buffer(), size - 3, queue
+    );
+
+    bc::vector<bc::uchar_> output(size, context);
+    bc::inclusive_scan(
+        input.begin(), input.end(), output.begin(), bc::max<bc::uchar_>(), queue
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(output.get_buffer(), size - 4, queue),
+        bc::uchar_(1)
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(output.get_buffer(), size - 1, queue),
+        bc::uchar_(9)
+    );
+
+    bc::uchar_ max_value = 0;
+    bc::reduce(
+        input.begin(), input.end(), &max_value, bc::max<bc::uchar_>(), queue
+    );
+    BOOST_CHECK_EQUAL(max_value, bc::uchar_(9));
+}
+
+BOOST_AUTO_TEST_CASE(find_if_and_extrema_above_4g)
+{
+    if(!can_allocate_large_ranges(device, 1, "find_if_and_extrema_above_4g")){
+        return;
+    }
+
+    const size_t size = large_range_size();
+    bc::vector<bc::uchar_> vector(size, context);
+    bc::copy(
+        bc::make_constant_iterator<bc::uchar_>(4, 0),
+        bc::make_constant_iterator<bc::uchar_>(4, size),
+        vector.begin(),
+        queue
+    );
+
+    // both positions are only reachable with 64-bit indices
+    bc::detail::write_single_value<bc::uchar_>(8, vector.get_buffer(), size - 5, queue);
+    bc::detail::write_single_value<bc::uchar_>(8, vector.get_buffer(), size - 2, queue);
+    bc::detail::write_single_value<bc::uchar_>(1, vector.get_buffer(), size - 3, queue);
+
+    using bc::lambda::_1;
+
+    if(device.supports_extension("cl_khr_int64_extended_atomics")){
+        BOOST_CHECK(
+            bc::find_if(vector.begin(), vector.end(), _1 > 4, queue) ==
+            vector.end() - 5
+        );
+        BOOST_CHECK(
+            bc::find_if(vector.begin(), vector.end(), _1 > 8, queue) ==
+            vector.end()
+        );
+    }
+    else {
+        std::cerr << "skipping find_if above 4g: "
+                  << "cl_khr_int64_extended_atomics not supported" << std::endl;
+    }
+
+    // the first of the two maximums is returned
+    BOOST_CHECK(
+        bc::max_element(vector.begin(), vector.end(), queue) ==
+        vector.end() - 5
+    );
+    BOOST_CHECK(
+        bc::min_element(vector.begin(), vector.end(), queue) ==
+        vector.end() - 3
+    );
+}
+
+BOOST_AUTO_TEST_CASE(sort_above_4g)
+{
+    if(!can_allocate_large_ranges(device, 2, "sort_above_4g")){
+        return;
+    }
+
+    const size_t size = large_range_size();
+    bc::vector<bc::uchar_> vector(size, context);
+    bc::copy(
+        bc::make_constant_iterator<bc::uchar_>(5, 0),
+        bc::make_constant_iterator<bc::uchar_>(5, size),
+        vector.begin(),
+        queue
+    );
+    bc::detail::write_single_value<bc::uchar_>(9, vector.get_buffer(), 0, queue);
+    bc::detail::write_single_value<bc::uchar_>(2, vector.get_buffer(), size - 1, queue);
+
+    bc::sort(vector.begin(), vector.end(), queue);
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(vector.get_buffer(), 0, queue),
+        bc::uchar_(2)
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(vector.get_buffer(), size - 2, queue),
+        bc::uchar_(5)
+    );
+    BOOST_CHECK_EQUAL(
+        bc::detail::read_single_value<bc::uchar_>(vector.get_buffer(), size - 1, queue),
+        bc::uchar_(9)
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
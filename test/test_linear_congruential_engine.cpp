@@ -11,7 +11,10 @@
 #define BOOST_TEST_MODULE TestLinearCongruentialEngine
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
 #include <boost/compute/random/linear_congruential_engine.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/container/vector.hpp>
 
 #include "check_macros.hpp"
@@ -117,4 +120,26 @@ BOOST_AUTO_TEST_CASE(assign_op)
     );
 }
 
+BOOST_AUTO_TEST_CASE(generate_large_range)
+{
+    using boost::compute::uint_;
+
+    const size_t size = 200000;
+
+    boost::compute::linear_congruential_engine<uint_> rng(queue, 7);
+    boost::compute::vector<uint_> vector(size, context);
+
+    rng.generate(vector.begin(), vector.begin() + 100, queue);
+    rng.generate(vector.begin() + 100, vector.end(), queue);
+
+    std::vector<uint_> result(size);
+    boost::compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+
+    uint_ x = 7;
+    for(size_t i = 0; i < size; i++){
+        x *= boost::compute::linear_congruential_engine<uint_>::a;
+        BOOST_REQUIRE_EQUAL(result[i], x);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
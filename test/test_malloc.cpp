@@ -12,6 +12,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/allocator/pooled_allocator.hpp>
 #include <boost/compute/experimental/malloc.hpp>
 
 #include "context_setup.hpp"
@@ -37,4 +38,41 @@ BOOST_AUTO_TEST_CASE(malloc_int)
     bc::experimental::free(ptr);
 }
 
+BOOST_AUTO_TEST_CASE(free_returns_memory_to_pool)
+{
+    bc::pooled_allocator<int> allocator(context);
+    allocator.trim();
+    const bc::pooled_allocator_statistics before = allocator.statistics();
+
+    bc::experimental::device_ptr<int> ptr = bc::experimental::malloc<int>(100, context);
+    const cl_mem mem = ptr.get_buffer().get();
+    bc::experimental::free(ptr);
+    BOOST_CHECK_GT(allocator.statistics().bytes_cached, size_t(0));
+
+    // the same memory is handed out again
+    ptr = bc::experimental::malloc<int>(100, context);
+    BOOST_CHECK(ptr.get_buffer().get() == mem);
+    BOOST_CHECK_EQUAL(allocator.statistics().hits, before.hits + 1);
+    bc::experimental::free(ptr);
+
+    allocator.trim();
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_cached, size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(free_memory_from_elsewhere)
+{
+    bc::pooled_allocator<int> allocator(context);
+    const bc::pooled_allocator_statistics before = allocator.statistics();
+
+    // memory which does not come from the pool is released directly
+    bc::buffer buf(context, 100 * sizeof(int));
+    clRetainMemObject(buf.get());
+    bc::experimental::device_ptr<int> ptr(buf);
+    bc::experimental::free(ptr);
+
+    const bc::pooled_allocator_statistics after = allocator.statistics();
+    BOOST_CHECK_EQUAL(after.bytes_in_use, before.bytes_in_use);
+    BOOST_CHECK_EQUAL(after.bytes_cached, before.bytes_cached);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
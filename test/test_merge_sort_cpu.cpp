@@ -0,0 +1,100 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestMergeSortOnCPU
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/is_sorted.hpp>
+#include <boost/compute/algorithm/detail/merge_sort_on_cpu.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(sort_mid_vector_int)
+{
+    bc::int_ data[] = { 9, -3, 15, 0, 7, 7, -12, 4, 1, 2 };
+    bc::vector<bc::int_> vector(data, data + 10, queue);
+
+    bc::detail::merge_sort_on_cpu(
+        vector.begin(), vector.end(), bc::less<bc::int_>(), queue
+    );
+    CHECK_RANGE_EQUAL(
+        bc::int_, 10, vector,
+        (-12, -3, 0, 1, 2, 4, 7, 7, 9, 15)
+    );
+}
+
+// the final passes of large sorts split each merge with merge path
+BOOST_AUTO_TEST_CASE(sort_large_vector_int)
+{
+    const size_t size = 300000;
+    std::vector<bc::int_> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() % 50000 - 25000;
+    }
+
+    bc::vector<bc::int_> vector(host.begin(), host.end(), queue);
+    bc::detail::merge_sort_on_cpu(
+        vector.begin(), vector.end(), bc::greater<bc::int_>(), queue
+    );
+    BOOST_CHECK(
+        bc::is_sorted(vector.begin(), vector.end(), bc::greater<bc::int_>(), queue)
+    );
+
+    std::sort(host.begin(), host.end(), std::greater<bc::int_>());
+    std::vector<bc::int_> result(size);
+    bc::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK(result == host);
+}
+
+// merge_sort_by_key_on_cpu should be stable
+BOOST_AUTO_TEST_CASE(stable_sort_large_vector_int_by_int)
+{
+    const size_t size = 300000;
+    std::vector<bc::int_> host_keys(size);
+    std::vector<bc::int_> host_values(size);
+    for(size_t i = 0; i < size; i++){
+        host_keys[i] = static_cast<bc::int_>((i * 7) % 1000);
+        host_values[i] = static_cast<bc::int_>(i);
+    }
+
+    bc::vector<bc::int_> keys(host_keys.begin(), host_keys.end(), queue);
+    bc::vector<bc::int_> values(host_values.begin(), host_values.end(), queue);
+    bc::detail::merge_sort_by_key_on_cpu(
+        keys.begin(), keys.end(), values.begin(), bc::less<bc::int_>(), queue
+    );
+
+    std::vector<bc::int_> result_keys(size);
+    std::vector<bc::int_> result_values(size);
+    bc::copy(keys.begin(), keys.end(), result_keys.begin(), queue);
+    bc::copy(values.begin(), values.end(), result_values.begin(), queue);
+
+    BOOST_CHECK(std::is_sorted(result_keys.begin(), result_keys.end()));
+    for(size_t i = 1; i < size; i++){
+        // values with equal keys keep their input order
+        if(result_keys[i] == result_keys[i-1]){
+            BOOST_CHECK_LT(result_values[i-1], result_values[i]);
+        }
+        BOOST_CHECK_EQUAL(
+            host_keys[static_cast<size_t>(result_values[i])], result_keys[i]
+        );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
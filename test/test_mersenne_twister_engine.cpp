@@ -11,7 +11,12 @@
 #define BOOST_TEST_MODULE TestMersenneTwisterEngine
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+
 #include <boost/compute/random/mersenne_twister_engine.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/container/vector.hpp>
 
 #include "check_macros.hpp"
@@ -117,4 +122,30 @@ BOOST_AUTO_TEST_CASE(assign_op)
     );
 }
 
+BOOST_AUTO_TEST_CASE(generate_many_blocks)
+{
+    using boost::compute::uint_;
+
+    // spans many regenerations of the state, starting and ending in the
+    // middle of a block
+    const size_t size = 100000;
+
+    boost::compute::mt19937 rng(queue);
+    boost::random::mt19937 host_rng;
+
+    rng.discard(1000, queue);
+    host_rng.discard(1000);
+
+    boost::compute::vector<uint_> vector(size, context);
+    rng.generate(vector.begin() + 1, vector.end(), queue);
+    rng.generate(vector.begin(), vector.begin() + 1, queue);
+
+    std::vector<uint_> result(size);
+    boost::compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    for(size_t i = 1; i < size; i++){
+        BOOST_REQUIRE_EQUAL(result[i], static_cast<uint_>(host_rng()));
+    }
+    BOOST_CHECK_EQUAL(result[0], static_cast<uint_>(host_rng()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
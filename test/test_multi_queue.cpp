@@ -0,0 +1,161 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestMultiQueue
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/functional.hpp>
+#include <boost/compute/lambda.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/exclusive_scan.hpp>
+#include <boost/compute/algorithm/inclusive_scan.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/algorithm/reduce.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/transform.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+// the multi-queue algorithms only require the queues to share a context, so
+// the tests use several queues for the same device
+std::vector<bc::command_queue> make_queues(const bc::context &context,
+                                           const bc::device &device,
+                                           size_t count)
+{
+    std::vector<bc::command_queue> queues;
+    for(size_t i = 0; i < count; i++){
+        queues.push_back(bc::command_queue(context, device));
+    }
+    return queues;
+}
+
+BOOST_AUTO_TEST_CASE(multi_queue_reduce)
+{
+    std::vector<bc::command_queue> queues = make_queues(context, device, 3);
+
+    // the values are written by another of the queues without waiting,
+    // the reduction must still see them
+    bc::vector<int> vector(100000, context);
+    bc::iota(vector.begin(), vector.end(), 0, queues[2]);
+
+    bc::long_ sum = 0;
+    bc::reduce(vector.begin(), vector.end(), &sum, bc::plus<bc::long_>(), queues);
+    BOOST_CHECK_EQUAL(sum, bc::long_(99999) * 100000 / 2);
+
+    int max = 0;
+    bc::reduce(vector.begin(), vector.end(), &max, bc::max<int>(), queues);
+    BOOST_CHECK_EQUAL(max, 99999);
+
+    // fewer values than queues
+    int small_sum = 0;
+    bc::reduce(vector.begin() + 5, vector.begin() + 7, &small_sum, queues);
+    BOOST_CHECK_EQUAL(small_sum, 11);
+}
+
+BOOST_AUTO_TEST_CASE(multi_queue_transform)
+{
+    std::vector<bc::command_queue> queues = make_queues(context, device, 4);
+
+    int data[] = { 1, -2, 3, -4, 5, -6, 7 };
+    bc::vector<int> input(data, data + 7, queue);
+    bc::vector<int> output(7, context);
+
+    BOOST_CHECK(
+        bc::transform(input.begin(), input.end(), output.begin(),
+                      bc::abs<int>(), queues) == output.end()
+    );
+    queues[0].finish();
+    CHECK_RANGE_EQUAL(int, 7, output, (1, 2, 3, 4, 5, 6, 7));
+
+    bc::transform(input.begin(), input.end(), output.begin(), output.begin(),
+                  bc::plus<int>(), queues);
+    queues[0].finish();
+    CHECK_RANGE_EQUAL(int, 7, output, (2, 0, 6, 0, 10, 0, 14));
+}
+
+BOOST_AUTO_TEST_CASE(multi_queue_scan)
+{
+    std::vector<bc::command_queue> queues = make_queues(context, device, 3);
+
+    bc::vector<int> input(10, context);
+    bc::iota(input.begin(), input.end(), 1, queues[1]);
+    bc::vector<int> output(10, context);
+
+    bc::inclusive_scan(input.begin(), input.end(), output.begin(), queues);
+    queues[0].finish();
+    CHECK_RANGE_EQUAL(
+        int, 10, output, (1, 3, 6, 10, 15, 21, 28, 36, 45, 55)
+    );
+
+    bc::exclusive_scan(input.begin(), input.end(), output.begin(), 5, queues);
+    queues[0].finish();
+    CHECK_RANGE_EQUAL(
+        int, 10, output, (5, 6, 8, 11, 15, 20, 26, 33, 41, 50)
+    );
+
+    // in-place with another operator
+    bc::inclusive_scan(input.begin(), input.end(), input.begin(),
+                       bc::max<int>(), queues);
+    queues[0].finish();
+    CHECK_RANGE_EQUAL(int, 10, input, (1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+}
+
+BOOST_AUTO_TEST_CASE(multi_queue_sort)
+{
+    const size_t size = 100003;
+
+    std::vector<int> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() % 5000 - 2500;
+    }
+
+    // an odd number of queues leaves a run out of the first merge
+    for(size_t queue_count = 1; queue_count <= 5; queue_count++){
+        std::vector<bc::command_queue> queues =
+            make_queues(context, device, queue_count);
+
+        bc::vector<int> vector(size, context);
+        bc::copy_async(host.begin(), host.end(), vector.begin(), queues.back());
+        bc::sort(vector.begin(), vector.end(), queues);
+
+        std::vector<int> result(size);
+        bc::copy(vector.begin(), vector.end(), result.begin(), queues[0]);
+
+        std::vector<int> expected = host;
+        std::sort(expected.begin(), expected.end());
+        BOOST_CHECK(result == expected);
+    }
+
+    // descending order with a lambda
+    std::vector<bc::command_queue> queues = make_queues(context, device, 2);
+    bc::vector<int> vector(host.begin(), host.end(), queue);
+
+    using bc::lambda::_1;
+    using bc::lambda::_2;
+    bc::sort(vector.begin(), vector.end(), _1 > _2, queues);
+
+    std::vector<int> result(size);
+    bc::copy(vector.begin(), vector.end(), result.begin(), queues[0]);
+    std::sort(host.begin(), host.end(), std::greater<int>());
+    BOOST_CHECK(result == host);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,7 +11,13 @@
 #define BOOST_TEST_MODULE TestNthElement
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
 #include <boost/compute/algorithm/copy_n.hpp>
 #include <boost/compute/algorithm/is_partitioned.hpp>
 #include <boost/compute/algorithm/nth_element.hpp>
@@ -110,4 +116,52 @@ BOOST_AUTO_TEST_CASE(nth_element_comparator)
     CHECK_RANGE_EQUAL(int, 10, vector, (9, 15, 1, 4, 9, 9, 4, 15, 12, 1));
 }
 
+BOOST_AUTO_TEST_CASE(nth_element_large_float)
+{
+    const size_t size = 100000;
+    const size_t nth = 31337;
+
+    std::vector<float> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = static_cast<float>(std::rand() % 1000) - 500.0f;
+    }
+
+    boost::compute::vector<float> vector(host.begin(), host.end(), queue);
+    boost::compute::nth_element(
+        vector.begin(), vector.begin() + nth, vector.end(), queue
+    );
+
+    std::vector<float> result(size);
+    boost::compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+
+    std::nth_element(host.begin(), host.begin() + nth, host.end());
+    BOOST_CHECK_EQUAL(result[nth], host[nth]);
+    for(size_t i = 0; i < nth; i++){
+        BOOST_CHECK(!(result[nth] < result[i]));
+    }
+    for(size_t i = nth + 1; i < size; i++){
+        BOOST_CHECK(!(result[i] < result[nth]));
+    }
+
+    // all elements are kept
+    std::sort(host.begin(), host.end());
+    std::sort(result.begin(), result.end());
+    BOOST_CHECK(result == host);
+}
+
+BOOST_AUTO_TEST_CASE(nth_element_greater)
+{
+    int data[] = { 9, 15, 1, 4, 9, 9, 4, 15, 12, 1 };
+    boost::compute::vector<int> vector(data, data + 10, queue);
+
+    boost::compute::nth_element(
+        vector.begin(), vector.begin() + 2, vector.end(),
+        boost::compute::greater<int>(), queue
+    );
+    BOOST_CHECK_EQUAL(vector[2], 12);
+    BOOST_VERIFY(boost::compute::is_partitioned(
+        vector.begin(), vector.end(), boost::compute::_1 >= 12, queue
+    ));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestPartialSort
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/partial_sort.hpp>
+#include <boost/compute/algorithm/partial_sort_copy.hpp>
+#include <boost/compute/algorithm/top_k.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(partial_sort_int)
+{
+    int data[] = { 9, 3, 7, 1, 8, 2, 6, 0, 5, 4 };
+    bc::vector<int> vector(data, data + 10, queue);
+
+    bc::partial_sort(vector.begin(), vector.begin() + 3, vector.end(), queue);
+    CHECK_RANGE_EQUAL(int, 3, vector, (0, 1, 2));
+
+    std::vector<int> host(10);
+    bc::copy(vector.begin(), vector.end(), host.begin(), queue);
+    std::sort(host.begin(), host.end());
+    BOOST_CHECK_EQUAL(host[9], 9);
+}
+
+BOOST_AUTO_TEST_CASE(partial_sort_large_vector)
+{
+    const size_t size = 200000;
+    const size_t k = 100;
+
+    std::vector<int> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() % 100000;
+    }
+
+    bc::vector<int> vector(host.begin(), host.end(), queue);
+    bc::partial_sort(
+        vector.begin(), vector.begin() + k, vector.end(), bc::greater<int>(), queue
+    );
+
+    std::vector<int> result(size);
+    bc::copy(vector.begin(), vector.end(), result.begin(), queue);
+
+    // the first k elements are the largest ones in descending order
+    std::vector<int> expected(host);
+    std::partial_sort(
+        expected.begin(), expected.begin() + k, expected.end(), std::greater<int>()
+    );
+    BOOST_CHECK(std::equal(expected.begin(), expected.begin() + k, result.begin()));
+
+    // all elements are kept
+    std::sort(host.begin(), host.end());
+    std::sort(result.begin(), result.end());
+    BOOST_CHECK(result == host);
+}
+
+BOOST_AUTO_TEST_CASE(partial_sort_copy_int)
+{
+    int data[] = { 9, 3, 7, 1, 8, 2, 6, 0, 5, 4 };
+    bc::vector<int> input(data, data + 10, queue);
+    bc::vector<int> output(4, context);
+
+    bc::vector<int>::iterator end = bc::partial_sort_copy(
+        input.begin(), input.end(), output.begin(), output.end(), queue
+    );
+    BOOST_CHECK(end == output.end());
+    CHECK_RANGE_EQUAL(int, 4, output, (0, 1, 2, 3));
+
+    // result range larger than the input
+    bc::vector<int> large_output(20, context);
+    end = bc::partial_sort_copy(
+        input.begin(), input.begin() + 3, large_output.begin(), large_output.end(),
+        queue
+    );
+    BOOST_CHECK(end == large_output.begin() + 3);
+    CHECK_RANGE_EQUAL(int, 3, large_output, (3, 7, 9));
+}
+
+BOOST_AUTO_TEST_CASE(top_k_float)
+{
+    const size_t size = 500000;
+    const size_t k = 100;
+
+    std::vector<float> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = static_cast<float>(std::rand()) / RAND_MAX;
+    }
+
+    bc::vector<float> input(host.begin(), host.end(), queue);
+    bc::vector<float> output(k, context);
+    bc::top_k(input.begin(), input.end(), k, output.begin(), queue);
+
+    std::partial_sort(
+        host.begin(), host.begin() + k, host.end(), std::greater<float>()
+    );
+    std::vector<float> result(k);
+    bc::copy(output.begin(), output.end(), result.begin(), queue);
+    BOOST_CHECK(std::equal(result.begin(), result.end(), host.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(top_k_by_key_int)
+{
+    const size_t size = 300000;
+    const size_t k = 50;
+
+    std::vector<int> host_keys(size);
+    std::vector<int> host_values(size);
+    for(size_t i = 0; i < size; i++){
+        // distinct keys so that the result is unique
+        host_keys[i] = static_cast<int>((i * 7919) % size);
+        host_values[i] = static_cast<int>(i);
+    }
+
+    bc::vector<int> keys(host_keys.begin(), host_keys.end(), queue);
+    bc::vector<int> values(host_values.begin(), host_values.end(), queue);
+    bc::vector<int> keys_output(k, context);
+    bc::vector<int> values_output(k, context);
+
+    bc::top_k_by_key(
+        keys.begin(), keys.end(), values.begin(), k,
+        keys_output.begin(), values_output.begin(), bc::less<int>(), queue
+    );
+
+    std::vector<int> result_keys(k);
+    std::vector<int> result_values(k);
+    bc::copy(keys_output.begin(), keys_output.end(), result_keys.begin(), queue);
+    bc::copy(values_output.begin(), values_output.end(), result_values.begin(), queue);
+    for(size_t i = 0; i < k; i++){
+        BOOST_CHECK_EQUAL(result_keys[i], static_cast<int>(i));
+        BOOST_CHECK_EQUAL(host_keys[static_cast<size_t>(result_values[i])], result_keys[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestPercentile
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/function.hpp>
+#include <boost/compute/algorithm/median.hpp>
+#include <boost/compute/algorithm/percentile.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(median_int)
+{
+    int data[] = { 5, 6, 4, 3, 2, 6, 7, 9, 3 };
+    bc::vector<int> vector(data, data + 9, queue);
+
+    BOOST_CHECK_EQUAL(bc::median(vector.begin(), vector.end(), queue), 5);
+
+    // lower median for an even number of elements
+    BOOST_CHECK_EQUAL(bc::median(vector.begin(), vector.begin() + 8, queue), 5);
+    BOOST_CHECK_EQUAL(bc::median(vector.begin(), vector.begin() + 4, queue), 4);
+
+    // the input is not modified
+    CHECK_RANGE_EQUAL(int, 9, vector, (5, 6, 4, 3, 2, 6, 7, 9, 3));
+}
+
+BOOST_AUTO_TEST_CASE(median_float)
+{
+    float data[] = { -1.5f, 2.0f, -0.0f, 8.25f, -7.0f };
+    bc::vector<float> vector(data, data + 5, queue);
+
+    BOOST_CHECK_EQUAL(bc::median(vector.begin(), vector.end(), queue), -0.0f);
+    BOOST_CHECK_EQUAL(
+        bc::median(vector.begin(), vector.end(), bc::greater<float>(), queue),
+        -0.0f
+    );
+}
+
+BOOST_AUTO_TEST_CASE(percentile_int)
+{
+    const size_t size = 100000;
+
+    std::vector<int> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() - RAND_MAX / 2;
+    }
+
+    bc::vector<int> vector(host.begin(), host.end(), queue);
+    std::sort(host.begin(), host.end());
+
+    BOOST_CHECK_EQUAL(bc::percentile(vector.begin(), vector.end(), 0.0, queue), host[0]);
+    BOOST_CHECK_EQUAL(bc::percentile(vector.begin(), vector.end(), 50.0, queue), host[49999]);
+    BOOST_CHECK_EQUAL(bc::percentile(vector.begin(), vector.end(), 99.0, queue), host[98999]);
+    BOOST_CHECK_EQUAL(bc::percentile(vector.begin(), vector.end(), 100.0, queue), host[size - 1]);
+}
+
+BOOST_AUTO_TEST_CASE(percentile_custom_compare)
+{
+    BOOST_COMPUTE_FUNCTION(bool, abs_less, (int a, int b),
+    {
+        return abs(a) < abs(b);
+    });
+
+    int data[] = { 1, -8, 3, -4, 6 };
+    bc::vector<int> vector(data, data + 5, queue);
+
+    // order by absolute value, handled by the generic path
+    BOOST_CHECK_EQUAL(
+        bc::percentile(vector.begin(), vector.end(), 60.0, abs_less, queue),
+        -4
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,175 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestPhiloxEngine
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/random/bernoulli_distribution.hpp>
+#include <boost/compute/random/normal_distribution.hpp>
+#include <boost/compute/random/philox_engine.hpp>
+#include <boost/compute/random/uniform_int_distribution.hpp>
+#include <boost/compute/random/uniform_real_distribution.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(generate_uint)
+{
+    using bc::uint_;
+
+    // known answers for a zero key and counter
+    bc::philox4x32_10 engine(queue);
+    bc::vector<uint_> values(6, context);
+    engine.generate(values.begin(), values.end(), queue);
+
+    std::vector<uint_> host(6);
+    bc::copy(values.begin(), values.end(), host.begin(), queue);
+    BOOST_CHECK_EQUAL(host[0], uint_(0x6627e8d5));
+    BOOST_CHECK_EQUAL(host[1], uint_(0xe169c58d));
+    BOOST_CHECK_EQUAL(host[2], uint_(0xbc57ac4c));
+    BOOST_CHECK_EQUAL(host[3], uint_(0x9b00dbd8));
+
+    // the same seed gives the same values
+    bc::philox4x32_10 other(queue);
+    bc::vector<uint_> other_values(6, context);
+    other.generate(other_values.begin(), other_values.end(), queue);
+    CHECK_RANGE_EQUAL(
+        uint_, 6, other_values,
+        (host[0], host[1], host[2], host[3], host[4], host[5])
+    );
+}
+
+BOOST_AUTO_TEST_CASE(generate_float)
+{
+    bc::philox4x32_10 engine(queue, 42);
+    bc::uniform_real_distribution<float> distribution(0.f, 4.f);
+
+    // not a multiple of the block size
+    const size_t size = 100001;
+    bc::vector<float> values(size, context);
+    distribution.generate(values.begin(), values.end(), engine, queue);
+
+    std::vector<float> host(size);
+    bc::copy(values.begin(), values.end(), host.begin(), queue);
+
+    double sum = 0.0;
+    for(size_t i = 0; i < size; i++){
+        BOOST_REQUIRE_LT(host[i], 4.0f);
+        BOOST_REQUIRE_GE(host[i], 0.0f);
+        sum += host[i];
+    }
+    BOOST_CHECK_CLOSE(sum / size, 2.0, 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(generate_normal)
+{
+    bc::philox4x32_10 engine(queue, 7);
+    bc::normal_distribution<float> distribution(5.f, 2.f);
+
+    const size_t size = 100003;
+    bc::vector<float> values(size, context);
+    distribution.generate(values.begin(), values.end(), engine, queue);
+
+    std::vector<float> host(size);
+    bc::copy(values.begin(), values.end(), host.begin(), queue);
+
+    double sum = 0.0;
+    double sum_of_squares = 0.0;
+    for(size_t i = 0; i < size; i++){
+        sum += host[i];
+        sum_of_squares += host[i] * host[i];
+    }
+    const double mean = sum / size;
+    const double stddev = std::sqrt(sum_of_squares / size - mean * mean);
+    BOOST_CHECK_CLOSE(mean, 5.0, 2.0);
+    BOOST_CHECK_CLOSE(stddev, 2.0, 5.0);
+}
+
+BOOST_AUTO_TEST_CASE(generate_int)
+{
+    bc::philox4x32_10 engine(queue, 3);
+    bc::uniform_int_distribution<int> distribution(-3, 6);
+
+    const size_t size = 10007;
+    bc::vector<int> values(size, context);
+    distribution.generate(values.begin(), values.end(), engine, queue);
+
+    std::vector<int> host(size);
+    bc::copy(values.begin(), values.end(), host.begin(), queue);
+
+    std::vector<size_t> histogram(10, 0);
+    for(size_t i = 0; i < size; i++){
+        BOOST_REQUIRE_GE(host[i], -3);
+        BOOST_REQUIRE_LE(host[i], 6);
+        histogram[host[i] + 3]++;
+    }
+    for(size_t i = 0; i < histogram.size(); i++){
+        BOOST_CHECK_GT(histogram[i], size_t(800));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(generate_long_full_range)
+{
+    using bc::long_;
+
+    // the size of the full 64-bit interval does not fit into a ulong
+    bc::philox4x32_10 engine(queue, 5);
+    bc::uniform_int_distribution<long_> distribution(
+        (std::numeric_limits<long_>::min)(), (std::numeric_limits<long_>::max)()
+    );
+
+    const size_t size = 4096;
+    bc::vector<long_> values(size, context);
+    distribution.generate(values.begin(), values.end(), engine, queue);
+
+    std::vector<long_> host(size);
+    bc::copy(values.begin(), values.end(), host.begin(), queue);
+
+    size_t negative = 0;
+    for(size_t i = 0; i < size; i++){
+        if(host[i] < 0){
+            negative++;
+        }
+    }
+    BOOST_CHECK_GT(negative, size_t(1500));
+    BOOST_CHECK_LT(negative, size_t(2600));
+    BOOST_CHECK(std::adjacent_find(host.begin(), host.end()) == host.end());
+}
+
+BOOST_AUTO_TEST_CASE(generate_bool)
+{
+    bc::philox4x32_10 engine(queue, 11);
+    bc::bernoulli_distribution<float> distribution(0.25f);
+
+    const size_t size = 10001;
+    bc::vector<bc::uchar_> values(size, context);
+    distribution.generate(values.begin(), values.end(), engine, queue);
+
+    std::vector<bc::uchar_> host(size);
+    bc::copy(values.begin(), values.end(), host.begin(), queue);
+
+    size_t ones = 0;
+    for(size_t i = 0; i < size; i++){
+        ones += host[i];
+    }
+    BOOST_CHECK_GT(ones, size_t(2200));
+    BOOST_CHECK_LT(ones, size_t(2800));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,161 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestPipeline
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/lambda.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/functional/operator.hpp>
+#include <boost/compute/utility/pipeline.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace compute = boost::compute;
+
+BOOST_AUTO_TEST_CASE(transform_and_copy)
+{
+    using compute::lambda::_1;
+
+    int data[] = { 1, 2, 3, 4, 5 };
+    compute::vector<int> input(data, data + 5, queue);
+    compute::vector<int> output(5, context);
+
+    compute::vector<int>::iterator end =
+        compute::make_pipeline(input.begin(), input.end())
+            .transform(_1 * 3)
+            .transform(_1 - 1)
+            .copy(output.begin(), queue);
+    BOOST_CHECK(end == output.end());
+    CHECK_RANGE_EQUAL(int, 5, output, (2, 5, 8, 11, 14));
+}
+
+BOOST_AUTO_TEST_CASE(filter_and_copy)
+{
+    using compute::lambda::_1;
+
+    int data[] = { 5, -2, 8, 0, 3, -7, 4, 1 };
+    compute::vector<int> input(data, data + 8, queue);
+    compute::vector<int> output(8, context);
+
+    // the kept values keep their order
+    compute::vector<int>::iterator end =
+        compute::make_pipeline(input.begin(), input.end())
+            .transform(_1 * 2)
+            .filter(_1 > 2)
+            .transform(_1 + 1)
+            .filter(_1 != 9)
+            .copy(output.begin(), queue);
+    BOOST_CHECK(end == output.begin() + 4);
+    CHECK_RANGE_EQUAL(int, 4, output, (11, 17, 7, 3));
+
+    // nothing passes the filter
+    end = compute::make_pipeline(input.begin(), input.end())
+              .filter(_1 > 100)
+              .copy(output.begin(), queue);
+    BOOST_CHECK(end == output.begin());
+}
+
+BOOST_AUTO_TEST_CASE(filter_and_reduce)
+{
+    using compute::lambda::_1;
+
+    const int size = 100000;
+    std::vector<int> host(size);
+    for(int i = 0; i < size; i++){
+        host[i] = std::rand() % 1000 - 500;
+    }
+
+    int expected = 10;
+    for(int i = 0; i < size; i++){
+        const int x = host[i] * 2;
+        if(x > 0){
+            expected += x - 1;
+        }
+    }
+
+    compute::vector<int> input(host.begin(), host.end(), queue);
+    int sum = compute::make_pipeline(input.begin(), input.end())
+                  .transform(_1 * 2)
+                  .filter(_1 > 0)
+                  .transform(_1 - 1)
+                  .reduce(10, compute::plus<int>(), queue);
+    BOOST_CHECK_EQUAL(sum, expected);
+
+    // reducing an empty selection returns the initial value
+    sum = compute::make_pipeline(input.begin(), input.end())
+              .filter(_1 > 1000)
+              .reduce(-1, compute::plus<int>(), queue);
+    BOOST_CHECK_EQUAL(sum, -1);
+}
+
+BOOST_AUTO_TEST_CASE(reduce_is_ordered)
+{
+    using compute::lambda::_1;
+    using compute::lambda::_2;
+
+    // keeping the maximum of the first component needs an ordered reduction
+    // when the maximum appears more than once, here the last value of the
+    // input is the maximum so the left-most position wins
+    compute::vector<compute::int2_> input(4096, context);
+    std::vector<compute::int2_> host(4096);
+    for(int i = 0; i < 4096; i++){
+        host[i] = compute::int2_(i % 7, i);
+    }
+    compute::copy(host.begin(), host.end(), input.begin(), queue);
+
+    BOOST_COMPUTE_FUNCTION(compute::int2_, max_first, (compute::int2_ a, compute::int2_ b),
+    {
+        return b.x > a.x ? b : a;
+    });
+
+    compute::int2_ result =
+        compute::make_pipeline(input.begin(), input.end())
+            .reduce(compute::int2_(-1, -1), max_first, queue);
+    BOOST_CHECK_EQUAL(result.x, 6);
+    BOOST_CHECK_EQUAL(result.y, 6);
+}
+
+BOOST_AUTO_TEST_CASE(scan_stage)
+{
+    using compute::lambda::_1;
+
+    compute::vector<int> input(10, context);
+    compute::iota(input.begin(), input.end(), 0, queue);
+    compute::vector<int> output(10, context);
+
+    // 1, 3, 5, 7, 9 -> 1, 4, 9, 16, 25 -> 10, 40, 90, 160, 250
+    compute::vector<int>::iterator end =
+        compute::make_pipeline(input.begin(), input.end())
+            .filter(_1 % 2 == 1)
+            .inclusive_scan(compute::plus<int>())
+            .transform(_1 * 10)
+            .copy(output.begin(), queue);
+    BOOST_CHECK(end == output.begin() + 5);
+    CHECK_RANGE_EQUAL(int, 5, output, (10, 40, 90, 160, 250));
+
+    BOOST_CHECK_EQUAL(
+        compute::make_pipeline(input.begin(), input.end())
+            .inclusive_scan(compute::plus<int>())
+            .filter(_1 > 20)
+            .reduce(0, compute::plus<int>(), queue),
+        21 + 28 + 36 + 45
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestPooledAllocator
+#include <boost/test/unit_test.hpp>
+
+#include <boost/compute/allocator/pooled_allocator.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+#include "opencl_version_check.hpp"
+
+namespace compute = boost::compute;
+
+typedef compute::vector<int, compute::pooled_allocator<int> > pooled_vector;
+
+BOOST_AUTO_TEST_CASE(size_class)
+{
+    using compute::detail::buffer_pool;
+
+    BOOST_CHECK_EQUAL(buffer_pool::size_class(1), size_t(256));
+    BOOST_CHECK_EQUAL(buffer_pool::size_class(256), size_t(256));
+    BOOST_CHECK_EQUAL(buffer_pool::size_class(257), size_t(320));
+    BOOST_CHECK_EQUAL(buffer_pool::size_class(1024), size_t(1024));
+    BOOST_CHECK_EQUAL(buffer_pool::size_class(1025), size_t(1280));
+    BOOST_CHECK_EQUAL(buffer_pool::size_class(4000), size_t(4096));
+}
+
+BOOST_AUTO_TEST_CASE(vector_with_pooled_allocator)
+{
+    pooled_vector vector(context);
+    vector.push_back(12, queue);
+    vector.push_back(24, queue);
+    CHECK_RANGE_EQUAL(int, 2, vector, (12, 24));
+}
+
+BOOST_AUTO_TEST_CASE(reuse_memory)
+{
+    compute::context ctx(device);
+    compute::command_queue queue(ctx, device);
+
+    compute::pooled_allocator<int> allocator(ctx);
+
+    for(int i = 0; i < 10; i++){
+        pooled_vector vector(1000, ctx);
+        compute::iota(vector.begin(), vector.end(), i, queue);
+        BOOST_CHECK_EQUAL(int((vector.end() - 1).read(queue)), 999 + i);
+    }
+
+    compute::pooled_allocator_statistics stats = allocator.statistics();
+    BOOST_CHECK_EQUAL(stats.misses, size_t(1));
+    BOOST_CHECK_EQUAL(stats.hits, size_t(9));
+    BOOST_CHECK_EQUAL(stats.bytes_in_use, size_t(0));
+    BOOST_CHECK_EQUAL(stats.bytes_cached, size_t(4096));
+
+    allocator.trim();
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_cached, size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(max_cached_size)
+{
+    compute::context ctx(device);
+
+    compute::pooled_allocator<int> allocator(ctx);
+    allocator.set_max_cached_size(1024);
+    BOOST_CHECK_EQUAL(allocator.max_cached_size(), size_t(1024));
+
+    compute::pooled_allocator<int>::pointer small = allocator.allocate(256);
+    compute::pooled_allocator<int>::pointer large = allocator.allocate(1024);
+    allocator.deallocate(small, 256);
+    allocator.deallocate(large, 1024);
+
+    // only the first buffer fits in the cache
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_cached, size_t(1024));
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_in_use, size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(slab_carving)
+{
+    REQUIRES_OPENCL_VERSION(1, 1);
+
+    compute::context ctx(device);
+    compute::command_queue queue(ctx, device);
+
+    compute::pooled_allocator<int> allocator(ctx);
+    allocator.set_slab_size(64 * 1024);
+
+    {
+        pooled_vector a(100, ctx);
+        pooled_vector b(100, ctx);
+        compute::iota(a.begin(), a.end(), 0, queue);
+        compute::iota(b.begin(), b.end(), 100, queue);
+        BOOST_CHECK(a.get_buffer() != b.get_buffer());
+        CHECK_RANGE_EQUAL(int, 3, a, (0, 1, 2));
+        CHECK_RANGE_EQUAL(int, 3, b, (100, 101, 102));
+    }
+
+    // both vectors were carved from the same slab
+    BOOST_CHECK_EQUAL(allocator.statistics().misses, size_t(1));
+    BOOST_CHECK_EQUAL(allocator.statistics().hits, size_t(1));
+
+    allocator.trim();
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_cached, size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(release_queue)
+{
+    compute::context ctx(device);
+    compute::command_queue queue(ctx, device);
+
+    compute::pooled_allocator<int> allocator(ctx);
+    allocator.set_release_queue(queue);
+    BOOST_CHECK(allocator.release_queue() == queue);
+
+    compute::pooled_allocator<int>::pointer ptr = allocator.allocate(1000);
+    allocator.deallocate(ptr, 1000);
+
+    // the memory is reused once the commands before its release are done
+    queue.finish();
+    ptr = allocator.allocate(1000);
+    BOOST_CHECK_EQUAL(allocator.statistics().hits, size_t(1));
+    allocator.deallocate(ptr, 1000);
+
+    allocator.set_release_queue(compute::command_queue());
+    allocator.trim();
+}
+
+BOOST_AUTO_TEST_CASE(release_pool)
+{
+    compute::context ctx(device);
+
+    compute::pooled_allocator<int> allocator(ctx);
+    allocator.deallocate(allocator.allocate(1000), 1000);
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_cached, size_t(4096));
+
+    allocator.release_pool();
+    BOOST_CHECK_EQUAL(allocator.statistics().bytes_cached, size_t(0));
+
+    // new allocators for the context use a new pool
+    compute::pooled_allocator<int> other(ctx);
+    BOOST_CHECK_EQUAL(other.statistics().misses, size_t(0));
+    other.release_pool();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,75 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestPrewarm
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/functional/operator.hpp>
+#include <boost/compute/utility/prewarm.hpp>
+#include <boost/compute/utility/program_cache.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace compute = boost::compute;
+
+BOOST_AUTO_TEST_CASE(prewarm_fills_program_cache)
+{
+    boost::shared_ptr<compute::program_cache> cache =
+        compute::program_cache::get_global_cache(context);
+    cache->clear();
+
+    std::vector<compute::prewarm_task> tasks;
+    tasks.push_back(compute::prewarm_sort<float>());
+    tasks.push_back(compute::prewarm_exclusive_scan<int>());
+    tasks.push_back(compute::prewarm_reduce<int>(compute::plus<int>()));
+    tasks.push_back(compute::prewarm_copy<int>());
+    BOOST_CHECK_EQUAL(tasks[0].name(), std::string("sort<float>"));
+
+    std::vector<size_t> sizes;
+    sizes.push_back(1024);
+    compute::prewarm(context, tasks, sizes);
+
+    // the prewarmed programs are now in the cache
+    const size_t cached = cache->size();
+    BOOST_CHECK(cached > 0);
+
+    // sorting does not need to build any new programs
+    float data[] = { 3.0f, 1.0f, 2.0f, 4.0f };
+    std::vector<float> host(1024, 5.0f);
+    std::copy(data, data + 4, host.begin());
+    compute::vector<float> vector(host.begin(), host.end(), queue);
+    compute::sort(vector.begin(), vector.end(), queue);
+    BOOST_CHECK_EQUAL(cache->size(), cached);
+    CHECK_RANGE_EQUAL(float, 4, vector, (1.0f, 2.0f, 3.0f, 4.0f));
+}
+
+struct failing_task
+{
+    void operator()(compute::command_queue &, size_t) const
+    {
+        throw std::runtime_error("failed");
+    }
+};
+
+BOOST_AUTO_TEST_CASE(prewarm_rethrows_task_errors)
+{
+    std::vector<compute::prewarm_task> tasks;
+    tasks.push_back(compute::prewarm_task("failing", failing_task()));
+
+    BOOST_CHECK_THROW(compute::prewarm(context, tasks), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,11 @@
 #define BOOST_TEST_MODULE TestProgramCache
 #include <boost/test/unit_test.hpp>
 
+#if defined(BOOST_COMPUTE_THREAD_SAFE) && defined(BOOST_COMPUTE_HAVE_THREAD_LOCAL)
+#include <thread>
+#include <vector>
+#endif
+
 #include <boost/compute/system.hpp>
 #include <boost/compute/utility/program_cache.hpp>
 
@@ -96,4 +101,43 @@ BOOST_AUTO_TEST_CASE(evict)
     BOOST_CHECK(cache.get("e") == boost::none);
 }
 
+#if defined(BOOST_COMPUTE_THREAD_SAFE) && defined(BOOST_COMPUTE_HAVE_THREAD_LOCAL)
+BOOST_AUTO_TEST_CASE(concurrent_get_or_build)
+{
+    const char source[] =
+        "__kernel void sub(__global int *a, int x)\n"
+        "{\n"
+        "    a[get_global_id(0)] -= x;\n"
+        "}\n";
+
+    const size_t thread_count = 8;
+    std::vector<boost::shared_ptr<compute::program_cache> > caches(thread_count);
+    std::vector<compute::program> programs(thread_count);
+
+    // build the same program from many threads at once
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < thread_count; i++){
+        threads.push_back(std::thread([&, i](){
+            caches[i] = compute::program_cache::get_global_cache(context);
+            programs[i] = caches[i]->get_or_build(
+                "concurrent", std::string(), source, context
+            );
+        }));
+    }
+    for(size_t i = 0; i < thread_count; i++){
+        threads[i].join();
+    }
+
+    // check that all threads share the global cache and that the
+    // program was only built once
+    for(size_t i = 1; i < thread_count; i++){
+        BOOST_CHECK(caches[i] == caches[0]);
+        BOOST_CHECK(programs[i] == programs[0]);
+    }
+    BOOST_CHECK(
+        compute::program_cache::get_global_cache(context)->get("concurrent") == programs[0]
+    );
+}
+#endif // BOOST_COMPUTE_THREAD_SAFE && BOOST_COMPUTE_HAVE_THREAD_LOCAL
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -540,4 +540,82 @@ BOOST_AUTO_TEST_CASE(sort_partial_vector)
     CHECK_RANGE_EQUAL(int, 10, vec, (9, 8, 2, 3, 4, 5, 6, 7, 1, 0));
 }
 
+BOOST_AUTO_TEST_CASE(sort_ulong_vector_bit_range)
+{
+    if(is_apple_cpu_device(device)) {
+        return;
+    }
+
+    using boost::compute::ulong_;
+
+    // keys only use bits 8 to 28
+    ulong_ data[] = {
+        0x0ffff00ULL, 0x0000100ULL, 0x1234500ULL, 0x0000000ULL, 0x1000000ULL,
+        0x0abcd00ULL, 0x0000200ULL, 0x0f0f000ULL, 0x0000100ULL, 0x1fffff00ULL
+    };
+    boost::compute::vector<ulong_> vector(data, data + 10, queue);
+
+    boost::compute::detail::radix_sort(vector.begin(), vector.end(), 8, 29, queue);
+    BOOST_CHECK(
+        boost::compute::is_sorted(vector.begin(), vector.end(), queue)
+    );
+    CHECK_RANGE_EQUAL(
+        ulong_, 10, vector,
+        (0x0000000ULL, 0x0000100ULL, 0x0000100ULL, 0x0000200ULL, 0x0abcd00ULL,
+         0x0f0f000ULL, 0x0ffff00ULL, 0x1000000ULL, 0x1234500ULL, 0x1fffff00ULL)
+    );
+
+    boost::compute::detail::radix_sort(
+        vector.begin(), vector.end(), 8, 29, descending, queue
+    );
+    CHECK_RANGE_EQUAL(
+        ulong_, 10, vector,
+        (0x1fffff00ULL, 0x1234500ULL, 0x1000000ULL, 0x0ffff00ULL, 0x0f0f000ULL,
+         0x0abcd00ULL, 0x0000200ULL, 0x0000100ULL, 0x0000100ULL, 0x0000000ULL)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(sort_uint_vector_skip_uniform_digits)
+{
+    if(is_apple_cpu_device(device)) {
+        return;
+    }
+
+    using boost::compute::uint_;
+
+    // only a single digit differs between the keys, which results in an
+    // odd number of passes
+    uint_ data[] = {
+        0xabc50123, 0xabc30123, 0xabc90123, 0xabc10123, 0xabc70123,
+        0xabc20123, 0xabc80123, 0xabc40123, 0xabc60123, 0xabc00123
+    };
+    boost::compute::vector<uint_> vector(data, data + 10, queue);
+
+    boost::compute::detail::radix_sort(
+        vector.begin(), vector.end(), 0, 32, true, true, queue
+    );
+    CHECK_RANGE_EQUAL(
+        uint_, 10, vector,
+        (0xabc00123, 0xabc10123, 0xabc20123, 0xabc30123, 0xabc40123,
+         0xabc50123, 0xabc60123, 0xabc70123, 0xabc80123, 0xabc90123)
+    );
+
+    boost::compute::detail::radix_sort(
+        vector.begin(), vector.end(), 0, 32, descending, true, queue
+    );
+    CHECK_RANGE_EQUAL(
+        uint_, 10, vector,
+        (0xabc90123, 0xabc80123, 0xabc70123, 0xabc60123, 0xabc50123,
+         0xabc40123, 0xabc30123, 0xabc20123, 0xabc10123, 0xabc00123)
+    );
+
+    // all keys equal, no passes at all
+    boost::compute::vector<uint_> equal(1000, uint_(42), queue);
+    boost::compute::detail::radix_sort(
+        equal.begin(), equal.end(), 0, 32, true, true, queue
+    );
+    BOOST_CHECK_EQUAL(uint_(equal[0]), uint_(42));
+    BOOST_CHECK_EQUAL(uint_(equal[999]), uint_(42));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
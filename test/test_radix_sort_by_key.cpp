@@ -308,4 +308,30 @@ BOOST_AUTO_TEST_CASE(stable_radix_sort_int2_by_int)
     );
 }
 
+BOOST_AUTO_TEST_CASE(radix_sort_ulong_by_int_bit_range)
+{
+    if(is_apple_cpu_device(device)) {
+        return;
+    }
+
+    using compute::ulong_;
+
+    // keys only use bits 0 to 20, equal keys must keep their order
+    ulong_ keys[] = { 70000, 5, 1048575, 5, 0, 65536, 70000, 12 };
+    int values[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    compute::vector<ulong_> keys_vector(keys, keys + 8, queue);
+    compute::vector<int> values_vector(values, values + 8, queue);
+
+    compute::detail::radix_sort_by_key(
+        keys_vector.begin(), keys_vector.end(), values_vector.begin(),
+        0, 20, queue
+    );
+    CHECK_RANGE_EQUAL(
+        ulong_, 8, keys_vector,
+        (ulong_(0), ulong_(5), ulong_(5), ulong_(12),
+         ulong_(65536), ulong_(70000), ulong_(70000), ulong_(1048575))
+    );
+    CHECK_RANGE_EQUAL(int, 8, values_vector, (4, 1, 3, 7, 5, 0, 6, 2));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestRadixSortOnCpu
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/is_sorted.hpp>
+#include <boost/compute/algorithm/detail/radix_sort_on_cpu.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace compute = boost::compute;
+
+BOOST_AUTO_TEST_CASE(sort_int_vector)
+{
+    int data[] = { -4, 152, -94, 963, 31002, -456, 0, -2113 };
+    compute::vector<int> vector(data, data + 8, queue);
+
+    compute::detail::radix_sort_on_cpu(vector.begin(), vector.end(), true, queue);
+    CHECK_RANGE_EQUAL(
+        int, 8, vector,
+        (-2113, -456, -94, -4, 0, 152, 963, 31002)
+    );
+
+    compute::detail::radix_sort_on_cpu(vector.begin(), vector.end(), false, queue);
+    CHECK_RANGE_EQUAL(
+        int, 8, vector,
+        (31002, 963, 152, 0, -4, -94, -456, -2113)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(sort_float_vector)
+{
+    float data[] = { 2.f, -1.5f, 0.f, -3.25f, 1e9f, -1e9f, 0.5f };
+    compute::vector<float> vector(data, data + 7, queue);
+
+    compute::detail::radix_sort_on_cpu(vector.begin(), vector.end(), true, queue);
+    CHECK_RANGE_EQUAL(
+        float, 7, vector,
+        (-1e9f, -3.25f, -1.5f, 0.f, 0.5f, 2.f, 1e9f)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(sort_large_uint_vector)
+{
+    std::vector<compute::uint_> host(100000);
+    for(size_t i = 0; i < host.size(); i++){
+        host[i] = static_cast<compute::uint_>(std::rand()) * 7919u;
+    }
+
+    compute::vector<compute::uint_> vector(host.begin(), host.end(), queue);
+    compute::detail::radix_sort_on_cpu(vector.begin(), vector.end(), true, queue);
+    BOOST_CHECK(compute::is_sorted(vector.begin(), vector.end(), queue));
+
+    std::sort(host.begin(), host.end());
+    std::vector<compute::uint_> result(host.size());
+    compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK(result == host);
+}
+
+BOOST_AUTO_TEST_CASE(sort_ulong_vector_uniform_digits)
+{
+    // only the bits 32-39 differ between the keys
+    std::vector<compute::ulong_> host(10000);
+    for(size_t i = 0; i < host.size(); i++){
+        host[i] = (compute::ulong_(i * 37 % 256) << 32) | 0xff00ff;
+    }
+
+    compute::vector<compute::ulong_> vector(host.begin(), host.end(), queue);
+    compute::detail::radix_sort_on_cpu(vector.begin(), vector.end(), true, queue);
+
+    std::sort(host.begin(), host.end());
+    std::vector<compute::ulong_> result(host.size());
+    compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK(result == host);
+}
+
+// radix_sort_by_key_on_cpu should be stable
+BOOST_AUTO_TEST_CASE(stable_sort_int_by_int)
+{
+    const size_t size = 20000;
+    std::vector<compute::int_> host_keys(size);
+    std::vector<compute::int_> host_values(size);
+    for(size_t i = 0; i < size; i++){
+        host_keys[i] = static_cast<compute::int_>(i % 100) - 50;
+        host_values[i] = static_cast<compute::int_>(i);
+    }
+
+    compute::vector<compute::int_> keys(host_keys.begin(), host_keys.end(), queue);
+    compute::vector<compute::int_> values(host_values.begin(), host_values.end(), queue);
+    compute::detail::radix_sort_by_key_on_cpu(
+        keys.begin(), keys.end(), values.begin(), true, queue
+    );
+
+    std::vector<compute::int_> result_keys(size);
+    std::vector<compute::int_> result_values(size);
+    compute::copy(keys.begin(), keys.end(), result_keys.begin(), queue);
+    compute::copy(values.begin(), values.end(), result_values.begin(), queue);
+
+    for(size_t i = 0; i < size; i++){
+        // each key appears 200 times and values keep their input order
+        const compute::int_ key = static_cast<compute::int_>(i / 200) - 50;
+        BOOST_CHECK_EQUAL(result_keys[i], key);
+        BOOST_CHECK_EQUAL(
+            result_values[i],
+            static_cast<compute::int_>((key + 50) + (i % 200) * 100)
+        );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
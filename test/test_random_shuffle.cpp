@@ -13,10 +13,17 @@
 
 #include <set>
 #include <iterator>
+#include <vector>
 
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/equal.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/algorithm/random_permutation.hpp>
 #include <boost/compute/algorithm/random_shuffle.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/random/threefry_engine.hpp>
 #include <boost/compute/container/vector.hpp>
 
 #include "context_setup.hpp"
@@ -51,4 +58,56 @@ BOOST_AUTO_TEST_CASE(shuffle_int_vector)
     BOOST_VERIFY(original_values == shuffled_values);
 }
 
+BOOST_AUTO_TEST_CASE(shuffle_with_seed)
+{
+    const size_t size = 100000;
+
+    bc::vector<int> a(size, context);
+    bc::vector<int> b(size, context);
+    bc::iota(a.begin(), a.end(), 0, queue);
+    bc::iota(b.begin(), b.end(), 0, queue);
+
+    // the same seed gives the same order
+    bc::random_shuffle(a.begin(), a.end(), 42, queue);
+    bc::random_shuffle(b.begin(), b.end(), 42, queue);
+
+    std::vector<int> host_a(size);
+    std::vector<int> host_b(size);
+    bc::copy(a.begin(), a.end(), host_a.begin(), queue);
+    bc::copy(b.begin(), b.end(), host_b.begin(), queue);
+    BOOST_CHECK(host_a == host_b);
+
+    // the elements were moved
+    size_t fixed_points = 0;
+    for(size_t i = 0; i < size; i++){
+        if(host_a[i] == static_cast<int>(i)){
+            fixed_points++;
+        }
+    }
+    BOOST_CHECK(fixed_points < size / 100);
+
+    // and kept
+    bc::sort(a.begin(), a.end(), queue);
+    bc::vector<int> expected(size, context);
+    bc::iota(expected.begin(), expected.end(), 0, queue);
+    BOOST_CHECK(bc::equal(a.begin(), a.end(), expected.begin(), queue));
+}
+
+BOOST_AUTO_TEST_CASE(random_permutation_indices)
+{
+    const size_t size = 12345;
+
+    bc::threefry_engine<> engine(queue, 7);
+    bc::vector<bc::uint_> indices(size, context);
+    bc::vector<bc::uint_>::iterator end =
+        bc::random_permutation(size, indices.begin(), engine, queue);
+    BOOST_CHECK(end == indices.end());
+
+    std::vector<bc::uint_> host(size);
+    bc::copy(indices.begin(), indices.end(), host.begin(), queue);
+    std::set<bc::uint_> unique(host.begin(), host.end());
+    BOOST_CHECK_EQUAL(unique.size(), size);
+    BOOST_CHECK_EQUAL(*unique.rbegin(), bc::uint_(size - 1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,7 @@
 #define BOOST_TEST_MODULE TestScan
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <numeric>
 #include <functional>
 #include <vector>
@@ -487,4 +488,63 @@ BOOST_AUTO_TEST_CASE(exclusive_scan_int_custom_function)
     CHECK_RANGE_EQUAL(int, 5, vector, (1, 2, 8, 16, 64));
 }
 
+BOOST_AUTO_TEST_CASE(scan_int_multiple_tiles)
+{
+    // large enough to span many work-groups of the single-pass scan
+    const size_t size = (1 << 20) + 123;
+    bc::vector<int> input(size, int(1), queue);
+    bc::vector<int> output(size, context);
+
+    bc::inclusive_scan(input.begin(), input.end(), output.begin(), queue);
+    BOOST_CHECK_EQUAL(int(output[0]), 1);
+    BOOST_CHECK_EQUAL(int(output[size / 2]), int(size / 2 + 1));
+    BOOST_CHECK_EQUAL(int(output[size - 1]), int(size));
+
+    bc::exclusive_scan(input.begin(), input.end(), output.begin(), int(5), queue);
+    BOOST_CHECK_EQUAL(int(output[0]), 5);
+    BOOST_CHECK_EQUAL(int(output[size / 2]), int(size / 2 + 5));
+    BOOST_CHECK_EQUAL(int(output[size - 1]), int(size + 4));
+
+    // in-place exclusive scan
+    bc::exclusive_scan(input.begin(), input.end(), input.begin(), queue);
+    BOOST_CHECK_EQUAL(int(input[0]), 0);
+    BOOST_CHECK_EQUAL(int(input[size - 1]), int(size - 1));
+}
+
+BOOST_AUTO_TEST_CASE(scan_int_non_commutative_function)
+{
+    // both functions are associative but not commutative, the results
+    // are only correct if prefixes are always applied from the left
+    BOOST_COMPUTE_FUNCTION(int, first_of, (int x, int y),
+    {
+        return x;
+    });
+    BOOST_COMPUTE_FUNCTION(int, last_of, (int x, int y),
+    {
+        return y;
+    });
+
+    const size_t size = 100000;
+    bc::vector<int> input(size, context);
+    bc::copy(
+        bc::make_counting_iterator<int>(7),
+        bc::make_counting_iterator<int>(7 + size),
+        input.begin(),
+        queue
+    );
+    bc::vector<int> output(size, context);
+
+    bc::inclusive_scan(input.begin(), input.end(), output.begin(), first_of, queue);
+    std::vector<int> host(size);
+    bc::copy(output.begin(), output.end(), host.begin(), queue);
+    BOOST_CHECK(std::count(host.begin(), host.end(), 7) == int(size));
+
+    bc::inclusive_scan(input.begin(), input.end(), output.begin(), last_of, queue);
+    bc::copy(output.begin(), output.end(), host.begin(), queue);
+    for(size_t i = 0; i < size; i += 997){
+        BOOST_CHECK_EQUAL(host[i], int(i + 7));
+    }
+    BOOST_CHECK_EQUAL(host[size - 1], int(size + 6));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
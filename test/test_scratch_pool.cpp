@@ -0,0 +1,166 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestScratchPool
+#include <boost/test/unit_test.hpp>
+
+#include <boost/weak_ptr.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/sort.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/algorithm/is_sorted.hpp>
+#include <boost/compute/algorithm/reverse.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/scratch_vector.hpp>
+#include <boost/compute/memory/scratch_pool.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+#include "opencl_version_check.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(get_pool)
+{
+    boost::shared_ptr<bc::scratch_pool> pool1 = bc::scratch_pool::get_pool(queue);
+    boost::shared_ptr<bc::scratch_pool> pool2 = bc::scratch_pool::get_pool(queue);
+    BOOST_CHECK(pool1 == pool2);
+    BOOST_CHECK(pool1->get_queue() == queue);
+
+    bc::command_queue other_queue(context, device);
+    boost::shared_ptr<bc::scratch_pool> pool3 = bc::scratch_pool::get_pool(other_queue);
+    BOOST_CHECK(pool1 != pool3);
+
+    // copies of a queue share its pool
+    bc::command_queue queue_copy = other_queue;
+    BOOST_CHECK(bc::scratch_pool::get_pool(queue_copy) == pool3);
+
+    // the pool is only created when it is first requested, so copies made
+    // before that and other objects for the same OpenCL queue share it too
+    bc::command_queue fresh_queue(context, device);
+    bc::command_queue fresh_copy = fresh_queue;
+    bc::command_queue fresh_wrapper(fresh_queue.get());
+    boost::shared_ptr<bc::scratch_pool> pool4 =
+        bc::scratch_pool::get_pool(fresh_copy);
+    BOOST_CHECK(bc::scratch_pool::get_pool(fresh_queue) == pool4);
+    BOOST_CHECK(bc::scratch_pool::get_pool(fresh_wrapper) == pool4);
+
+    // the pool is capped by default
+    BOOST_CHECK(pool1->max_size() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(release_pool_of_destroyed_queue)
+{
+    boost::weak_ptr<bc::scratch_pool> weak_pool;
+    {
+        bc::command_queue scratch_queue(context, device);
+        weak_pool = bc::scratch_pool::get_pool(scratch_queue);
+        BOOST_CHECK(!weak_pool.expired());
+    }
+
+    // the pool is released along with the last copy of its queue
+    BOOST_CHECK(weak_pool.expired());
+}
+
+BOOST_AUTO_TEST_CASE(reuse_memory)
+{
+    REQUIRES_OPENCL_VERSION(1, 1);
+
+    bc::command_queue scratch_queue(context, device);
+    boost::shared_ptr<bc::scratch_pool> pool =
+        bc::scratch_pool::get_pool(scratch_queue);
+    BOOST_CHECK_EQUAL(pool->size(), size_t(0));
+
+    {
+        bc::detail::scratch_vector<int> a(1024, scratch_queue);
+        bc::detail::scratch_vector<int> b(1024, scratch_queue);
+        BOOST_CHECK_EQUAL(a.size(), size_t(1024));
+        BOOST_CHECK(a.get_buffer() != b.get_buffer());
+        BOOST_CHECK(pool->used() >= 2 * 1024 * sizeof(int));
+    }
+    BOOST_CHECK_EQUAL(pool->used(), size_t(0));
+    BOOST_CHECK_EQUAL(pool->slab_count(), size_t(1));
+
+    const size_t size = pool->size();
+    for(int i = 0; i < 8; i++){
+        bc::detail::scratch_vector<int> a(1024, scratch_queue);
+    }
+    BOOST_CHECK_EQUAL(pool->size(), size);
+    BOOST_CHECK_EQUAL(pool->slab_count(), size_t(1));
+
+    pool->trim();
+    BOOST_CHECK_EQUAL(pool->size(), size_t(0));
+    BOOST_CHECK_EQUAL(pool->slab_count(), size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(reserve_and_max_size)
+{
+    REQUIRES_OPENCL_VERSION(1, 1);
+
+    bc::command_queue scratch_queue(context, device);
+    boost::shared_ptr<bc::scratch_pool> pool =
+        bc::scratch_pool::get_pool(scratch_queue);
+
+    pool->reserve(64 * 1024);
+    BOOST_CHECK(pool->size() >= 64 * 1024);
+    const size_t size = pool->size();
+
+    pool->reserve(32 * 1024);
+    BOOST_CHECK_EQUAL(pool->size(), size);
+
+    // allocations beyond the cap are served with dedicated buffers
+    const size_t max_size = pool->max_size();
+    pool->set_max_size(size);
+    BOOST_CHECK_EQUAL(pool->max_size(), size);
+    {
+        bc::detail::scratch_vector<char> a(size, scratch_queue);
+        bc::detail::scratch_vector<char> b(size, scratch_queue);
+        BOOST_CHECK_EQUAL(pool->size(), size);
+    }
+    BOOST_CHECK_EQUAL(pool->used(), size_t(0));
+
+    pool->set_max_size(max_size);
+}
+
+BOOST_AUTO_TEST_CASE(scratch_vector_data)
+{
+    int data[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    bc::detail::scratch_vector<int> vector(8, queue);
+    bc::copy(data, data + 8, vector.begin(), queue);
+    bc::reverse(vector.begin(), vector.end(), queue);
+    CHECK_RANGE_EQUAL(int, 8, vector, (8, 7, 6, 5, 4, 3, 2, 1));
+}
+
+BOOST_AUTO_TEST_CASE(algorithms_with_scratch_memory)
+{
+    bc::command_queue scratch_queue(context, device);
+    boost::shared_ptr<bc::scratch_pool> pool =
+        bc::scratch_pool::get_pool(scratch_queue);
+
+    bc::vector<int> vector(10000, context);
+    for(int i = 0; i < 3; i++){
+        bc::iota(vector.begin(), vector.end(), 0, scratch_queue);
+        bc::reverse(vector.begin(), vector.end(), scratch_queue);
+        bc::sort(vector.begin(), vector.end(), scratch_queue);
+
+        BOOST_CHECK_EQUAL(vector[0], 0);
+        BOOST_CHECK_EQUAL(vector[9999], 9999);
+        BOOST_CHECK(bc::is_sorted(vector.begin(), vector.end(), scratch_queue));
+    }
+
+    // all temporary memory has been returned to the pool
+    BOOST_CHECK_EQUAL(pool->used(), size_t(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
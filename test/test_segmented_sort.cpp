@@ -0,0 +1,142 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestSegmentedSort
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/segmented_sort.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace compute = boost::compute;
+
+BOOST_AUTO_TEST_CASE(segmented_sort_int)
+{
+    int data[] = { 3, 1, 2, 9, 7, 8, 5, 4, 6, 0 };
+    int offsets_data[] = { 0, 3, 6, 6 };
+
+    compute::vector<int> vector(data, data + 10, queue);
+    compute::vector<int> offsets(offsets_data, offsets_data + 4, queue);
+
+    compute::segmented_sort(
+        vector.begin(), vector.end(), offsets.begin(), offsets.end(), queue
+    );
+    CHECK_RANGE_EQUAL(int, 10, vector, (1, 2, 3, 7, 8, 9, 0, 4, 5, 6));
+
+    compute::segmented_sort(
+        vector.begin(), vector.end(), offsets.begin(), offsets.end(),
+        compute::greater<int>(), queue
+    );
+    CHECK_RANGE_EQUAL(int, 10, vector, (3, 2, 1, 9, 8, 7, 6, 5, 4, 0));
+}
+
+// segments of all size classes (small and full work-groups and merged chunks)
+BOOST_AUTO_TEST_CASE(segmented_sort_mixed_sizes)
+{
+    const size_t lengths[] = { 1, 17, 0, 256, 300, 4096, 5000, 20000, 2 };
+    const size_t segment_count = sizeof(lengths) / sizeof(lengths[0]);
+
+    std::vector<compute::uint_> host_offsets;
+    std::vector<float> host;
+    for(size_t i = 0; i < segment_count; i++){
+        host_offsets.push_back(static_cast<compute::uint_>(host.size()));
+        for(size_t j = 0; j < lengths[i]; j++){
+            host.push_back(static_cast<float>(std::rand() % 1000) - 500.f);
+        }
+    }
+
+    compute::vector<float> vector(host.begin(), host.end(), queue);
+    compute::vector<compute::uint_> offsets(
+        host_offsets.begin(), host_offsets.end(), queue
+    );
+    compute::segmented_sort(
+        vector.begin(), vector.end(), offsets.begin(), offsets.end(), queue
+    );
+
+    for(size_t i = 0; i < segment_count; i++){
+        std::vector<float>::iterator first = host.begin() + host_offsets[i];
+        std::sort(first, first + lengths[i]);
+    }
+    std::vector<float> result(host.size());
+    compute::copy(vector.begin(), vector.end(), result.begin(), queue);
+    BOOST_CHECK(result == host);
+}
+
+// sorts segment_count segments of segment_length keys with few distinct
+// values by key and checks that the order of equal keys is kept
+void check_segmented_sort_by_key_stable(const size_t segment_length,
+                                        const size_t segment_count,
+                                        compute::command_queue &queue)
+{
+    const size_t size = segment_length * segment_count;
+
+    std::vector<compute::int_> host_keys(size);
+    std::vector<compute::int_> host_values(size);
+    std::vector<compute::int_> host_offsets(segment_count);
+    for(size_t i = 0; i < size; i++){
+        host_keys[i] = std::rand() % 10;
+        host_values[i] = static_cast<compute::int_>(i);
+    }
+    for(size_t i = 0; i < segment_count; i++){
+        host_offsets[i] = static_cast<compute::int_>(i * segment_length);
+    }
+
+    compute::vector<compute::int_> keys(host_keys.begin(), host_keys.end(), queue);
+    compute::vector<compute::int_> values(host_values.begin(), host_values.end(), queue);
+    compute::vector<compute::int_> offsets(host_offsets.begin(), host_offsets.end(), queue);
+    compute::segmented_sort_by_key(
+        keys.begin(), keys.end(), values.begin(),
+        offsets.begin(), offsets.end(), queue
+    );
+
+    std::vector<compute::int_> result_keys(size);
+    std::vector<compute::int_> result_values(size);
+    compute::copy(keys.begin(), keys.end(), result_keys.begin(), queue);
+    compute::copy(values.begin(), values.end(), result_values.begin(), queue);
+
+    for(size_t i = 0; i < size; i++){
+        const size_t segment = i / segment_length;
+        const size_t value = static_cast<size_t>(result_values[i]);
+
+        // values stay in their segment and with their key
+        BOOST_CHECK_EQUAL(value / segment_length, segment);
+        BOOST_CHECK_EQUAL(host_keys[value], result_keys[i]);
+
+        if(i % segment_length != 0){
+            BOOST_CHECK(result_keys[i-1] <= result_keys[i]);
+            if(result_keys[i-1] == result_keys[i]){
+                BOOST_CHECK_LT(result_values[i-1], result_values[i]);
+            }
+        }
+    }
+}
+
+// segmented_sort_by_key should be stable
+BOOST_AUTO_TEST_CASE(segmented_sort_by_key_stable)
+{
+    check_segmented_sort_by_key_stable(1000, 50, queue);
+}
+
+BOOST_AUTO_TEST_CASE(segmented_sort_by_key_stable_long_segments)
+{
+    // long segments are sorted in chunks which are merged, with an odd
+    // number of chunks per segment so that some runs have no partner
+    check_segmented_sort_by_key_stable(9001, 3, queue);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
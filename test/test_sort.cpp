@@ -364,4 +364,42 @@ BOOST_AUTO_TEST_CASE(sort_int2)
     BOOST_CHECK_NE(host[0], host[1]);
 }
 
+BOOST_AUTO_TEST_CASE(sort_ulong_bit_range)
+{
+    using bc::ulong_;
+
+    // the ids only use their low 36 bits
+    ulong_ data[] = {
+        0x812345678ULL, 0x000000001ULL, 0xfffffffffULL, 0x400000000ULL,
+        0x0ffffffffULL, 0x000000000ULL, 0x812345677ULL, 0x400000000ULL
+    };
+    bc::vector<ulong_> vector(data, data + 8, queue);
+
+    bc::sort(vector.begin(), vector.end(), 0, 36, queue);
+    CHECK_RANGE_EQUAL(
+        ulong_, 8, vector,
+        (0x000000000ULL, 0x000000001ULL, 0x0ffffffffULL, 0x400000000ULL,
+         0x400000000ULL, 0x812345677ULL, 0x812345678ULL, 0xfffffffffULL)
+    );
+}
+
+BOOST_AUTO_TEST_CASE(sort_ulong_skip_uniform_digits)
+{
+    using bc::ulong_;
+
+    // the high 28 bits are the same in every value
+    ulong_ data[] = {
+        0xabc0000812345678ULL, 0xabc0000000000001ULL, 0xabc0000fffffffffULL,
+        0xabc0000400000000ULL, 0xabc00000ffffffffULL, 0xabc0000000000000ULL
+    };
+    bc::vector<ulong_> vector(data, data + 6, queue);
+
+    bc::sort(vector.begin(), vector.end(), 0, 64, true, queue);
+    CHECK_RANGE_EQUAL(
+        ulong_, 6, vector,
+        (0xabc0000000000000ULL, 0xabc0000000000001ULL, 0xabc00000ffffffffULL,
+         0xabc0000400000000ULL, 0xabc0000812345678ULL, 0xabc0000fffffffffULL)
+    );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
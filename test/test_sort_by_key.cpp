@@ -204,4 +204,24 @@ BOOST_AUTO_TEST_CASE(sort_custom_struct_by_int)
     BOOST_CHECK(compute::is_sorted(values.begin(), values.end(), sort_custom_struct, queue) == true);
 }
 
+BOOST_AUTO_TEST_CASE(sort_uint_by_int_bit_range)
+{
+    using compute::uint_;
+
+    // keys only use bits 4 to 12, equal keys keep their order
+    uint_ keys[] = { 0x120, 0x010, 0xff0, 0x010, 0x000, 0x800 };
+    int values[] = { 0, 1, 2, 3, 4, 5 };
+    compute::vector<uint_> keys_vector(keys, keys + 6, queue);
+    compute::vector<int> values_vector(values, values + 6, queue);
+
+    compute::sort_by_key(
+        keys_vector.begin(), keys_vector.end(), values_vector.begin(), 4, 12, queue
+    );
+    CHECK_RANGE_EQUAL(
+        uint_, 6, keys_vector,
+        (uint_(0x000), uint_(0x010), uint_(0x010), uint_(0x120), uint_(0x800), uint_(0xff0))
+    );
+    CHECK_RANGE_EQUAL(int, 6, values_vector, (4, 1, 3, 0, 5, 2));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -19,6 +19,7 @@
 #include <boost/compute/container/vector.hpp>
 #include <boost/compute/iterator/counting_iterator.hpp>
 #include <boost/compute/functional/field.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
 
 #include "check_macros.hpp"
 #include "context_setup.hpp"
@@ -321,4 +322,32 @@ BOOST_AUTO_TEST_CASE(abs_if_odd)
     CHECK_RANGE_EQUAL(int, 8, vector, (-2, +3, -4, +5, -6, +7, -8, +9));
 }
 
+BOOST_AUTO_TEST_CASE(transform_reuses_cached_kernel)
+{
+    using compute::detail::meta_kernel;
+
+    int data1[] = { 1, -2, 3, -4 };
+    compute::vector<int> vector1(data1, data1 + 4, queue);
+    int data2[] = { -5, 6, -7, 8, -9 };
+    compute::vector<int> vector2(data2, data2 + 5, queue);
+
+    meta_kernel::clear_kernel_cache();
+
+    compute::transform(
+        vector1.begin(), vector1.end(), vector1.begin(), compute::abs<int>(), queue
+    );
+    BOOST_CHECK_EQUAL(meta_kernel::kernel_cache_statistics().hits, size_t(0));
+    BOOST_CHECK_EQUAL(meta_kernel::kernel_cache_statistics().misses, size_t(1));
+
+    // same kernel with different buffers and size only rebinds arguments
+    compute::transform(
+        vector2.begin(), vector2.end(), vector2.begin(), compute::abs<int>(), queue
+    );
+    BOOST_CHECK_EQUAL(meta_kernel::kernel_cache_statistics().hits, size_t(1));
+    BOOST_CHECK_EQUAL(meta_kernel::kernel_cache_statistics().misses, size_t(1));
+
+    CHECK_RANGE_EQUAL(int, 4, vector1, (1, 2, 3, 4));
+    CHECK_RANGE_EQUAL(int, 5, vector2, (5, 6, 7, 8, 9));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
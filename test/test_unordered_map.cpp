@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestUnorderedMap
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/container/unordered_map.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(insert_and_find)
+{
+    int keys_data[] = { 1, -1, 3, 2, 3 };
+    float values_data[] = { 1.1f, -1.1f, 3.3f, 2.2f, 4.4f };
+    bc::vector<int> keys(keys_data, keys_data + 5, queue);
+    bc::vector<float> values(values_data, values_data + 4, queue);
+
+    bc::unordered_map<int, float> map(context);
+    BOOST_CHECK_EQUAL(
+        map.insert(keys.begin(), keys.begin() + 4, values.begin(), queue),
+        size_t(4)
+    );
+    BOOST_CHECK_EQUAL(map.size(), size_t(4));
+
+    // existing keys keep their values
+    BOOST_CHECK(!map.insert(3, 9.9f, queue));
+    BOOST_CHECK(map.insert(7, 7.7f, queue));
+    BOOST_CHECK_EQUAL(map.size(), size_t(5));
+
+    int query_data[] = { 3, 4, -1, 7, 1, 0 };
+    bc::vector<int> queries(query_data, query_data + 6, queue);
+    bc::vector<float> result(6, context);
+    map.find(queries.begin(), queries.end(), result.begin(), -100.f, queue);
+    CHECK_RANGE_EQUAL(
+        float, 6, result, (3.3f, -100.f, -1.1f, 7.7f, 1.1f, -100.f)
+    );
+
+    bc::vector<int> found(6, context);
+    map.contains(queries.begin(), queries.end(), found.begin(), queue);
+    CHECK_RANGE_EQUAL(int, 6, found, (1, 0, 1, 1, 1, 0));
+
+    BOOST_CHECK_EQUAL(map.erase(3, queue), size_t(1));
+    BOOST_CHECK_EQUAL(map.count(3, queue), size_t(0));
+    BOOST_CHECK_EQUAL(map.count(2, queue), size_t(1));
+}
+
+BOOST_AUTO_TEST_CASE(large_map)
+{
+    const size_t size = 500000;
+
+    std::vector<bc::uint_> host_keys(size);
+    std::vector<bc::uint_> host_values(size);
+    for(size_t i = 0; i < size; i++){
+        host_keys[i] = static_cast<bc::uint_>(i * 7919);
+        host_values[i] = static_cast<bc::uint_>(i);
+    }
+
+    bc::vector<bc::uint_> keys(host_keys.begin(), host_keys.end(), queue);
+    bc::vector<bc::uint_> values(host_values.begin(), host_values.end(), queue);
+
+    bc::unordered_map<bc::uint_, bc::uint_> map(context);
+    map.insert(keys.begin(), keys.begin() + size / 2, values.begin(), queue);
+    map.insert(keys.begin() + size / 2, keys.end(), values.begin() + size / 2, queue);
+    BOOST_CHECK_EQUAL(map.size(), size);
+    BOOST_CHECK_LE(map.load_factor(), map.max_load_factor());
+
+    bc::vector<bc::uint_> result(size, context);
+    map.find(keys.begin(), keys.end(), result.begin(), bc::uint_(0), queue);
+    std::vector<bc::uint_> host_result(size);
+    bc::copy(result.begin(), result.end(), host_result.begin(), queue);
+    BOOST_CHECK(host_result == host_values);
+
+    // copy out all items and check that each key has its value
+    bc::vector<bc::uint_> keys_out(size, context);
+    bc::vector<bc::uint_> values_out(size, context);
+    std::pair<bc::vector<bc::uint_>::iterator, bc::vector<bc::uint_>::iterator> end =
+        map.copy_items(keys_out.begin(), values_out.begin(), queue);
+    BOOST_CHECK(end.first == keys_out.end());
+    BOOST_CHECK(end.second == values_out.end());
+
+    std::vector<bc::uint_> host_keys_out(size);
+    std::vector<bc::uint_> host_values_out(size);
+    bc::copy(keys_out.begin(), keys_out.end(), host_keys_out.begin(), queue);
+    bc::copy(values_out.begin(), values_out.end(), host_values_out.begin(), queue);
+    for(size_t i = 0; i < size; i++){
+        if(host_keys_out[i] != host_values_out[i] * 7919){
+            BOOST_ERROR("wrong value for key " << host_keys_out[i]);
+            break;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+#define BOOST_TEST_MODULE TestUnorderedSet
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/command_queue.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/iota.hpp>
+#include <boost/compute/container/unordered_set.hpp>
+#include <boost/compute/container/vector.hpp>
+
+#include "check_macros.hpp"
+#include "context_setup.hpp"
+
+namespace bc = boost::compute;
+
+BOOST_AUTO_TEST_CASE(insert_and_count)
+{
+    bc::unordered_set<int> set(context);
+    BOOST_CHECK(set.empty());
+    BOOST_CHECK_EQUAL(set.count(12, queue), size_t(0));
+
+    BOOST_CHECK(set.insert(12, queue));
+    BOOST_CHECK(!set.insert(12, queue));
+    BOOST_CHECK(set.insert(4, queue));
+    BOOST_CHECK_EQUAL(set.size(), size_t(2));
+    BOOST_CHECK_EQUAL(set.count(12, queue), size_t(1));
+    BOOST_CHECK_EQUAL(set.count(4, queue), size_t(1));
+    BOOST_CHECK_EQUAL(set.count(5, queue), size_t(0));
+
+    BOOST_CHECK_EQUAL(set.erase(12, queue), size_t(1));
+    BOOST_CHECK_EQUAL(set.erase(12, queue), size_t(0));
+    BOOST_CHECK_EQUAL(set.size(), size_t(1));
+    BOOST_CHECK_EQUAL(set.count(12, queue), size_t(0));
+    BOOST_CHECK_EQUAL(set.count(4, queue), size_t(1));
+
+    // erased keys can be inserted again
+    BOOST_CHECK(set.insert(12, queue));
+    BOOST_CHECK_EQUAL(set.count(12, queue), size_t(1));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_insert_with_duplicates)
+{
+    const size_t size = 100000;
+
+    std::vector<int> host(size);
+    for(size_t i = 0; i < size; i++){
+        host[i] = std::rand() % 20000 - 10000;
+    }
+    std::set<int> expected(host.begin(), host.end());
+
+    bc::vector<int> keys(host.begin(), host.end(), queue);
+    bc::unordered_set<int> set(context);
+    BOOST_CHECK_EQUAL(set.insert(keys.begin(), keys.end(), queue), expected.size());
+    BOOST_CHECK_EQUAL(set.size(), expected.size());
+    BOOST_CHECK_LE(set.load_factor(), set.max_load_factor());
+
+    // inserting the same keys again adds nothing
+    BOOST_CHECK_EQUAL(set.insert(keys.begin(), keys.end(), queue), size_t(0));
+
+    bc::vector<int> result(set.size(), context);
+    BOOST_CHECK(set.copy_keys(result.begin(), queue) == result.end());
+
+    std::vector<int> host_result(result.size());
+    bc::copy(result.begin(), result.end(), host_result.begin(), queue);
+    std::sort(host_result.begin(), host_result.end());
+    BOOST_CHECK(std::equal(host_result.begin(), host_result.end(), expected.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_contains_and_erase)
+{
+    const size_t size = 1000000;
+
+    // even numbers are in the set
+    bc::vector<bc::uint_> keys(size, context);
+    bc::iota(keys.begin(), keys.end(), bc::uint_(0), queue);
+    bc::unordered_set<bc::uint_> set(context);
+    set.insert(keys.begin(), keys.end(), queue);
+    BOOST_CHECK_EQUAL(set.size(), size);
+
+    bc::vector<bc::uint_> odd(size / 2, context);
+    std::vector<bc::uint_> host_odd(size / 2);
+    for(size_t i = 0; i < host_odd.size(); i++){
+        host_odd[i] = static_cast<bc::uint_>(2 * i + 1);
+    }
+    bc::copy(host_odd.begin(), host_odd.end(), odd.begin(), queue);
+    BOOST_CHECK_EQUAL(set.erase(odd.begin(), odd.end(), queue), size / 2);
+    BOOST_CHECK_EQUAL(set.size(), size / 2);
+
+    bc::vector<bc::uchar_> found(size, context);
+    set.contains(keys.begin(), keys.end(), found.begin(), queue);
+
+    std::vector<bc::uchar_> host_found(size);
+    bc::copy(found.begin(), found.end(), host_found.begin(), queue);
+    for(size_t i = 0; i < size; i++){
+        if(host_found[i] != (i % 2 == 0 ? 1 : 0)){
+            BOOST_ERROR("wrong result for key " << i);
+            break;
+        }
+    }
+
+    BOOST_CHECK_EQUAL(set.statistics(queue).erased, size / 2);
+}
+
+BOOST_AUTO_TEST_CASE(rehash)
+{
+    bc::unordered_set<float> set(16, queue);
+    BOOST_CHECK_EQUAL(set.bucket_count(), size_t(16));
+
+    const float data[] = { 1.5f, -2.0f, 3.25f, 4.0f, 5.0f, 6.5f, 7.0f, 8.0f, 9.0f, 10.0f };
+    bc::vector<float> keys(data, data + 10, queue);
+    set.insert(keys.begin(), keys.end(), queue);
+    BOOST_CHECK_EQUAL(set.size(), size_t(10));
+    BOOST_CHECK_GE(set.bucket_count(), size_t(32));
+
+    set.rehash(1024, queue);
+    BOOST_CHECK_EQUAL(set.bucket_count(), size_t(1024));
+    BOOST_CHECK_EQUAL(set.size(), size_t(10));
+
+    bc::vector<int> found(10, context);
+    set.contains(keys.begin(), keys.end(), found.begin(), queue);
+    CHECK_RANGE_EQUAL(int, 10, found, (1, 1, 1, 1, 1, 1, 1, 1, 1, 1));
+
+    bc::unordered_set<float>::statistics_type stats = set.statistics(queue);
+    BOOST_CHECK_EQUAL(stats.size, size_t(10));
+    BOOST_CHECK_EQUAL(stats.bucket_count, size_t(1024));
+    BOOST_CHECK_GE(stats.max_probe_length, size_t(1));
+    BOOST_CHECK_CLOSE(stats.load_factor(), 10.0 / 1024, 1e-6);
+
+    // copies are independent
+    bc::unordered_set<float> copy = set;
+    copy.clear(queue);
+    BOOST_CHECK(copy.empty());
+    BOOST_CHECK_EQUAL(set.count(4.0f, queue), size_t(1));
+    BOOST_CHECK_EQUAL(copy.count(4.0f, queue), size_t(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
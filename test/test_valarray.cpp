@@ -14,6 +14,7 @@
 #include <boost/compute/system.hpp>
 #include <boost/compute/command_queue.hpp>
 #include <boost/compute/container/valarray.hpp>
+#include <boost/compute/detail/meta_kernel.hpp>
 
 #include "check_macros.hpp"
 #include "context_setup.hpp"
@@ -358,4 +359,79 @@ BOOST_COMPUTE_TEST_VALARRAY_LOGICAL_OPERATOR(||, logical_or)
 
 #undef BOOST_COMPUTE_TEST_VALARRAY_COMPARISON_OPERATOR
 
+BOOST_AUTO_TEST_CASE(fused_expression)
+{
+    using boost::compute::detail::meta_kernel;
+
+    float data_a[] = { 1, 2, 3, 4 };
+    float data_b[] = { 2, 2, 2, 2 };
+    float data_c[] = { 0, 1, 0, 1 };
+    float data_d[] = { 5, 6, 7, 8 };
+    float data_e[] = { 1, 1, 2, 2 };
+    boost::compute::valarray<float> a(data_a, 4);
+    boost::compute::valarray<float> b(data_b, 4);
+    boost::compute::valarray<float> c(data_c, 4);
+    boost::compute::valarray<float> d(data_d, 4);
+    boost::compute::valarray<float> e(data_e, 4);
+    boost::compute::system::finish();
+
+    // the whole expression is evaluated by a single kernel
+    meta_kernel::clear_kernel_cache();
+    boost::compute::valarray<float> result = a * b + c * d - e;
+    BOOST_CHECK_EQUAL(meta_kernel::kernel_cache_statistics().hits +
+                      meta_kernel::kernel_cache_statistics().misses,
+                      size_t(1));
+    boost::compute::system::finish();
+    BOOST_CHECK_CLOSE(float(result[0]), 1.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[1]), 9.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[2]), 4.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[3]), 14.0f, 1e-4f);
+
+    // the same expression with other arrays and scalars reuses the kernel
+    result = 2.0f * a - -(b / 0.5f);
+    boost::compute::system::finish();
+    BOOST_CHECK_CLOSE(float(result[0]), 6.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[1]), 8.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[2]), 10.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[3]), 12.0f, 1e-4f);
+
+    // compound assignment of an expression
+    result -= a * b;
+    boost::compute::system::finish();
+    BOOST_CHECK_CLOSE(float(result[0]), 4.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[1]), 4.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[2]), 4.0f, 1e-4f);
+    BOOST_CHECK_CLOSE(float(result[3]), 4.0f, 1e-4f);
+}
+
+BOOST_AUTO_TEST_CASE(expression_aliasing)
+{
+    int data1[] = { 1, 2, 3, 4 };
+    int data2[] = { 3, 3, 3, 3 };
+    boost::compute::valarray<int> array1(data1, 4);
+    boost::compute::valarray<int> array2(data2, 4);
+    boost::compute::system::finish();
+
+    array1 = array1 * array2 + array1 % 2;
+    boost::compute::system::finish();
+    BOOST_CHECK_EQUAL(int(array1[0]), int(4));
+    BOOST_CHECK_EQUAL(int(array1[1]), int(6));
+    BOOST_CHECK_EQUAL(int(array1[2]), int(10));
+    BOOST_CHECK_EQUAL(int(array1[3]), int(12));
+
+    // assigning to an array of another size reallocates it
+    boost::compute::valarray<int> small(2);
+    small = ~array2;
+    boost::compute::system::finish();
+    BOOST_CHECK_EQUAL(small.size(), size_t(4));
+    BOOST_CHECK_EQUAL(int(small[3]), ~3);
+
+    boost::compute::valarray<char> mask = (array1 > 5) && !(array2 < 3);
+    boost::compute::system::finish();
+    BOOST_CHECK_EQUAL(bool(mask[0]), false);
+    BOOST_CHECK_EQUAL(bool(mask[1]), true);
+    BOOST_CHECK_EQUAL(bool(mask[2]), true);
+    BOOST_CHECK_EQUAL(bool(mask[3]), true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
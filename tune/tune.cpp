@@ -0,0 +1,580 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2013-2014 Kyle Lutz <kyle.r.lutz@gmail.com>
+//
+// Distributed under the Boost Software License, Version 1.0
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+//
+// See http://boostorg.github.com/compute for more information.
+//---------------------------------------------------------------------------//
+
+// the boost.compute auto-tuner. sweeps the tunable parameters of the
+// algorithms on the local device and stores the fastest values in the
+// offline parameter cache (e.g. ~/.boost_compute/tune/<device>.json) where
+// they are picked up by all applications using boost.compute.
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/program_options.hpp>
+
+#include <boost/compute/system.hpp>
+#include <boost/compute/algorithm/copy.hpp>
+#include <boost/compute/algorithm/fill.hpp>
+#include <boost/compute/algorithm/detail/find_if_with_atomics.hpp>
+#include <boost/compute/algorithm/detail/merge_sort_on_cpu.hpp>
+#include <boost/compute/algorithm/detail/radix_sort_on_cpu.hpp>
+#include <boost/compute/algorithm/detail/radix_sort.hpp>
+#include <boost/compute/algorithm/detail/reduce_on_cpu.hpp>
+#include <boost/compute/algorithm/detail/scan_on_gpu.hpp>
+#include <boost/compute/container/vector.hpp>
+#include <boost/compute/detail/parameter_cache.hpp>
+#include <boost/compute/lambda.hpp>
+#include <boost/compute/type_traits/type_name.hpp>
+
+#include "perf.hpp"
+
+namespace po = boost::program_options;
+namespace compute = boost::compute;
+
+typedef boost::function<void(size_t)> benchmark_function;
+
+// settings shared by all tuning procedures
+struct tune_settings
+{
+    compute::command_queue queue;
+    boost::shared_ptr<compute::detail::parameter_cache> parameters;
+    size_t trials;
+    size_t size;
+    std::vector<size_t> sizes;
+    bool quick;
+};
+
+// returns the minimum time (in nanoseconds) for running 'benchmark' with an
+// input of 'size' elements. returns infinity if the benchmark fails (e.g.
+// because of an invalid work-group size for the device).
+double time_benchmark(const tune_settings &settings,
+                      const benchmark_function &benchmark,
+                      size_t size)
+{
+    compute::command_queue queue = settings.queue;
+
+    try {
+        // warm-up run (compiles the programs)
+        benchmark(size);
+        queue.finish();
+
+        perf_timer t;
+        for(size_t trial = 0; trial < settings.trials; trial++){
+            t.start();
+            benchmark(size);
+            queue.finish();
+            t.stop();
+        }
+        return static_cast<double>(t.min_time());
+    }
+    catch(compute::opencl_error&){
+        return (std::numeric_limits<double>::max)();
+    }
+}
+
+// sets each of the candidate values for 'object.parameter', benchmarks it
+// and stores the fastest one
+compute::uint_ tune_parameter(tune_settings &settings,
+                              const std::string &object,
+                              const std::string &parameter,
+                              const std::vector<compute::uint_> &candidates,
+                              const benchmark_function &benchmark)
+{
+    double best_time = (std::numeric_limits<double>::max)();
+    compute::uint_ best_value = candidates.front();
+
+    for(size_t i = 0; i < candidates.size(); i++){
+        settings.parameters->set(object, parameter, candidates[i]);
+
+        const double time = time_benchmark(settings, benchmark, settings.size);
+        if(time < best_time){
+            best_time = time;
+            best_value = candidates[i];
+        }
+    }
+
+    settings.parameters->set(object, parameter, best_value);
+    std::cout << "  " << object << "." << parameter << " = " << best_value << std::endl;
+    return best_value;
+}
+
+// finds the input size at which the code path selected by setting
+// 'object.parameter' to 'above_value' becomes faster than the one selected
+// by 'below_value' and stores it (multiplied by 'unit') as the threshold.
+// if the 'above' path is never faster, 'below_value' is stored.
+compute::uint_ tune_threshold(tune_settings &settings,
+                              const std::string &object,
+                              const std::string &parameter,
+                              compute::uint_ below_value,
+                              compute::uint_ above_value,
+                              size_t unit,
+                              const benchmark_function &benchmark)
+{
+    const std::vector<size_t> &sizes = settings.sizes;
+
+    // search from the largest size down to find the point from which the
+    // 'above' path is faster for all larger sizes
+    compute::uint_ value = below_value;
+    for(size_t i = sizes.size(); i > 0; i--){
+        const size_t size = sizes[i - 1];
+
+        settings.parameters->set(object, parameter, below_value);
+        const double below_time = time_benchmark(settings, benchmark, size);
+
+        settings.parameters->set(object, parameter, above_value);
+        const double above_time = time_benchmark(settings, benchmark, size);
+
+        if(above_time < below_time){
+            value = static_cast<compute::uint_>(size * unit);
+        }
+        else {
+            break;
+        }
+    }
+
+    settings.parameters->set(object, parameter, value);
+    std::cout << "  " << object << "." << parameter << " = " << value << std::endl;
+    return value;
+}
+
+// radix_sort: "k" and "tpb"
+template<class T>
+void radix_sort_benchmark(compute::command_queue &queue,
+                          compute::vector<T> &vector,
+                          size_t size)
+{
+    compute::detail::radix_sort(vector.begin(), vector.begin() + size, queue);
+}
+
+template<class T>
+void tune_radix_sort(tune_settings &settings)
+{
+    const std::string object =
+        std::string("__boost_radix_sort_") + compute::type_name<T>();
+
+    std::vector<T> host = generate_random_vector<T>(settings.size);
+    compute::vector<T> vector(settings.size, settings.queue.get_context());
+    compute::copy(host.begin(), host.end(), vector.begin(), settings.queue);
+
+    benchmark_function benchmark =
+        boost::bind(&radix_sort_benchmark<T>, settings.queue, boost::ref(vector), _1);
+
+    const compute::uint_ ks[] = { 2, 4 };
+    const compute::uint_ tpbs[] = { 64, 128, 256, 512 };
+
+    // tune the block size for each radix width and keep the best pair
+    double best_time = (std::numeric_limits<double>::max)();
+    compute::uint_ best_k = 4;
+    compute::uint_ best_tpb = 128;
+    for(size_t i = 0; i < sizeof(ks) / sizeof(*ks); i++){
+        settings.parameters->set(object, "k", ks[i]);
+
+        for(size_t j = 0; j < sizeof(tpbs) / sizeof(*tpbs); j++){
+            if(settings.quick && tpbs[j] > 256){
+                continue;
+            }
+
+            settings.parameters->set(object, "tpb", tpbs[j]);
+
+            const double time = time_benchmark(settings, benchmark, settings.size);
+            if(time < best_time){
+                best_time = time;
+                best_k = ks[i];
+                best_tpb = tpbs[j];
+            }
+        }
+    }
+
+    settings.parameters->set(object, "k", best_k);
+    settings.parameters->set(object, "tpb", best_tpb);
+    std::cout << "  " << object << ".k = " << best_k << std::endl;
+    std::cout << "  " << object << ".tpb = " << best_tpb << std::endl;
+}
+
+// copy: "map_copy_threshold" and "direct_copy_threshold" for host <-> device
+// copies with value type conversion
+template<class HostType, class DeviceType>
+void copy_to_device_benchmark(compute::command_queue &queue,
+                              const std::vector<HostType> &host,
+                              compute::vector<DeviceType> &device,
+                              size_t size)
+{
+    compute::copy(host.begin(), host.begin() + size, device.begin(), queue);
+}
+
+template<class HostType, class DeviceType>
+void copy_to_host_benchmark(compute::command_queue &queue,
+                            const compute::vector<DeviceType> &device,
+                            std::vector<HostType> &host,
+                            size_t size)
+{
+    compute::copy(device.begin(), device.begin() + size, host.begin(), queue);
+}
+
+template<class HostType, class DeviceType>
+void tune_copy(tune_settings &settings)
+{
+    const size_t max_size = settings.sizes.back();
+    std::vector<HostType> host(max_size, HostType(1));
+    compute::vector<DeviceType> device(max_size, settings.queue.get_context());
+
+    const compute::uint_ max_threshold =
+        (std::numeric_limits<compute::uint_>::max)();
+
+    // host -> device: mapping vs. converting on the host
+    const std::string to_device_object =
+        std::string("__boost_compute_copy_to_device_")
+            + compute::type_name<HostType>() + "_" + compute::type_name<DeviceType>();
+    benchmark_function to_device_benchmark =
+        boost::bind(&copy_to_device_benchmark<HostType, DeviceType>,
+                    settings.queue, boost::cref(host), boost::ref(device), _1);
+    settings.parameters->set(to_device_object, "direct_copy_threshold", max_threshold);
+    const compute::uint_ to_device_map_threshold = tune_threshold(
+        settings, to_device_object, "map_copy_threshold", max_threshold, 0,
+        sizeof(HostType), to_device_benchmark
+    );
+
+    // host -> device: converting on the host vs. converting on the device
+    settings.parameters->set(to_device_object, "map_copy_threshold", 0);
+    tune_threshold(
+        settings, to_device_object, "direct_copy_threshold", max_threshold, 0,
+        sizeof(HostType), to_device_benchmark
+    );
+    settings.parameters->set(
+        to_device_object, "map_copy_threshold", to_device_map_threshold
+    );
+
+    // device -> host: mapping vs. copying to a temporary vector. the
+    // temporary is only used if direct_copy_threshold > map_copy_threshold
+    const std::string to_host_object =
+        std::string("__boost_compute_copy_to_host_")
+            + compute::type_name<DeviceType>() + "_" + compute::type_name<HostType>();
+    settings.parameters->set(to_host_object, "direct_copy_threshold", max_threshold);
+    const compute::uint_ to_host_map_threshold = tune_threshold(
+        settings, to_host_object, "map_copy_threshold", max_threshold, 0,
+        sizeof(DeviceType),
+        boost::bind(&copy_to_host_benchmark<HostType, DeviceType>,
+                    settings.queue, boost::cref(device), boost::ref(host), _1)
+    );
+    if(to_host_map_threshold == max_threshold){
+        // mapping is always faster
+        settings.parameters->set(to_host_object, "direct_copy_threshold", 0);
+    }
+}
+
+// find_if_with_atomics: "vpt" and "one_vpt_threshold" (only used on GPUs)
+template<class T>
+void find_if_benchmark(compute::command_queue &queue,
+                       const compute::vector<T> &vector,
+                       size_t size)
+{
+    using compute::lambda::_1;
+
+    // the value is never found so the whole range is searched
+    compute::detail::find_if_with_atomics(
+        vector.begin(), vector.begin() + size, _1 == T(1), queue
+    );
+}
+
+template<class T>
+void tune_find_if(tune_settings &settings)
+{
+    const std::string object =
+        std::string("__boost_find_if_with_atomics_") + compute::type_name<T>();
+
+    compute::vector<T> vector(settings.sizes.back(), T(0), settings.queue);
+    benchmark_function benchmark =
+        boost::bind(&find_if_benchmark<T>, settings.queue, boost::cref(vector), _1);
+
+    // tune values per thread with the multiple-vpt kernel
+    settings.parameters->set(object, "one_vpt_threshold", 0);
+    const compute::uint_ vpts[] = { 4, 8, 16, 32, 64, 128 };
+    tune_parameter(
+        settings, object, "vpt",
+        std::vector<compute::uint_>(vpts, vpts + sizeof(vpts) / sizeof(*vpts)),
+        benchmark
+    );
+
+    // find the crossover between the one-vpt and multiple-vpt kernels
+    tune_threshold(
+        settings, object, "one_vpt_threshold",
+        (std::numeric_limits<compute::uint_>::max)(), 0, 1, benchmark
+    );
+}
+
+// scan_on_gpu: "tpb" and "vpt" (only used on GPUs)
+template<class T>
+void scan_benchmark(compute::command_queue &queue,
+                    const compute::vector<T> &input,
+                    compute::vector<T> &output,
+                    size_t size)
+{
+    compute::detail::scan_on_gpu(
+        input.begin(), input.begin() + size, output.begin(),
+        false, T(0), compute::plus<T>(), queue
+    );
+}
+
+template<class T>
+void tune_scan_on_gpu(tune_settings &settings)
+{
+    const std::string object =
+        "__boost_scan_gpu_" + boost::lexical_cast<std::string>(sizeof(T));
+
+    compute::vector<T> input(settings.size, T(1), settings.queue);
+    compute::vector<T> output(settings.size, settings.queue.get_context());
+    benchmark_function benchmark =
+        boost::bind(&scan_benchmark<T>, settings.queue,
+                    boost::cref(input), boost::ref(output), _1);
+
+    const compute::uint_ tpbs[] = { 64, 128, 256 };
+    tune_parameter(
+        settings, object, "tpb",
+        std::vector<compute::uint_>(tpbs, tpbs + sizeof(tpbs) / sizeof(*tpbs)),
+        benchmark
+    );
+
+    const compute::uint_ vpts[] = { 1, 2, 4, 8, 16 };
+    tune_parameter(
+        settings, object, "vpt",
+        std::vector<compute::uint_>(vpts, vpts + sizeof(vpts) / sizeof(*vpts)),
+        benchmark
+    );
+}
+
+// merge_sort_on_cpu: "insertion_sort_block_size" (only used on CPUs)
+template<class T>
+void merge_sort_benchmark(compute::command_queue &queue,
+                          const compute::vector<T> &input,
+                          compute::vector<T> &vector,
+                          size_t size)
+{
+    compute::copy(input.begin(), input.begin() + size, vector.begin(), queue);
+    compute::detail::merge_sort_on_cpu(
+        vector.begin(), vector.begin() + size, compute::less<T>(), queue
+    );
+}
+
+template<class T>
+void tune_merge_sort_on_cpu(tune_settings &settings)
+{
+    const std::string object =
+        std::string("__boost_merge_sort_on_cpu_") + compute::type_name<T>();
+
+    std::vector<T> host = generate_random_vector<T>(settings.size);
+    compute::vector<T> input(host.begin(), host.end(), settings.queue);
+    compute::vector<T> vector(settings.size, settings.queue.get_context());
+
+    const compute::uint_ block_sizes[] = { 8, 16, 32, 64, 128, 256 };
+    tune_parameter(
+        settings, object, "insertion_sort_block_size",
+        std::vector<compute::uint_>(
+            block_sizes, block_sizes + sizeof(block_sizes) / sizeof(*block_sizes)
+        ),
+        boost::bind(&merge_sort_benchmark<T>, settings.queue,
+                    boost::cref(input), boost::ref(vector), _1)
+    );
+}
+
+// radix_sort_on_cpu: "k", "threads_per_cu" and "wc_size" (only used on CPUs)
+template<class T>
+void radix_sort_on_cpu_benchmark(compute::command_queue &queue,
+                                 const compute::vector<T> &input,
+                                 compute::vector<T> &vector,
+                                 size_t size)
+{
+    compute::copy(input.begin(), input.begin() + size, vector.begin(), queue);
+    compute::detail::radix_sort_on_cpu(
+        vector.begin(), vector.begin() + size, true, queue
+    );
+}
+
+template<class T>
+void tune_radix_sort_on_cpu(tune_settings &settings)
+{
+    const std::string object =
+        std::string("__boost_radix_sort_on_cpu_") + compute::type_name<T>();
+
+    std::vector<T> host = generate_random_vector<T>(settings.size);
+    compute::vector<T> input(host.begin(), host.end(), settings.queue);
+    compute::vector<T> vector(settings.size, settings.queue.get_context());
+    benchmark_function benchmark =
+        boost::bind(&radix_sort_on_cpu_benchmark<T>, settings.queue,
+                    boost::cref(input), boost::ref(vector), _1);
+
+    const compute::uint_ ks[] = { 4, 6, 8, 11 };
+    tune_parameter(
+        settings, object, "k",
+        std::vector<compute::uint_>(ks, ks + sizeof(ks) / sizeof(*ks)),
+        benchmark
+    );
+
+    const compute::uint_ threads[] = { 1, 2, 4 };
+    tune_parameter(
+        settings, object, "threads_per_cu",
+        std::vector<compute::uint_>(threads, threads + sizeof(threads) / sizeof(*threads)),
+        benchmark
+    );
+
+    const compute::uint_ wc_sizes[] = { 1, 4, 8, 16, 32 };
+    tune_parameter(
+        settings, object, "wc_size",
+        std::vector<compute::uint_>(wc_sizes, wc_sizes + sizeof(wc_sizes) / sizeof(*wc_sizes)),
+        benchmark
+    );
+}
+
+// reduce_on_cpu: "serial_reduce_threshold" (only used on CPUs)
+template<class T>
+void reduce_benchmark(compute::command_queue &queue,
+                      const compute::vector<T> &vector,
+                      compute::vector<T> &result,
+                      size_t size)
+{
+    compute::detail::reduce_on_cpu(
+        vector.begin(), vector.begin() + size, result.begin(),
+        compute::plus<T>(), queue
+    );
+}
+
+template<class T>
+void tune_reduce_on_cpu(tune_settings &settings)
+{
+    const std::string object =
+        "__boost_reduce_cpu_" + boost::lexical_cast<std::string>(sizeof(T));
+
+    compute::vector<T> vector(settings.sizes.back(), T(1), settings.queue);
+    compute::vector<T> result(1, settings.queue.get_context());
+
+    tune_threshold(
+        settings, object, "serial_reduce_threshold",
+        (std::numeric_limits<compute::uint_>::max)(), 0, 1,
+        boost::bind(&reduce_benchmark<T>, settings.queue,
+                    boost::cref(vector), boost::ref(result), _1)
+    );
+}
+
+// a named tuning procedure. completed procedures are recorded in the
+// parameter cache so that an interrupted run can be resumed.
+struct tune_task
+{
+    tune_task(const std::string &name_, void (*function_)(tune_settings &))
+        : name(name_),
+          function(function_)
+    {
+    }
+
+    std::string name;
+    void (*function)(tune_settings &);
+};
+
+int main(int argc, char *argv[])
+{
+    // setup command line arguments
+    po::options_description options("options");
+    options.add_options()
+        ("help", "show usage instructions")
+        ("quick", "only tune the most common types with fewer sizes and trials")
+        ("restart", "re-run all tuning procedures instead of resuming")
+        ("size", po::value<size_t>(), "input size used for tuning parameters")
+        ("trials", po::value<size_t>(), "number of trials to run for each value")
+    ;
+
+    // parse command line
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    po::notify(vm);
+
+    if(vm.count("help")){
+        std::cout << options << std::endl;
+        return 0;
+    }
+
+    const bool quick = vm.count("quick") > 0;
+
+    // setup context and queue for the default device
+    compute::device device = compute::system::default_device();
+    compute::context context(device);
+
+    tune_settings settings;
+    settings.queue = compute::command_queue(context, device);
+    settings.parameters = compute::detail::parameter_cache::get_global_cache(device);
+    settings.quick = quick;
+    settings.size = quick ? (size_t(1) << 20) : (size_t(1) << 23);
+    settings.trials = quick ? 1 : 3;
+    if(vm.count("size")){
+        settings.size = vm["size"].as<size_t>();
+    }
+    if(vm.count("trials")){
+        settings.trials = vm["trials"].as<size_t>();
+    }
+
+    // input sizes swept when searching for thresholds
+    for(size_t size = 1024; size <= settings.size; size *= (quick ? 16 : 4)){
+        settings.sizes.push_back(size);
+    }
+
+    std::cout << "device: " << device.name() << std::endl;
+
+    // build list of tuning procedures for the device
+    const bool gpu = (device.type() & compute::device::gpu) != 0;
+    std::vector<tune_task> tasks;
+    tasks.push_back(tune_task("radix_sort_uint", &tune_radix_sort<compute::uint_>));
+    tasks.push_back(tune_task("radix_sort_float", &tune_radix_sort<compute::float_>));
+    tasks.push_back(tune_task("copy_int_float", &tune_copy<compute::int_, compute::float_>));
+    if(!quick){
+        tasks.push_back(tune_task("radix_sort_int", &tune_radix_sort<compute::int_>));
+        tasks.push_back(tune_task("radix_sort_ulong", &tune_radix_sort<compute::ulong_>));
+        tasks.push_back(tune_task("copy_float_int", &tune_copy<compute::float_, compute::int_>));
+    }
+    if(gpu){
+        tasks.push_back(tune_task("find_if_int", &tune_find_if<compute::int_>));
+        tasks.push_back(tune_task("scan_on_gpu_4", &tune_scan_on_gpu<compute::int_>));
+        if(!quick){
+            tasks.push_back(tune_task("find_if_float", &tune_find_if<compute::float_>));
+            tasks.push_back(tune_task("scan_on_gpu_8", &tune_scan_on_gpu<compute::ulong_>));
+        }
+    }
+    else {
+        tasks.push_back(tune_task("merge_sort_on_cpu_int", &tune_merge_sort_on_cpu<compute::int_>));
+        tasks.push_back(tune_task("reduce_on_cpu_4", &tune_reduce_on_cpu<compute::int_>));
+        tasks.push_back(tune_task("radix_sort_on_cpu_uint", &tune_radix_sort_on_cpu<compute::uint_>));
+        if(!quick){
+            tasks.push_back(tune_task("merge_sort_on_cpu_float", &tune_merge_sort_on_cpu<compute::float_>));
+            tasks.push_back(tune_task("reduce_on_cpu_8", &tune_reduce_on_cpu<compute::ulong_>));
+            tasks.push_back(tune_task("radix_sort_on_cpu_float", &tune_radix_sort_on_cpu<compute::float_>));
+        }
+    }
+
+    const std::string progress_object = "__boost_tune";
+    for(size_t i = 0; i < tasks.size(); i++){
+        const tune_task &task = tasks[i];
+
+        if(!vm.count("restart") &&
+           settings.parameters->get(progress_object, task.name, 0) != 0){
+            std::cout << task.name << ": already tuned" << std::endl;
+            continue;
+        }
+
+        std::cout << task.name << ":" << std::endl;
+        task.function(settings);
+
+        // record progress and save the parameters after each procedure so
+        // that an interrupted run can be resumed
+        settings.parameters->set(progress_object, task.name, 1);
+        settings.parameters->flush();
+    }
+
+    return 0;
+}